@@ -74,17 +74,17 @@ void autocorrelation(const Eigen::MatrixBase<DerivedA>& y,
  * <p>The implementation involves a fast Fourier transform,
  * followed by a normalization, followed by an inverse transform.
  *
- * <p>This method is just a light wrapper around the three-argument
- * autocovariance function
+ * <p>Reusing the FFT engine across calls avoids recomputing its
+ * plan for sequences of the same length.
  *
  * @tparam T Scalar type.
  * @param y Input sequence.
  * @param acov Autocovariances.
+ * @param fft FFT engine instance.
  */
 template <typename T, typename DerivedA, typename DerivedB>
 void autocovariance(const Eigen::MatrixBase<DerivedA>& y,
-                    Eigen::MatrixBase<DerivedB>& acov) {
-  Eigen::FFT<T> fft;
+                    Eigen::MatrixBase<DerivedB>& acov, Eigen::FFT<T>& fft) {
   autocorrelation(y, acov, fft);
 
   using boost::accumulators::accumulator_set;
@@ -99,6 +99,209 @@ void autocovariance(const Eigen::MatrixBase<DerivedA>& y,
   acov = acov.array() * boost::accumulators::variance(acc);
 }
 
+/**
+ * Reusable FFT engine and buffers for computing autocovariances.  The
+ * FFT plans are computed on first use and cached by the engine for
+ * each transform length, and the buffers only grow, so a workspace can
+ * be reused across chains, parameters and sequence lengths without
+ * reallocating or replanning.  A workspace may only be used by one
+ * thread at a time.
+ */
+class autocovariance_workspace {
+ public:
+  autocovariance_workspace() = default;
+
+  /**
+   * Construct a workspace for sequences of the specified length.
+   *
+   * @param N length of the input sequences
+   */
+  explicit autocovariance_workspace(Eigen::Index N) { resize(N); }
+
+  /**
+   * Set the length of the input sequences.  The buffers are enlarged
+   * if the transforms for this length do not fit in them and are never
+   * shrunk.
+   *
+   * @param N length of the input sequences
+   */
+  void resize(Eigen::Index N) {
+    if (N == size_)
+      return;
+    size_ = N;
+    fft_size_ = 2 * math::internal::fft_next_good_size(N);
+    if (fft_size_ > centered_signal_.size()) {
+      centered_signal_.resize(fft_size_);
+      signal_.resize(fft_size_);
+      freqvec_.resize(fft_size_);
+      result_.resize(fft_size_);
+    }
+  }
+
+  /**
+   * Return the length of the input sequences the workspace is sized for.
+   */
+  Eigen::Index size() const { return size_; }
+
+ private:
+  template <typename DerivedA, typename DerivedB>
+  friend void autocovariance(const Eigen::MatrixBase<DerivedA>& y,
+                             Eigen::MatrixBase<DerivedB>& acov,
+                             autocovariance_workspace& ws);
+  friend void autocovariance_batch(
+      const Eigen::Ref<const Eigen::MatrixXd>& y, Eigen::MatrixXd& acov,
+      autocovariance_workspace& ws);
+
+  Eigen::Index size_ = -1;
+  // Length of the transforms, which may be shorter than the buffers
+  Eigen::Index fft_size_ = 0;
+  Eigen::FFT<double> fft_;
+  Eigen::VectorXd centered_signal_;
+  Eigen::VectorXcd signal_;
+  Eigen::VectorXcd freqvec_;
+  Eigen::VectorXcd result_;
+};
+
+namespace internal {
+
+/**
+ * Return the variance of the specified sequence, normalized by N.
+ *
+ * @tparam Derived type of sequence
+ * @param y sequence
+ * @return variance
+ */
+template <typename Derived>
+inline double autocovariance_scale(const Eigen::MatrixBase<Derived>& y) {
+  using boost::accumulators::accumulator_set;
+  using boost::accumulators::stats;
+  using boost::accumulators::tag::variance;
+
+  accumulator_set<double, stats<variance>> acc;
+  for (int n = 0; n < y.size(); ++n) {
+    acc(y(n));
+  }
+  return boost::accumulators::variance(acc);
+}
+
+}  // namespace internal
+
+/**
+ * Write autocovariance estimates for every lag for the specified
+ * input sequence into the specified result using the FFT engine and
+ * buffers of the specified workspace, which is resized to the length
+ * of the sequence if needed.  The estimates equal those of the
+ * two-argument <code>autocovariance</code>.
+ *
+ * @tparam DerivedA type of input sequence
+ * @tparam DerivedB type of result
+ * @param y Input sequence.
+ * @param acov Autocovariances.
+ * @param ws Workspace.
+ */
+template <typename DerivedA, typename DerivedB>
+void autocovariance(const Eigen::MatrixBase<DerivedA>& y,
+                    Eigen::MatrixBase<DerivedB>& acov,
+                    autocovariance_workspace& ws) {
+  const Eigen::Index N = y.size();
+  ws.resize(N);
+  const Eigen::Index Mt2 = ws.fft_size_;
+
+  // centered_signal = y-mean(y) followed by N zeros
+  ws.centered_signal_.head(Mt2).setZero();
+  ws.centered_signal_.head(N) = y.array() - y.mean();
+  ws.fft_.fwd(ws.freqvec_.data(), ws.centered_signal_.data(), Mt2);
+  ws.freqvec_.head(Mt2) = ws.freqvec_.head(Mt2).cwiseAbs2();
+  ws.fft_.inv(ws.result_.data(), ws.freqvec_.data(), Mt2);
+
+  // use "biased" estimate as recommended by Geyer (1992)
+  acov = ws.result_.head(N).real().array() / (N * N * 2);
+  acov /= acov(0);
+  acov *= internal::autocovariance_scale(y);
+}
+
+/**
+ * Write autocovariance estimates for every lag of every column of the
+ * specified matrix into the columns of the specified result, using
+ * the FFT engine and buffers of the specified workspace, which is
+ * resized to the number of rows if needed.
+ *
+ * <p>Columns are transformed two at a time by packing one into the
+ * real and one into the imaginary part of a single complex sequence.
+ * Because the power spectrum of a real sequence is real and even, both
+ * spectra can be recovered from the one forward transform and inverted
+ * together in one inverse transform, halving the number of transforms.
+ * The estimates agree with the single-sequence estimates up to
+ * floating-point rounding.
+ *
+ * @param y Input sequences, one per column.
+ * @param acov Autocovariances, resized to the size of the input.
+ * @param ws Workspace.
+ */
+inline void autocovariance_batch(const Eigen::Ref<const Eigen::MatrixXd>& y,
+                                 Eigen::MatrixXd& acov,
+                                 autocovariance_workspace& ws) {
+  const Eigen::Index N = y.rows();
+  const Eigen::Index num_cols = y.cols();
+  acov.resize(N, num_cols);
+  ws.resize(N);
+  const Eigen::Index Mt2 = ws.fft_size_;
+
+  Eigen::Index j = 0;
+  for (; j + 1 < num_cols; j += 2) {
+    ws.signal_.head(Mt2).setZero();
+    ws.signal_.head(N).real() = y.col(j).array() - y.col(j).mean();
+    ws.signal_.head(N).imag() = y.col(j + 1).array() - y.col(j + 1).mean();
+    ws.fft_.fwd(ws.freqvec_.data(), ws.signal_.data(), Mt2);
+
+    // separate the two spectra: X_k = (Z_k + conj(Z_-k)) / 2 and
+    // Y_k = (Z_k - conj(Z_-k)) / 2i, then pack |X_k|^2 + i |Y_k|^2
+    for (Eigen::Index k = 0; k < Mt2; ++k) {
+      const std::complex<double> z = ws.freqvec_(k);
+      const std::complex<double> z_conj
+          = std::conj(ws.freqvec_(k == 0 ? 0 : Mt2 - k));
+      ws.result_(k) = {std::norm(z + z_conj) / 4, std::norm(z - z_conj) / 4};
+    }
+    ws.fft_.inv(ws.freqvec_.data(), ws.result_.data(), Mt2);
+
+    acov.col(j) = ws.freqvec_.head(N).real();
+    acov.col(j + 1) = ws.freqvec_.head(N).imag();
+    for (Eigen::Index c = j; c < j + 2; ++c) {
+      acov.col(c) *= internal::autocovariance_scale(y.col(c)) / acov(0, c);
+    }
+  }
+  if (j < num_cols) {
+    auto acov_col = acov.col(j);
+    autocovariance(y.col(j), acov_col, ws);
+  }
+}
+
+/**
+ * Write autocovariance estimates for every lag for the specified
+ * input sequence into the specified result. Normalizes lag-k
+ * autocovariance estimators by N instead of (N - k), yielding biased
+ * but more stable estimators as discussed in Geyer (1992); see
+ * https://projecteuclid.org/euclid.ss/1177011137. The return vector
+ * will be resized to the same length as the input sequence with
+ * lags given by array index.
+ *
+ * <p>The implementation involves a fast Fourier transform,
+ * followed by a normalization, followed by an inverse transform.
+ *
+ * <p>This method is just a light wrapper around the three-argument
+ * autocovariance function
+ *
+ * @tparam T Scalar type.
+ * @param y Input sequence.
+ * @param acov Autocovariances.
+ */
+template <typename T, typename DerivedA, typename DerivedB>
+void autocovariance(const Eigen::MatrixBase<DerivedA>& y,
+                    Eigen::MatrixBase<DerivedB>& acov) {
+  Eigen::FFT<T> fft;
+  autocovariance(y, acov, fft);
+}
+
 /**
  * Write autocovariance estimates for every lag for the specified
  * input sequence into the specified result using the specified FFT
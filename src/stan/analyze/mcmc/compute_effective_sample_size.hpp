@@ -75,10 +75,12 @@ inline double compute_effective_sample_size(std::vector<const double*> draws,
   Eigen::Matrix<Eigen::VectorXd, Eigen::Dynamic, 1> acov(num_chains);
   Eigen::VectorXd chain_mean(num_chains);
   Eigen::VectorXd chain_var(num_chains);
+  autocovariance_workspace ws;
   for (int chain = 0; chain < num_chains; ++chain) {
     Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 1>> draw(
         draws[chain], sizes[chain]);
-    autocovariance<double>(draw, acov(chain));
+    acov(chain).resize(sizes[chain]);
+    autocovariance(draw, acov(chain), ws);
     chain_mean(chain) = draw.mean();
     chain_var(chain) = acov(chain)(0) * num_draws / (num_draws - 1);
   }
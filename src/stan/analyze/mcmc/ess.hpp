@@ -22,25 +22,27 @@ namespace analyze {
  * yielding biased but more stable estimators as discussed in Geyer (1992); see
  * https://projecteuclid.org/euclid.ss/1177011137.
  *
+ * <p>The autocovariances of all chains are computed with the FFT
+ * engine and buffers of the specified workspace, so callers computing
+ * ESS for many parameters can pass the same workspace to every call.
+ *
  * @param chains matrix of draws across all chains
+ * @param ws autocovariance workspace
  * @return effective sample size for the specified parameter
  */
-double ess(const Eigen::MatrixXd& chains) {
+inline double ess(const Eigen::MatrixXd& chains,
+                  autocovariance_workspace& ws) {
   const Eigen::Index num_chains = chains.cols();
   const Eigen::Index draws_per_chain = chains.rows();
-  Eigen::MatrixXd acov(draws_per_chain, num_chains);
+  Eigen::MatrixXd acov;
   Eigen::VectorXd chain_mean(num_chains);
   Eigen::VectorXd chain_var(num_chains);
 
   // compute the per-chain autocovariance
+  autocovariance_batch(chains, acov, ws);
   for (size_t i = 0; i < num_chains; ++i) {
     chain_mean(i) = chains.col(i).mean();
-    Eigen::Map<const Eigen::VectorXd> draw_col(chains.col(i).data(),
-                                               draws_per_chain);
-    Eigen::VectorXd cov_col(draws_per_chain);
-    autocovariance<double>(draw_col, cov_col);
-    acov.col(i) = cov_col;
-    chain_var(i) = cov_col(0) * draws_per_chain / (draws_per_chain - 1);
+    chain_var(i) = acov(0, i) * draws_per_chain / (draws_per_chain - 1);
   }
 
   // compute var_plus, eqn (3)
@@ -102,6 +104,20 @@ double ess(const Eigen::MatrixXd& chains) {
   return (draws_total / tau_hat);
 }
 
+/**
+ * Computes the effective sample size (ESS) for the specified
+ * parameter across all chains.  The number of draws per chain must be > 3,
+ * and the values across all draws must be finite and not constant.
+ * See https://arxiv.org/abs/1903.08008, section 3.2 for discussion.
+ *
+ * @param chains matrix of draws across all chains
+ * @return effective sample size for the specified parameter
+ */
+inline double ess(const Eigen::MatrixXd& chains) {
+  autocovariance_workspace ws(chains.rows());
+  return ess(chains, ws);
+}
+
 }  // namespace analyze
 }  // namespace stan
 
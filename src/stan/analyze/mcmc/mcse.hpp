@@ -18,16 +18,30 @@ namespace analyze {
  * Follows implementation in the R posterior package.
  *
  * @param chains matrix of draws across all chains
+ * @param ws autocovariance workspace used for the ESS computation
  * @return mcse
  */
-inline double mcse_mean(const Eigen::MatrixXd& chains) {
+inline double mcse_mean(const Eigen::MatrixXd& chains,
+                        autocovariance_workspace& ws) {
   const Eigen::Index num_draws = chains.rows();
   if (chains.rows() < 4 || !is_finite_and_varies(chains))
     return std::numeric_limits<double>::quiet_NaN();
 
   double sample_var
       = (chains.array() - chains.mean()).square().sum() / (chains.size() - 1);
-  return std::sqrt(sample_var / ess(chains));
+  return std::sqrt(sample_var / ess(chains, ws));
+}
+
+/**
+ * Computes the mean Monte Carlo error estimate for the central 90% interval.
+ * See https://arxiv.org/abs/1903.08008, section 4.4.
+ *
+ * @param chains matrix of draws across all chains
+ * @return mcse
+ */
+inline double mcse_mean(const Eigen::MatrixXd& chains) {
+  autocovariance_workspace ws;
+  return mcse_mean(chains, ws);
 }
 
 /**
@@ -37,9 +51,11 @@ inline double mcse_mean(const Eigen::MatrixXd& chains) {
  * https://github.com/stan-dev/posterior/blob/98bf52329d68f3307ac4ecaaea659276ee1de8df/R/convergence.R#L478-L496
  *
  * @param chains matrix of draws across all chains
+ * @param ws autocovariance workspace used for the ESS computation
  * @return mcse
  */
-inline double mcse_sd(const Eigen::MatrixXd& chains) {
+inline double mcse_sd(const Eigen::MatrixXd& chains,
+                      autocovariance_workspace& ws) {
   if (chains.rows() < 4 || !is_finite_and_varies(chains))
     return std::numeric_limits<double>::quiet_NaN();
 
@@ -47,7 +63,7 @@ inline double mcse_sd(const Eigen::MatrixXd& chains) {
   Eigen::MatrixXd draws_ctr = (chains.array() - chains.mean()).abs().matrix();
 
   // posterior pkg fn `ess_mean` computes on split chains
-  double ess_mean = ess(split_chains(draws_ctr));
+  double ess_mean = ess(split_chains(draws_ctr), ws);
 
   // estimated variance (2nd moment)
   double Evar = draws_ctr.array().square().mean();
@@ -61,6 +77,18 @@ inline double mcse_sd(const Eigen::MatrixXd& chains) {
   return std::sqrt(varsd);
 }
 
+/**
+ * Computes the standard deviation of the Monte Carlo error estimate
+ * https://arxiv.org/abs/1903.08008, section 4.4.
+ *
+ * @param chains matrix of draws across all chains
+ * @return mcse
+ */
+inline double mcse_sd(const Eigen::MatrixXd& chains) {
+  autocovariance_workspace ws;
+  return mcse_sd(chains, ws);
+}
+
 }  // namespace analyze
 }  // namespace stan
 
@@ -2,57 +2,188 @@
 #define STAN_ANALYZE_MCMC_RANK_NORMALIZATION_HPP
 
 #include <stan/math/prim.hpp>
-#include <boost/math/distributions/normal.hpp>
+#include <tbb/parallel_sort.h>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <vector>
 #include <limits>
 
 namespace stan {
 namespace analyze {
+namespace internal {
 
 /**
- * Computes normalized average ranks for pooled draws.  The values across
- * all draws be finite and not constant. Normal scores computed using
- * inverse normal transformation and a fractional offset. Based on paper
- * https://arxiv.org/abs/1903.08008
+ * Computes the inverse of the standard normal cumulative distribution
+ * function using algorithm AS 241 of Wichura (1988), "The percentage
+ * points of the normal distribution", Applied Statistics 37, 477-484,
+ * which is accurate to about 1e-16.  The central region, which holds
+ * most draws, is a single rational function without library calls.
  *
- * @param chains matrix of draws, one column per chain
- * @return normal scores for average ranks of draws
+ * @param p probability, strictly between 0 and 1
+ * @return quantile of the standard normal distribution
  */
-inline Eigen::MatrixXd rank_transform(const Eigen::MatrixXd& chains) {
-  const Eigen::Index rows = chains.rows();
-  const Eigen::Index cols = chains.cols();
-  const Eigen::Index size = rows * cols;
+inline double inv_normal_cdf(double p) {
+  const double q = p - 0.5;
+  if (std::fabs(q) <= 0.425) {
+    const double r = 0.180625 - q * q;
+    return q
+           * (((((((r * 2509.0809287301226727 + 33430.575583588128105) * r
+                   + 67265.770927008700853)
+                      * r
+                  + 45921.953931549871457)
+                     * r
+                 + 13731.693765509461125)
+                    * r
+                + 1971.5909503065514427)
+                   * r
+               + 133.14166789178437745)
+                  * r
+              + 3.387132872796366608)
+           / (((((((r * 5226.495278852545925 + 28729.085735721942674) * r
+                   + 39307.89580009271061)
+                      * r
+                  + 21213.794301586595867)
+                     * r
+                 + 5394.1960214247511077)
+                    * r
+                + 687.1870074920579083)
+                   * r
+               + 42.313330701600911252)
+                  * r
+              + 1.0);
+  }
+  double r = std::sqrt(-std::log(q < 0 ? p : 1 - p));
+  double val;
+  if (r <= 5.0) {
+    r -= 1.6;
+    val = (((((((r * 7.7454501427834140764e-4 + 0.0227238449892691845833) * r
+                + 0.24178072517745061177)
+                   * r
+               + 1.27045825245236838258)
+                  * r
+              + 3.64784832476320460504)
+                 * r
+             + 5.7694972214606914055)
+                * r
+            + 4.6303378461565452959)
+               * r
+           + 1.42343711074968357734)
+          / (((((((r * 1.05075007164441684324e-9 + 5.475938084995344946e-4)
+                      * r
+                  + 0.0151986665636164571966)
+                     * r
+                 + 0.14810397642748007459)
+                    * r
+                + 0.68976733498510000455)
+                   * r
+               + 1.6763848301838038494)
+                  * r
+              + 2.05319162663775882187)
+                 * r
+             + 1.0);
+  } else {
+    r -= 5.0;
+    val = (((((((r * 2.01033439929228813265e-7 + 2.71155556874348757815e-5)
+                    * r
+                + 0.0012426609473880784386)
+                   * r
+               + 0.026532189526576123093)
+                  * r
+              + 0.29656057182850489123)
+                 * r
+             + 1.7848265399172913358)
+                * r
+            + 5.4637849111641143699)
+               * r
+           + 6.6579046435011037772)
+          / (((((((r * 2.04426310338993978564e-15 + 1.4215117583164458887e-7)
+                      * r
+                  + 1.8463183175100546818e-5)
+                     * r
+                 + 7.868691311456132591e-4)
+                    * r
+                + 0.0148753612908506148525)
+                   * r
+               + 0.13692988092273580531)
+                  * r
+              + 0.59983220655588793769)
+                 * r
+             + 1.0);
+  }
+  return q < 0 ? -val : val;
+}
 
-  std::vector<std::pair<double, int>> value_with_index(size);
-  for (Eigen::Index i = 0; i < size; ++i) {
-    value_with_index[i] = {chains(i), i};
+}  // namespace internal
+
+/**
+ * Computes normalized average ranks for pooled draws into the
+ * specified matrix, using the specified vector as scratch space for
+ * the sort.  Reusing the result and scratch space across calls avoids
+ * allocating when transforming many parameters with the same number of
+ * draws.  The values across all draws be finite and not constant.
+ * Normal scores computed using inverse normal transformation and a
+ * fractional offset. Based on paper https://arxiv.org/abs/1903.08008
+ *
+ * <p>Only the draw indices are sorted.  Inputs with at least
+ * <code>parallel_threshold</code> draws are sorted in parallel on the
+ * TBB thread pool.
+ *
+ * @param[in] chains matrix of draws, one column per chain
+ * @param[out] rank_matrix normal scores for average ranks of draws,
+ * resized to the size of <code>chains</code>
+ * @param[in, out] order scratch space, resized to the number of draws
+ * @param[in] parallel_threshold minimum number of draws sorted in parallel
+ */
+inline void rank_transform(const Eigen::MatrixXd& chains,
+                           Eigen::MatrixXd& rank_matrix,
+                           std::vector<Eigen::Index>& order,
+                           Eigen::Index parallel_threshold = 1 << 16) {
+  const Eigen::Index size = chains.size();
+  rank_matrix.resize(chains.rows(), chains.cols());
+  order.resize(size);
+  std::iota(order.begin(), order.end(), 0);
+
+  const double* draws = chains.data();
+  auto draw_less = [draws](Eigen::Index a, Eigen::Index b) {
+    return draws[a] < draws[b];
+  };
+  if (size >= parallel_threshold) {
+    tbb::parallel_sort(order.begin(), order.end(), draw_less);
+  } else {
+    std::sort(order.begin(), order.end(), draw_less);
   }
 
-  std::sort(value_with_index.begin(), value_with_index.end());
-  Eigen::MatrixXd rank_matrix = Eigen::MatrixXd::Zero(rows, cols);
   // Assigning average ranks
-  for (Eigen::Index i = 0; i < size; ++i) {
-    // Handle ties by averaging ranks
+  for (Eigen::Index i = 0; i < size;) {
+    // Handle ties by averaging ranks, which start from 1
     Eigen::Index j = i + 1;
-    double sum_ranks = j;
-    Eigen::Index count = 1;
-
-    while (j < size && value_with_index[j].first == value_with_index[i].first) {
-      sum_ranks += j + 1;  // Rank starts from 1
+    while (j < size && draws[order[j]] == draws[order[i]]) {
       ++j;
-      ++count;
     }
-    double avg_rank = sum_ranks / count;
-    boost::math::normal_distribution<double> dist;
-    for (std::size_t k = i; k < j; ++k) {
-      double p = (avg_rank - 0.375) / (size + 0.25);
-      const Eigen::Index index = value_with_index[k].second;
-      rank_matrix(index) = boost::math::quantile(dist, p);
+    double avg_rank = (i + 1 + j) / 2.0;
+    double normal_score
+        = internal::inv_normal_cdf((avg_rank - 0.375) / (size + 0.25));
+    for (Eigen::Index k = i; k < j; ++k) {
+      rank_matrix(order[k]) = normal_score;
     }
-    i = j - 1;  // Skip over tied elements
+    i = j;
   }
+}
+
+/**
+ * Computes normalized average ranks for pooled draws.  The values across
+ * all draws be finite and not constant. Normal scores computed using
+ * inverse normal transformation and a fractional offset. Based on paper
+ * https://arxiv.org/abs/1903.08008
+ *
+ * @param chains matrix of draws, one column per chain
+ * @return normal scores for average ranks of draws
+ */
+inline Eigen::MatrixXd rank_transform(const Eigen::MatrixXd& chains) {
+  Eigen::MatrixXd rank_matrix;
+  std::vector<Eigen::Index> order;
+  rank_transform(chains, rank_matrix, order);
   return rank_matrix;
 }
 
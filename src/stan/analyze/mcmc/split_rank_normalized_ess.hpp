@@ -11,6 +11,44 @@
 namespace stan {
 namespace analyze {
 
+/**
+ * Computes bulk and tail split ESS from chains which have already been
+ * split and whose bulk rank transform has already been computed, so
+ * that callers computing both Rhat and ESS only rank the draws once.
+ * The split draws must be finite, not constant, and have at least four
+ * draws per split chain.
+ *
+ * @param split_draws_matrix matrix of split chains, as returned by
+ * <code>split_chains</code>
+ * @param bulk_ranks rank transform of the split chains, as returned by
+ * <code>rank_transform</code>
+ * @param ws autocovariance workspace
+ * @return pair ESS_bulk, ESS_tail
+ */
+inline std::pair<double, double> split_rank_normalized_ess(
+    const Eigen::MatrixXd& split_draws_matrix,
+    const Eigen::MatrixXd& bulk_ranks, autocovariance_workspace& ws) {
+  double ess_bulk = ess(bulk_ranks, ws);
+  Eigen::MatrixXd q05 = (split_draws_matrix.array()
+                         <= math::quantile(split_draws_matrix.reshaped(), 0.05))
+                            .cast<double>();
+  double ess_tail_05 = ess(q05, ws);
+  Eigen::MatrixXd q95 = (split_draws_matrix.array()
+                         >= math::quantile(split_draws_matrix.reshaped(), 0.95))
+                            .cast<double>();
+  double ess_tail_95 = ess(q95, ws);
+
+  double ess_tail;
+  if (std::isnan(ess_tail_05)) {
+    ess_tail = ess_tail_95;
+  } else if (std::isnan(ess_tail_95)) {
+    ess_tail = ess_tail_05;
+  } else {
+    ess_tail = std::min(ess_tail_05, ess_tail_95);
+  }
+  return std::make_pair(ess_bulk, ess_tail);
+}
+
 /**
  * Computes the split effective sample size (split ESS) using rank based
  * diagnostic for a set of per-chain draws. Based on paper
@@ -33,25 +71,9 @@ inline std::pair<double, double> split_rank_normalized_ess(
     return std::make_pair(std::numeric_limits<double>::quiet_NaN(),
                           std::numeric_limits<double>::quiet_NaN());
   }
-  double ess_bulk = ess(rank_transform(split_draws_matrix));
-  Eigen::MatrixXd q05 = (split_draws_matrix.array()
-                         <= math::quantile(split_draws_matrix.reshaped(), 0.05))
-                            .cast<double>();
-  double ess_tail_05 = ess(q05);
-  Eigen::MatrixXd q95 = (split_draws_matrix.array()
-                         >= math::quantile(split_draws_matrix.reshaped(), 0.95))
-                            .cast<double>();
-  double ess_tail_95 = ess(q95);
-
-  double ess_tail;
-  if (std::isnan(ess_tail_05)) {
-    ess_tail = ess_tail_95;
-  } else if (std::isnan(ess_tail_95)) {
-    ess_tail = ess_tail_05;
-  } else {
-    ess_tail = std::min(ess_tail_05, ess_tail_95);
-  }
-  return std::make_pair(ess_bulk, ess_tail);
+  autocovariance_workspace ws(split_draws_matrix.rows());
+  return split_rank_normalized_ess(split_draws_matrix,
+                                   rank_transform(split_draws_matrix), ws);
 }
 
 }  // namespace analyze
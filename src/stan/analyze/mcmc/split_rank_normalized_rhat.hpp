@@ -12,6 +12,31 @@
 namespace stan {
 namespace analyze {
 
+/**
+ * Computes bulk and tail split Rhat from chains which have already been
+ * split and whose bulk rank transform has already been computed, so
+ * that callers computing both Rhat and ESS only rank the draws once.
+ * The split draws must be finite and not constant, see
+ * <code>is_finite_and_varies</code>.
+ *
+ * @param split_draws_matrix matrix of split chains, as returned by
+ * <code>split_chains</code>
+ * @param bulk_ranks rank transform of the split chains, as returned by
+ * <code>rank_transform</code>
+ * @return pair (bulk_rhat, tail_rhat)
+ */
+inline std::pair<double, double> split_rank_normalized_rhat(
+    const Eigen::MatrixXd& split_draws_matrix,
+    const Eigen::MatrixXd& bulk_ranks) {
+  double rhat_bulk = rhat(bulk_ranks);
+  // zero-center the draws at the median
+  double rhat_tail = rhat(
+      rank_transform((split_draws_matrix.array()
+                      - math::quantile(split_draws_matrix.reshaped(), 0.5))
+                         .abs()));
+  return std::make_pair(rhat_bulk, rhat_tail);
+}
+
 /**
  * Computes the split potential scale reduction (split Rhat) using rank based
  * diagnostic for a set of per-chain draws. Based on paper
@@ -32,13 +57,8 @@ inline std::pair<double, double> split_rank_normalized_rhat(
     return std::make_pair(std::numeric_limits<double>::quiet_NaN(),
                           std::numeric_limits<double>::quiet_NaN());
   }
-  double rhat_bulk = rhat(rank_transform(split_draws_matrix));
-  // zero-center the draws at the median
-  double rhat_tail = rhat(
-      rank_transform((split_draws_matrix.array()
-                      - math::quantile(split_draws_matrix.reshaped(), 0.5))
-                         .abs()));
-  return std::make_pair(rhat_bulk, rhat_tail);
+  return split_rank_normalized_rhat(split_draws_matrix,
+                                    rank_transform(split_draws_matrix));
 }
 
 }  // namespace analyze
@@ -0,0 +1,273 @@
+#ifndef STAN_CALLBACKS_ASYNC_WRITER_HPP
+#define STAN_CALLBACKS_ASYNC_WRITER_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <tbb/concurrent_queue.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * <code>async_write_queue</code> owns a bounded queue of pending writes
+ * and a dedicated I/O thread which drains it, calling the target
+ * writers in the order the writes were queued.
+ *
+ * Writes are queued through <code>async_writer</code> adapters, so
+ * threads producing output, such as the chains of the multi-chain
+ * services, do not block on formatting or disk I/O unless the queue is
+ * full.  Each target writer is only called from the I/O thread, so
+ * targets need not be thread safe.  Writes queued by one thread reach
+ * their target in the order they were made.
+ *
+ * When the queue is full, producers wait for the I/O thread.  These
+ * waits are counted and timed, see <code>statistics()</code>, so that
+ * callers can tell when sampling is bound by output rather than
+ * computation and increase the capacity.
+ */
+class async_write_queue {
+ public:
+  /**
+   * Back-pressure statistics of a queue.
+   */
+  struct stats {
+    /**
+     * Number of writes queued.
+     */
+    std::size_t writes;
+
+    /**
+     * Number of writes which found the queue full and had to wait.
+     */
+    std::size_t blocked_writes;
+
+    /**
+     * Total time in seconds producers spent waiting on a full queue.
+     */
+    double blocked_seconds;
+  };
+
+  /**
+   * Construct a queue and start its I/O thread.
+   *
+   * @param[in] capacity maximum number of pending writes, at least one
+   */
+  explicit async_write_queue(std::size_t capacity = 1024) {
+    queue_.set_capacity(capacity > 0 ? capacity : 1);
+    io_thread_ = std::thread([this]() { drain(); });
+  }
+
+  async_write_queue(const async_write_queue& other) = delete;
+  async_write_queue& operator=(const async_write_queue& other) = delete;
+
+  /**
+   * Write all pending writes and stop the I/O thread.  Errors raised by
+   * target writers are discarded; call <code>close()</code> to observe
+   * them.
+   */
+  ~async_write_queue() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  /**
+   * Write all pending writes and stop the I/O thread.  Writes queued
+   * after a queue is closed are discarded.
+   *
+   * @throw the first exception thrown by a target writer, after which
+   * the remaining writes were discarded
+   */
+  void close() {
+    if (io_thread_.joinable()) {
+      closed_ = true;
+      queue_.push(record(record::stop, nullptr));
+      io_thread_.join();
+    }
+    if (error_) {
+      std::exception_ptr error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  /**
+   * Return the back-pressure statistics of the writes so far.
+   */
+  stats statistics() const {
+    return {writes_.load(), blocked_writes_.load(),
+            blocked_nanoseconds_.load() * 1e-9};
+  }
+
+ private:
+  friend class async_writer;
+
+  /**
+   * A pending call to a target writer.
+   */
+  struct record {
+    enum kind {
+      write_names,
+      write_values,
+      write_blank,
+      write_message,
+      write_matrix,
+      stop
+    };
+
+    record() : type(stop), target(nullptr) {}
+    record(kind type, writer* target) : type(type), target(target) {}
+
+    kind type;
+    writer* target;
+    std::vector<std::string> names;
+    std::vector<double> values;
+    std::string message;
+    Eigen::MatrixXd matrix;
+  };
+
+  /**
+   * Queue a record, waiting while the queue is full.
+   *
+   * @param[in] r record, moved into the queue
+   */
+  void push(record&& r) {
+    if (closed_)
+      return;
+    ++writes_;
+    if (queue_.try_push(std::move(r)))
+      return;
+    ++blocked_writes_;
+    auto start = std::chrono::steady_clock::now();
+    queue_.push(std::move(r));
+    auto blocked = std::chrono::steady_clock::now() - start;
+    blocked_nanoseconds_
+        += std::chrono::duration_cast<std::chrono::nanoseconds>(blocked)
+               .count();
+  }
+
+  /**
+   * Body of the I/O thread.  After a target writer throws, the
+   * remaining records are discarded so producers never wait forever.
+   */
+  void drain() {
+    record r;
+    while (true) {
+      queue_.pop(r);
+      if (r.type == record::stop)
+        return;
+      if (error_)
+        continue;
+      try {
+        writer& target = *r.target;
+        switch (r.type) {
+          case record::write_names:
+            target(r.names);
+            break;
+          case record::write_values:
+            target(std::move(r.values));
+            break;
+          case record::write_blank:
+            target();
+            break;
+          case record::write_message:
+            target(r.message);
+            break;
+          case record::write_matrix:
+            target(r.matrix);
+            break;
+          default:
+            break;
+        }
+      } catch (...) {
+        error_ = std::current_exception();
+      }
+    }
+  }
+
+  tbb::concurrent_bounded_queue<record> queue_;
+  std::thread io_thread_;
+  std::exception_ptr error_;
+  std::atomic<bool> closed_{false};
+  std::atomic<std::size_t> writes_{0};
+  std::atomic<std::size_t> blocked_writes_{0};
+  std::atomic<long long> blocked_nanoseconds_{0};
+};
+
+/**
+ * <code>async_writer</code> is an implementation of <code>writer</code>
+ * which queues every call on an <code>async_write_queue</code> to be
+ * made on the target writer by the queue's I/O thread.
+ *
+ * Rows of values passed as rvalues are moved into the queue rather than
+ * copied.  The queue must outlive the writer and must be closed before
+ * the output of the target writer is used.
+ */
+class async_writer final : public writer {
+ public:
+  /**
+   * Construct a writer queuing calls to the target writer.
+   *
+   * @param[in, out] queue queue and I/O thread making the calls
+   * @param[in, out] target writer receiving the calls
+   */
+  async_writer(async_write_queue& queue, writer& target)
+      : queue_(queue), target_(target) {}
+
+  void operator()(const std::vector<std::string>& names) {
+    record r(record::write_names, &target_);
+    r.names = names;
+    queue_.push(std::move(r));
+  }
+
+  void operator()(const std::vector<double>& state) {
+    (*this)(std::vector<double>(state));
+  }
+
+  void operator()(std::vector<double>&& state) {
+    record r(record::write_values, &target_);
+    r.values = std::move(state);
+    queue_.push(std::move(r));
+  }
+
+  void operator()() {
+    queue_.push(record(record::write_blank, &target_));
+  }
+
+  void operator()(const std::string& message) {
+    record r(record::write_message, &target_);
+    r.message = message;
+    queue_.push(std::move(r));
+  }
+
+  void operator()(const Eigen::Ref<Eigen::Matrix<double, -1, -1>>& values) {
+    record r(record::write_matrix, &target_);
+    r.matrix = values;
+    queue_.push(std::move(r));
+  }
+
+ private:
+  using record = async_write_queue::record;
+
+  /**
+   * The queue making the calls
+   */
+  async_write_queue& queue_;
+
+  /**
+   * The writer receiving the calls
+   */
+  writer& target_;
+};
+
+}  // namespace callbacks
+}  // namespace stan
+#endif
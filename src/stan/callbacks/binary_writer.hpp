@@ -0,0 +1,205 @@
+#ifndef STAN_CALLBACKS_BINARY_WRITER_HPP
+#define STAN_CALLBACKS_BINARY_WRITER_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/binary_draws.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * `binary_writer` is an implementation of `writer` that writes
+ * draws in the binary columnar format described in
+ * `stan/io/binary_draws.hpp` rather than as text.
+ *
+ * Rows of values are buffered and written in blocks of doubles stored
+ * column-major, so writing a draw costs a copy into the buffer
+ * instead of formatting every value.  Names and comments are written
+ * as they arrive, after any buffered draws, so the output keeps the
+ * order of the calls.  The underlying stream is only flushed on
+ * destruction or an explicit call to `flush()`.  The output can be
+ * read back with `stan::io::stan_csv_reader::parse`.
+ *
+ * @tparam Stream A type inheriting from `std::ostream`, opened in
+ * binary mode
+ * @tparam Deleter A class with a valid `operator()` method for deleting the
+ * output stream
+ */
+template <typename Stream, typename Deleter = std::default_delete<Stream>>
+class binary_writer final : public writer {
+ public:
+  /**
+   * Constructs a binary writer and writes the format preamble.
+   *
+   * @param[in, out] output A unique pointer to a type inheriting from
+   * `std::ostream`, opened in binary mode
+   * @param[in] block_rows number of draws buffered before a block is
+   * written
+   */
+  explicit binary_writer(std::unique_ptr<Stream, Deleter>&& output,
+                         std::size_t block_rows = 1024)
+      : output_(std::move(output)), block_rows_(block_rows) {
+    if (block_rows_ == 0)
+      block_rows_ = 1;
+    if (output_ != nullptr)
+      io::binary_draws::write_preamble(*output_);
+  }
+
+  binary_writer(binary_writer& other) = delete;
+  binary_writer(binary_writer&& other) = delete;
+
+  /**
+   * Writes any buffered draws and flushes the stream before destruction.
+   */
+  virtual ~binary_writer() { flush(); }
+
+  /**
+   * Writes a set of names.
+   *
+   * @param[in] names Names in a std::vector
+   */
+  void operator()(const std::vector<std::string>& names) {
+    if (output_ == nullptr)
+      return;
+    write_buffered();
+    output_->put(io::binary_draws::names_record);
+    io::binary_draws::write_uint64(*output_, names.size());
+    for (const auto& name : names)
+      io::binary_draws::write_string(*output_, name);
+  }
+
+  /**
+   * Buffers a row of values, writing a block when the buffer is full.
+   *
+   * @param[in] values Values in a std::vector
+   */
+  void operator()(const std::vector<double>& values) {
+    if (output_ == nullptr)
+      return;
+    if (values.size() != block_cols_) {
+      write_buffered();
+      block_cols_ = values.size();
+      block_.resize(block_rows_ * block_cols_);
+    }
+    for (std::size_t j = 0; j < block_cols_; ++j)
+      block_[j * block_rows_ + buffered_rows_] = values[j];
+    if (++buffered_rows_ == block_rows_)
+      write_buffered();
+  }
+
+  /**
+   * Writes multiple rows and columns of values.
+   *
+   * @param[in] values A matrix of values. The input is expected to have
+   * parameters in the rows and samples in the columns. The matrix is then
+   * transposed for the output.
+   */
+  void operator()(const Eigen::Ref<Eigen::Matrix<double, -1, -1>>& values) {
+    if (output_ == nullptr)
+      return;
+    write_buffered();
+    Eigen::MatrixXd draws = values.transpose();
+    write_block(draws.data(), draws.rows(), draws.cols());
+  }
+
+  /**
+   * Writes a blank comment line.
+   */
+  void operator()() { (*this)(std::string()); }
+
+  /**
+   * Writes the message as a comment line.
+   *
+   * @param[in] message A string
+   */
+  void operator()(const std::string& message) {
+    if (output_ == nullptr)
+      return;
+    write_buffered();
+    output_->put(io::binary_draws::comment_record);
+    io::binary_draws::write_string(*output_, message);
+  }
+
+  /**
+   * Writes any buffered draws and flushes the underlying stream.
+   */
+  void flush() {
+    if (output_ == nullptr)
+      return;
+    write_buffered();
+    output_->flush();
+  }
+
+  /**
+   * Get the underlying stream
+   */
+  inline auto& get_stream() noexcept { return *output_; }
+
+ private:
+  /**
+   * Writes any buffered draws as a block, without flushing the stream.
+   */
+  void write_buffered() {
+    if (buffered_rows_ == 0)
+      return;
+    if (buffered_rows_ < block_rows_) {
+      // Compact the partially filled columns before writing
+      for (std::size_t j = 1; j < block_cols_; ++j)
+        std::copy(block_.begin() + j * block_rows_,
+                  block_.begin() + j * block_rows_ + buffered_rows_,
+                  block_.begin() + j * buffered_rows_);
+    }
+    write_block(block_.data(), buffered_rows_, block_cols_);
+    buffered_rows_ = 0;
+  }
+
+  /**
+   * Writes a draws record.
+   *
+   * @param[in] data column-major values
+   * @param[in] rows number of draws
+   * @param[in] cols number of values per draw
+   */
+  void write_block(const double* data, std::size_t rows, std::size_t cols) {
+    output_->put(io::binary_draws::draws_record);
+    io::binary_draws::write_uint64(*output_, rows);
+    io::binary_draws::write_uint64(*output_, cols);
+    io::binary_draws::write_values(*output_, data, rows * cols);
+  }
+
+  /**
+   * Output stream
+   */
+  std::unique_ptr<Stream, Deleter> output_;
+
+  /**
+   * Number of draws per block
+   */
+  std::size_t block_rows_;
+
+  /**
+   * Number of values per draw in the current block
+   */
+  std::size_t block_cols_{0};
+
+  /**
+   * Number of draws in the current block
+   */
+  std::size_t buffered_rows_{0};
+
+  /**
+   * Column-major buffer holding the current block
+   */
+  std::vector<double> block_;
+};
+
+}  // namespace callbacks
+}  // namespace stan
+
+#endif
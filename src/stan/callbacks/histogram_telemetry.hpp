@@ -0,0 +1,232 @@
+#ifndef STAN_CALLBACKS_HISTOGRAM_TELEMETRY_HPP
+#define STAN_CALLBACKS_HISTOGRAM_TELEMETRY_HPP
+
+#include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/telemetry.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * <code>histogram_telemetry</code> is an implementation of
+ * <code>telemetry</code> that aggregates the measurements of each
+ * transition into histograms, separately for warmup and for the main
+ * phase (sampling, or the iterations of an optimizer), and writes them
+ * as a single record to a <code>structured_writer</code>.
+ *
+ * <p>The measurements are not synchronized, so each chain running in
+ * parallel needs its own instance.
+ */
+class histogram_telemetry : public telemetry {
+ public:
+  /**
+   * A histogram with fixed bin edges.  A histogram with edges
+   * <code>e[0] < ... < e[K-1]</code> has <code>K + 1</code> bins: values
+   * below <code>e[0]</code>, values in <code>[e[k-1], e[k])</code> for
+   * <code>k = 1, ..., K-1</code>, and values from <code>e[K-1]</code> on.
+   */
+  class histogram {
+   private:
+    std::vector<double> edges_;
+    std::vector<int> counts_;
+    std::size_t count_ = 0;
+    double sum_ = 0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+
+   public:
+    /**
+     * Construct an empty histogram with the specified bin edges.
+     *
+     * @param edges increasing bin edges
+     */
+    explicit histogram(std::vector<double> edges)
+        : edges_(std::move(edges)), counts_(edges_.size() + 1, 0) {}
+
+    /**
+     * Return an empty histogram with geometrically spaced edges
+     * <code>first * ratio^k</code> for <code>k = 0, ..., num_edges - 1</code>.
+     *
+     * @param first first edge, must be positive
+     * @param ratio ratio of consecutive edges, must be greater than one
+     * @param num_edges number of edges
+     */
+    static histogram geometric(double first, double ratio,
+                               std::size_t num_edges) {
+      std::vector<double> edges(num_edges);
+      for (std::size_t k = 0; k < num_edges; ++k)
+        edges[k] = first * std::pow(ratio, k);
+      return histogram(std::move(edges));
+    }
+
+    /**
+     * Return an empty histogram with evenly spaced edges
+     * <code>first + width * k</code> for
+     * <code>k = 0, ..., num_edges - 1</code>.
+     *
+     * @param first first edge
+     * @param width width of the bins, must be positive
+     * @param num_edges number of edges
+     */
+    static histogram linear(double first, double width,
+                            std::size_t num_edges) {
+      std::vector<double> edges(num_edges);
+      for (std::size_t k = 0; k < num_edges; ++k)
+        edges[k] = first + width * k;
+      return histogram(std::move(edges));
+    }
+
+    /**
+     * Add a value to the histogram.
+     *
+     * @param x value
+     */
+    void add(double x) {
+      ++count_;
+      sum_ += x;
+      min_ = std::min(min_, x);
+      max_ = std::max(max_, x);
+      ++counts_[std::upper_bound(edges_.begin(), edges_.end(), x)
+                - edges_.begin()];
+    }
+
+    std::size_t count() const { return count_; }
+
+    double sum() const { return sum_; }
+
+    /**
+     * Return the mean of the values, or NaN if there are none.
+     */
+    double mean() const {
+      return count_ == 0 ? std::numeric_limits<double>::quiet_NaN()
+                         : sum_ / count_;
+    }
+
+    /**
+     * Return the smallest value, or NaN if there are none.
+     */
+    double min() const {
+      return count_ == 0 ? std::numeric_limits<double>::quiet_NaN() : min_;
+    }
+
+    /**
+     * Return the largest value, or NaN if there are none.
+     */
+    double max() const {
+      return count_ == 0 ? std::numeric_limits<double>::quiet_NaN() : max_;
+    }
+
+    const std::vector<double>& edges() const { return edges_; }
+
+    const std::vector<int>& counts() const { return counts_; }
+
+    /**
+     * Write the histogram as a record with the specified key.
+     *
+     * @param writer structured writer
+     * @param key name of the record
+     */
+    void write(structured_writer& writer, const std::string& key) const {
+      writer.begin_record(key);
+      writer.write("count", count_);
+      writer.write("sum", sum_);
+      writer.write("mean", mean());
+      writer.write("min", min());
+      writer.write("max", max());
+      writer.write("edges", edges_);
+      writer.write("counts", counts_);
+      writer.end_record();
+    }
+  };
+
+  /**
+   * Histograms of the transitions of one phase of a run.  Times have
+   * four bins per decade from 100 nanoseconds to 1000 seconds, gradient
+   * evaluations have bins at powers of two and tree depths have a bin
+   * per depth.
+   */
+  struct phase {
+    std::size_t transitions = 0;
+    histogram transition_seconds = seconds();
+    histogram gradient_evals = histogram::geometric(1, 2, 17);
+    histogram gradient_seconds = seconds();
+    histogram integrator_seconds = seconds();
+    histogram tree_depth = histogram::linear(0, 1, 16);
+    histogram write_array_seconds = seconds();
+    histogram writer_seconds = seconds();
+
+    void add(const transition_stats& stats) {
+      ++transitions;
+      transition_seconds.add(stats.transition_seconds);
+      gradient_evals.add(stats.gradient_evals);
+      gradient_seconds.add(stats.gradient_seconds);
+      integrator_seconds.add(stats.integrator_seconds());
+      if (stats.tree_depth >= 0)
+        tree_depth.add(stats.tree_depth);
+      write_array_seconds.add(stats.write_array_seconds);
+      writer_seconds.add(stats.writer_seconds);
+    }
+
+    void write(structured_writer& writer, const std::string& key) const {
+      writer.begin_record(key);
+      writer.write("transitions", transitions);
+      transition_seconds.write(writer, "transition_seconds");
+      gradient_evals.write(writer, "gradient_evals");
+      gradient_seconds.write(writer, "gradient_seconds");
+      integrator_seconds.write(writer, "integrator_seconds");
+      tree_depth.write(writer, "tree_depth");
+      write_array_seconds.write(writer, "write_array_seconds");
+      writer_seconds.write(writer, "writer_seconds");
+      writer.end_record();
+    }
+
+   private:
+    static histogram seconds() {
+      return histogram::geometric(1e-7, std::pow(10.0, 0.25), 41);
+    }
+  };
+
+  bool enabled() const { return true; }
+
+  void operator()(const transition_stats& stats) {
+    (stats.warmup ? warmup_ : main_).add(stats);
+  }
+
+  /**
+   * Return the histograms of the warmup transitions.
+   */
+  const phase& warmup() const { return warmup_; }
+
+  /**
+   * Return the histograms of the sampling transitions or optimizer
+   * iterations.
+   */
+  const phase& main() const { return main_; }
+
+  /**
+   * Write the histograms of both phases as a record with the entries
+   * <code>warmup</code> and <code>main</code>.
+   *
+   * @param writer structured writer, typically a <code>json_writer</code>
+   */
+  void write(structured_writer& writer) const {
+    writer.begin_record();
+    warmup_.write(writer, "warmup");
+    main_.write(writer, "main");
+    writer.end_record();
+  }
+
+ private:
+  phase warmup_;
+  phase main_;
+};
+
+}  // namespace callbacks
+}  // namespace stan
+#endif
@@ -0,0 +1,96 @@
+#ifndef STAN_CALLBACKS_TELEMETRY_HPP
+#define STAN_CALLBACKS_TELEMETRY_HPP
+
+#include <cstddef>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * Performance measurements of a single sampler transition or optimizer
+ * iteration.  All times are wall clock seconds measured with
+ * <code>std::chrono::steady_clock</code>.
+ */
+struct transition_stats {
+  /**
+   * Whether the transition was a warmup transition.
+   */
+  bool warmup = false;
+
+  /**
+   * Time spent generating the transition, including the gradient
+   * evaluations.
+   */
+  double transition_seconds = 0;
+
+  /**
+   * Number of log density gradient evaluations, including gradients
+   * computed together with a Hessian.
+   */
+  std::size_t gradient_evals = 0;
+
+  /**
+   * Time spent evaluating log density gradients, and for the SoftAbs
+   * metrics also the Hessians and Hessian products the metric needs.
+   */
+  double gradient_seconds = 0;
+
+  /**
+   * Depth of the trajectory tree, or -1 for algorithms which do not
+   * build one.
+   */
+  int tree_depth = -1;
+
+  /**
+   * Time spent in the model's <code>write_array</code>.
+   */
+  double write_array_seconds = 0;
+
+  /**
+   * Time spent writing the draw and its diagnostics, excluding
+   * <code>write_array</code>.
+   */
+  double writer_seconds = 0;
+
+  /**
+   * Return the time spent generating the transition outside of the
+   * gradient evaluations, that is the overhead of the integrator, the
+   * trajectory bookkeeping and the adaptation.
+   */
+  double integrator_seconds() const {
+    return transition_seconds - gradient_seconds;
+  }
+};
+
+/**
+ * <code>telemetry</code> is a base class defining the interface
+ * for Stan performance instrumentation callbacks.
+ *
+ * The algorithms measure each transition or iteration only if the
+ * callback is enabled, so the base class, which is disabled, adds no
+ * clock reads to a run.
+ */
+class telemetry {
+ public:
+  /**
+   * Return whether the algorithms should measure and report their
+   * transitions to this callback.
+   */
+  virtual bool enabled() const { return false; }
+
+  /**
+   * Callback function called with the measurements of each transition.
+   *
+   * @param stats measurements of the transition
+   */
+  virtual void operator()(const transition_stats& stats) {}
+
+  /**
+   * Virtual destructor.
+   */
+  virtual ~telemetry() {}
+};
+
+}  // namespace callbacks
+}  // namespace stan
+#endif
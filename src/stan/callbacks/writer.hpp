@@ -34,6 +34,19 @@ class writer {
    */
   virtual void operator()(const std::vector<double>& state) {}
 
+  /**
+   * Writes a set of values which the caller no longer needs.  Writers
+   * which keep the values, such as <code>async_writer</code>, override
+   * this to take ownership instead of copying them.  By default the
+   * values are written as by <code>operator()(const
+   * std::vector<double>&)</code>.
+   *
+   * @param[in] state Values in a std::vector
+   */
+  virtual void operator()(std::vector<double>&& state) {
+    (*this)(static_cast<const std::vector<double>&>(state));
+  }
+
   /**
    * Writes blank input.
    */
@@ -287,6 +287,21 @@ class array_var_context : public var_context {
     return empty_vec_r_;
   }
 
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Double values are not copied; integer values are
+   * converted into a buffer owned by the view.
+   *
+   * @param name Name of variable.
+   * @return View of the values of variable.
+   */
+  var_span<double> vals_r_span(const std::string& name) const {
+    const auto ret_val_r = vars_r_.find(name);
+    if (ret_val_r != vars_r_.end())
+      return var_span<double>(ret_val_r->second.first);
+    return var_context::vals_r_span(name);
+  }
+
   /**
    * Return the double values for the variable with the specified
    * name or null.
@@ -361,6 +376,20 @@ class array_var_context : public var_context {
     return empty_vec_i_;
   }
 
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name without copying them.
+   *
+   * @param name Name of variable.
+   * @return View of the values.
+   */
+  var_span<int> vals_i_span(const std::string& name) const {
+    auto ret_val_i = vars_i_.find(name);
+    if (ret_val_i != vars_i_.end())
+      return var_span<int>(ret_val_i->second.first);
+    return var_span<int>();
+  }
+
   /**
    * Return the dimensions for the integer variable with the specified
    * name.
@@ -423,7 +452,7 @@ class array_var_context : public var_context {
   virtual void names_i(std::vector<std::string>& names) const {
     names.clear();
     names.reserve(vars_i_.size());
-    for (const auto& vars_i_iter : vars_r_) {
+    for (const auto& vars_i_iter : vars_i_) {
       names.push_back(vars_i_iter.first);
     }
   }
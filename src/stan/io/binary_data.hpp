@@ -0,0 +1,162 @@
+#ifndef STAN_IO_BINARY_DATA_HPP
+#define STAN_IO_BINARY_DATA_HPP
+
+#include <stan/io/binary_draws.hpp>
+#include <stan/io/var_context.hpp>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Layout of the binary data format read by
+ * `stan::io::binary_var_context`.
+ *
+ * A file starts with the eight magic bytes, a little-endian `uint32`
+ * format version, four reserved zero bytes and a `uint64` number of
+ * variables.  Each variable is then described by
+ *
+ *  - its name, a `uint64` length followed by its bytes,
+ *  - a one byte type, `i` for `int32` values or `d` for doubles,
+ *  - a `uint64` number of dimensions followed by that many `uint64`
+ *    dimensions, and
+ *  - the `uint64` offset of its values from the start of the file.
+ *
+ * The values of every variable are stored column-major, as returned
+ * by `var_context::vals_r` and `var_context::vals_i`, starting at an
+ * offset that is a multiple of `alignment`, so that they can be read
+ * in place from a memory-mapped file.  All integers and doubles are
+ * little-endian.
+ */
+namespace binary_data {
+
+/**
+ * Magic bytes at the start of every binary data file.
+ */
+constexpr char magic[8] = {'\x89', 'S', 'T', 'A', 'N', 'D', 'A', 'T'};
+
+/**
+ * Version of the binary data format.
+ */
+constexpr std::uint32_t version = 1;
+
+/**
+ * Alignment in bytes of the values of each variable.
+ */
+constexpr std::uint64_t alignment = 64;
+
+constexpr char int_type = 'i';
+constexpr char real_type = 'd';
+
+static_assert(sizeof(int) == sizeof(std::int32_t),
+              "binary data requires 32-bit int");
+
+/**
+ * Return the specified offset rounded up to the alignment.
+ */
+inline std::uint64_t align(std::uint64_t offset) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Throw if the number of values of a variable does not match its
+ * dimensions.
+ */
+inline void check_size(const std::string& name, std::uint64_t expected,
+                       std::uint64_t found) {
+  if (expected != found)
+    throw std::invalid_argument("Error: variable " + name + " has "
+                                + std::to_string(found) + " values but "
+                                + std::to_string(expected)
+                                + " were expected from its dimensions");
+}
+
+/**
+ * Write the variables of a var_context in the binary data format.
+ * Integer variables are written as integers and all other variables
+ * as doubles.  This converts data read by `stan::json::json_data` or
+ * `stan::io::dump` so that it can be memory-mapped by
+ * `stan::io::binary_var_context`.
+ *
+ * @param[in] context variables to write
+ * @param[in, out] out stream, opened in binary mode
+ * @throw std::invalid_argument if the number of values of a variable
+ * does not match its dimensions
+ */
+inline void write_binary_data(const var_context& context, std::ostream& out) {
+  struct variable {
+    std::string name;
+    char type;
+    std::vector<size_t> dims;
+    std::uint64_t size;
+    std::uint64_t offset;
+  };
+  std::vector<variable> variables;
+  std::vector<std::string> names;
+  context.names_i(names);
+  for (const auto& name : names) {
+    if (context.contains_i(name))
+      variables.push_back({name, int_type, context.dims_i(name), 0, 0});
+  }
+  context.names_r(names);
+  for (const auto& name : names) {
+    if (!context.contains_i(name))
+      variables.push_back({name, real_type, context.dims_r(name), 0, 0});
+  }
+
+  std::uint64_t header_size = sizeof(magic) + 2 * sizeof(std::uint32_t)
+                              + sizeof(std::uint64_t);
+  for (const auto& v : variables)
+    header_size += sizeof(std::uint64_t) + v.name.size() + 1
+                   + sizeof(std::uint64_t) * (v.dims.size() + 2);
+  std::uint64_t offset = header_size;
+  for (auto& v : variables) {
+    v.size = 1;
+    for (size_t d : v.dims)
+      v.size *= d;
+    offset = align(offset);
+    v.offset = offset;
+    offset += v.size * (v.type == int_type ? sizeof(std::int32_t)
+                                           : sizeof(double));
+  }
+
+  out.write(magic, sizeof(magic));
+  binary_draws::write_values(out, &version, 1);
+  const std::uint32_t reserved = 0;
+  binary_draws::write_values(out, &reserved, 1);
+  binary_draws::write_uint64(out, variables.size());
+  for (const auto& v : variables) {
+    binary_draws::write_string(out, v.name);
+    out.put(v.type);
+    binary_draws::write_uint64(out, v.dims.size());
+    for (size_t d : v.dims)
+      binary_draws::write_uint64(out, d);
+    binary_draws::write_uint64(out, v.offset);
+  }
+
+  offset = header_size;
+  for (const auto& v : variables) {
+    for (; offset < v.offset; ++offset)
+      out.put('\0');
+    if (v.type == int_type) {
+      var_span<int> values = context.vals_i_span(v.name);
+      check_size(v.name, v.size, values.size());
+      binary_draws::write_values(out, values.data(), values.size());
+      offset += values.size() * sizeof(std::int32_t);
+    } else {
+      var_span<double> values = context.vals_r_span(v.name);
+      check_size(v.name, v.size, values.size());
+      binary_draws::write_values(out, values.data(), values.size());
+      offset += values.size() * sizeof(double);
+    }
+  }
+}
+
+}  // namespace binary_data
+}  // namespace io
+}  // namespace stan
+#endif
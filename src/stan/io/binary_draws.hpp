@@ -0,0 +1,203 @@
+#ifndef STAN_IO_BINARY_DRAWS_HPP
+#define STAN_IO_BINARY_DRAWS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+namespace io {
+
+/**
+ * Layout of the binary draws format written by
+ * `stan::callbacks::binary_writer` and read back by
+ * `stan::io::stan_csv_reader`.
+ *
+ * A file starts with the eight magic bytes followed by a little-endian
+ * `uint32` format version.  The rest of the file is a sequence of
+ * records, each introduced by a one byte tag:
+ *
+ *  - `N`, names: a `uint64` count followed by that many strings.
+ *  - `C`, comment: a single string holding one comment line without
+ *    its comment prefix.  Blank comment lines are empty strings.
+ *  - `D`, draws: a `uint64` number of rows and a `uint64` number of
+ *    columns followed by rows x columns doubles stored column-major.
+ *
+ * Strings are a `uint64` length followed by their bytes.  All
+ * integers and doubles are little-endian.  Records appear in the
+ * order the writer received them, so the file carries the same
+ * information, in the same order, as the CSV output.
+ */
+namespace binary_draws {
+
+/**
+ * Magic bytes at the start of every binary draws file.  The first
+ * byte is not valid text so the format can be told apart from CSV
+ * output by peeking at a single character.
+ */
+constexpr char magic[8] = {'\x89', 'S', 'T', 'A', 'N', 'B', 'I', 'N'};
+
+/**
+ * Version of the binary draws format.
+ */
+constexpr std::uint32_t version = 1;
+
+constexpr char names_record = 'N';
+constexpr char comment_record = 'C';
+constexpr char draws_record = 'D';
+
+/**
+ * Return true if the platform stores multi-byte values little-endian.
+ */
+inline bool is_little_endian() {
+  const std::uint16_t x = 1;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &x, 1);
+  return first_byte == 1;
+}
+
+/**
+ * Reverse the byte order of each of the specified values.
+ *
+ * @tparam T type of values
+ * @param[in, out] x pointer to the first value
+ * @param[in] n number of values
+ */
+template <typename T>
+inline void reverse_bytes(T* x, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    char* bytes = reinterpret_cast<char*>(x + i);
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+}
+
+/**
+ * Write values to the stream in little-endian byte order.
+ *
+ * @tparam T type of values
+ * @param[in, out] out stream, opened in binary mode
+ * @param[in] x pointer to the first value
+ * @param[in] n number of values
+ */
+template <typename T>
+inline void write_values(std::ostream& out, const T* x, std::size_t n) {
+  if (is_little_endian()) {
+    out.write(reinterpret_cast<const char*>(x), n * sizeof(T));
+    return;
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    T y = x[i];
+    reverse_bytes(&y, 1);
+    out.write(reinterpret_cast<const char*>(&y), sizeof(T));
+  }
+}
+
+/**
+ * Read little-endian values from the stream.
+ *
+ * @tparam T type of values
+ * @param[in, out] in stream, opened in binary mode
+ * @param[out] x pointer to storage for the values
+ * @param[in] n number of values
+ * @throw std::invalid_argument if the stream ends early
+ */
+template <typename T>
+inline void read_values(std::istream& in, T* x, std::size_t n) {
+  in.read(reinterpret_cast<char*>(x), n * sizeof(T));
+  if (static_cast<std::size_t>(in.gcount()) != n * sizeof(T))
+    throw std::invalid_argument("Error: unexpected end of binary draws");
+  if (!is_little_endian())
+    reverse_bytes(x, n);
+}
+
+inline void write_uint64(std::ostream& out, std::uint64_t x) {
+  write_values(out, &x, 1);
+}
+
+inline std::uint64_t read_uint64(std::istream& in) {
+  std::uint64_t x;
+  read_values(in, &x, 1);
+  return x;
+}
+
+inline void write_string(std::ostream& out, const std::string& x) {
+  write_uint64(out, x.size());
+  out.write(x.data(), x.size());
+}
+
+/**
+ * Read a string from the stream.
+ *
+ * The length is read from the input, so the string is read in chunks
+ * of bounded size; a corrupt length can't allocate more memory than
+ * the input actually holds.
+ *
+ * @param[in, out] in stream, opened in binary mode
+ * @throw std::domain_error if the length exceeds the remaining input
+ */
+inline std::string read_string(std::istream& in) {
+  constexpr std::uint64_t chunk_size = 65536;
+  const std::uint64_t length = read_uint64(in);
+  std::string x;
+  while (x.size() < length) {
+    const std::size_t offset = x.size();
+    const std::size_t n
+        = std::min<std::uint64_t>(chunk_size, length - offset);
+    x.resize(offset + n);
+    in.read(&x[offset], n);
+    if (static_cast<std::size_t>(in.gcount()) != n)
+      throw std::domain_error("Error: string length " + std::to_string(length)
+                              + " exceeds the remaining binary draws");
+  }
+  return x;
+}
+
+/**
+ * Write the magic bytes and format version.
+ *
+ * @param[in, out] out stream, opened in binary mode
+ */
+inline void write_preamble(std::ostream& out) {
+  out.write(magic, sizeof(magic));
+  write_values(out, &version, 1);
+}
+
+/**
+ * Return true if the stream is positioned at the start of a binary
+ * draws file, without consuming any input.
+ *
+ * @param[in, out] in input stream
+ */
+inline bool at_preamble(std::istream& in) {
+  return in.peek() == static_cast<unsigned char>(magic[0]);
+}
+
+/**
+ * Read and check the magic bytes and format version.
+ *
+ * @param[in, out] in stream, opened in binary mode
+ * @throw std::invalid_argument if the stream does not hold binary
+ * draws of a supported version
+ */
+inline void read_preamble(std::istream& in) {
+  char file_magic[sizeof(magic)];
+  in.read(file_magic, sizeof(magic));
+  if (in.gcount() != sizeof(magic)
+      || !std::equal(file_magic, file_magic + sizeof(magic), magic))
+    throw std::invalid_argument("Error: not a binary Stan output file");
+  std::uint32_t file_version;
+  read_values(in, &file_version, 1);
+  if (file_version != version)
+    throw std::invalid_argument(
+        "Error: unsupported binary Stan output version "
+        + std::to_string(file_version));
+}
+
+}  // namespace binary_draws
+}  // namespace io
+}  // namespace stan
+#endif
@@ -0,0 +1,413 @@
+#ifndef STAN_IO_BINARY_VAR_CONTEXT_HPP
+#define STAN_IO_BINARY_VAR_CONTEXT_HPP
+
+#include <stan/io/binary_data.hpp>
+#include <stan/io/binary_draws.hpp>
+#include <stan/io/validate_dims.hpp>
+#include <stan/io/var_context.hpp>
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace stan {
+namespace io {
+namespace internal {
+
+/**
+ * A read-only view of the contents of a file.  On POSIX systems the
+ * file is memory-mapped, so its pages are loaded on demand and shared
+ * through the page cache by every process reading the same file;
+ * elsewhere the file is read into memory.
+ */
+class mapped_file {
+ public:
+  /**
+   * Map the specified file.
+   *
+   * @param path path of the file
+   * @throw std::invalid_argument if the file cannot be opened or mapped
+   */
+  explicit mapped_file(const std::string& path) : data_(nullptr), size_(0) {
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+      throw std::invalid_argument("Error: cannot open " + path);
+    buffer_.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(&buffer_[0], buffer_.size());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::invalid_argument("Error: cannot open " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::invalid_argument("Error: cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::invalid_argument("Error: cannot map " + path);
+      }
+      data_ = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+#endif
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file() {
+#ifndef _WIN32
+    if (data_)
+      ::munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+};
+
+}  // namespace internal
+
+/**
+ * A <code>binary_var_context</code> reads variables from a file in the
+ * binary data format described in <code>binary_data.hpp</code>.
+ *
+ * <p>The file is memory-mapped and only its header is parsed on
+ * construction.  On little-endian platforms the values are read in
+ * place: the span accessors return views of the mapped file without
+ * copying, which keep the mapping alive for as long as they exist, and
+ * the vector accessors copy only the requested variable.
+ */
+class binary_var_context : public var_context {
+ private:
+  struct variable {
+    char type;
+    std::vector<size_t> dims;
+    const char* data;
+    size_t size;
+    // Keeps the values alive for views that outlive the context
+    std::shared_ptr<const void> owner;
+  };
+
+  std::shared_ptr<const internal::mapped_file> file_;
+  std::map<std::string, variable> vars_;
+
+  /**
+   * Copy bytes from the header at the cursor, advancing it.
+   */
+  void read_header(size_t& cursor, void* x, size_t n) const {
+    if (n > file_->size() - cursor)
+      throw std::invalid_argument("Error: unexpected end of binary data");
+    std::memcpy(x, file_->data() + cursor, n);
+    cursor += n;
+  }
+
+  std::uint64_t read_uint64(size_t& cursor) const {
+    std::uint64_t x;
+    read_header(cursor, &x, sizeof(x));
+    if (!binary_draws::is_little_endian())
+      binary_draws::reverse_bytes(&x, 1);
+    return x;
+  }
+
+  /**
+   * Point the variable at its values in native byte order, converting
+   * them into a buffer of their own on big-endian platforms.
+   */
+  template <typename T>
+  void set_native_values(variable& v, const char* data) const {
+    if (binary_draws::is_little_endian()) {
+      v.data = data;
+      v.owner = file_;
+      return;
+    }
+    auto values = std::make_shared<std::vector<T>>(v.size);
+    std::memcpy(values->data(), data, v.size * sizeof(T));
+    binary_draws::reverse_bytes(values->data(), v.size);
+    v.data = reinterpret_cast<const char*>(values->data());
+    v.owner = values;
+  }
+
+  const variable* find(const std::string& name) const {
+    auto it = vars_.find(name);
+    return it == vars_.end() ? nullptr : &it->second;
+  }
+
+  const double* real_data(const variable& v) const {
+    return reinterpret_cast<const double*>(v.data);
+  }
+
+  const int* int_data(const variable& v) const {
+    return reinterpret_cast<const int*>(v.data);
+  }
+
+ public:
+  /**
+   * Construct a binary_var_context by mapping the specified file.
+   *
+   * @param path path of a file in the binary data format
+   * @throw std::invalid_argument if the file cannot be mapped or is not
+   * a valid binary data file of a supported version
+   */
+  explicit binary_var_context(const std::string& path)
+      : file_(std::make_shared<const internal::mapped_file>(path)) {
+    size_t cursor = 0;
+    char file_magic[sizeof(binary_data::magic)];
+    if (file_->size() < sizeof(file_magic))
+      throw std::invalid_argument("Error: not a binary Stan data file");
+    read_header(cursor, file_magic, sizeof(file_magic));
+    if (!std::equal(file_magic, file_magic + sizeof(file_magic),
+                    binary_data::magic))
+      throw std::invalid_argument("Error: not a binary Stan data file");
+    std::uint32_t file_version[2];
+    read_header(cursor, file_version, sizeof(file_version));
+    if (!binary_draws::is_little_endian())
+      binary_draws::reverse_bytes(file_version, 2);
+    if (file_version[0] != binary_data::version)
+      throw std::invalid_argument("Error: unsupported binary Stan data version "
+                                  + std::to_string(file_version[0]));
+
+    std::uint64_t num_vars = read_uint64(cursor);
+    for (std::uint64_t i = 0; i < num_vars; ++i) {
+      std::uint64_t name_size = read_uint64(cursor);
+      if (name_size > file_->size() - cursor)
+        throw std::invalid_argument("Error: unexpected end of binary data");
+      std::string name(file_->data() + cursor, name_size);
+      cursor += name_size;
+      variable v;
+      read_header(cursor, &v.type, 1);
+      if (v.type != binary_data::int_type && v.type != binary_data::real_type)
+        throw std::invalid_argument("Error: unknown type of variable " + name
+                                    + " in binary data");
+      std::uint64_t num_dims = read_uint64(cursor);
+      if (num_dims > (file_->size() - cursor) / sizeof(std::uint64_t))
+        throw std::invalid_argument("Error: unexpected end of binary data");
+      v.size = 1;
+      for (std::uint64_t d = 0; d < num_dims; ++d) {
+        std::uint64_t dim = read_uint64(cursor);
+        if (dim != 0 && v.size > std::numeric_limits<size_t>::max() / dim)
+          throw std::invalid_argument("Error: size of variable " + name
+                                      + " overflows");
+        v.dims.push_back(dim);
+        v.size *= dim;
+      }
+      std::uint64_t offset = read_uint64(cursor);
+      const size_t value_size = v.type == binary_data::int_type
+                                    ? sizeof(std::int32_t)
+                                    : sizeof(double);
+      if (offset % binary_data::alignment != 0 || offset > file_->size()
+          || (v.size > 0
+              && v.size > (file_->size() - offset) / value_size))
+        throw std::invalid_argument("Error: values of variable " + name
+                                    + " are outside the binary data file");
+      if (v.type == binary_data::int_type)
+        set_native_values<int>(v, file_->data() + offset);
+      else
+        set_native_values<double>(v, file_->data() + offset);
+      vars_[name] = std::move(v);
+    }
+  }
+
+  /**
+   * Return <code>true</code> if the specified variable is defined,
+   * whether its values are integers or doubles.
+   *
+   * @param name Name of variable.
+   * @return <code>true</code> if the variable exists.
+   */
+  bool contains_r(const std::string& name) const { return find(name); }
+
+  /**
+   * Return <code>true</code> if the specified variable has integer
+   * values.
+   *
+   * @param name Name of variable.
+   * @return <code>true</code> if an integer variable exists.
+   */
+  bool contains_i(const std::string& name) const {
+    const variable* v = find(name);
+    return v && v->type == binary_data::int_type;
+  }
+
+  /**
+   * Return a copy of the double values for the variable with the
+   * specified name, converting integer values.
+   *
+   * @param name Name of variable.
+   * @return Values of variable.
+   */
+  std::vector<double> vals_r(const std::string& name) const {
+    const variable* v = find(name);
+    if (!v)
+      return std::vector<double>();
+    if (v->type == binary_data::int_type)
+      return std::vector<double>(int_data(*v), int_data(*v) + v->size);
+    return std::vector<double>(real_data(*v), real_data(*v) + v->size);
+  }
+
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Double values are read in place from the mapped
+   * file; integer values are converted into a buffer owned by the view.
+   *
+   * @param name Name of variable.
+   * @return View of the values of variable.
+   */
+  var_span<double> vals_r_span(const std::string& name) const {
+    const variable* v = find(name);
+    if (v && v->type == binary_data::real_type)
+      return var_span<double>(real_data(*v), v->size, v->owner);
+    return var_context::vals_r_span(name);
+  }
+
+  /**
+   * Return the complex values for the variable with the specified
+   * name, whose last dimension holds the real and imaginary parts.
+   *
+   * @param name Name of variable.
+   * @return Complex values of variable.
+   */
+  std::vector<std::complex<double>> vals_c(const std::string& name) const {
+    const variable* v = find(name);
+    if (!v || v->dims.empty())
+      return std::vector<std::complex<double>>();
+    std::vector<double> vals = vals_r(name);
+    size_t offset = vals.size() / 2;
+    std::vector<std::complex<double>> vals_c(offset);
+    for (size_t i = 0; i < offset; ++i)
+      vals_c[i] = std::complex<double>{vals[i], vals[i + offset]};
+    return vals_c;
+  }
+
+  /**
+   * Return the dimensions for the variable with the specified name.
+   *
+   * @param name Name of variable.
+   * @return Dimensions of variable.
+   */
+  std::vector<size_t> dims_r(const std::string& name) const {
+    const variable* v = find(name);
+    return v ? v->dims : std::vector<size_t>();
+  }
+
+  /**
+   * Return a copy of the integer values for the variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return Values.
+   */
+  std::vector<int> vals_i(const std::string& name) const {
+    if (!contains_i(name))
+      return std::vector<int>();
+    const variable& v = *find(name);
+    return std::vector<int>(int_data(v), int_data(v) + v.size);
+  }
+
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name, read in place from the mapped file.
+   *
+   * @param name Name of variable.
+   * @return View of the values.
+   */
+  var_span<int> vals_i_span(const std::string& name) const {
+    if (!contains_i(name))
+      return var_span<int>();
+    const variable& v = *find(name);
+    return var_span<int>(int_data(v), v.size, v.owner);
+  }
+
+  /**
+   * Return the dimensions for the integer variable with the specified
+   * name.
+   *
+   * @param name Name of variable.
+   * @return Dimensions of variable.
+   */
+  std::vector<size_t> dims_i(const std::string& name) const {
+    return contains_i(name) ? find(name)->dims : std::vector<size_t>();
+  }
+
+  /**
+   * Check variable dimensions against variable declaration.
+   *
+   * @param stage stan program processing stage
+   * @param name variable name
+   * @param base_type declared stan variable type
+   * @param dims_declared variable dimensions
+   * @throw std::runtime_error if mismatch between declared
+   *        dimensions and dimensions found in context.
+   */
+  void validate_dims(const std::string& stage, const std::string& name,
+                     const std::string& base_type,
+                     const std::vector<size_t>& dims_declared) const {
+    size_t num_elts = 1;
+    for (auto& d : dims_declared) {
+      num_elts *= d;
+    }
+    if (num_elts == 0) {
+      return;
+    }
+    stan::io::validate_dims(*this, stage, name, base_type, dims_declared);
+  }
+
+  /**
+   * Return a list of the names of the variables with double values.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  void names_r(std::vector<std::string>& names) const {
+    names.clear();
+    for (const auto& v : vars_) {
+      if (v.second.type == binary_data::real_type)
+        names.push_back(v.first);
+    }
+  }
+
+  /**
+   * Return a list of the names of the variables with integer values.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  void names_i(std::vector<std::string>& names) const {
+    names.clear();
+    for (const auto& v : vars_) {
+      if (v.second.type == binary_data::int_type)
+        names.push_back(v.first);
+    }
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -34,6 +34,11 @@ class chained_var_context : public var_context {
     return vc1_.contains_r(name) ? vc1_.vals_r(name) : vc2_.vals_r(name);
   }
 
+  var_span<double> vals_r_span(const std::string& name) const {
+    return vc1_.contains_r(name) ? vc1_.vals_r_span(name)
+                                 : vc2_.vals_r_span(name);
+  }
+
   std::vector<std::complex<double>> vals_c(const std::string& name) const {
     return vc1_.contains_r(name) ? vc1_.vals_c(name) : vc2_.vals_c(name);
   }
@@ -42,6 +47,11 @@ class chained_var_context : public var_context {
     return vc1_.contains_i(name) ? vc1_.vals_i(name) : vc2_.vals_i(name);
   }
 
+  var_span<int> vals_i_span(const std::string& name) const {
+    return vc1_.contains_i(name) ? vc1_.vals_i_span(name)
+                                 : vc2_.vals_i_span(name);
+  }
+
   std::vector<size_t> dims_r(const std::string& name) const {
     return vc1_.contains_r(name) ? vc1_.dims_r(name) : vc2_.dims_r(name);
   }
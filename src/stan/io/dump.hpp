@@ -684,6 +684,20 @@ class dump : public stan::io::var_context {
     return empty_vec_r_;
   }
 
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Double values are not copied; integer values are
+   * converted into a buffer owned by the view.
+   *
+   * @param name Name of variable.
+   * @return View of the values of variable.
+   */
+  var_span<double> vals_r_span(const std::string& name) const {
+    if (contains_r_only(name))
+      return var_span<double>((vars_r_.find(name)->second).first);
+    return var_context::vals_r_span(name);
+  }
+
   std::vector<std::complex<double>> vals_c(const std::string& name) const {
     const auto val_r = vars_r_.find(name);
     if (val_r != vars_r_.end()) {
@@ -745,6 +759,19 @@ class dump : public stan::io::var_context {
     return empty_vec_i_;
   }
 
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name without copying them.
+   *
+   * @param name Name of variable.
+   * @return View of the values.
+   */
+  var_span<int> vals_i_span(const std::string& name) const {
+    if (contains_i(name))
+      return var_span<int>((vars_i_.find(name)->second).first);
+    return var_span<int>();
+  }
+
   /**
    * Return the dimensions for the integer variable with the specified
    * name.
@@ -120,6 +120,20 @@ class json_data : public stan::io::var_context {
     return empty_vec_r_;
   }
 
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name.  Double values are not copied; integer values are
+   * converted into a buffer owned by the view.
+   *
+   * @param name Name of variable.
+   * @return View of the values of variable.
+   */
+  stan::io::var_span<double> vals_r_span(const std::string &name) const {
+    if (contains_r_only(name))
+      return stan::io::var_span<double>((vars_r_.find(name)->second).first);
+    return stan::io::var_context::vals_r_span(name);
+  }
+
   /**
    * Read out the complex values for the variable with the specified
    * name and return a flat vector of complex values.
@@ -189,6 +203,19 @@ class json_data : public stan::io::var_context {
     return empty_vec_i_;
   }
 
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name without copying them.
+   *
+   * @param name Name of variable.
+   * @return View of the values.
+   */
+  stan::io::var_span<int> vals_i_span(const std::string &name) const {
+    if (contains_i(name))
+      return stan::io::var_span<int>((vars_i_.find(name)->second).first);
+    return stan::io::var_span<int>();
+  }
+
   /**
    * Return the dimensions for the integer variable with the specified
    * name.
@@ -136,6 +136,10 @@ class json_data_handler : public stan::json::json_handler {
   size_t array_start_r;          // index into values_r
   int event;                     // tracks most recent meta_event
   bool not_stan_var;             // accept non-Stan entries
+  bool fast_arrays;              // enables the numeric array fast path
+  bool in_fast_array;            // parsing a top-level numeric array
+  bool fast_is_int;              // fast path array values are all int
+  array_dims fast_dims;          // fast path array dimensions
 
   void reset_values() {
     // Once var values have been copied into var_context maps,
@@ -222,9 +226,16 @@ class json_data_handler : public stan::json::json_handler {
     slot_dims_map[key] = update;
   }
 
+  /* Whether the values of the current slot are all int so far.
+   */
+  bool is_int_slot() {
+    return in_fast_array ? fast_is_int : int_slots_map[key_str()];
+  }
+
   void promote_to_double() {
-    if (int_slots_map[key_str()]) {
-      int_slots_map[key_str()] = false;
+    bool& is_int = in_fast_array ? fast_is_int : int_slots_map[key_str()];
+    if (is_int) {
+      is_int = false;
       values_r.reserve(values_i.size());
       values_r.insert(values_r.end(), values_i.begin(), values_i.end());
       array_start_r = array_start_i;
@@ -245,6 +256,11 @@ class json_data_handler : public stan::json::json_handler {
       key_stack.pop_back();
       return;
     }
+    if (in_fast_array) {
+      save_fast_array();
+      key_stack.pop_back();
+      return;
+    }
     std::string key = key_str();
     if (slot_types_map.count(key) < 1)
       unexpected_error(key, "unknown variable");
@@ -258,15 +274,10 @@ class json_data_handler : public stan::json::json_handler {
       if (slot_dims_map.count(key) == 1)
         dims = slot_dims_map[key].dims;
       if (dims.size() > 1) {
-        if (is_int) {
-          std::vector<int> cm_values_i(values_i.size());
-          to_column_major(key, cm_values_i, values_i, dims);
-          values_i.assign(cm_values_i.begin(), cm_values_i.end());
-        } else {
-          std::vector<double> cm_values_r(values_r.size());
-          to_column_major(key, cm_values_r, values_r, dims);
-          values_r.assign(cm_values_r.begin(), cm_values_r.end());
-        }
+        if (is_int)
+          to_column_major(key, values_i, dims);
+        else
+          to_column_major(key, values_r, dims);
       }
       if (is_new) {
         var_types_map[key] = slot_types_map[key];
@@ -345,6 +356,82 @@ class json_data_handler : public stan::json::json_handler {
     key_stack.pop_back();
   }
 
+  /* Save a top-level array read by the fast path.  Its values are
+   * moved rather than copied into vars_i or vars_r.
+   */
+  void save_fast_array() {
+    const std::string& key = key_stack.back();
+    in_fast_array = false;
+    if (fast_dims.cur_dim != 0)
+      unexpected_error(key, "ill-formed array");
+    slot_dims_map[key] = fast_dims;
+    int_slots_map[key] = fast_is_int;
+    var_types_map[key] = meta_type::ARRAY;
+    if (fast_is_int) {
+      to_column_major(key, values_i, fast_dims.dims);
+      vars_i[key] = var_i(std::move(values_i), fast_dims.dims);
+    } else {
+      to_column_major(key, values_r, fast_dims.dims);
+      vars_r[key] = var_r(std::move(values_r), fast_dims.dims);
+    }
+  }
+
+  /* Hand a top-level array over from the fast path to the general
+   * path, which happens when an array element turns out to be a tuple.
+   */
+  void leave_fast_array() {
+    const std::string& key = key_stack.back();
+    in_fast_array = false;
+    slot_dims_map[key] = fast_dims;
+    int_slots_map[key] = fast_is_int;
+  }
+
+  /* Record the start of an array dimension.
+   */
+  void open_dim(array_dims& dims) {
+    dims.cur_dim++;
+    if (dims.dims.empty() || dims.dims.size() < dims.cur_dim) {
+      dims.dims.push_back(0);
+      dims.dims_acc.push_back(0);
+    }
+    if (dims.cur_dim > 1)
+      dims.dims_acc[dims.cur_dim - 2]++;
+    array_start_i = values_i.size();
+    array_start_r = values_r.size();
+  }
+
+  /* Record the end of an array dimension, setting its size from the
+   * first row and checking that later rows have the same size.
+   */
+  void close_dim(const std::string& key, array_dims& dims, bool is_int,
+                 bool is_last) {
+    int idx = dims.cur_dim - 1;
+    if (is_last && 0 == dims.dims[idx]) {  // innermost row of scalar elts
+      if (is_int)
+        dims.dims[idx] = values_i.size() - array_start_i;
+      else
+        dims.dims[idx] = values_r.size() - array_start_r;
+    } else if (0 == dims.dims[idx]) {  // row of array or tuple elts
+      dims.dims[idx] = dims.dims_acc[idx];
+    } else {
+      bool is_rect = false;
+      if (is_last) {
+        if ((is_int && dims.dims[idx] == values_i.size() - array_start_i)
+            || (!is_int && dims.dims[idx] == values_r.size() - array_start_r))
+          is_rect = true;
+      } else if (dims.dims[idx] == dims.dims_acc[idx]) {
+        is_rect = true;
+      }
+      if (!is_rect) {
+        std::stringstream errorMsg;
+        errorMsg << "Variable: " << key << ", error: non-rectangular array.";
+        throw json_error(errorMsg.str());
+      }
+    }
+    dims.dims_acc[idx] = 0;
+    dims.cur_dim--;
+  }
+
   /* For array of tuples, concatenate dimensions
    * Update vars_i and vars_r dimensions accordingly.
    */
@@ -384,22 +471,43 @@ class json_data_handler : public stan::json::json_handler {
     }
   }
 
+  /* Convert the values of an array from row-major to column-major
+   * order.  Rows are copied with the column-major stride of the last
+   * dimension and the offset of each row is updated incrementally, so
+   * there is no per-element index arithmetic.
+   */
   template <typename T>
-  void to_column_major(std::string vname, std::vector<T>& cm_vals,
-                       const std::vector<T>& rm_vals,
+  void to_column_major(const std::string& vname, std::vector<T>& vals,
                        const std::vector<size_t>& dims) {
     size_t expected_size = 1;
     for (auto& x : dims)
       expected_size *= x;
-    if (expected_size != rm_vals.size()) {
+    if (expected_size != vals.size()) {
       std::stringstream errorMsg;
       errorMsg << "Variable: " << vname << ", error: ill-formed array.";
       throw json_error(errorMsg.str());
     }
-    for (size_t i = 0; i < rm_vals.size(); i++) {
-      size_t idx = convert_offset_rtl_2_ltr(vname, i, dims);
-      cm_vals[idx] = rm_vals[i];
+    if (dims.size() < 2 || vals.empty())
+      return;
+    size_t last = dims.size() - 1;
+    std::vector<size_t> strides(dims.size(), 1);
+    for (size_t k = 1; k < dims.size(); ++k)
+      strides[k] = strides[k - 1] * dims[k - 1];
+    std::vector<size_t> idx(last, 0);
+    std::vector<T> cm_vals(vals.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < vals.size(); i += dims[last]) {
+      for (size_t j = 0; j < dims[last]; ++j)
+        cm_vals[offset + j * strides[last]] = vals[i + j];
+      for (size_t k = last; k-- > 0;) {
+        offset += strides[k];
+        if (++idx[k] < dims[k])
+          break;
+        offset -= strides[k] * dims[k];
+        idx[k] = 0;
+      }
     }
+    vals.swap(cm_vals);
   }
 
   void unexpected_error(const std::string& where, const std::string& what) {
@@ -412,10 +520,18 @@ class json_data_handler : public stan::json::json_handler {
   /**
    * Construct a json_data_handler object.
    *
+   * Top-level arrays of numbers are read by a fast path which tracks
+   * their dimensions without per-value map lookups and moves their
+   * values into the maps.  An array falls back to the general path as
+   * soon as one of its elements is a tuple.
+   *
    * @param a_vars_r name-value map for real-valued variables
    * @param a_vars_i name-value map for int-valued variables
+   * @param a_fast_arrays use the fast path for arrays of numbers; if
+   * false, all values are read by the general path
    */
-  json_data_handler(vars_map_r& a_vars_r, vars_map_i& a_vars_i)
+  json_data_handler(vars_map_r& a_vars_r, vars_map_i& a_vars_i,
+                    bool a_fast_arrays = true)
       : json_handler(),
         vars_r(a_vars_r),
         vars_i(a_vars_i),
@@ -428,7 +544,11 @@ class json_data_handler : public stan::json::json_handler {
         values_r(),
         values_i(),
         array_start_i(0),
-        array_start_r(0) {}
+        array_start_r(0),
+        fast_arrays(a_fast_arrays),
+        in_fast_array(false),
+        fast_is_int(true),
+        fast_dims() {}
 
   /** Clear all maps before parsing next JSON object.
    *  This means that we don't accumulate variable definitions
@@ -444,6 +564,7 @@ class json_data_handler : public stan::json::json_handler {
     int_slots_map.clear();
     reset_values();
     not_stan_var = true;
+    in_fast_array = false;
   }
 
   /** Once all variable definitions have been processed,
@@ -494,6 +615,8 @@ class json_data_handler : public stan::json::json_handler {
    */
   void start_object() {
     event = meta_event::OBJ_OPEN;
+    if (in_fast_array)
+      leave_fast_array();
     if (is_init() || not_stan_var)
       return;
     std::string key = key_str();
@@ -561,6 +684,10 @@ class json_data_handler : public stan::json::json_handler {
     }
     if (not_stan_var)
       return;
+    if (in_fast_array) {
+      open_dim(fast_dims);
+      return;
+    }
     std::string key(key_str());
     if (slot_types_map[key] == meta_type::SCALAR
         && !(values_r.empty() && values_r.empty())) {
@@ -568,6 +695,15 @@ class json_data_handler : public stan::json::json_handler {
       errorMsg << "Variable: " << key << ", error: non-scalar array value.";
       throw json_error(errorMsg.str());
     }
+    if (fast_arrays && key_stack.size() == 1
+        && slot_types_map[key] == meta_type::SCALAR) {
+      slot_types_map[key] = meta_type::ARRAY;
+      in_fast_array = true;
+      fast_is_int = true;
+      fast_dims = array_dims();
+      open_dim(fast_dims);
+      return;
+    }
     if (slot_types_map[key] == meta_type::SCALAR)
       slot_types_map[key] = meta_type::ARRAY;
     else if (slot_types_map[key] == meta_type::TUPLE)
@@ -575,16 +711,8 @@ class json_data_handler : public stan::json::json_handler {
     array_dims dims;
     if (slot_dims_map.count(key) == 1)
       dims = slot_dims_map[key];
-    dims.cur_dim++;
-    if (dims.dims.empty() || dims.dims.size() < dims.cur_dim) {
-      dims.dims.push_back(0);
-      dims.dims_acc.push_back(0);
-    }
-    if (dims.cur_dim > 1)
-      dims.dims_acc[dims.cur_dim - 2]++;
+    open_dim(dims);
     slot_dims_map[key] = dims;
-    array_start_i = values_i.size();
-    array_start_r = values_r.size();
   }
 
   /** An array event ("]") closes the current array dimension.
@@ -596,38 +724,19 @@ class json_data_handler : public stan::json::json_handler {
   void end_array() {
     if (not_stan_var)
       return;
+    if (in_fast_array) {
+      close_dim(key_stack.back(), fast_dims, fast_is_int,
+                fast_dims.cur_dim == fast_dims.dims.size());
+      return;
+    }
     if (slot_dims_map.count(key_str()) == 0)
       unexpected_error(key_str(), "ill-formed array");
     std::string key(key_str());
     array_dims dims = slot_dims_map[key];
-    int idx = dims.cur_dim - 1;
     bool is_int = int_slots_map[key];
     bool is_last = (slot_types_map[key] != meta_type::ARRAY_OF_TUPLES
                     && dims.cur_dim == dims.dims.size());
-    if (is_last && 0 == dims.dims[idx]) {  // innermost row of scalar elts
-      if (is_int)
-        dims.dims[idx] = values_i.size() - array_start_i;
-      else
-        dims.dims[idx] = values_r.size() - array_start_r;
-    } else if (0 == dims.dims[idx]) {  // row of array or tuple elts
-      dims.dims[idx] = dims.dims_acc[idx];
-    } else {
-      bool is_rect = false;
-      if (is_last) {
-        if ((is_int && dims.dims[idx] == values_i.size() - array_start_i)
-            || (!is_int && dims.dims[idx] == values_r.size() - array_start_r))
-          is_rect = true;
-      } else if (dims.dims[idx] == dims.dims_acc[idx]) {
-        is_rect = true;
-      }
-      if (!is_rect) {
-        std::stringstream errorMsg;
-        errorMsg << "Variable: " << key << ", error: non-rectangular array.";
-        throw json_error(errorMsg.str());
-      }
-    }
-    dims.dims_acc[idx] = 0;
-    dims.cur_dim--;
+    close_dim(key, dims, is_int, is_last);
     slot_dims_map[key] = dims;
   }
 
@@ -683,7 +792,7 @@ class json_data_handler : public stan::json::json_handler {
   void number_int(int n) {
     if (not_stan_var)
       return;
-    if (int_slots_map[key_str()]) {
+    if (is_int_slot()) {
       values_i.push_back(n);
     } else {
       values_r.push_back(n);
@@ -696,7 +805,7 @@ class json_data_handler : public stan::json::json_handler {
     // if integer overflow, promote numeric data to double
     if (n > (unsigned)std::numeric_limits<int>::max())
       promote_to_double();
-    if (int_slots_map[key_str()]) {
+    if (is_int_slot()) {
       values_i.push_back(static_cast<int>(n));
     } else {
       values_r.push_back(n);
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace stan {
 namespace json {
@@ -111,7 +112,9 @@ template <typename Handler>
 void rapidjson_parse(std::istream &in, Handler &handler) {
   rapidjson::Reader reader;
   RapidJSONHandler<Handler> filter(handler);
-  rapidjson::IStreamWrapper isw(in);
+  // The default buffer of the stream wrapper holds only four characters.
+  std::vector<char> buffer(1 << 16);
+  rapidjson::IStreamWrapper isw(in, buffer.data(), buffer.size());
   handler.start_text();
   if (!reader.Parse<rapidjson::kParseNanAndInfFlag
                     | rapidjson::kParseValidateEncodingFlag
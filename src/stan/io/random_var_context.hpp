@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -41,21 +42,32 @@ class random_var_context : public var_context {
    */
   template <class Model, class RNG>
   random_var_context(Model& model, RNG& rng, double init_radius, bool init_zero)
-      : unconstrained_params_(model.num_params_r()) {
-    size_t num_unconstrained_ = model.num_params_r();
+      : random_var_context(model, rng,
+                           draw_unconstrained(model, rng, init_radius,
+                                              init_zero)) {}
+
+  /**
+   * Constructs a var_context from unconstrained values that have
+   * already been drawn with <code>draw_unconstrained()</code>.
+   *
+   * Splitting the draws from the construction lets the draws for
+   * several contexts be taken in sequence from one generator while
+   * the contexts themselves, which require transforming the values to
+   * the constrained scale, are constructed concurrently.
+   *
+   * @tparam Model Model class
+   * @tparam RNG Random number generator type
+   * @param[in] model instantiated model to generate variables for
+   * @param[in,out] rng pseudo-random number generator passed to the
+   *   model when transforming the values, which does not draw from it
+   * @param[in] unconstrained values on the unconstrained scale
+   */
+  template <class Model, class RNG>
+  random_var_context(Model& model, RNG& rng, std::vector<double> unconstrained)
+      : unconstrained_params_(std::move(unconstrained)) {
     model.get_param_names(names_, false, false);
     model.get_dims(dims_, false, false);
 
-    if (init_zero) {
-      for (size_t n = 0; n < num_unconstrained_; ++n)
-        unconstrained_params_[n] = 0.0;
-    } else {
-      boost::random::uniform_real_distribution<double> unif(-init_radius,
-                                                            init_radius);
-      for (size_t n = 0; n < num_unconstrained_; ++n)
-        unconstrained_params_[n] = unif(rng);
-    }
-
     std::vector<double> constrained_params;
     std::vector<int> int_params;
     model.write_array(rng, unconstrained_params_, int_params,
@@ -65,8 +77,34 @@ class random_var_context : public var_context {
   }
 
   /**
-   * Destructor.
+   * Return random values on the unconstrained scale for the
+   * parameters of the model, as drawn by the constructor of a
+   * random var_context.
+   *
+   * @tparam Model Model class
+   * @tparam RNG Random number generator type
+   * @param[in] model instantiated model to generate variables for
+   * @param[in,out] rng pseudo-random number generator
+   * @param[in] init_radius the unconstrained variables are uniform draws
+   *   from -init_radius to init_radius.
+   * @param[in] init_zero indicates whether all unconstrained variables
+   *   should be 0, in which case nothing is drawn from the generator.
+   * @return unconstrained values
    */
+  template <class Model, class RNG>
+  static std::vector<double> draw_unconstrained(const Model& model, RNG& rng,
+                                                double init_radius,
+                                                bool init_zero) {
+    std::vector<double> unconstrained(model.num_params_r(), 0.0);
+    if (!init_zero) {
+      boost::random::uniform_real_distribution<double> unif(-init_radius,
+                                                            init_radius);
+      for (size_t n = 0; n < unconstrained.size(); ++n)
+        unconstrained[n] = unif(rng);
+    }
+    return unconstrained;
+  }
+
   ~random_var_context() {}
 
   /**
@@ -98,6 +136,23 @@ class random_var_context : public var_context {
     return vals_r_[loc - names_.begin()];
   }
 
+  /**
+   * Returns a view of the values of the constrained variables without
+   * copying them.
+   *
+   * @param name Name of variable.
+   *
+   * @return the constrained values if the variable is in the
+   *   var_context; an empty view is returned otherwise
+   */
+  var_span<double> vals_r_span(const std::string& name) const {
+    std::vector<std::string>::const_iterator loc
+        = std::find(names_.begin(), names_.end(), name);
+    if (loc == names_.end())
+      return var_span<double>();
+    return var_span<double>(vals_r_[loc - names_.begin()]);
+  }
+
   std::vector<std::complex<double>> vals_c(const std::string& name) const {
     std::vector<std::string>::const_iterator loc
         = std::find(names_.begin(), names_.end(), name);
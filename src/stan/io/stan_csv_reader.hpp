@@ -2,12 +2,24 @@
 #define STAN_IO_STAN_CSV_READER_HPP
 
 #include <boost/algorithm/string.hpp>
+#include <stan/io/binary_draws.hpp>
 #include <stan/math/prim.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <istream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -250,7 +262,7 @@ class stan_csv_reader {
 
     int rows = lines - 3;
     int cols = std::count(line.begin(), line.end(), ',') + 1;
-    adaptation.metric.resize(rows, cols);
+    adaptation.metric.setZero(rows, cols);
     char comment;  // Buffer for comment indicator, #
 
     // parse metric, row by row, element by element
@@ -268,72 +280,185 @@ class stan_csv_reader {
     }
   }
 
-  static bool read_samples(std::istream& in, Eigen::MatrixXd& samples,
-                           stan_csv_timing& timing) {
-    std::stringstream ss;
-    std::string line;
-
-    int rows = 0;
-    int cols = -1;
+  /**
+   * Adds the elapsed time reported on a timing comment line to the
+   * matching field of the timing.  Other lines are ignored.
+   *
+   * @param[in] line comment line, including its comment prefix
+   * @param[in, out] timing timing to update
+   */
+  static void read_timing(const std::string& line, stan_csv_timing& timing) {
+    if (line.find("(Warm-up)") != std::string::npos) {
+      int left = 17;
+      int right = line.find(" seconds");
+      double warmup;
+      std::stringstream(line.substr(left, right - left)) >> warmup;
+      timing.warmup += warmup;
+    } else if (line.find("(Sampling)") != std::string::npos) {
+      int left = 17;
+      int right = line.find(" seconds");
+      double sampling;
+      std::stringstream(line.substr(left, right - left)) >> sampling;
+      timing.sampling += sampling;
+    }
+  }
 
-    if (in.peek() == '#' || in.good() == false)
-      return false;  // need at least one data row
+  /**
+   * Parses the value of a single csv cell.  Surrounding whitespace is
+   * ignored and a cell that does not start with a number is read as
+   * zero.
+   *
+   * @param[in] first start of the cell
+   * @param[in] last end of the cell
+   * @return value of the cell
+   */
+  static double read_value(const char* first, const char* last) {
+    while (first < last && std::isspace(static_cast<unsigned char>(*first)))
+      ++first;
+    while (first < last
+           && std::isspace(static_cast<unsigned char>(*(last - 1))))
+      --last;
+    if (first < last && *first == '+')
+      ++first;
+    double value = 0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc::result_out_of_range)
+      return result.ec == std::errc() ? value : 0;
+#endif
+    // fall back to strtod, which also returns subnormal values
+    std::string cell(first, last);
+    return std::strtod(cell.c_str(), nullptr);
+  }
 
-    while (in.good()) {
-      bool comment_line = (in.peek() == '#');
-      bool empty_line = (in.peek() == '\n');
+  /**
+   * Parses one row of comma separated values.  Values beyond the
+   * specified number of columns are counted but not stored.
+   *
+   * @param[in] first start of the row
+   * @param[in] last end of the row, excluding the newline
+   * @param[out] values storage for the values of the row
+   * @param[in] cols number of values to store
+   * @return number of values in the row
+   */
+  static Eigen::Index read_row(const char* first, const char* last,
+                               double* values, Eigen::Index cols) {
+    Eigen::Index col = 0;
+    while (true) {
+      const char* cell_end = std::find(first, last, ',');
+      if (col < cols)
+        values[col] = read_value(first, cell_end);
+      ++col;
+      if (cell_end == last)
+        return col;
+      first = cell_end + 1;
+    }
+  }
 
-      std::getline(in, line);
-      if (empty_line)
-        continue;
-      if (!line.length())
-        break;
-
-      if (comment_line) {
-        if (line.find("(Warm-up)") != std::string::npos) {
-          int left = 17;
-          int right = line.find(" seconds");
-          double warmup;
-          std::stringstream(line.substr(left, right - left)) >> warmup;
-          timing.warmup += warmup;
-        } else if (line.find("(Sampling)") != std::string::npos) {
-          int left = 17;
-          int right = line.find(" seconds");
-          double sampling;
-          std::stringstream(line.substr(left, right - left)) >> sampling;
-          timing.sampling += sampling;
-        }
-      } else {
-        ss << line << '\n';
-        int current_cols = std::count(line.begin(), line.end(), ',') + 1;
-        if (cols == -1) {
-          cols = current_cols;
-        } else if (cols != current_cols) {
-          std::stringstream msg;
-          msg << "Error: expected " << cols << " columns, but found "
-              << current_cols << " instead for row " << rows + 1;
-          throw std::invalid_argument(msg.str());
-        }
-        rows++;
+  /**
+   * Reads the remaining contents of the stream in one pass.
+   *
+   * @param[in, out] in input stream
+   * @return remaining contents of the stream
+   */
+  static std::string read_remaining(std::istream& in) {
+    std::string buffer;
+    std::istream::pos_type start = in.tellg();
+    if (start != std::istream::pos_type(-1)) {
+      in.seekg(0, std::ios_base::end);
+      std::istream::pos_type end = in.tellg();
+      in.seekg(start);
+      if (end != std::istream::pos_type(-1) && in.good()) {
+        buffer.resize(static_cast<std::size_t>(end - start));
+        in.read(&buffer[0], buffer.size());
+        buffer.resize(in.gcount());
+        in.peek();
+        return buffer;
       }
-
-      in.peek();
+      in.clear();
     }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  }
 
-    ss.seekg(std::ios_base::beg);
+  /**
+   * Reads the draws, and the timing reported in comments among them,
+   * from the rest of the stream.
+   *
+   * The stream is read into memory in one pass and split into lines.
+   * The data rows are then parsed in parallel, stopping at the first
+   * row with the wrong number of values.
+   *
+   * @param[in, out] in input stream
+   * @param[out] samples draws, one row per data line
+   * @param[in, out] timing timing to which elapsed times are added
+   * @return false if the stream does not start with a data row
+   * @throw std::invalid_argument if the rows have differing numbers
+   * of values
+   */
+  static bool read_samples(std::istream& in, Eigen::MatrixXd& samples,
+                           stan_csv_timing& timing) {
+    if (in.peek() == '#' || in.good() == false)
+      return false;  // need at least one data row
 
-    if (rows > 0) {
-      samples.resize(rows, cols);
-      for (int row = 0; row < rows; row++) {
-        std::getline(ss, line);
-        std::stringstream ls(line);
-        for (int col = 0; col < cols; col++) {
-          std::getline(ls, line, ',');
-          boost::trim(line);
-          std::stringstream(line) >> samples(row, col);
-        }
+    const std::string buffer = read_remaining(in);
+    const char* end = buffer.data() + buffer.size();
+
+    // Start and end of each data row
+    std::vector<std::pair<const char*, const char*>> rows;
+    for (const char* line = buffer.data(); line < end;) {
+      const char* line_end
+          = static_cast<const char*>(std::memchr(line, '\n', end - line));
+      if (line_end == nullptr)
+        line_end = end;
+      if (line != line_end) {
+        if (*line == '#')
+          read_timing(std::string(line, line_end), timing);
+        else
+          rows.emplace_back(line, line_end);
       }
+      line = line_end + 1;
+    }
+
+    if (rows.empty())
+      return true;
+
+    const Eigen::Index cols
+        = std::count(rows[0].first, rows[0].second, ',') + 1;
+    // Each task fills whole rows of a row-major buffer, so tasks never
+    // write to the same cache line; the buffer is transposed once.
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        values(rows.size(), cols);
+    std::atomic<std::size_t> bad_row{rows.size()};
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, rows.size(), 256),
+        [&](const tbb::blocked_range<std::size_t>& r) {
+          for (std::size_t row = r.begin(); row < r.end(); ++row) {
+            if (row >= bad_row.load(std::memory_order_relaxed))
+              return;
+            if (read_row(rows[row].first, rows[row].second,
+                         values.row(row).data(), cols)
+                != cols) {
+              // keep the first bad row, whichever task finds it
+              std::size_t first = bad_row.load();
+              while (row < first
+                     && !bad_row.compare_exchange_weak(first, row)) {
+              }
+              return;
+            }
+          }
+        });
+
+    if (bad_row < rows.size()) {
+      std::stringstream msg;
+      const auto& row = rows[bad_row];
+      msg << "Error: expected " << cols << " columns, but found "
+          << std::count(row.first, row.second, ',') + 1 << " instead for row "
+          << bad_row + 1;
+      throw std::invalid_argument(msg.str());
     }
+    samples = values;
     return true;
   }
 
@@ -348,6 +473,9 @@ class stan_csv_reader {
    * @param[out] out output stream to send messages
    */
   static stan_csv parse(std::istream& in, std::ostream* out) {
+    if (binary_draws::at_preamble(in))
+      return parse_binary(in, out);
+
     stan_csv data;
     std::string line;
 
@@ -381,6 +509,178 @@ class stan_csv_reader {
     }
     return data;
   }
+
+  /**
+   * Parses output written by `stan::callbacks::binary_writer`.
+   *
+   * Comments are interpreted exactly as the corresponding lines of a
+   * csv file, so the metadata, adaptation and timing match those
+   * parsed from the csv output of the same run.  The records are
+   * scanned first, skipping over the draws, so the samples can be
+   * allocated once and the draws read straight into them.  Input that
+   * can't seek is buffered before parsing.
+   *
+   * Throws exception if contents can't be parsed into header + data rows.
+   *
+   * @param[in] in input stream to parse, opened in binary mode
+   * @param[out] out output stream to send messages
+   * @throw std::domain_error if a count or length read from the input
+   * exceeds the remaining input
+   */
+  static stan_csv parse_binary(std::istream& in, std::ostream* out) {
+    const std::streampos start = in.tellg();
+    if (start == std::streampos(-1)) {
+      std::stringstream buffer(std::ios_base::in | std::ios_base::out
+                               | std::ios_base::binary);
+      buffer << in.rdbuf();
+      return parse_binary(buffer, out);
+    }
+    in.seekg(0, std::ios_base::end);
+    const std::streampos end = in.tellg();
+    in.seekg(start);
+    auto remaining = [&in, &end]() -> std::uint64_t {
+      return end - in.tellg();
+    };
+
+    stan_csv data;
+    binary_draws::read_preamble(in);
+
+    // comment lines before the header hold the metadata
+    std::stringstream metadata_ss;
+    bool has_header = false;
+    // comments and draws after the header, in the order written
+    struct draws_block {
+      std::streampos pos;
+      Eigen::Index rows;
+      Eigen::Index cols;
+    };
+    std::vector<std::string> comments;
+    std::vector<draws_block> blocks;
+    std::vector<bool> is_comment;
+    int tag;
+    while ((tag = in.get()) != std::char_traits<char>::eof()) {
+      if (tag == binary_draws::comment_record) {
+        std::string comment = binary_draws::read_string(in);
+        if (has_header) {
+          comments.push_back(std::move(comment));
+          is_comment.push_back(true);
+        } else {
+          metadata_ss << "# " << comment << '\n';
+        }
+      } else if (tag == binary_draws::names_record) {
+        std::uint64_t size = binary_draws::read_uint64(in);
+        // every name takes at least its length
+        if (size > remaining() / sizeof(std::uint64_t))
+          throw std::domain_error("Error: number of names "
+                                  + std::to_string(size)
+                                  + " exceeds the remaining binary draws");
+        std::vector<std::string> names(size);
+        for (auto& name : names) {
+          name = binary_draws::read_string(in);
+          prettify_stan_csv_name(name);
+        }
+        if (!has_header) {
+          data.header = std::move(names);
+          has_header = true;
+        }
+      } else if (tag == binary_draws::draws_record) {
+        std::uint64_t rows = binary_draws::read_uint64(in);
+        std::uint64_t cols = binary_draws::read_uint64(in);
+        std::uint64_t values = remaining() / sizeof(double);
+        if (cols > 0 && rows > values / cols)
+          throw std::domain_error(
+              "Error: draws block of " + std::to_string(rows) + " x "
+              + std::to_string(cols) + " exceeds the remaining binary draws");
+        if (has_header) {
+          blocks.push_back({in.tellg(), static_cast<Eigen::Index>(rows),
+                            static_cast<Eigen::Index>(cols)});
+          is_comment.push_back(false);
+        }
+        in.seekg(rows * cols * sizeof(double), std::ios_base::cur);
+      } else {
+        throw std::invalid_argument(
+            "Error: unrecognized record in binary Stan output file");
+      }
+    }
+
+    read_metadata(metadata_ss, data.metadata);
+    if (!has_header) {
+      throw std::invalid_argument("Error: no column names found in csv file");
+    }
+
+    std::size_t item = 0;
+    std::size_t comment = 0;
+    std::size_t block = 0;
+
+    // skip warmup draws, if any
+    if (data.metadata.algorithm != "fixed_param" && data.metadata.num_warmup > 0
+        && data.metadata.save_warmup) {
+      for (; item < is_comment.size() && !is_comment[item]; ++item)
+        ++block;
+    }
+
+    if (data.metadata.algorithm != "fixed_param") {
+      std::stringstream adaptation_ss;
+      for (; item < is_comment.size() && is_comment[item]; ++item)
+        adaptation_ss << "# " << comments[comment++] << '\n';
+      read_adaptation(adaptation_ss, data.adaptation);
+    }
+
+    data.timing.warmup = 0;
+    data.timing.sampling = 0;
+
+    // discard variational estimate
+    Eigen::Index skip_rows = data.metadata.method == "variational" ? 1 : 0;
+
+    Eigen::Index cols = -1;
+    Eigen::Index rows = 0;
+    std::vector<std::pair<std::size_t, Eigen::Index>> sample_blocks;
+    for (; item < is_comment.size(); ++item) {
+      if (is_comment[item]) {
+        read_timing("# " + comments[comment++], data.timing);
+        continue;
+      }
+      const draws_block& draws = blocks[block];
+      Eigen::Index skip = std::min(skip_rows, draws.rows);
+      skip_rows -= skip;
+      if (draws.rows > skip) {
+        if (cols == -1) {
+          cols = draws.cols;
+        } else if (cols != draws.cols) {
+          std::stringstream msg;
+          msg << "Error: expected " << cols << " columns, but found "
+              << draws.cols << " instead for row " << rows + 1;
+          throw std::invalid_argument(msg.str());
+        }
+        sample_blocks.emplace_back(block, skip);
+        rows += draws.rows - skip;
+      }
+      ++block;
+    }
+
+    if (rows == 0) {
+      if (out)
+        *out << "No draws found" << std::endl;
+      return data;
+    }
+    data.samples.resize(rows, cols);
+    in.clear();
+    Eigen::Index row = 0;
+    for (const auto& sample_block : sample_blocks) {
+      const draws_block& draws = blocks[sample_block.first];
+      Eigen::Index skip = sample_block.second;
+      Eigen::Index block_rows = draws.rows - skip;
+      // both are column-major, so each column of the block is read
+      // into its place in the samples
+      in.seekg(draws.pos);
+      for (Eigen::Index j = 0; j < cols; ++j) {
+        in.ignore(skip * sizeof(double));
+        binary_draws::read_values(in, &data.samples(row, j), block_rows);
+      }
+      row += block_rows;
+    }
+    return data;
+  }
 };
 
 }  // namespace io
@@ -1,6 +1,7 @@
 #ifndef STAN_IO_VAR_CONTEXT_HPP
 #define STAN_IO_VAR_CONTEXT_HPP
 
+#include <stan/io/var_span.hpp>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -56,6 +57,23 @@ class var_context {
    */
   virtual std::vector<double> vals_r(const std::string& name) const = 0;
 
+  /**
+   * Return a read-only view of the floating point values for the
+   * variable of the specified name in last-index-major order, with
+   * integers cast to floating point values as by <code>vals_r</code>.
+   *
+   * <p>Contexts that store the values contiguously should override
+   * this method to return a view of their storage without copying it.
+   * The default implementation returns a view owning the result of
+   * <code>vals_r</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the values for the named variable.
+   */
+  virtual var_span<double> vals_r_span(const std::string& name) const {
+    return var_span<double>(vals_r(name));
+  }
+
   /**
    * Return the complex floating point values for the variable of the
    * specified variable name in last-index-major order.  This
@@ -101,6 +119,23 @@ class var_context {
    */
   virtual std::vector<int> vals_i(const std::string& name) const = 0;
 
+  /**
+   * Return a read-only view of the integer values for the variable of
+   * the specified name in last-index-major order, or an empty view if
+   * the variable is not defined.
+   *
+   * <p>Contexts that store the values contiguously should override
+   * this method to return a view of their storage without copying it.
+   * The default implementation returns a view owning the result of
+   * <code>vals_i</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the integer values.
+   */
+  virtual var_span<int> vals_i_span(const std::string& name) const {
+    return var_span<int>(vals_i(name));
+  }
+
   /**
    * Return the dimensions of the specified floating point variable.
    * If the variable doesn't exist (or if it is a scalar), the
@@ -0,0 +1,108 @@
+#ifndef STAN_IO_VAR_SPAN_HPP
+#define STAN_IO_VAR_SPAN_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * A <code>var_span</code> is a read-only view of the values of a
+ * variable in a <code>var_context</code>, given by a pointer to the
+ * first value and the number of values.
+ *
+ * <p>A span either refers to storage owned by the context, in which
+ * case it is valid only as long as the context is alive and the
+ * variable is not modified or removed, or it shares ownership of an
+ * immutable buffer, in which case it remains valid for as long as any
+ * copy of it exists.  Copying a span never copies the values.
+ *
+ * @tparam T type of values
+ */
+template <typename T>
+class var_span {
+ public:
+  using value_type = T;
+  using const_iterator = const T*;
+
+  /**
+   * Construct an empty span.
+   */
+  var_span() : data_(nullptr), size_(0) {}
+
+  /**
+   * Construct a span referring to values owned by someone else.
+   *
+   * @param data pointer to the first value
+   * @param size number of values
+   */
+  var_span(const T* data, size_t size) : data_(data), size_(size) {}
+
+  /**
+   * Construct a span referring to the values of a vector owned by
+   * someone else.
+   *
+   * @param values values
+   */
+  explicit var_span(const std::vector<T>& values)
+      : data_(values.data()), size_(values.size()) {}
+
+  /**
+   * Construct a span referring to values kept alive by the specified
+   * owner, which may be any object holding the storage.
+   *
+   * @param data pointer to the first value
+   * @param size number of values
+   * @param owner shared owner of the storage
+   */
+  var_span(const T* data, size_t size, std::shared_ptr<const void> owner)
+      : data_(data), size_(size), owner_(std::move(owner)) {}
+
+  /**
+   * Construct a span sharing ownership of an immutable buffer.
+   *
+   * @param values buffer of values
+   */
+  explicit var_span(std::shared_ptr<const std::vector<T>> values)
+      : data_(values ? values->data() : nullptr),
+        size_(values ? values->size() : 0),
+        owner_(std::move(values)) {}
+
+  /**
+   * Construct a span owning the specified values.
+   *
+   * @param values values, which are moved into a shared buffer
+   */
+  explicit var_span(std::vector<T>&& values)
+      : var_span(
+          std::make_shared<const std::vector<T>>(std::move(values))) {}
+
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const T& operator[](size_t i) const { return data_[i]; }
+
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  /**
+   * Return a copy of the values as a vector.
+   *
+   * @return values
+   */
+  std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+ private:
+  const T* data_;
+  size_t size_;
+  std::shared_ptr<const void> owner_;
+};
+
+}  // namespace io
+}  // namespace stan
+
+#endif
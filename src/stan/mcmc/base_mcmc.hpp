@@ -2,6 +2,7 @@
 #define STAN_MCMC_BASE_MCMC_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <ostream>
@@ -29,6 +30,21 @@ class base_mcmc {
       std::vector<std::string>& model_names, std::vector<std::string>& names) {}
 
   virtual void get_sampler_diagnostics(std::vector<double>& values) {}
+
+  /**
+   * Start measuring the work done by each transition for
+   * <code>collect_telemetry</code>, discarding earlier measurements.
+   */
+  virtual void enable_telemetry() {}
+
+  /**
+   * Fill in the sampler's measurements of the work done since the last
+   * call, such as gradient evaluations and tree depth, and restart
+   * them.
+   *
+   * @param[in,out] stats measurements of the current transition
+   */
+  virtual void collect_telemetry(callbacks::transition_stats& stats) {}
 };
 
 }  // namespace mcmc
@@ -8,13 +8,18 @@
 #include <stan/analyze/mcmc/split_rank_normalized_ess.hpp>
 #include <stan/analyze/mcmc/split_rank_normalized_rhat.hpp>
 #include <stan/analyze/mcmc/mcse.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include <cstdlib>
@@ -36,7 +41,37 @@ class chainset {
   std::vector<std::string> param_names_;
   std::vector<Eigen::MatrixXd> chains_;
 
+  /**
+   * Per-thread scratch space used by <code>summary</code>.
+   */
+  struct summary_workspace {
+    Eigen::MatrixXd draws;
+    Eigen::MatrixXd bulk_ranks;
+    std::vector<Eigen::Index> rank_order;
+    analyze::autocovariance_workspace acov;
+  };
+
  public:
+  /**
+   * Summary statistics for a single parameter, as computed by
+   * <code>summary</code>.  Each member holds the value returned by the
+   * corresponding per-statistic method, except that order statistics of
+   * draws which contain NaN are NaN instead of throwing.
+   */
+  struct param_summary {
+    double mean;
+    double sd;
+    double mcse_mean;
+    double mcse_sd;
+    double median;
+    double max_abs_deviation;
+    Eigen::VectorXd quantiles;
+    double ess_bulk;
+    double ess_tail;
+    double rhat_bulk;
+    double rhat_tail;
+  };
+
   /* Construct a chainset from a single sample.
    * Throws execption if sample is empty.
    */
@@ -447,6 +482,45 @@ class chainset {
    */
   double mcse_sd(const std::string& name) const { return mcse_sd(index(name)); }
 
+  /**
+   * Compute the summary statistics of every parameter in one pass.
+   *
+   * Parameters are summarized in parallel using the TBB thread pool.
+   * Each thread reuses one draws buffer and one autocovariance
+   * workspace, holding the FFT engine and its buffers, across the
+   * parameters it processes, and the split chains and their rank
+   * transform are computed once per parameter and shared between the
+   * Rhat and ESS computations.  The results equal those of the
+   * per-statistic methods.
+   *
+   * @param probs vector of probabilities for the quantiles
+   * @return summary statistics, one entry per parameter in column order
+   */
+  std::vector<param_summary> summary(const Eigen::VectorXd& probs) const {
+    std::vector<param_summary> result(num_params());
+    std::vector<double> probs_vec(probs.data(), probs.data() + probs.size());
+    tbb::enumerable_thread_specific<summary_workspace> workspaces;
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_params()),
+                      [&](const tbb::blocked_range<int>& r) {
+                        summary_workspace& ws = workspaces.local();
+                        for (int index = r.begin(); index < r.end(); ++index)
+                          summarize(index, probs_vec, ws, result[index]);
+                      });
+    return result;
+  }
+
+  /**
+   * Compute the summary statistics of every parameter in one pass,
+   * reporting the 5%, 50%, and 95% quantiles.
+   *
+   * @return summary statistics, one entry per parameter in column order
+   */
+  std::vector<param_summary> summary() const {
+    Eigen::VectorXd probs(3);
+    probs << 0.05, 0.5, 0.95;
+    return summary(probs);
+  }
+
   /**
    * Compute autocorrelation for one column of one chain.
    * Throws exception if column index is out of bounds.
@@ -478,6 +552,68 @@ class chainset {
                                   const std::string name) const {
     return autocorrelation(chain, index(name));
   }
+
+ private:
+  /**
+   * Compute the summary statistics of one parameter using the
+   * specified workspace.
+   *
+   * @param[in] index parameter index
+   * @param[in] probs vector of probabilities for the quantiles
+   * @param[in, out] ws workspace
+   * @param[out] stats summary statistics
+   */
+  void summarize(int index, const std::vector<double>& probs,
+                 summary_workspace& ws, param_summary& stats) const {
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    Eigen::MatrixXd& draws = ws.draws;
+    draws.resize(num_samples_, chains_.size());
+    for (size_t i = 0; i < chains_.size(); ++i) {
+      draws.col(i) = chains_[i].col(index);
+    }
+
+    stats.mean = draws.mean();
+    stats.sd = std::sqrt((draws.array() - stats.mean).square().sum()
+                         / (draws.size() - 1));
+    stats.mcse_mean = analyze::mcse_mean(draws, ws.acov);
+    stats.mcse_sd = analyze::mcse_sd(draws, ws.acov);
+
+    Eigen::Map<Eigen::VectorXd> map(draws.data(), draws.size());
+    if (map.array().isNaN().any()) {
+      stats.median = nan;
+      stats.max_abs_deviation = nan;
+      stats.quantiles = Eigen::VectorXd::Constant(probs.size(), nan);
+    } else {
+      stats.median = stan::math::quantile(map, 0.5);
+      Eigen::VectorXd abs_dev = (map.array() - stats.median).abs();
+      stats.max_abs_deviation = 1.4826 * stan::math::quantile(abs_dev, 0.5);
+      if (probs.empty()) {
+        stats.quantiles = Eigen::VectorXd::Zero(0);
+      } else {
+        std::vector<double> quantiles = stan::math::quantile(map, probs);
+        stats.quantiles = Eigen::Map<Eigen::VectorXd>(quantiles.data(),
+                                                      quantiles.size());
+      }
+    }
+
+    Eigen::MatrixXd split_draws = analyze::split_chains(draws);
+    if (!analyze::is_finite_and_varies(split_draws)) {
+      stats.rhat_bulk = stats.rhat_tail = nan;
+      stats.ess_bulk = stats.ess_tail = nan;
+      return;
+    }
+    Eigen::MatrixXd& bulk_ranks = ws.bulk_ranks;
+    analyze::rank_transform(split_draws, bulk_ranks, ws.rank_order);
+    std::tie(stats.rhat_bulk, stats.rhat_tail)
+        = analyze::split_rank_normalized_rhat(split_draws, bulk_ranks);
+    if (split_draws.rows() < 4) {
+      stats.ess_bulk = stats.ess_tail = nan;
+    } else {
+      std::tie(stats.ess_bulk, stats.ess_tail)
+          = analyze::split_rank_normalized_ess(split_draws, bulk_ranks,
+                                               ws.acov);
+    }
+  }
 };
 
 }  // namespace mcmc
@@ -0,0 +1,200 @@
+#ifndef STAN_MCMC_CONVERGENCE_MONITOR_HPP
+#define STAN_MCMC_CONVERGENCE_MONITOR_HPP
+
+#include <stan/analyze/mcmc/autocovariance.hpp>
+#include <stan/analyze/mcmc/check_chains.hpp>
+#include <stan/analyze/mcmc/rank_normalization.hpp>
+#include <stan/analyze/mcmc/split_chains.hpp>
+#include <stan/analyze/mcmc/split_rank_normalized_ess.hpp>
+#include <stan/analyze/mcmc/split_rank_normalized_rhat.hpp>
+#include <stan/math/prim.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace mcmc {
+
+/**
+ * A <code>convergence_monitor</code> collects the draws of several
+ * chains as they are generated and computes the split rank-normalized
+ * Rhat and ESS of each monitored quantity across the chains, so that a
+ * run can stop once its draws are good enough.
+ *
+ * <p>Each chain appends to its own buffer, so chains running in
+ * parallel may add draws concurrently.  Diagnostics use the draws that
+ * every chain has produced and must not be computed while draws are
+ * being added.
+ */
+class convergence_monitor {
+ private:
+  size_t num_params_;
+  std::vector<std::vector<double>> draws_;
+
+  /**
+   * Per-thread scratch space used by <code>diagnostics</code>.
+   */
+  struct workspace {
+    Eigen::MatrixXd draws;
+    Eigen::MatrixXd bulk_ranks;
+    std::vector<Eigen::Index> rank_order;
+    analyze::autocovariance_workspace acov;
+  };
+
+ public:
+  /**
+   * Convergence diagnostics of a single monitored quantity.  Each
+   * value is NaN when the draws are not finite, are constant, or are
+   * too few to compute it.
+   */
+  struct param_diagnostics {
+    double rhat_bulk;
+    double rhat_tail;
+    double ess_bulk;
+    double ess_tail;
+  };
+
+  /**
+   * Worst diagnostics over all monitored quantities.  Each value is NaN
+   * if it is NaN for any quantity.
+   */
+  struct summary {
+    double max_rhat;
+    double min_ess_bulk;
+    double min_ess_tail;
+  };
+
+  /**
+   * Construct a monitor for the specified number of chains, each of
+   * which produces draws of the specified number of quantities.
+   *
+   * @param num_chains number of chains
+   * @param num_params number of monitored quantities
+   */
+  convergence_monitor(size_t num_chains, size_t num_params)
+      : num_params_(num_params), draws_(num_chains) {}
+
+  size_t num_chains() const { return draws_.size(); }
+
+  size_t num_params() const { return num_params_; }
+
+  /**
+   * Return the number of draws that every chain has produced.
+   */
+  size_t num_draws() const {
+    if (draws_.empty() || num_params_ == 0)
+      return 0;
+    size_t n = std::numeric_limits<size_t>::max();
+    for (const auto& chain : draws_)
+      n = std::min(n, chain.size() / num_params_);
+    return n;
+  }
+
+  /**
+   * Append a draw to the specified chain.
+   *
+   * @param chain chain index
+   * @param draw values of the monitored quantities
+   */
+  template <typename Derived>
+  void add_draw(size_t chain, const Eigen::MatrixBase<Derived>& draw) {
+    std::vector<double>& buffer = draws_[chain];
+    for (Eigen::Index i = 0; i < draw.size(); ++i)
+      buffer.push_back(draw(i));
+  }
+
+  /**
+   * Discard the draws of every chain.
+   */
+  void clear() {
+    for (auto& chain : draws_)
+      chain.clear();
+  }
+
+  /**
+   * Compute the diagnostics of each monitored quantity from the draws
+   * from the specified draw on, in parallel over the quantities.
+   *
+   * @param first index of the first draw of each chain to use
+   * @return diagnostics, one entry per monitored quantity
+   */
+  std::vector<param_diagnostics> diagnostics(size_t first = 0) const {
+    std::vector<param_diagnostics> result(num_params_);
+    const size_t last = num_draws();
+    first = std::min(first, last);
+    tbb::enumerable_thread_specific<workspace> workspaces;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_params_),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        workspace& ws = workspaces.local();
+                        for (size_t index = r.begin(); index < r.end();
+                             ++index)
+                          diagnose(index, first, last, ws, result[index]);
+                      });
+    return result;
+  }
+
+  /**
+   * Return the worst of the specified diagnostics.
+   *
+   * @param diagnostics diagnostics of each monitored quantity
+   * @return largest Rhat and smallest bulk and tail ESS
+   */
+  static summary summarize(const std::vector<param_diagnostics>& diagnostics) {
+    summary worst{0, std::numeric_limits<double>::infinity(),
+                  std::numeric_limits<double>::infinity()};
+    for (const param_diagnostics& d : diagnostics) {
+      worst.max_rhat = max_or_nan(worst.max_rhat, d.rhat_bulk);
+      worst.max_rhat = max_or_nan(worst.max_rhat, d.rhat_tail);
+      worst.min_ess_bulk = -max_or_nan(-worst.min_ess_bulk, -d.ess_bulk);
+      worst.min_ess_tail = -max_or_nan(-worst.min_ess_tail, -d.ess_tail);
+    }
+    return worst;
+  }
+
+ private:
+  static double max_or_nan(double a, double b) {
+    return std::isnan(a) || std::isnan(b)
+               ? std::numeric_limits<double>::quiet_NaN()
+               : std::max(a, b);
+  }
+
+  void diagnose(size_t index, size_t first, size_t last, workspace& ws,
+                param_diagnostics& stats) const {
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    stats.rhat_bulk = stats.rhat_tail = nan;
+    stats.ess_bulk = stats.ess_tail = nan;
+
+    Eigen::MatrixXd& draws = ws.draws;
+    draws.resize(last - first, draws_.size());
+    for (size_t chain = 0; chain < draws_.size(); ++chain) {
+      const double* values = draws_[chain].data() + index;
+      for (size_t n = first; n < last; ++n)
+        draws(n - first, chain) = values[n * num_params_];
+    }
+    if (draws.rows() < 2)
+      return;
+
+    Eigen::MatrixXd split_draws = analyze::split_chains(draws);
+    if (!analyze::is_finite_and_varies(split_draws))
+      return;
+    Eigen::MatrixXd& bulk_ranks = ws.bulk_ranks;
+    analyze::rank_transform(split_draws, bulk_ranks, ws.rank_order);
+    std::tie(stats.rhat_bulk, stats.rhat_tail)
+        = analyze::split_rank_normalized_rhat(split_draws, bulk_ranks);
+    if (split_draws.rows() >= 4) {
+      std::tie(stats.ess_bulk, stats.ess_tail)
+          = analyze::split_rank_normalized_ess(split_draws, bulk_ranks,
+                                               ws.acov);
+    }
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+
+#endif
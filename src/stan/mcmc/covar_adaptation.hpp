@@ -12,7 +12,7 @@ namespace mcmc {
 class covar_adaptation : public windowed_adaptation {
  public:
   explicit covar_adaptation(int n)
-      : windowed_adaptation("covariance"), estimator_(n) {}
+      : windowed_adaptation("covariance"), estimator_(n), pooled_(false) {}
 
   bool learn_covariance(Eigen::MatrixXd& covar, const Eigen::VectorXd& q) {
     if (adaptation_window())
@@ -20,25 +20,14 @@ class covar_adaptation : public windowed_adaptation {
 
     if (end_adaptation_window()) {
       compute_next_window();
+      ++adapt_window_counter_;
 
-      estimator_.sample_covariance(covar);
-
-      double n = static_cast<double>(estimator_.num_samples());
-      covar = (n / (n + 5.0)) * covar
-              + 1e-3 * (5.0 / (n + 5.0))
-                    * Eigen::MatrixXd::Identity(covar.rows(), covar.cols());
-
-      if (!covar.allFinite())
-        throw std::runtime_error(
-            "Numerical overflow in metric adaptation. "
-            "This occurs when the sampler encounters extreme values on the "
-            "unconstrained space; this may happen when the posterior density "
-            "function is too wide or improper. "
-            "There may be problems with your model specification.");
+      if (pooled_)
+        return false;
 
+      estimator_.sample_covariance(covar);
+      regularize(covar, estimator_.num_samples());
       estimator_.restart();
-
-      ++adapt_window_counter_;
       return true;
     }
 
@@ -46,8 +35,78 @@ class covar_adaptation : public windowed_adaptation {
     return false;
   }
 
+  /**
+   * Set whether the covariance estimate is pooled across adaptations.
+   * A pooled adaptation keeps its samples at the end of each adaptation
+   * window and leaves the covariance untouched, so that the samples of
+   * several chains can be combined with <code>pool_covariance</code>.
+   *
+   * @param pooled true to pool the covariance estimate
+   */
+  void set_pooled(bool pooled) { pooled_ = pooled; }
+
+  bool pooled() const { return pooled_; }
+
+  /**
+   * Compute the regularized covariance of the samples of all of the
+   * specified adaptations, as if a single adaptation had seen all of
+   * them, and restart their estimators.
+   *
+   * @param[in, out] adaptations adaptations to pool
+   * @param[out] covar pooled covariance
+   * @throw std::runtime_error if the covariance overflows
+   */
+  static void pool_covariance(
+      const std::vector<covar_adaptation*>& adaptations,
+      Eigen::MatrixXd& covar) {
+    double n = 0;
+    Eigen::VectorXd mean = Eigen::VectorXd::Zero(covar.rows());
+    Eigen::MatrixXd m2 = Eigen::MatrixXd::Zero(covar.rows(), covar.cols());
+    Eigen::VectorXd mean_a(covar.rows());
+    Eigen::MatrixXd m2_a(covar.rows(), covar.cols());
+    for (covar_adaptation* a : adaptations) {
+      double n_a = a->estimator_.num_samples();
+      if (n_a == 0)
+        continue;
+      a->estimator_.sample_mean(mean_a);
+      m2_a.setZero();
+      if (n_a > 1) {
+        a->estimator_.sample_covariance(m2_a);
+        m2_a *= n_a - 1;
+      }
+      Eigen::VectorXd delta = mean_a - mean;
+      double n_ab = n + n_a;
+      mean += (n_a / n_ab) * delta;
+      m2 += m2_a + (n * n_a / n_ab) * delta * delta.transpose();
+      n = n_ab;
+      a->estimator_.restart();
+    }
+    if (n > 1)
+      covar = m2 / (n - 1);
+    regularize(covar, n);
+  }
+
  protected:
+  /**
+   * Shrink the covariance estimated from the specified number of
+   * samples towards a small multiple of the identity.
+   */
+  static void regularize(Eigen::MatrixXd& covar, double n) {
+    covar = (n / (n + 5.0)) * covar
+            + 1e-3 * (5.0 / (n + 5.0))
+                  * Eigen::MatrixXd::Identity(covar.rows(), covar.cols());
+
+    if (!covar.allFinite())
+      throw std::runtime_error(
+          "Numerical overflow in metric adaptation. "
+          "This occurs when the sampler encounters extreme values on the "
+          "unconstrained space; this may happen when the posterior density "
+          "function is too wide or improper. "
+          "There may be problems with your model specification.");
+  }
+
   stan::math::welford_covar_estimator estimator_;
+  bool pooled_;
 };
 
 }  // namespace mcmc
@@ -4,6 +4,7 @@
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
 #include <boost/random/uniform_01.hpp>
@@ -71,7 +72,7 @@ class base_hmc : public base_mcmc {
     struct_writer.begin_record();
     struct_writer.write("stepsize", get_nominal_stepsize());
     struct_writer.write("metric_type", z_.metric_type());
-    struct_writer.write("inv_metric", z_.inv_e_metric_);
+    z_.write_metric(struct_writer);
     struct_writer.end_record();
   }
 
@@ -84,6 +85,17 @@ class base_hmc : public base_mcmc {
     z_.get_params(values);
   }
 
+  void enable_telemetry() {
+    hamiltonian_.set_gradient_timing(true);
+    hamiltonian_.reset_gradient_stats();
+  }
+
+  void collect_telemetry(callbacks::transition_stats& stats) {
+    stats.gradient_evals = hamiltonian_.gradient_evals();
+    stats.gradient_seconds = hamiltonian_.gradient_seconds();
+    hamiltonian_.reset_gradient_stats();
+  }
+
   void seed(const Eigen::VectorXd& q) { z_.q = q; }
 
   void init_hamiltonian(callbacks::logger& logger) {
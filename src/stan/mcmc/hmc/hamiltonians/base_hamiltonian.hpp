@@ -5,6 +5,7 @@
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <stan/model/gradient.hpp>
 #include <stan/model/log_prob_propto.hpp>
+#include <chrono>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
@@ -40,9 +41,35 @@ class base_hamiltonian {
 
   virtual Eigen::VectorXd dtau_dp(Point& z) = 0;
 
+  /**
+   * Evaluate <code>dtau_dp</code> into the specified vector.  Metrics
+   * override this to write the result in place, so that callers which
+   * keep the vector between calls do not allocate.
+   *
+   * @param[in] z point in phase space
+   * @param[out] p_sharp derivative of tau with respect to the momentum
+   */
+  virtual void eval_dtau_dp(Point& z, Eigen::VectorXd& p_sharp) {
+    p_sharp = dtau_dp(z);
+  }
+
   // phi = 0.5 * log | Lambda (q) | + V(q)
   virtual Eigen::VectorXd dphi_dq(Point& z, callbacks::logger& logger) = 0;
 
+  /**
+   * Evaluate <code>dphi_dq</code> into the specified vector.  Metrics
+   * override this to write the result in place, so that callers which
+   * keep the vector between calls do not allocate.
+   *
+   * @param[in] z point in phase space
+   * @param[out] dphi derivative of phi with respect to the position
+   * @param[in, out] logger logger for messages
+   */
+  virtual void eval_dphi_dq(Point& z, Eigen::VectorXd& dphi,
+                            callbacks::logger& logger) {
+    dphi = dphi_dq(z, logger);
+  }
+
   virtual void sample_p(Point& z, BaseRNG& rng) = 0;
 
   void init(Point& z, callbacks::logger& logger) {
@@ -59,14 +86,16 @@ class base_hamiltonian {
   }
 
   void update_potential_gradient(Point& z, callbacks::logger& logger) {
-    try {
-      stan::model::gradient(model_, z.q, z.V, z.g, logger);
-      z.V = -z.V;
-    } catch (const std::domain_error& e) {
-      this->write_error_msg_(e, logger);
-      z.V = std::numeric_limits<double>::infinity();
-    }
-    z.g = -z.g;
+    evaluate_derivatives_([&]() {
+      try {
+        stan::model::gradient(model_, z.q, z.V, z.g, logger);
+        z.V = -z.V;
+      } catch (const std::domain_error& e) {
+        this->write_error_msg_(e, logger);
+        z.V = std::numeric_limits<double>::infinity();
+      }
+      z.g = -z.g;
+    });
   }
 
   void update_metric(Point& z, callbacks::logger& logger) {}
@@ -77,8 +106,65 @@ class base_hamiltonian {
     update_potential_gradient(z, logger);
   }
 
+  /**
+   * Enable or disable timing of the log density gradient evaluations.
+   * Evaluations are always counted.
+   *
+   * @param time_gradients whether to time the gradient evaluations
+   */
+  void set_gradient_timing(bool time_gradients) {
+    time_gradients_ = time_gradients;
+  }
+
+  /**
+   * Return the number of gradient evaluations since the last call to
+   * <code>reset_gradient_stats</code>.
+   */
+  std::size_t gradient_evals() const { return gradient_evals_; }
+
+  /**
+   * Return the seconds spent in timed gradient evaluations since the
+   * last call to <code>reset_gradient_stats</code>.
+   */
+  double gradient_seconds() const { return gradient_seconds_; }
+
+  void reset_gradient_stats() {
+    gradient_evals_ = 0;
+    gradient_seconds_ = 0;
+  }
+
  protected:
   const Model& model_;
+  std::size_t gradient_evals_ = 0;
+  double gradient_seconds_ = 0;
+  bool time_gradients_ = false;
+
+  /**
+   * Call the specified function, which evaluates derivatives of the log
+   * density, counting the gradient evaluations it makes and adding its
+   * time to the gradient time when timing is enabled.  Metrics that
+   * differentiate the log density other than through
+   * <code>update_potential_gradient</code> wrap those evaluations in
+   * this, so that telemetry covers them.
+   *
+   * @tparam F type of function
+   * @param f function taking no arguments
+   * @param num_gradients number of log density gradients computed by
+   *   <code>f</code>, zero for evaluations of higher derivatives only
+   */
+  template <typename F>
+  void evaluate_derivatives_(F&& f, std::size_t num_gradients = 1) {
+    gradient_evals_ += num_gradients;
+    if (!time_gradients_) {
+      f();
+      return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    f();
+    gradient_seconds_ += std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  }
 
   void write_error_msg_(const std::exception& e, callbacks::logger& logger) {
     logger.error(
@@ -1,6 +1,7 @@
 #ifndef STAN_MCMC_HMC_HAMILTONIANS_DENSE_E_POINT_HPP
 #define STAN_MCMC_HMC_HAMILTONIANS_DENSE_E_POINT_HPP
 
+#include <stan/callbacks/structured_writer.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
 
@@ -12,11 +13,6 @@ namespace mcmc {
  */
 class dense_e_point : public ps_point {
  public:
-  /**
-   * Inverse mass matrix.
-   */
-  Eigen::MatrixXd inv_e_metric_;
-
   /**
    * Construct a dense point in n-dimensional phase space
    * with identity matrix as inverse mass matrix.
@@ -25,6 +21,7 @@ class dense_e_point : public ps_point {
    */
   explicit dense_e_point(int n) : ps_point(n), inv_e_metric_(n, n) {
     inv_e_metric_.setIdentity();
+    factor_metric();
   }
 
   /**
@@ -34,6 +31,43 @@ class dense_e_point : public ps_point {
    */
   void set_metric(const Eigen::MatrixXd& inv_e_metric) {
     inv_e_metric_ = inv_e_metric;
+    factor_metric();
+  }
+
+  /**
+   * Update the inverse mass matrix in place and refactor it if the
+   * update changed it, as metric adaptation does at the end of each
+   * adaptation window.  The update is called with the inverse mass
+   * matrix and returns true if it changed the matrix.
+   *
+   * @tparam F type of the update
+   * @param update update of the inverse mass matrix
+   * @return true if the inverse mass matrix changed
+   */
+  template <typename F>
+  bool update_metric(const F& update) {
+    bool updated = false;
+    try {
+      updated = update(inv_e_metric_);
+    } catch (...) {
+      factor_metric();
+      throw;
+    }
+    if (updated)
+      factor_metric();
+    return updated;
+  }
+
+  /**
+   * Return the inverse mass matrix.
+   */
+  const Eigen::MatrixXd& inv_e_metric() const { return inv_e_metric_; }
+
+  /**
+   * Return the Cholesky factorization of the inverse mass matrix.
+   */
+  const Eigen::LLT<Eigen::MatrixXd>& inv_e_metric_llt() const {
+    return inv_e_metric_llt_;
   }
 
   /**
@@ -54,7 +88,32 @@ class dense_e_point : public ps_point {
     }
   }
 
+  /**
+   * Write the inverse mass matrix to a structured writer.
+   *
+   * @param writer Stan structured writer callback
+   */
+  inline void write_metric(stan::callbacks::structured_writer& writer) {
+    writer.write("inv_metric", inv_e_metric_);
+  }
+
   inline std::string metric_type() { return "dense_e"; }
+
+ private:
+  /**
+   * Inverse mass matrix.
+   */
+  Eigen::MatrixXd inv_e_metric_;
+
+  /**
+   * Cholesky factorization of the inverse mass matrix.  The metric only
+   * changes between adaptation windows, so the factorization is computed
+   * when the metric is set rather than on every transition.  It is kept
+   * private with the matrix so that the two cannot go out of step.
+   */
+  Eigen::LLT<Eigen::MatrixXd> inv_e_metric_llt_;
+
+  void factor_metric() { inv_e_metric_llt_.compute(inv_e_metric_); }
 };
 
 }  // namespace mcmc
@@ -1,6 +1,7 @@
 #ifndef STAN_MCMC_HMC_HAMILTONIANS_DIAG_E_POINT_HPP
 #define STAN_MCMC_HMC_HAMILTONIANS_DIAG_E_POINT_HPP
 
+#include <stan/callbacks/structured_writer.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
 
@@ -36,6 +37,11 @@ class diag_e_point : public ps_point {
     inv_e_metric_ = inv_e_metric;
   }
 
+  /**
+   * Return the diagonal elements of the inverse mass matrix.
+   */
+  const Eigen::VectorXd& inv_e_metric() const { return inv_e_metric_; }
+
   /**
    * Write elements of mass matrix to string and handoff to writer.
    *
@@ -51,6 +57,15 @@ class diag_e_point : public ps_point {
     writer(inv_e_metric_ss.str());
   }
 
+  /**
+   * Write the inverse mass matrix to a structured writer.
+   *
+   * @param writer Stan structured writer callback
+   */
+  inline void write_metric(stan::callbacks::structured_writer& writer) {
+    writer.write("inv_metric", inv_e_metric_);
+  }
+
   inline std::string metric_type() { return "diag_e"; }
 };
 
@@ -0,0 +1,181 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_E_POINT_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_E_POINT_HPP
+
+#include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace stan {
+namespace mcmc {
+/**
+ * Point in a phase space with a base Euclidean manifold whose inverse
+ * metric is a diagonal matrix plus a low-rank update,
+ * <code>diag(inv_e_metric_) + inv_e_metric_lowrank_ *
+ * inv_e_metric_lowrank_^T</code>.  Products with the metric and draws
+ * of the momenta cost O(nk) for n dimensions and rank k.
+ */
+class lowrank_e_point : public ps_point {
+ public:
+  /**
+   * Vector of diagonal elements of the diagonal part of the inverse
+   * mass matrix.
+   */
+  Eigen::VectorXd inv_e_metric_;
+
+  /**
+   * Low-rank part of the inverse mass matrix, one n-vector per column.
+   */
+  Eigen::MatrixXd inv_e_metric_lowrank_;
+
+  /**
+   * Construct a point in n-dimensional phase space with identity
+   * matrix as inverse mass matrix.
+   *
+   * @param n number of dimensions
+   */
+  explicit lowrank_e_point(int n)
+      : ps_point(n), inv_e_metric_(n), inv_e_metric_lowrank_(n, 0) {
+    inv_e_metric_.setOnes();
+    factor_metric();
+  }
+
+  /**
+   * Set the diagonal of the inverse mass matrix and remove any low-rank
+   * part.
+   *
+   * @param inv_e_metric diagonal of the inverse mass matrix
+   */
+  void set_metric(const Eigen::VectorXd& inv_e_metric) {
+    inv_e_metric_ = inv_e_metric;
+    inv_e_metric_lowrank_.resize(inv_e_metric.size(), 0);
+    factor_metric();
+  }
+
+  /**
+   * Set the diagonal and low-rank parts of the inverse mass matrix.
+   *
+   * @param inv_e_metric diagonal of the inverse mass matrix
+   * @param inv_e_metric_lowrank low-rank part of the inverse mass
+   * matrix, one column per rank
+   */
+  void set_metric(const Eigen::VectorXd& inv_e_metric,
+                  const Eigen::MatrixXd& inv_e_metric_lowrank) {
+    inv_e_metric_ = inv_e_metric;
+    inv_e_metric_lowrank_ = inv_e_metric_lowrank;
+    factor_metric();
+  }
+
+  /**
+   * Precompute the factors used to draw momenta.  Writing the inverse
+   * metric as D^(1/2) (I + V V^T) D^(1/2) with V = D^(-1/2) U and the
+   * eigendecomposition V^T V = W diag(lambda) W^T, the inverse square
+   * root of I + V V^T is I + B diag(c) B^T with B = V W and
+   * c = ((1 + lambda)^(-1/2) - 1) / lambda.  Must be called after the
+   * metric is modified in place.
+   */
+  void factor_metric() {
+    inv_sqrt_diag_ = inv_e_metric_.array().rsqrt();
+    if (inv_e_metric_lowrank_.cols() == 0) {
+      momentum_basis_.resize(inv_e_metric_.size(), 0);
+      momentum_scale_.resize(0);
+      return;
+    }
+    Eigen::MatrixXd V = inv_sqrt_diag_.asDiagonal() * inv_e_metric_lowrank_;
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(V.transpose() * V);
+    momentum_basis_ = V * solver.eigenvectors();
+    const Eigen::VectorXd& lambda = solver.eigenvalues();
+    momentum_scale_.resize(lambda.size());
+    for (Eigen::Index i = 0; i < lambda.size(); ++i) {
+      // The limit as lambda goes to zero is -1/2
+      momentum_scale_(i)
+          = lambda(i) > 1e-8 ? (1 / std::sqrt(1 + lambda(i)) - 1) / lambda(i)
+                             : -0.5;
+    }
+  }
+
+  /**
+   * Return the product of the inverse mass matrix and a vector.
+   *
+   * @param x vector
+   */
+  Eigen::VectorXd inv_e_metric_times(const Eigen::VectorXd& x) const {
+    return inv_e_metric_.cwiseProduct(x)
+           + inv_e_metric_lowrank_ * (inv_e_metric_lowrank_.transpose() * x);
+  }
+
+  /**
+   * Map a vector of independent standard normal draws to a draw of the
+   * momenta, which are normal with covariance the mass matrix.
+   *
+   * @param u vector of standard normal draws
+   */
+  Eigen::VectorXd momentum_from_std_normal(const Eigen::VectorXd& u) const {
+    Eigen::VectorXd x
+        = u
+          + momentum_basis_
+                * momentum_scale_.cwiseProduct(momentum_basis_.transpose() * u);
+    return inv_sqrt_diag_.cwiseProduct(x);
+  }
+
+  /**
+   * Write elements of mass matrix to string and handoff to writer.
+   *
+   * @param writer Stan writer callback
+   */
+  inline void write_metric(stan::callbacks::writer& writer) {
+    writer("Diagonal elements of inverse mass matrix:");
+    std::stringstream inv_e_metric_ss;
+    if (inv_e_metric_.size() > 0)
+      inv_e_metric_ss << inv_e_metric_(0);
+    for (int i = 1; i < inv_e_metric_.size(); ++i)
+      inv_e_metric_ss << ", " << inv_e_metric_(i);
+    writer(inv_e_metric_ss.str());
+    writer("Low-rank elements of inverse mass matrix:");
+    if (inv_e_metric_lowrank_.cols() == 0)
+      writer("");
+    for (int j = 0; j < inv_e_metric_lowrank_.cols(); ++j) {
+      std::stringstream lowrank_ss;
+      if (inv_e_metric_lowrank_.rows() > 0)
+        lowrank_ss << inv_e_metric_lowrank_(0, j);
+      for (int i = 1; i < inv_e_metric_lowrank_.rows(); ++i)
+        lowrank_ss << ", " << inv_e_metric_lowrank_(i, j);
+      writer(lowrank_ss.str());
+    }
+  }
+
+  /**
+   * Write the inverse mass matrix to a structured writer.
+   *
+   * @param writer Stan structured writer callback
+   */
+  inline void write_metric(stan::callbacks::structured_writer& writer) {
+    writer.write("inv_metric", inv_e_metric_);
+    writer.write("inv_metric_lowrank", inv_e_metric_lowrank_);
+  }
+
+  inline std::string metric_type() { return "lowrank_e"; }
+
+ private:
+  /**
+   * Elementwise inverse square root of the diagonal part, D^(-1/2)
+   */
+  Eigen::VectorXd inv_sqrt_diag_;
+
+  /**
+   * Basis B of the low-rank correction used to draw momenta
+   */
+  Eigen::MatrixXd momentum_basis_;
+
+  /**
+   * Scales c of the low-rank correction used to draw momenta
+   */
+  Eigen::VectorXd momentum_scale_;
+};
+
+}  // namespace mcmc
+}  // namespace stan
+
+#endif
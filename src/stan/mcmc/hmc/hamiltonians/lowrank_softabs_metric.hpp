@@ -0,0 +1,347 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_SOFTABS_METRIC_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_SOFTABS_METRIC_HPP
+
+#include <stan/math/mix.hpp>
+#include <stan/mcmc/hmc/hamiltonians/base_hamiltonian.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_softabs_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/softabs_metric.hpp>
+#include <stan/model/hessian_times_vector.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+namespace mcmc {
+
+/**
+ * Riemannian manifold with a matrix-free, truncated SoftAbs metric.
+ *
+ * <p>The Hessian is never formed.  Each metric update runs a Lanczos
+ * iteration with full reorthogonalization on Hessian-vector products,
+ * keeps the <code>rank</code> Ritz pairs of largest magnitude, and
+ * treats the unresolved eigenvalues as zero, so that the metric is
+ * <code>Q diag(softabs(lambda)) Q^T + (I - Q Q^T) / alpha</code>.  The
+ * gradients of the metric follow from first-order perturbation of this
+ * spectrum and need one third-order sweep per resolved eigenpair, so
+ * the cost of an update is O(rank) gradient evaluations and O(n rank)
+ * memory rather than O(n) gradient evaluations and O(n^2) memory for
+ * <code>softabs_metric</code>.  When <code>rank</code> equals the
+ * number of parameters the two metrics coincide.
+ *
+ * <p>The gradients are exact only if the unresolved eigenvalues are
+ * zero.  Otherwise the truncated metric depends on them through the
+ * choice of the resolved subspace, which first-order perturbation of
+ * the resolved pairs does not capture, so the samplers built on this
+ * metric require <code>rank</code> to be at least the number of
+ * parameters.
+ */
+template <class Model, class BaseRNG>
+class lowrank_softabs_metric
+    : public base_hamiltonian<Model, lowrank_softabs_point, BaseRNG> {
+ public:
+  explicit lowrank_softabs_metric(const Model& model)
+      : base_hamiltonian<Model, lowrank_softabs_point, BaseRNG>(model) {}
+
+  double T(lowrank_softabs_point& z) {
+    return this->tau(z) + 0.5 * z.log_det_metric;
+  }
+
+  double tau(lowrank_softabs_point& z) {
+    Eigen::VectorXd Qp = z.eigenvectors.transpose() * z.p;
+    return 0.5
+           * (Qp.dot(z.softabs_lambda_inv.cwiseProduct(Qp))
+              + (z.p.squaredNorm() - Qp.squaredNorm()) / z.softabs_remainder);
+  }
+
+  double phi(lowrank_softabs_point& z) {
+    return this->V(z) + 0.5 * z.log_det_metric;
+  }
+
+  double dG_dt(lowrank_softabs_point& z, callbacks::logger& logger) {
+    return 2 * T(z) - z.q.dot(dtau_dq(z, logger) + dphi_dq(z, logger));
+  }
+
+  Eigen::VectorXd dtau_dq(lowrank_softabs_point& z,
+                          callbacks::logger& logger) {
+    const Eigen::Index n = z.q.size();
+    const Eigen::Index k = z.eigenvectors.cols();
+
+    Eigen::VectorXd Qp = z.eigenvectors.transpose() * z.p;
+    Eigen::VectorXd a = z.softabs_lambda_inv.cwiseProduct(Qp);
+    Eigen::MatrixXd J = z.pseudo_j.selfadjointView<Eigen::Lower>();
+    Eigen::MatrixXd C = a.asDiagonal() * J * a.asDiagonal();
+
+    // Resolved block, tr(Q C Q^T H), plus the coupling between the
+    // resolved and unresolved subspaces
+    Eigen::MatrixXd U(n, k + 1);
+    Eigen::MatrixXd W(n, k + 1);
+    U.leftCols(k) = z.eigenvectors * C;
+    W.leftCols(k) = z.eigenvectors;
+    U.col(k) = 2 * (z.p - z.eigenvectors * Qp) / z.softabs_remainder;
+    W.col(k) = z.eigenvectors * z.remainder_j.cwiseProduct(a);
+    if (k == n) {
+      U.conservativeResize(n, k);
+      W.conservativeResize(n, k);
+    }
+
+    Eigen::VectorXd b;
+    this->evaluate_derivatives_(
+        [&]() { b = grad_tr_hessian_times(z, U, W, logger); }, 0);
+    return 0.5 * b;
+  }
+
+  Eigen::VectorXd dtau_dp(lowrank_softabs_point& z) {
+    Eigen::VectorXd Qp = z.eigenvectors.transpose() * z.p;
+    Eigen::VectorXd a
+        = (z.softabs_lambda_inv.array() - 1 / z.softabs_remainder).matrix();
+    return z.eigenvectors * a.cwiseProduct(Qp) + z.p / z.softabs_remainder;
+  }
+
+  Eigen::VectorXd dphi_dq(lowrank_softabs_point& z,
+                          callbacks::logger& logger) {
+    Eigen::VectorXd a
+        = z.softabs_lambda_inv.cwiseProduct(z.pseudo_j.diagonal());
+    Eigen::MatrixXd A = z.eigenvectors * a.asDiagonal();
+
+    Eigen::VectorXd b;
+    this->evaluate_derivatives_(
+        [&]() { b = grad_tr_hessian_times(z, A, z.eigenvectors, logger); },
+        0);
+    return -0.5 * b + z.g;
+  }
+
+  void sample_p(lowrank_softabs_point& z, BaseRNG& rng) {
+    boost::variate_generator<BaseRNG&, boost::normal_distribution<> >
+        rand_unit_gaus(rng, boost::normal_distribution<>());
+
+    Eigen::VectorXd u(z.p.size());
+    for (Eigen::Index n = 0; n < u.size(); ++n)
+      u(n) = rand_unit_gaus();
+
+    double sqrt_remainder = std::sqrt(z.softabs_remainder);
+    Eigen::VectorXd a
+        = (z.softabs_lambda.array().sqrt() - sqrt_remainder).matrix();
+    z.p = sqrt_remainder * u
+          + z.eigenvectors * a.cwiseProduct(z.eigenvectors.transpose() * u);
+  }
+
+  void init(lowrank_softabs_point& z, callbacks::logger& logger) {
+    update_metric(z, logger);
+    update_metric_gradient(z, logger);
+  }
+
+  void update_metric(lowrank_softabs_point& z, callbacks::logger& logger) {
+    this->update_potential_gradient(z, logger);
+
+    const Eigen::Index n = z.q.size();
+    const Eigen::Index k
+        = std::min<Eigen::Index>(std::max(z.rank, 0), n);
+    z.softabs_remainder = dense_metric::softabs(0, z.alpha);
+
+    if (k == 0 || !std::isfinite(z.V) || !lanczos(z, k, logger)) {
+      z.eigenvectors.resize(n, 0);
+      z.hessian_lambda.resize(0);
+    }
+
+    z.softabs_lambda.resize(z.hessian_lambda.size());
+    z.softabs_lambda_inv.resize(z.hessian_lambda.size());
+    for (Eigen::Index i = 0; i < z.hessian_lambda.size(); ++i) {
+      z.softabs_lambda(i)
+          = dense_metric::softabs(z.hessian_lambda(i), z.alpha);
+      z.softabs_lambda_inv(i) = 1.0 / z.softabs_lambda(i);
+    }
+
+    // Compute the log determinant of the metric
+    z.log_det_metric = (n - z.hessian_lambda.size())
+                       * std::log(z.softabs_remainder);
+    for (Eigen::Index i = 0; i < z.hessian_lambda.size(); ++i)
+      z.log_det_metric += std::log(z.softabs_lambda(i));
+  }
+
+  void update_metric_gradient(lowrank_softabs_point& z,
+                              callbacks::logger& logger) {
+    // Compute the pseudo-Jacobian of the SoftAbs transform, with the
+    // unresolved eigenvalues at zero
+    const Eigen::Index k = z.hessian_lambda.size();
+    z.pseudo_j.resize(k, k);
+    z.remainder_j.resize(k);
+    for (Eigen::Index i = 0; i < k; ++i) {
+      for (Eigen::Index j = 0; j <= i; ++j)
+        z.pseudo_j(i, j) = dense_metric::pseudo_jacobian(
+            z.hessian_lambda(i), z.hessian_lambda(j), z.softabs_lambda(i),
+            z.softabs_lambda(j), z.alpha);
+      z.remainder_j(i) = dense_metric::pseudo_jacobian(
+          z.hessian_lambda(i), 0, z.softabs_lambda(i), z.softabs_remainder,
+          z.alpha);
+    }
+  }
+
+  void update_gradients(lowrank_softabs_point& z, callbacks::logger& logger) {
+    update_metric_gradient(z, logger);
+  }
+
+  // Relative size of the Lanczos residual below which
+  // the Krylov subspace is taken to be invariant
+  static constexpr double lanczos_breakdown_thresh = 1e-12;
+
+ private:
+  typedef softabs_metric<Model, BaseRNG> dense_metric;
+
+  /**
+   * Run a Lanczos iteration on the Hessian of the potential at
+   * <code>z.q</code> and store the <code>k</code> Ritz pairs of largest
+   * magnitude in <code>z</code>.  The starting vector is drawn from a
+   * fixed seed so that the metric is a deterministic function of the
+   * position, and the iteration is restarted orthogonally to the
+   * current basis whenever the Krylov subspace becomes invariant, which
+   * recovers repeated eigenvalues.
+   *
+   * @param[in, out] z point at which to decompose the Hessian
+   * @param[in] k number of eigenpairs to keep
+   * @param[in, out] logger logger for error messages
+   * @return false if the Hessian could not be evaluated
+   */
+  bool lanczos(lowrank_softabs_point& z, Eigen::Index k,
+               callbacks::logger& logger) {
+    const Eigen::Index n = z.q.size();
+    const Eigen::Index m
+        = std::min<Eigen::Index>(n, std::max<Eigen::Index>(2 * k, k + 10));
+
+    boost::random::mt19937 rng(0);
+    Eigen::MatrixXd basis(n, m);
+    Eigen::VectorXd diag(m);
+    Eigen::VectorXd offdiag = Eigen::VectorXd::Zero(m - 1);
+    Eigen::VectorXd v = random_orthogonal_unit(basis.leftCols(0), rng);
+
+    for (Eigen::Index j = 0; j < m; ++j) {
+      basis.col(j) = v;
+
+      double f = 0;
+      Eigen::VectorXd w;
+      try {
+        this->evaluate_derivatives_(
+            [&]() {
+              stan::model::hessian_times_vector(this->model_, z.q, v, f, w);
+            },
+            0);
+      } catch (const std::exception& e) {
+        this->write_error_msg_(e, logger);
+        z.V = std::numeric_limits<double>::infinity();
+        return false;
+      }
+      w = -w;
+      diag(j) = v.dot(w);
+      if (j + 1 == m)
+        break;
+
+      double scale = w.norm();
+      for (int pass = 0; pass < 2; ++pass)
+        w -= basis.leftCols(j + 1) * (basis.leftCols(j + 1).transpose() * w);
+      double beta = w.norm();
+      if (beta > lanczos_breakdown_thresh * scale) {
+        offdiag(j) = beta;
+        v = w / beta;
+      } else {
+        v = random_orthogonal_unit(basis.leftCols(j + 1), rng);
+      }
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> tridiag_deco;
+    tridiag_deco.computeFromTridiagonal(diag, offdiag);
+    const Eigen::VectorXd& theta = tridiag_deco.eigenvalues();
+
+    std::vector<Eigen::Index> order(m);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&theta](Eigen::Index i, Eigen::Index j) {
+                       return std::fabs(theta(i)) > std::fabs(theta(j));
+                     });
+
+    z.eigenvectors.resize(n, k);
+    z.hessian_lambda.resize(k);
+    for (Eigen::Index i = 0; i < k; ++i) {
+      z.hessian_lambda(i) = theta(order[i]);
+      z.eigenvectors.col(i) = basis * tridiag_deco.eigenvectors().col(order[i]);
+    }
+    return true;
+  }
+
+  /**
+   * Return a random unit vector orthogonal to the columns of an
+   * orthonormal basis with fewer columns than rows.
+   */
+  static Eigen::VectorXd random_orthogonal_unit(
+      const Eigen::Ref<const Eigen::MatrixXd>& basis,
+      boost::random::mt19937& rng) {
+    boost::random::normal_distribution<double> std_normal;
+    Eigen::VectorXd v(basis.rows());
+    for (Eigen::Index i = 0; i < v.size(); ++i)
+      v(i) = std_normal(rng);
+    for (int pass = 0; pass < 2; ++pass)
+      v -= basis * (basis.transpose() * v);
+    return v.normalized();
+  }
+
+  /**
+   * Return the gradient of <code>tr(W U^T H)</code>, the sum of
+   * <code>U.col(l)^T H W.col(l)</code> over the columns, where H is the
+   * Hessian of the log density at <code>z.q</code>.  Each column costs
+   * one forward-over-forward-over-reverse sweep.  If the log density
+   * cannot be evaluated the error is logged, the potential is set to
+   * infinity so that the proposal is rejected, and zero is returned.
+   */
+  Eigen::VectorXd grad_tr_hessian_times(lowrank_softabs_point& z,
+                                        const Eigen::MatrixXd& U,
+                                        const Eigen::MatrixXd& W,
+                                        callbacks::logger& logger) {
+    using stan::math::fvar;
+    using stan::math::var;
+
+    const Eigen::VectorXd& q = z.q;
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(q.size());
+    if (U.cols() == 0)
+      return grad;
+
+    try {
+      stan::math::nested_rev_autodiff nested;
+      Eigen::Matrix<var, Eigen::Dynamic, 1> q_var(q.size());
+      for (Eigen::Index i = 0; i < q.size(); ++i)
+        q_var(i) = q(i);
+
+      Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> q_fvar(q.size());
+      var sum(0.0);
+      for (Eigen::Index l = 0; l < U.cols(); ++l) {
+        for (Eigen::Index i = 0; i < q.size(); ++i)
+          q_fvar(i) = fvar<var>(q_var(i), W(i, l));
+        Eigen::VectorXd u = U.col(l);
+        fvar<var> f;
+        fvar<var> grad_f_dot_u;
+        stan::math::gradient_dot_vector(softabs_fun<Model>(this->model_, 0),
+                                        q_fvar, u, f, grad_f_dot_u);
+        sum += grad_f_dot_u.d_;
+      }
+      sum.grad();
+
+      for (Eigen::Index i = 0; i < q.size(); ++i)
+        grad(i) = q_var(i).adj();
+    } catch (const std::exception& e) {
+      this->write_error_msg_(e, logger);
+      z.V = std::numeric_limits<double>::infinity();
+      grad.setZero();
+    }
+    return grad;
+  }
+};
+
+template <class Model, class BaseRNG>
+constexpr double
+    lowrank_softabs_metric<Model, BaseRNG>::lanczos_breakdown_thresh;
+}  // namespace mcmc
+}  // namespace stan
+#endif
@@ -0,0 +1,70 @@
+#ifndef STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_SOFTABS_POINT_HPP
+#define STAN_MCMC_HMC_HAMILTONIANS_LOWRANK_SOFTABS_POINT_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <string>
+
+namespace stan {
+namespace mcmc {
+/**
+ * Point in a phase space with a base Riemannian manifold with a
+ * truncated SoftAbs metric.  Only the <code>rank</code> eigenpairs of
+ * the Hessian with the largest magnitude are resolved; the remaining
+ * eigenvalues are taken to be zero, so the metric is isotropic with
+ * value <code>1 / alpha</code> on the orthogonal complement.  By
+ * default every eigenpair is resolved.
+ */
+class lowrank_softabs_point : public ps_point {
+ public:
+  explicit lowrank_softabs_point(int n)
+      : ps_point(n),
+        alpha(1.0),
+        rank(n),
+        eigenvectors(n, 0),
+        hessian_lambda(0),
+        log_det_metric(0),
+        softabs_lambda(0),
+        softabs_lambda_inv(0),
+        softabs_remainder(1.0),
+        pseudo_j(0, 0),
+        remainder_j(0) {}
+
+  // SoftAbs regularization parameter
+  double alpha;
+
+  // Maximum number of resolved eigenpairs of the Hessian
+  int rank;
+
+  // Resolved eigenvectors and eigenvalues of the Hessian
+  Eigen::MatrixXd eigenvectors;
+  Eigen::VectorXd hessian_lambda;
+
+  // Log determinant of metric
+  double log_det_metric;
+
+  // SoftAbs transformed resolved eigenvalues of Hessian
+  Eigen::VectorXd softabs_lambda;
+  Eigen::VectorXd softabs_lambda_inv;
+
+  // SoftAbs transform of the unresolved eigenvalues
+  double softabs_remainder;
+
+  // Psuedo-Jacobian of the resolved eigenvalues
+  Eigen::MatrixXd pseudo_j;
+
+  // Psuedo-Jacobian between each resolved eigenvalue and the
+  // unresolved eigenvalues
+  Eigen::VectorXd remainder_j;
+
+  virtual inline void write_metric(stan::callbacks::writer& writer) {
+    writer("No free parameters for SoftAbs metric");
+  }
+
+  inline std::string metric_type() { return "lowrank_softabs"; }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+
+#endif
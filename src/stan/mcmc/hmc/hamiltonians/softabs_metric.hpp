@@ -57,8 +57,12 @@ class softabs_metric : public base_hamiltonian<Model, softabs_point, BaseRNG> {
     Eigen::MatrixXd C = A.transpose() * B;
 
     Eigen::VectorXd b(z.q.size());
-    stan::math::grad_tr_mat_times_hessian(softabs_fun<Model>(this->model_, 0),
-                                          z.q, C, b);
+    this->evaluate_derivatives_(
+        [&]() {
+          stan::math::grad_tr_mat_times_hessian(
+              softabs_fun<Model>(this->model_, 0), z.q, C, b);
+        },
+        0);
 
     return 0.5 * b;
   }
@@ -76,8 +80,12 @@ class softabs_metric : public base_hamiltonian<Model, softabs_point, BaseRNG> {
         = a.asDiagonal() * z.eigen_deco.eigenvectors().transpose();
     Eigen::MatrixXd B = z.eigen_deco.eigenvectors() * A;
 
-    stan::math::grad_tr_mat_times_hessian(softabs_fun<Model>(this->model_, 0),
-                                          z.q, B, a);
+    this->evaluate_derivatives_(
+        [&]() {
+          stan::math::grad_tr_mat_times_hessian(
+              softabs_fun<Model>(this->model_, 0), z.q, B, a);
+        },
+        0);
 
     return -0.5 * a + z.g;
   }
@@ -100,8 +108,11 @@ class softabs_metric : public base_hamiltonian<Model, softabs_point, BaseRNG> {
   }
 
   void update_metric(softabs_point& z, callbacks::logger& logger) {
-    math::hessian<softabs_fun<Model> >(softabs_fun<Model>(this->model_, 0), z.q,
-                                       z.V, z.g, z.hessian);
+    // The Hessian evaluation computes the gradient along with it
+    this->evaluate_derivatives_([&]() {
+      math::hessian<softabs_fun<Model> >(softabs_fun<Model>(this->model_, 0),
+                                         z.q, z.V, z.g, z.hessian);
+    });
     z.V = -z.V;
     z.g = -z.g;
     z.hessian = -z.hessian;
@@ -110,24 +121,8 @@ class softabs_metric : public base_hamiltonian<Model, softabs_point, BaseRNG> {
     z.eigen_deco.compute(z.hessian);
 
     for (idx_t i = 0; i < z.q.size(); ++i) {
-      double lambda = z.eigen_deco.eigenvalues()(i);
-      double alpha_lambda = z.alpha * lambda;
-
-      double softabs_lambda = 0;
-
-      // Thresholds defined such that the approximation
-      // error is on the same order of double precision
-      if (std::fabs(alpha_lambda) < lower_softabs_thresh) {
-        softabs_lambda
-            = (1.0 + (1.0 / 3.0) * alpha_lambda * alpha_lambda) / z.alpha;
-      } else if (std::fabs(alpha_lambda) > upper_softabs_thresh) {
-        softabs_lambda = std::fabs(lambda);
-      } else {
-        softabs_lambda = lambda / std::tanh(alpha_lambda);
-      }
-
-      z.softabs_lambda(i) = softabs_lambda;
-      z.softabs_lambda_inv(i) = 1.0 / softabs_lambda;
+      z.softabs_lambda(i) = softabs(z.eigen_deco.eigenvalues()(i), z.alpha);
+      z.softabs_lambda_inv(i) = 1.0 / z.softabs_lambda(i);
     }
 
     // Compute the log determinant of the metric
@@ -138,34 +133,11 @@ class softabs_metric : public base_hamiltonian<Model, softabs_point, BaseRNG> {
 
   void update_metric_gradient(softabs_point& z, callbacks::logger& logger) {
     // Compute the pseudo-Jacobian of the SoftAbs transform
-    for (idx_t i = 0; i < z.q.size(); ++i) {
-      for (idx_t j = 0; j <= i; ++j) {
-        double delta
-            = z.eigen_deco.eigenvalues()(i) - z.eigen_deco.eigenvalues()(j);
-
-        if (std::fabs(delta) < jacobian_thresh) {
-          double lambda = z.eigen_deco.eigenvalues()(i);
-          double alpha_lambda = z.alpha * lambda;
-
-          // Thresholds defined such that the approximation
-          // error is on the same order of double precision
-          if (std::fabs(alpha_lambda) < lower_softabs_thresh) {
-            z.pseudo_j(i, j)
-                = (2.0 / 3.0) * alpha_lambda
-                  * (1.0 - (2.0 / 15.0) * alpha_lambda * alpha_lambda);
-          } else if (std::fabs(alpha_lambda) > upper_softabs_thresh) {
-            z.pseudo_j(i, j) = lambda > 0 ? 1 : -1;
-          } else {
-            double sdx = std::sinh(alpha_lambda) / lambda;
-            z.pseudo_j(i, j)
-                = (z.softabs_lambda(i) - z.alpha / (sdx * sdx)) / lambda;
-          }
-        } else {
-          z.pseudo_j(i, j)
-              = (z.softabs_lambda(i) - z.softabs_lambda(j)) / delta;
-        }
-      }
-    }
+    for (idx_t i = 0; i < z.q.size(); ++i)
+      for (idx_t j = 0; j <= i; ++j)
+        z.pseudo_j(i, j) = pseudo_jacobian(
+            z.eigen_deco.eigenvalues()(i), z.eigen_deco.eigenvalues()(j),
+            z.softabs_lambda(i), z.softabs_lambda(j), z.alpha);
   }
 
   void update_gradients(softabs_point& z, callbacks::logger& logger) {
@@ -184,6 +156,57 @@ class softabs_metric : public base_hamiltonian<Model, softabs_point, BaseRNG> {
   // used in the Jacobian calculation instead of
   // finite differencing
   static constexpr double jacobian_thresh = 1e-10;
+
+  /**
+   * Return the SoftAbs transform of an eigenvalue of the Hessian.
+   *
+   * @param lambda eigenvalue
+   * @param alpha SoftAbs regularization parameter
+   * @return <code>lambda / tanh(alpha * lambda)</code>
+   */
+  static double softabs(double lambda, double alpha) {
+    double alpha_lambda = alpha * lambda;
+
+    // Thresholds defined such that the approximation
+    // error is on the same order of double precision
+    if (std::fabs(alpha_lambda) < lower_softabs_thresh)
+      return (1.0 + (1.0 / 3.0) * alpha_lambda * alpha_lambda) / alpha;
+    if (std::fabs(alpha_lambda) > upper_softabs_thresh)
+      return std::fabs(lambda);
+    return lambda / std::tanh(alpha_lambda);
+  }
+
+  /**
+   * Return the element of the pseudo-Jacobian of the SoftAbs transform
+   * for a pair of eigenvalues of the Hessian: the divided difference of
+   * the transform, or its derivative when the eigenvalues coincide.
+   *
+   * @param lambda_i first eigenvalue
+   * @param lambda_j second eigenvalue
+   * @param softabs_i SoftAbs transform of the first eigenvalue
+   * @param softabs_j SoftAbs transform of the second eigenvalue
+   * @param alpha SoftAbs regularization parameter
+   * @return pseudo-Jacobian element
+   */
+  static double pseudo_jacobian(double lambda_i, double lambda_j,
+                                double softabs_i, double softabs_j,
+                                double alpha) {
+    double delta = lambda_i - lambda_j;
+    if (std::fabs(delta) >= jacobian_thresh)
+      return (softabs_i - softabs_j) / delta;
+
+    double alpha_lambda = alpha * lambda_i;
+
+    // Thresholds defined such that the approximation
+    // error is on the same order of double precision
+    if (std::fabs(alpha_lambda) < lower_softabs_thresh)
+      return (2.0 / 3.0) * alpha_lambda
+             * (1.0 - (2.0 / 15.0) * alpha_lambda * alpha_lambda);
+    if (std::fabs(alpha_lambda) > upper_softabs_thresh)
+      return lambda_i > 0 ? 1 : -1;
+    double sdx = std::sinh(alpha_lambda) / lambda_i;
+    return (softabs_i - alpha / (sdx * sdx)) / lambda_i;
+  }
 };
 
 template <class Model, class BaseRNG>
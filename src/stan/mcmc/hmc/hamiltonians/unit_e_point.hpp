@@ -1,6 +1,7 @@
 #ifndef STAN_MCMC_HMC_HAMILTONIANS_UNIT_E_POINT_HPP
 #define STAN_MCMC_HMC_HAMILTONIANS_UNIT_E_POINT_HPP
 
+#include <stan/callbacks/structured_writer.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
 
@@ -31,6 +32,15 @@ class unit_e_point : public ps_point {
     writer("No free parameters for unit metric");
   }
 
+  /**
+   * Write the inverse mass matrix to a structured writer.
+   *
+   * @param writer Stan structured writer callback
+   */
+  inline void write_metric(stan::callbacks::structured_writer& writer) {
+    writer.write("inv_metric", inv_e_metric_);
+  }
+
   inline std::string metric_type() { return "unit_e"; }
 };
 
@@ -16,20 +16,29 @@ class expl_leapfrog : public base_leapfrog<Hamiltonian> {
   void begin_update_p(typename Hamiltonian::PointType& z,
                       Hamiltonian& hamiltonian, double epsilon,
                       callbacks::logger& logger) {
-    z.p -= epsilon * hamiltonian.dphi_dq(z, logger);
+    hamiltonian.eval_dphi_dq(z, dphi_dq_, logger);
+    z.p -= epsilon * dphi_dq_;
   }
 
   void update_q(typename Hamiltonian::PointType& z, Hamiltonian& hamiltonian,
                 double epsilon, callbacks::logger& logger) {
-    z.q += epsilon * hamiltonian.dtau_dp(z);
+    hamiltonian.eval_dtau_dp(z, dtau_dp_);
+    z.q += epsilon * dtau_dp_;
     hamiltonian.update_potential_gradient(z, logger);
   }
 
   void end_update_p(typename Hamiltonian::PointType& z,
                     Hamiltonian& hamiltonian, double epsilon,
                     callbacks::logger& logger) {
-    z.p -= epsilon * hamiltonian.dphi_dq(z, logger);
+    hamiltonian.eval_dphi_dq(z, dphi_dq_, logger);
+    z.p -= epsilon * dphi_dq_;
   }
+
+ private:
+  // Derivatives of the Hamiltonian, kept between steps so that the
+  // Euclidean metrics evaluate them without allocating
+  Eigen::VectorXd dtau_dp_;
+  Eigen::VectorXd dphi_dq_;
 };
 
 }  // namespace mcmc
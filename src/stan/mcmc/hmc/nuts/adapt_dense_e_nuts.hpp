@@ -29,23 +29,43 @@ class adapt_dense_e_nuts : public dense_e_nuts<Model, BaseRNG>,
       this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
                                                 s.accept_stat());
 
-      bool update = this->covar_adaptation_.learn_covariance(
-          this->z_.inv_e_metric_, this->z_.q);
+      bool update = this->z_.update_metric([this](Eigen::MatrixXd& covar) {
+        return this->covar_adaptation_.learn_covariance(covar, this->z_.q);
+      });
 
       if (update) {
-        this->init_stepsize(logger);
-
-        this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
-        this->stepsize_adaptation_.restart();
+        restart_stepsize_adaptation(logger);
       }
     }
     return s;
   }
 
+  /**
+   * Set the inverse metric to one estimated outside of this sampler,
+   * such as one pooled across chains, and restart the step size
+   * adaptation as at the end of an adaptation window.
+   *
+   * @param inv_metric inverse metric
+   * @param logger logger for messages
+   */
+  void set_adapted_metric(const Eigen::MatrixXd& inv_metric,
+                          callbacks::logger& logger) {
+    this->z_.set_metric(inv_metric);
+    restart_stepsize_adaptation(logger);
+  }
+
   void disengage_adaptation() {
     base_adapter::disengage_adaptation();
     this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
   }
+
+ private:
+  void restart_stepsize_adaptation(callbacks::logger& logger) {
+    this->init_stepsize(logger);
+
+    this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
+    this->stepsize_adaptation_.restart();
+  }
 };
 
 }  // namespace mcmc
@@ -27,7 +27,8 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
         max_deltaH_(1000),
         n_leapfrog_(0),
         divergent_(false),
-        energy_(0) {}
+        energy_(0),
+        trajectory_(this->z_.q.size()) {}
 
   /**
    * specialized constructor for specified diag mass matrix
@@ -40,7 +41,8 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
         max_deltaH_(1000),
         n_leapfrog_(0),
         divergent_(false),
-        energy_(0) {}
+        energy_(0),
+        trajectory_(this->z_.q.size()) {}
 
   /**
    * specialized constructor for specified dense mass matrix
@@ -53,7 +55,8 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
         max_deltaH_(1000),
         n_leapfrog_(0),
         divergent_(false),
-        energy_(0) {}
+        energy_(0),
+        trajectory_(this->z_.q.size()) {}
 
   ~base_nuts() {}
 
@@ -84,30 +87,32 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
     this->hamiltonian_.sample_p(this->z_, this->rand_int_);
     this->hamiltonian_.init(this->z_, logger);
 
-    ps_point z_fwd(this->z_);  // State at forward end of trajectory
-    ps_point z_bck(z_fwd);     // State at backward end of trajectory
+    trajectory_workspace& ws = this->trajectory_;
 
-    ps_point z_sample(z_fwd);
-    ps_point z_propose(z_fwd);
+    ws.z_fwd = this->z_;  // State at forward end of trajectory
+    ws.z_bck = this->z_;  // State at backward end of trajectory
+
+    ws.z_sample = this->z_;
+    ws.z_propose = this->z_;
 
     // Momentum and sharp momentum at forward end of forward subtree
-    Eigen::VectorXd p_fwd_fwd = this->z_.p;
-    Eigen::VectorXd p_sharp_fwd_fwd = this->hamiltonian_.dtau_dp(this->z_);
+    ws.p_fwd_fwd = this->z_.p;
+    this->hamiltonian_.eval_dtau_dp(this->z_, ws.p_sharp_fwd_fwd);
 
     // Momentum and sharp momentum at backward end of forward subtree
-    Eigen::VectorXd p_fwd_bck = this->z_.p;
-    Eigen::VectorXd p_sharp_fwd_bck = p_sharp_fwd_fwd;
+    ws.p_fwd_bck = this->z_.p;
+    ws.p_sharp_fwd_bck = ws.p_sharp_fwd_fwd;
 
     // Momentum and sharp momentum at forward end of backward subtree
-    Eigen::VectorXd p_bck_fwd = this->z_.p;
-    Eigen::VectorXd p_sharp_bck_fwd = p_sharp_fwd_fwd;
+    ws.p_bck_fwd = this->z_.p;
+    ws.p_sharp_bck_fwd = ws.p_sharp_fwd_fwd;
 
     // Momentum and sharp momentum at backward end of backward subtree
-    Eigen::VectorXd p_bck_bck = this->z_.p;
-    Eigen::VectorXd p_sharp_bck_bck = p_sharp_fwd_fwd;
+    ws.p_bck_bck = this->z_.p;
+    ws.p_sharp_bck_bck = ws.p_sharp_fwd_fwd;
 
     // Integrated momenta along trajectory
-    Eigen::VectorXd rho = this->z_.p.transpose();
+    ws.rho = this->z_.p;
 
     // Log sum of state weights (offset by H0) along trajectory
     double log_sum_weight = 0;  // log(exp(H0 - H0))
@@ -122,36 +127,36 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
 
     while (this->depth_ < this->max_depth_) {
       // Build a new subtree in a random direction
-      Eigen::VectorXd rho_fwd = Eigen::VectorXd::Zero(rho.size());
-      Eigen::VectorXd rho_bck = Eigen::VectorXd::Zero(rho.size());
+      ws.rho_fwd.setZero();
+      ws.rho_bck.setZero();
 
       bool valid_subtree = false;
       double log_sum_weight_subtree = -std::numeric_limits<double>::infinity();
 
       if (this->rand_uniform_() > 0.5) {
         // Extend the current trajectory forward
-        this->z_.ps_point::operator=(z_fwd);
-        rho_bck = rho;
-        p_bck_fwd = p_fwd_fwd;
-        p_sharp_bck_fwd = p_sharp_fwd_fwd;
+        this->z_.ps_point::operator=(ws.z_fwd);
+        ws.rho_bck = ws.rho;
+        ws.p_bck_fwd = ws.p_fwd_fwd;
+        ws.p_sharp_bck_fwd = ws.p_sharp_fwd_fwd;
 
         valid_subtree = build_tree(
-            this->depth_, z_propose, p_sharp_fwd_bck, p_sharp_fwd_fwd, rho_fwd,
-            p_fwd_bck, p_fwd_fwd, H0, 1, n_leapfrog, log_sum_weight_subtree,
-            sum_metro_prob, logger);
-        z_fwd.ps_point::operator=(this->z_);
+            this->depth_, ws.z_propose, ws.p_sharp_fwd_bck, ws.p_sharp_fwd_fwd,
+            ws.rho_fwd, ws.p_fwd_bck, ws.p_fwd_fwd, H0, 1, n_leapfrog,
+            log_sum_weight_subtree, sum_metro_prob, logger);
+        ws.z_fwd = this->z_;
       } else {
         // Extend the current trajectory backwards
-        this->z_.ps_point::operator=(z_bck);
-        rho_fwd = rho;
-        p_fwd_bck = p_bck_bck;
-        p_sharp_fwd_bck = p_sharp_bck_bck;
+        this->z_.ps_point::operator=(ws.z_bck);
+        ws.rho_fwd = ws.rho;
+        ws.p_fwd_bck = ws.p_bck_bck;
+        ws.p_sharp_fwd_bck = ws.p_sharp_bck_bck;
 
         valid_subtree = build_tree(
-            this->depth_, z_propose, p_sharp_bck_fwd, p_sharp_bck_bck, rho_bck,
-            p_bck_fwd, p_bck_bck, H0, -1, n_leapfrog, log_sum_weight_subtree,
-            sum_metro_prob, logger);
-        z_bck.ps_point::operator=(this->z_);
+            this->depth_, ws.z_propose, ws.p_sharp_bck_fwd, ws.p_sharp_bck_bck,
+            ws.rho_bck, ws.p_bck_fwd, ws.p_bck_bck, H0, -1, n_leapfrog,
+            log_sum_weight_subtree, sum_metro_prob, logger);
+        ws.z_bck = this->z_;
       }
 
       if (!valid_subtree)
@@ -161,32 +166,32 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
       ++(this->depth_);
 
       if (log_sum_weight_subtree > log_sum_weight) {
-        z_sample = z_propose;
+        ws.z_sample = ws.z_propose;
       } else {
         double accept_prob = std::exp(log_sum_weight_subtree - log_sum_weight);
         if (this->rand_uniform_() < accept_prob)
-          z_sample = z_propose;
+          ws.z_sample = ws.z_propose;
       }
 
       log_sum_weight
           = math::log_sum_exp(log_sum_weight, log_sum_weight_subtree);
 
       // Break when no-u-turn criterion is no longer satisfied
-      rho = rho_bck + rho_fwd;
+      ws.rho = ws.rho_bck + ws.rho_fwd;
 
       // Demand satisfaction around merged subtrees
       bool persist_criterion
-          = compute_criterion(p_sharp_bck_bck, p_sharp_fwd_fwd, rho);
+          = compute_criterion(ws.p_sharp_bck_bck, ws.p_sharp_fwd_fwd, ws.rho);
 
       // Demand satisfaction between subtrees
-      Eigen::VectorXd rho_extended = rho_bck + p_fwd_bck;
+      ws.rho_extended = ws.rho_bck + ws.p_fwd_bck;
 
-      persist_criterion
-          &= compute_criterion(p_sharp_bck_bck, p_sharp_fwd_bck, rho_extended);
+      persist_criterion &= compute_criterion(
+          ws.p_sharp_bck_bck, ws.p_sharp_fwd_bck, ws.rho_extended);
 
-      rho_extended = rho_fwd + p_bck_fwd;
-      persist_criterion
-          &= compute_criterion(p_sharp_bck_fwd, p_sharp_fwd_fwd, rho_extended);
+      ws.rho_extended = ws.rho_fwd + ws.p_bck_fwd;
+      persist_criterion &= compute_criterion(
+          ws.p_sharp_bck_fwd, ws.p_sharp_fwd_fwd, ws.rho_extended);
 
       if (!persist_criterion)
         break;
@@ -198,7 +203,7 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
     // even over subtrees that may have been rejected
     double accept_prob = sum_metro_prob / static_cast<double>(n_leapfrog);
 
-    this->z_.ps_point::operator=(z_sample);
+    this->z_.ps_point::operator=(ws.z_sample);
     this->energy_ = this->hamiltonian_.H(this->z_);
     return sample(this->z_.q, -this->z_.V, accept_prob);
   }
@@ -219,6 +224,11 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
     values.push_back(this->energy_);
   }
 
+  void collect_telemetry(callbacks::transition_stats& stats) {
+    base_hmc<Model, Hamiltonian, Integrator, BaseRNG>::collect_telemetry(stats);
+    stats.tree_depth = this->depth_;
+  }
+
   virtual bool compute_criterion(Eigen::VectorXd& p_sharp_minus,
                                  Eigen::VectorXd& p_sharp_plus,
                                  Eigen::VectorXd& rho) {
@@ -271,7 +281,7 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
 
       z_propose = this->z_;
 
-      p_sharp_beg = this->hamiltonian_.dtau_dp(this->z_);
+      this->hamiltonian_.eval_dtau_dp(this->z_, p_sharp_beg);
       p_sharp_end = p_sharp_beg;
 
       rho += this->z_.p;
@@ -281,39 +291,36 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
       return !this->divergent_;
     }
     // General recursion
+    subtree_workspace& ws = subtree_workspace_at(depth);
 
     // Build the initial subtree
     double log_sum_weight_init = -std::numeric_limits<double>::infinity();
 
     // Momentum and sharp momentum at end of the initial subtree
-    Eigen::VectorXd p_init_end(this->z_.p.size());
-    Eigen::VectorXd p_sharp_init_end(this->z_.p.size());
-
-    Eigen::VectorXd rho_init = Eigen::VectorXd::Zero(rho.size());
+    // are stored in ws.p_init_end and ws.p_sharp_init_end
+    ws.rho_init.setZero();
 
     bool valid_init
-        = build_tree(depth - 1, z_propose, p_sharp_beg, p_sharp_init_end,
-                     rho_init, p_beg, p_init_end, H0, sign, n_leapfrog,
+        = build_tree(depth - 1, z_propose, p_sharp_beg, ws.p_sharp_init_end,
+                     ws.rho_init, p_beg, ws.p_init_end, H0, sign, n_leapfrog,
                      log_sum_weight_init, sum_metro_prob, logger);
 
     if (!valid_init)
       return false;
 
     // Build the final subtree
-    ps_point z_propose_final(this->z_);
+    ws.z_propose_final = this->z_;
 
     double log_sum_weight_final = -std::numeric_limits<double>::infinity();
 
     // Momentum and sharp momentum at beginning of the final subtree
-    Eigen::VectorXd p_final_beg(this->z_.p.size());
-    Eigen::VectorXd p_sharp_final_beg(this->z_.p.size());
-
-    Eigen::VectorXd rho_final = Eigen::VectorXd::Zero(rho.size());
+    // are stored in ws.p_final_beg and ws.p_sharp_final_beg
+    ws.rho_final.setZero();
 
-    bool valid_final
-        = build_tree(depth - 1, z_propose_final, p_sharp_final_beg, p_sharp_end,
-                     rho_final, p_final_beg, p_end, H0, sign, n_leapfrog,
-                     log_sum_weight_final, sum_metro_prob, logger);
+    bool valid_final = build_tree(
+        depth - 1, ws.z_propose_final, ws.p_sharp_final_beg, p_sharp_end,
+        ws.rho_final, ws.p_final_beg, p_end, H0, sign, n_leapfrog,
+        log_sum_weight_final, sum_metro_prob, logger);
 
     if (!valid_final)
       return false;
@@ -324,29 +331,29 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
     log_sum_weight = math::log_sum_exp(log_sum_weight, log_sum_weight_subtree);
 
     if (log_sum_weight_final > log_sum_weight_subtree) {
-      z_propose = z_propose_final;
+      z_propose = ws.z_propose_final;
     } else {
       double accept_prob
           = std::exp(log_sum_weight_final - log_sum_weight_subtree);
       if (this->rand_uniform_() < accept_prob)
-        z_propose = z_propose_final;
+        z_propose = ws.z_propose_final;
     }
 
-    Eigen::VectorXd rho_subtree = rho_init + rho_final;
-    rho += rho_subtree;
+    ws.rho_subtree = ws.rho_init + ws.rho_final;
+    rho += ws.rho_subtree;
 
     // Demand satisfaction around merged subtrees
     bool persist_criterion
-        = compute_criterion(p_sharp_beg, p_sharp_end, rho_subtree);
+        = compute_criterion(p_sharp_beg, p_sharp_end, ws.rho_subtree);
 
     // Demand satisfaction between subtrees
-    rho_subtree = rho_init + p_final_beg;
+    ws.rho_subtree = ws.rho_init + ws.p_final_beg;
     persist_criterion
-        &= compute_criterion(p_sharp_beg, p_sharp_final_beg, rho_subtree);
+        &= compute_criterion(p_sharp_beg, ws.p_sharp_final_beg, ws.rho_subtree);
 
-    rho_subtree = rho_final + p_init_end;
+    ws.rho_subtree = ws.rho_final + ws.p_init_end;
     persist_criterion
-        &= compute_criterion(p_sharp_init_end, p_sharp_end, rho_subtree);
+        &= compute_criterion(ws.p_sharp_init_end, p_sharp_end, ws.rho_subtree);
 
     return persist_criterion;
   }
@@ -358,6 +365,95 @@ class base_nuts : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
   int n_leapfrog_;
   bool divergent_;
   double energy_;
+
+ protected:
+  /**
+   * Storage for the state carried along the whole trajectory in
+   * <code>transition()</code>, sized once at construction.
+   */
+  struct trajectory_workspace {
+    explicit trajectory_workspace(Eigen::Index n)
+        : z_fwd(n),
+          z_bck(n),
+          z_sample(n),
+          z_propose(n),
+          p_fwd_fwd(n),
+          p_sharp_fwd_fwd(n),
+          p_fwd_bck(n),
+          p_sharp_fwd_bck(n),
+          p_bck_fwd(n),
+          p_sharp_bck_fwd(n),
+          p_bck_bck(n),
+          p_sharp_bck_bck(n),
+          rho(n),
+          rho_fwd(n),
+          rho_bck(n),
+          rho_extended(n) {}
+
+    ps_point z_fwd;
+    ps_point z_bck;
+    ps_point z_sample;
+    ps_point z_propose;
+    Eigen::VectorXd p_fwd_fwd;
+    Eigen::VectorXd p_sharp_fwd_fwd;
+    Eigen::VectorXd p_fwd_bck;
+    Eigen::VectorXd p_sharp_fwd_bck;
+    Eigen::VectorXd p_bck_fwd;
+    Eigen::VectorXd p_sharp_bck_fwd;
+    Eigen::VectorXd p_bck_bck;
+    Eigen::VectorXd p_sharp_bck_bck;
+    Eigen::VectorXd rho;
+    Eigen::VectorXd rho_fwd;
+    Eigen::VectorXd rho_bck;
+    Eigen::VectorXd rho_extended;
+  };
+
+  /**
+   * Storage for the intermediate state of one level of
+   * <code>build_tree()</code>.  Each depth owns its own buffers so that
+   * nested calls never overwrite the state of their callers.
+   */
+  struct subtree_workspace {
+    explicit subtree_workspace(Eigen::Index n)
+        : z_propose_final(n),
+          p_init_end(n),
+          p_sharp_init_end(n),
+          rho_init(n),
+          p_final_beg(n),
+          p_sharp_final_beg(n),
+          rho_final(n),
+          rho_subtree(n) {}
+
+    ps_point z_propose_final;
+    Eigen::VectorXd p_init_end;
+    Eigen::VectorXd p_sharp_init_end;
+    Eigen::VectorXd rho_init;
+    Eigen::VectorXd p_final_beg;
+    Eigen::VectorXd p_sharp_final_beg;
+    Eigen::VectorXd rho_final;
+    Eigen::VectorXd rho_subtree;
+  };
+
+  /**
+   * Return the workspace for a subtree of the given depth, allocating
+   * workspaces up to that depth the first time it is reached.
+   *
+   * Trees are always built from the deepest level down, so the
+   * workspaces only grow at the outermost call of
+   * <code>build_tree()</code>, before any reference into them is held.
+   *
+   * @param depth Depth of the subtree, at least one
+   * @return Workspace for the subtree
+   */
+  subtree_workspace& subtree_workspace_at(int depth) {
+    const Eigen::Index n = this->z_.q.size();
+    while (static_cast<int>(subtree_workspaces_.size()) < depth)
+      subtree_workspaces_.emplace_back(n);
+    return subtree_workspaces_[depth - 1];
+  }
+
+  trajectory_workspace trajectory_;
+  std::vector<subtree_workspace> subtree_workspaces_;
 };
 
 }  // namespace mcmc
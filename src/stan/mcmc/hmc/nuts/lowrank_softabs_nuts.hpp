@@ -0,0 +1,49 @@
+#ifndef STAN_MCMC_HMC_NUTS_LOWRANK_SOFTABS_NUTS_HPP
+#define STAN_MCMC_HMC_NUTS_LOWRANK_SOFTABS_NUTS_HPP
+
+#include <stan/mcmc/hmc/nuts/base_nuts.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_softabs_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_softabs_metric.hpp>
+#include <stan/mcmc/hmc/integrators/impl_leapfrog.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+namespace mcmc {
+/**
+ * The No-U-Turn sampler (NUTS) with multinomial sampling
+ * with a Gaussian-Riemannian disintegration and truncated,
+ * matrix-free SoftAbs metric
+ */
+template <class Model, class BaseRNG>
+class lowrank_softabs_nuts
+    : public base_nuts<Model, lowrank_softabs_metric, impl_leapfrog,
+                       BaseRNG> {
+ public:
+  lowrank_softabs_nuts(const Model& model, BaseRNG& rng)
+      : base_nuts<Model, lowrank_softabs_metric, impl_leapfrog, BaseRNG>(
+          model, rng) {}
+
+  /**
+   * Return a transition from the specified sample.  The gradients of
+   * the truncated metric are exact only when every eigenpair of the
+   * Hessian is resolved, so ranks below the number of parameters are
+   * rejected.
+   *
+   * @throw std::invalid_argument if the rank of the point is less than
+   *   the number of parameters
+   */
+  sample transition(sample& init_sample, callbacks::logger& logger) {
+    if (this->z_.rank < this->z_.q.size())
+      throw std::invalid_argument(
+          "lowrank_softabs rank is " + std::to_string(this->z_.rank)
+          + ", but must be at least the number of parameters, "
+          + std::to_string(this->z_.q.size()));
+    return base_nuts<Model, lowrank_softabs_metric, impl_leapfrog,
+                     BaseRNG>::transition(init_sample, logger);
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+#endif
@@ -29,8 +29,9 @@ class adapt_dense_e_nuts_classic : public dense_e_nuts_classic<Model, BaseRNG>,
       this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
                                                 s.accept_stat());
 
-      bool update = this->covar_adaptation_.learn_covariance(
-          this->z_.inv_e_metric_, this->z_.q);
+      bool update = this->z_.update_metric([this](Eigen::MatrixXd& covar) {
+        return this->covar_adaptation_.learn_covariance(covar, this->z_.q);
+      });
 
       if (update) {
         this->init_stepsize(logger);
@@ -19,11 +19,11 @@ class dense_e_nuts_classic
                                                                          rng) {}
 
   // Note that the points don't need to be swapped
-  // here since start.inv_e_metric_ = finish.inv_e_metric_
+  // here since start.inv_e_metric() = finish.inv_e_metric()
   bool compute_criterion(ps_point& start, dense_e_point& finish,
                          Eigen::VectorXd& rho) {
-    return finish.p.transpose() * finish.inv_e_metric_ * (rho - finish.p) > 0
-           && start.p.transpose() * finish.inv_e_metric_ * (rho - start.p) > 0;
+    return finish.p.transpose() * finish.inv_e_metric() * (rho - finish.p) > 0
+           && start.p.transpose() * finish.inv_e_metric() * (rho - start.p) > 0;
   }
 };
 
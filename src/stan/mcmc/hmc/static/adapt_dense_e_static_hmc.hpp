@@ -32,8 +32,9 @@ class adapt_dense_e_static_hmc : public dense_e_static_hmc<Model, BaseRNG>,
                                                 s.accept_stat());
       this->update_L_();
 
-      bool update = this->covar_adaptation_.learn_covariance(
-          this->z_.inv_e_metric_, this->z_.q);
+      bool update = this->z_.update_metric([this](Eigen::MatrixXd& covar) {
+        return this->covar_adaptation_.learn_covariance(covar, this->z_.q);
+      });
 
       if (update) {
         this->init_stepsize(logger);
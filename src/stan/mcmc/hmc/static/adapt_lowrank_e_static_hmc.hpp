@@ -0,0 +1,58 @@
+#ifndef STAN_MCMC_HMC_STATIC_ADAPT_LOWRANK_E_STATIC_HMC_HPP
+#define STAN_MCMC_HMC_STATIC_ADAPT_LOWRANK_E_STATIC_HMC_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/mcmc/hmc/static/lowrank_e_static_hmc.hpp>
+#include <stan/mcmc/stepsize_lowrank_adapter.hpp>
+
+namespace stan {
+namespace mcmc {
+/**
+ * Hamiltonian Monte Carlo implementation using the endpoint
+ * of trajectories with a static integration time with a
+ * Gaussian-Euclidean disintegration and adaptive diagonal plus
+ * low-rank metric and adaptive step size
+ */
+template <class Model, class BaseRNG>
+class adapt_lowrank_e_static_hmc : public lowrank_e_static_hmc<Model, BaseRNG>,
+                                   public stepsize_lowrank_adapter {
+ public:
+  adapt_lowrank_e_static_hmc(const Model& model, BaseRNG& rng, int rank)
+      : lowrank_e_static_hmc<Model, BaseRNG>(model, rng),
+        stepsize_lowrank_adapter(model.num_params_r(), rank) {}
+
+  ~adapt_lowrank_e_static_hmc() {}
+
+  sample transition(sample& init_sample, callbacks::logger& logger) {
+    sample s
+        = lowrank_e_static_hmc<Model, BaseRNG>::transition(init_sample, logger);
+
+    if (this->adapt_flag_) {
+      this->stepsize_adaptation_.learn_stepsize(this->nom_epsilon_,
+                                                s.accept_stat());
+      this->update_L_();
+
+      bool update = this->lowrank_adaptation_.learn_metric(
+          this->z_.inv_e_metric_, this->z_.inv_e_metric_lowrank_, this->z_.q);
+
+      if (update) {
+        this->z_.factor_metric();
+        this->init_stepsize(logger);
+        this->update_L_();
+
+        this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
+        this->stepsize_adaptation_.restart();
+      }
+    }
+    return s;
+  }
+
+  void disengage_adaptation() {
+    base_adapter::disengage_adaptation();
+    this->stepsize_adaptation_.complete_adaptation(this->nom_epsilon_);
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+#endif
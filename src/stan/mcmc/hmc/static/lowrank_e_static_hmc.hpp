@@ -0,0 +1,36 @@
+#ifndef STAN_MCMC_HMC_STATIC_LOWRANK_E_STATIC_HMC_HPP
+#define STAN_MCMC_HMC_STATIC_LOWRANK_E_STATIC_HMC_HPP
+
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+#include <stan/mcmc/hmc/static/base_static_hmc.hpp>
+
+namespace stan {
+namespace mcmc {
+/**
+ * Hamiltonian Monte Carlo implementation using the endpoint
+ * of trajectories with a static integration time with a
+ * Gaussian-Euclidean disintegration and diagonal plus low-rank metric
+ */
+template <class Model, class BaseRNG>
+class lowrank_e_static_hmc
+    : public base_static_hmc<Model, lowrank_e_metric, expl_leapfrog,
+                             BaseRNG> {
+ public:
+  lowrank_e_static_hmc(const Model& model, BaseRNG& rng)
+      : base_static_hmc<Model, lowrank_e_metric, expl_leapfrog, BaseRNG>(
+          model, rng) {}
+
+  using base_static_hmc<Model, lowrank_e_metric, expl_leapfrog,
+                        BaseRNG>::set_metric;
+
+  void set_metric(const Eigen::VectorXd& inv_e_metric,
+                  const Eigen::MatrixXd& inv_e_metric_lowrank) {
+    this->z_.set_metric(inv_e_metric, inv_e_metric_lowrank);
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+#endif
@@ -0,0 +1,50 @@
+#ifndef STAN_MCMC_HMC_STATIC_LOWRANK_SOFTABS_STATIC_HMC_HPP
+#define STAN_MCMC_HMC_STATIC_LOWRANK_SOFTABS_STATIC_HMC_HPP
+
+#include <stan/mcmc/hmc/hamiltonians/lowrank_softabs_point.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_softabs_metric.hpp>
+#include <stan/mcmc/hmc/integrators/impl_leapfrog.hpp>
+#include <stan/mcmc/hmc/static/base_static_hmc.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+namespace mcmc {
+/**
+ * Hamiltonian Monte Carlo implementation using the endpoint
+ * of trajectories with a static integration time with a
+ * Gaussian-Riemannian disintegration and truncated,
+ * matrix-free SoftAbs metric
+ */
+template <class Model, class BaseRNG>
+class lowrank_softabs_static_hmc
+    : public base_static_hmc<Model, lowrank_softabs_metric, impl_leapfrog,
+                             BaseRNG> {
+ public:
+  lowrank_softabs_static_hmc(const Model& model, BaseRNG& rng)
+      : base_static_hmc<Model, lowrank_softabs_metric, impl_leapfrog,
+                        BaseRNG>(model, rng) {}
+
+  /**
+   * Return a transition from the specified sample.  The gradients of
+   * the truncated metric are exact only when every eigenpair of the
+   * Hessian is resolved, so ranks below the number of parameters are
+   * rejected.
+   *
+   * @throw std::invalid_argument if the rank of the point is less than
+   *   the number of parameters
+   */
+  sample transition(sample& init_sample, callbacks::logger& logger) {
+    if (this->z_.rank < this->z_.q.size())
+      throw std::invalid_argument(
+          "lowrank_softabs rank is " + std::to_string(this->z_.rank)
+          + ", but must be at least the number of parameters, "
+          + std::to_string(this->z_.q.size()));
+    return base_static_hmc<Model, lowrank_softabs_metric, impl_leapfrog,
+                           BaseRNG>::transition(init_sample, logger);
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+#endif
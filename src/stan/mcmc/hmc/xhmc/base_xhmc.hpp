@@ -140,6 +140,11 @@ class base_xhmc : public base_hmc<Model, Hamiltonian, Integrator, BaseRNG> {
     values.push_back(this->energy_);
   }
 
+  void collect_telemetry(callbacks::transition_stats& stats) {
+    base_hmc<Model, Hamiltonian, Integrator, BaseRNG>::collect_telemetry(stats);
+    stats.tree_depth = this->depth_;
+  }
+
   /**
    * Recursively build a new subtree to completion or until
    * the subtree becomes invalid.  Returns validity of the
@@ -0,0 +1,184 @@
+#ifndef STAN_MCMC_LOWRANK_ADAPTATION_HPP
+#define STAN_MCMC_LOWRANK_ADAPTATION_HPP
+
+#include <stan/math/prim.hpp>
+#include <stan/mcmc/windowed_adaptation.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+
+namespace mcmc {
+
+/**
+ * Windowed adaptation of a diagonal plus low-rank inverse metric.
+ *
+ * <p>The diagonal is the regularized sample variance of each window,
+ * exactly as in <code>var_adaptation</code>.  The low-rank part captures
+ * the leading correlations: the draws of the window are standardized by
+ * the diagonal, the leading eigenpairs of their sample covariance are
+ * found with a randomized subspace iteration, and each eigenvalue
+ * greater than one contributes the excess variance along its
+ * eigenvector.  Only the draws of the current window are kept, so
+ * memory and time are linear in the number of parameters rather than
+ * quadratic as for <code>covar_adaptation</code>.
+ */
+class lowrank_adaptation : public windowed_adaptation {
+ public:
+  /**
+   * Construct an adaptation for the specified dimension and rank.
+   *
+   * @param n number of parameters
+   * @param rank maximum rank of the low-rank part of the metric
+   */
+  lowrank_adaptation(int n, int rank)
+      : windowed_adaptation("low-rank covariance"),
+        estimator_(n),
+        rank_(std::max(rank, 0)),
+        rng_(0) {}
+
+  /**
+   * Set the maximum rank of the low-rank part of the metric.
+   *
+   * @param rank maximum rank, at least zero
+   */
+  void set_rank(int rank) { rank_ = std::max(rank, 0); }
+
+  int get_rank() const { return rank_; }
+
+  /**
+   * Add a draw to the current window and, at the end of a window,
+   * update the inverse metric.
+   *
+   * @param[in, out] var diagonal of the inverse metric
+   * @param[in, out] lowrank low-rank part of the inverse metric, one
+   * column per rank
+   * @param[in] q draw of the unconstrained parameters
+   * @return true if the metric was updated
+   * @throw std::runtime_error if the updated metric is not finite
+   */
+  bool learn_metric(Eigen::VectorXd& var, Eigen::MatrixXd& lowrank,
+                    const Eigen::VectorXd& q) {
+    if (adaptation_window()) {
+      estimator_.add_sample(q);
+      draws_.push_back(q);
+    }
+
+    if (end_adaptation_window()) {
+      compute_next_window();
+
+      estimator_.sample_variance(var);
+
+      double n = static_cast<double>(estimator_.num_samples());
+      var = (n / (n + 5.0)) * var
+            + 1e-3 * (5.0 / (n + 5.0)) * Eigen::VectorXd::Ones(var.size());
+
+      compute_lowrank(var, n / (n + 5.0), lowrank);
+
+      if (!var.allFinite() || !lowrank.allFinite())
+        throw std::runtime_error(
+            "Numerical overflow in metric adaptation. "
+            "This occurs when the sampler encounters extreme values on the "
+            "unconstrained space; this may happen when the posterior density "
+            "function is too wide or improper. "
+            "There may be problems with your model specification.");
+
+      estimator_.restart();
+      draws_.clear();
+
+      ++adapt_window_counter_;
+      return true;
+    }
+
+    ++adapt_window_counter_;
+    return false;
+  }
+
+ protected:
+  /**
+   * Compute the low-rank part of the inverse metric from the draws of
+   * the current window.
+   *
+   * @param[in] var regularized diagonal of the inverse metric
+   * @param[in] shrinkage weight of the excess variance
+   * @param[out] lowrank low-rank part, with at most <code>rank_</code>
+   * columns
+   */
+  void compute_lowrank(const Eigen::VectorXd& var, double shrinkage,
+                       Eigen::MatrixXd& lowrank) {
+    const Eigen::Index d = var.size();
+    const Eigen::Index n = draws_.size();
+    const Eigen::Index k = std::min<Eigen::Index>({rank_, d, n - 1});
+    if (k <= 0) {
+      lowrank.resize(d, 0);
+      return;
+    }
+
+    // Standardized, centered draws Z, so that Z * Z^T is the sample
+    // covariance of the standardized draws
+    Eigen::VectorXd mean = Eigen::VectorXd::Zero(d);
+    for (const auto& draw : draws_)
+      mean += draw;
+    mean /= static_cast<double>(n);
+    const Eigen::VectorXd inv_sd = var.array().rsqrt();
+    const double scale = 1 / std::sqrt(static_cast<double>(n - 1));
+    Eigen::MatrixXd Z(d, n);
+    for (Eigen::Index j = 0; j < n; ++j)
+      Z.col(j) = scale * inv_sd.cwiseProduct(draws_[j] - mean);
+
+    // Randomized subspace iteration for the leading eigenvectors of
+    // Z * Z^T, starting from a random combination of the draws
+    const Eigen::Index l = std::min<Eigen::Index>({k + 10, d, n});
+    boost::random::normal_distribution<double> std_normal;
+    Eigen::MatrixXd omega(n, l);
+    for (Eigen::Index j = 0; j < l; ++j)
+      for (Eigen::Index i = 0; i < n; ++i)
+        omega(i, j) = std_normal(rng_);
+    Eigen::MatrixXd Q = orthonormalize(Z * omega);
+    for (int iter = 0; iter < 2; ++iter)
+      Q = orthonormalize(Z * (Z.transpose() * Q));
+
+    // Rayleigh-Ritz on the subspace
+    Eigen::MatrixXd B = Q.transpose() * Z;
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(B * B.transpose());
+    const Eigen::VectorXd& lambda = solver.eigenvalues();
+    const Eigen::VectorXd sd = var.array().sqrt();
+
+    // Eigenvalues are in increasing order; keep the largest that exceed
+    // the variance already captured by the diagonal
+    Eigen::Index rank = 0;
+    while (rank < k && lambda(l - 1 - rank) > 1)
+      ++rank;
+    lowrank.resize(d, rank);
+    for (Eigen::Index j = 0; j < rank; ++j) {
+      const Eigen::Index e = l - 1 - j;
+      lowrank.col(j) = std::sqrt(shrinkage * (lambda(e) - 1))
+                       * sd.cwiseProduct(Q * solver.eigenvectors().col(e));
+    }
+  }
+
+  /**
+   * Return an orthonormal basis of the column space of a matrix with at
+   * least as many rows as columns.
+   *
+   * @param x matrix
+   */
+  static Eigen::MatrixXd orthonormalize(const Eigen::MatrixXd& x) {
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(x);
+    return qr.householderQ() * Eigen::MatrixXd::Identity(x.rows(), x.cols());
+  }
+
+  stan::math::welford_var_estimator estimator_;
+  int rank_;
+  std::vector<Eigen::VectorXd> draws_;
+  boost::random::mt19937 rng_;
+};
+
+}  // namespace mcmc
+
+}  // namespace stan
+#endif
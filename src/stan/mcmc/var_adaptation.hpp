@@ -12,7 +12,7 @@ namespace mcmc {
 class var_adaptation : public windowed_adaptation {
  public:
   explicit var_adaptation(int n)
-      : windowed_adaptation("variance"), estimator_(n) {}
+      : windowed_adaptation("variance"), estimator_(n), pooled_(false) {}
 
   bool learn_variance(Eigen::VectorXd& var, const Eigen::VectorXd& q) {
     if (adaptation_window())
@@ -20,24 +20,14 @@ class var_adaptation : public windowed_adaptation {
 
     if (end_adaptation_window()) {
       compute_next_window();
+      ++adapt_window_counter_;
 
-      estimator_.sample_variance(var);
-
-      double n = static_cast<double>(estimator_.num_samples());
-      var = (n / (n + 5.0)) * var
-            + 1e-3 * (5.0 / (n + 5.0)) * Eigen::VectorXd::Ones(var.size());
-
-      if (!var.allFinite())
-        throw std::runtime_error(
-            "Numerical overflow in metric adaptation. "
-            "This occurs when the sampler encounters extreme values on the "
-            "unconstrained space; this may happen when the posterior density "
-            "function is too wide or improper. "
-            "There may be problems with your model specification.");
+      if (pooled_)
+        return false;
 
+      estimator_.sample_variance(var);
+      regularize(var, estimator_.num_samples());
       estimator_.restart();
-
-      ++adapt_window_counter_;
       return true;
     }
 
@@ -45,8 +35,77 @@ class var_adaptation : public windowed_adaptation {
     return false;
   }
 
+  /**
+   * Set whether the variance estimate is pooled across adaptations.  A
+   * pooled adaptation keeps its samples at the end of each adaptation
+   * window and leaves the variance untouched, so that the samples of
+   * several chains can be combined with <code>pool_variance</code>.
+   *
+   * @param pooled true to pool the variance estimate
+   */
+  void set_pooled(bool pooled) { pooled_ = pooled; }
+
+  bool pooled() const { return pooled_; }
+
+  /**
+   * Compute the regularized variance of the samples of all of the
+   * specified adaptations, as if a single adaptation had seen all of
+   * them, and restart their estimators.  The per-adaptation means and
+   * sums of squared deviations are combined pairwise.
+   *
+   * @param[in, out] adaptations adaptations to pool
+   * @param[out] var pooled variance
+   * @throw std::runtime_error if the variance overflows
+   */
+  static void pool_variance(const std::vector<var_adaptation*>& adaptations,
+                            Eigen::VectorXd& var) {
+    double n = 0;
+    Eigen::VectorXd mean = Eigen::VectorXd::Zero(var.size());
+    Eigen::VectorXd m2 = Eigen::VectorXd::Zero(var.size());
+    Eigen::VectorXd mean_a(var.size());
+    Eigen::VectorXd m2_a(var.size());
+    for (var_adaptation* a : adaptations) {
+      double n_a = a->estimator_.num_samples();
+      if (n_a == 0)
+        continue;
+      a->estimator_.sample_mean(mean_a);
+      m2_a.setZero();
+      if (n_a > 1) {
+        a->estimator_.sample_variance(m2_a);
+        m2_a *= n_a - 1;
+      }
+      Eigen::VectorXd delta = mean_a - mean;
+      double n_ab = n + n_a;
+      mean += (n_a / n_ab) * delta;
+      m2 += m2_a + (n * n_a / n_ab) * delta.cwiseProduct(delta);
+      n = n_ab;
+      a->estimator_.restart();
+    }
+    if (n > 1)
+      var = m2 / (n - 1);
+    regularize(var, n);
+  }
+
  protected:
+  /**
+   * Shrink the variance estimated from the specified number of samples
+   * towards a small multiple of the identity.
+   */
+  static void regularize(Eigen::VectorXd& var, double n) {
+    var = (n / (n + 5.0)) * var
+          + 1e-3 * (5.0 / (n + 5.0)) * Eigen::VectorXd::Ones(var.size());
+
+    if (!var.allFinite())
+      throw std::runtime_error(
+          "Numerical overflow in metric adaptation. "
+          "This occurs when the sampler encounters extreme values on the "
+          "unconstrained space; this may happen when the posterior density "
+          "function is too wide or improper. "
+          "There may be problems with your model specification.");
+  }
+
   stan::math::welford_var_estimator estimator_;
+  bool pooled_;
 };
 
 }  // namespace mcmc
@@ -5,6 +5,7 @@
 #include <stan/mcmc/base_adaptation.hpp>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace stan {
 namespace mcmc {
@@ -109,6 +110,47 @@ class windowed_adaptation : public base_adaptation {
     }
   }
 
+  /**
+   * Make the current slow adaptation window the last one and shorten
+   * warmup so that it finishes after the terminal buffer.  The window
+   * still runs to its scheduled end, so the final metric is estimated
+   * from a full window rather than from the few draws it may hold when
+   * this is called.  This has no effect before the first slow
+   * adaptation window or once the current window is already the last.
+   *
+   * @return true if warmup was shortened
+   */
+  bool end_adaptation_early() {
+    if (adapt_window_counter_ < adapt_init_buffer_
+        || adapt_next_window_ + adapt_term_buffer_ + 1 >= num_warmup_)
+      return false;
+    num_warmup_ = adapt_next_window_ + adapt_term_buffer_ + 1;
+    return true;
+  }
+
+  unsigned int num_warmup() const { return num_warmup_; }
+
+  /**
+   * Return the warmup iterations, counted from the start of warmup, at
+   * which the remaining adaptation windows end.  The windows are found
+   * by stepping a copy of this adaptation, so this is the schedule its
+   * own updates will follow.
+   *
+   * @return iterations ending an adaptation window, in increasing order
+   */
+  std::vector<unsigned int> adaptation_window_ends() const {
+    windowed_adaptation schedule(*this);
+    std::vector<unsigned int> ends;
+    for (; schedule.adapt_window_counter_ < schedule.num_warmup_;
+         ++schedule.adapt_window_counter_) {
+      if (schedule.end_adaptation_window()) {
+        ends.push_back(schedule.adapt_window_counter_);
+        schedule.compute_next_window();
+      }
+    }
+    return ends;
+  }
+
  protected:
   std::string estimator_name_;
 
@@ -2,11 +2,154 @@
 #define STAN_MODEL_FINITE_DIFF_GRAD_HPP
 
 #include <stan/callbacks/interrupt.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace stan {
 namespace model {
+namespace internal {
+
+/**
+ * Compute central finite differences of the log density along a
+ * sequence of perturbations.  The <code>k</code>-th difference is
+ * <code>(log_prob(x + epsilon v_k) - log_prob(x - epsilon v_k)) /
+ * (2 epsilon)</code>, where the perturbation functor applies
+ * <code>x + h v_k</code> to a copy of the parameters.
+ *
+ * <p>When the program is built with <code>STAN_THREADS</code>, the
+ * differences are computed in rounds that are distributed over the TBB
+ * thread pool; otherwise they are computed serially, one per round.
+ * The interrupt callback is called on the calling thread before each
+ * round.  Messages are buffered per difference and written to the
+ * stream in order, so the output does not depend on the number of
+ * threads.
+ *
+ * @tparam F Type of perturbation functor with signature
+ * <code>void(size_t k, double h, std::vector<double>& x)</code>, which
+ * sets <code>x</code> to the parameters plus <code>h v_k</code>, given
+ * that <code>x</code> holds the unperturbed parameters, and which
+ * restores them when called with <code>h = 0</code>.
+ * @param[in] model Model.
+ * @param[in,out] interrupt Interrupt callback.
+ * @param[in] params_r Real-valued parameters.
+ * @param[in] params_i Integer-valued parameters.
+ * @param[in] n Number of perturbations.
+ * @param[in] perturb Perturbation functor.
+ * @param[in] epsilon Size of the perturbation.
+ * @param[out] diffs Finite differences, one per perturbation.
+ * @param[in,out] msgs Stream to which messages are written, or null.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M, typename F>
+void central_differences(const M& model, stan::callbacks::interrupt& interrupt,
+                         const std::vector<double>& params_r,
+                         std::vector<int>& params_i, size_t n,
+                         const F& perturb, double epsilon,
+                         std::vector<double>& diffs, std::ostream* msgs) {
+#ifdef STAN_THREADS
+  const size_t round_size = 256;
+#else
+  const size_t round_size = 1;
+#endif
+  diffs.resize(n);
+  std::vector<std::string> diff_msgs(msgs ? round_size : 0);
+  for (size_t round_begin = 0; round_begin < n; round_begin += round_size) {
+    interrupt();
+    const size_t round_end = std::min(n, round_begin + round_size);
+
+    const auto compute_range = [&](size_t begin, size_t end) {
+      std::stringstream ss;
+      std::vector<double> perturbed(params_r);
+      for (size_t k = begin; k < end; ++k) {
+        perturb(k, epsilon, perturbed);
+        double logp_plus
+            = model.template log_prob<propto, jacobian_adjust_transform>(
+                perturbed, params_i, msgs ? &ss : 0);
+        perturb(k, -epsilon, perturbed);
+        double logp_minus
+            = model.template log_prob<propto, jacobian_adjust_transform>(
+                perturbed, params_i, msgs ? &ss : 0);
+        perturb(k, 0, perturbed);
+        diffs[k] = (logp_plus - logp_minus) / (2 * epsilon);
+        if (msgs) {
+          diff_msgs[k - round_begin] = ss.str();
+          ss.str(std::string());
+        }
+      }
+    };
+
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<size_t>(round_begin, round_end),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        compute_range(r.begin(), r.end());
+                      });
+#else
+    compute_range(round_begin, round_end);
+#endif
+
+    if (msgs) {
+      for (size_t k = round_begin; k < round_end; ++k)
+        *msgs << diff_msgs[k - round_begin];
+    }
+  }
+}
+
+}  // namespace internal
+
+/**
+ * Compute the gradient using finite differences for the specified
+ * coordinates of the specified parameters, writing the result into the
+ * specified gradient, using the specified perturbation.  Each partial
+ * derivative costs two evaluations of the log density; they are
+ * computed in parallel when the program is built with
+ * <code>STAN_THREADS</code>.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam M Class of model.
+ * @param model Model.
+ * @param interrupt interrupt callback to be called before each round
+ *   of finite differences.
+ * @param params_r Real-valued parameters.
+ * @param params_i Integer-valued parameters.
+ * @param coordinates Indexes of the parameters to differentiate with
+ *   respect to.
+ * @param[out] grad Vector into which the partial derivatives are
+ *   written, in the order of the coordinates.
+ * @param epsilon
+ * @param[in,out] msgs
+ * @throw std::out_of_range if a coordinate is not an index of the
+ *   parameters.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void finite_diff_grad(const M& model, stan::callbacks::interrupt& interrupt,
+                      std::vector<double>& params_r, std::vector<int>& params_i,
+                      const std::vector<size_t>& coordinates,
+                      std::vector<double>& grad, double epsilon = 1e-6,
+                      std::ostream* msgs = 0) {
+  for (size_t coordinate : coordinates) {
+    if (coordinate >= params_r.size()) {
+      std::stringstream ss;
+      ss << "finite_diff_grad: coordinate " << coordinate
+         << " is out of range for " << params_r.size() << " parameters";
+      throw std::out_of_range(ss.str());
+    }
+  }
+  internal::central_differences<propto, jacobian_adjust_transform>(
+      model, interrupt, params_r, params_i, coordinates.size(),
+      [&](size_t k, double h, std::vector<double>& x) {
+        x[coordinates[k]] = params_r[coordinates[k]] + h;
+      },
+      epsilon, grad, msgs);
+}
 
 /**
  * Compute the gradient using finite differences for
@@ -20,8 +163,8 @@ namespace model {
  * log probability.
  * @tparam M Class of model.
  * @param model Model.
- * @param interrupt interrupt callback to be called before calculating
- *   the finite differences for each parameter.
+ * @param interrupt interrupt callback to be called before each round
+ *   of finite differences.
  * @param params_r Real-valued parameters.
  * @param params_i Integer-valued parameters.
  * @param[out] grad Vector into which gradient is written.
@@ -33,22 +176,59 @@ void finite_diff_grad(const M& model, stan::callbacks::interrupt& interrupt,
                       std::vector<double>& params_r, std::vector<int>& params_i,
                       std::vector<double>& grad, double epsilon = 1e-6,
                       std::ostream* msgs = 0) {
-  std::vector<double> perturbed(params_r);
-  grad.resize(params_r.size());
-  for (size_t k = 0; k < params_r.size(); k++) {
-    interrupt();
-    perturbed[k] += epsilon;
-    double logp_plus
-        = model.template log_prob<propto, jacobian_adjust_transform>(
-            perturbed, params_i, msgs);
-    perturbed[k] = params_r[k] - epsilon;
-    double logp_minus
-        = model.template log_prob<propto, jacobian_adjust_transform>(
-            perturbed, params_i, msgs);
-    double gradest = (logp_plus - logp_minus) / (2 * epsilon);
-    grad[k] = gradest;
-    perturbed[k] = params_r[k];
+  std::vector<size_t> coordinates(params_r.size());
+  for (size_t k = 0; k < coordinates.size(); ++k)
+    coordinates[k] = k;
+  finite_diff_grad<propto, jacobian_adjust_transform>(
+      model, interrupt, params_r, params_i, coordinates, grad, epsilon, msgs);
+}
+
+/**
+ * Compute directional derivatives of the log density using central
+ * finite differences, two evaluations of the log density per direction
+ * regardless of the number of parameters.  The derivative along
+ * direction <code>v</code> is the finite difference approximation to
+ * <code>grad^T v</code>.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam M Class of model.
+ * @param model Model.
+ * @param interrupt interrupt callback to be called before each round
+ *   of finite differences.
+ * @param params_r Real-valued parameters.
+ * @param params_i Integer-valued parameters.
+ * @param directions Directions, each the size of the parameters.
+ * @param[out] derivatives Vector into which the directional derivatives
+ *   are written, one per direction.
+ * @param epsilon
+ * @param[in,out] msgs
+ * @throw std::invalid_argument if the size of a direction does not
+ *   match the number of parameters.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void finite_diff_directional_derivatives(
+    const M& model, stan::callbacks::interrupt& interrupt,
+    std::vector<double>& params_r, std::vector<int>& params_i,
+    const std::vector<std::vector<double>>& directions,
+    std::vector<double>& derivatives, double epsilon = 1e-6,
+    std::ostream* msgs = 0) {
+  for (const auto& direction : directions) {
+    if (direction.size() != params_r.size())
+      throw std::invalid_argument(
+          "finite_diff_directional_derivatives: direction size must match "
+          "the number of parameters");
   }
+  internal::central_differences<propto, jacobian_adjust_transform>(
+      model, interrupt, params_r, params_i, directions.size(),
+      [&](size_t k, double h, std::vector<double>& x) {
+        for (size_t i = 0; i < x.size(); ++i)
+          x[i] = params_r[i] + h * directions[k][i];
+      },
+      epsilon, derivatives, msgs);
 }
 
 }  // namespace model
@@ -2,6 +2,7 @@
 #define STAN_MODEL_GRAD_HESS_LOG_PROB_HPP
 
 #include <stan/model/log_prob_grad.hpp>
+#include <stan/model/log_prob_grad_hessian.hpp>
 #include <iostream>
 #include <vector>
 
@@ -10,9 +11,13 @@ namespace model {
 
 /**
  * Evaluate the log-probability, its gradient, and its Hessian
- * at params_r. This default version computes the Hessian
- * numerically by finite-differencing the gradient, at a cost of
- * O(params_r.size()^2).
+ * at params_r.  The Hessian is computed by forward-over-reverse
+ * automatic differentiation when the program is built with
+ * <code>STAN_MODEL_FVAR_VAR</code> and otherwise numerically by
+ * finite-differencing the gradient, at a cost of 4 * params_r.size()
+ * gradient evaluations.  When the program is built with
+ * <code>STAN_THREADS</code> the columns of the Hessian are computed in
+ * parallel.
  *
  * @tparam propto True if calculation is up to proportion
  * (double-only terms dropped).
@@ -37,35 +42,24 @@ double grad_hess_log_prob(const M& model, std::vector<double>& params_r,
                           std::vector<double>& hessian,
                           std::ostream* msgs = 0) {
   static const double epsilon = 1e-3;
-  static const double half_epsilon = 0.5 * epsilon;
-  static const int order = 4;
-  static const double perturbations[order]
-      = {-2 * epsilon, -1 * epsilon, epsilon, 2 * epsilon};
-  static const double coefficients[order]
+  static const std::vector<double> perturbations = {-2, -1, 1, 2};
+  static const std::vector<double> coefficients
       = {1.0 / 12.0, -2.0 / 3.0, 2.0 / 3.0, -1.0 / 12.0};
-  static const double half_epsilon_coeff[order]
-      = {half_epsilon * coefficients[0], half_epsilon * coefficients[1],
-         half_epsilon * coefficients[2], half_epsilon * coefficients[3]};
+  const Eigen::Index n = params_r.size();
   double result = log_prob_grad<propto, jacobian_adjust_transform>(
       model, params_r, params_i, gradient, msgs);
-  hessian.assign(params_r.size() * params_r.size(), 0);
-  std::vector<double> temp_grad(params_r.size());
-  std::vector<double> perturbed_params(params_r.begin(), params_r.end());
-  for (size_t d = 0; d < params_r.size(); ++d) {
-    const int row_iter = d * params_r.size();
-    for (int i = 0; i < order; ++i) {
-      perturbed_params[d] = params_r[d] + perturbations[i];
-      log_prob_grad<propto, jacobian_adjust_transform>(model, perturbed_params,
-                                                       params_i, temp_grad);
-      for (size_t dd = 0; dd < params_r.size(); ++dd) {
-        const double increment = half_epsilon_coeff[i] * temp_grad[dd];
-        const int col_iter = dd * params_r.size();
-        hessian[dd + row_iter] += increment;
-        hessian[d + col_iter] += increment;
-      }
-    }
-    perturbed_params[d] = params_r[d];
-  }
+  Eigen::Map<const Eigen::VectorXd> x(params_r.data(), n);
+  Eigen::MatrixXd H;
+#ifdef STAN_MODEL_FVAR_VAR
+  Eigen::VectorXd grad;
+  autodiff_log_prob_grad_hessian<propto, jacobian_adjust_transform>(
+      model, x, grad, H);
+#else
+  internal::finite_diff_hessian<propto, jacobian_adjust_transform>(
+      model, x, Eigen::VectorXd::Constant(n, epsilon), perturbations,
+      coefficients, H, 0);
+#endif
+  hessian.assign(H.data(), H.data() + n * n);
   return result;
 }
 
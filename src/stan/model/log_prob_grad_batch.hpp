@@ -0,0 +1,89 @@
+#ifndef STAN_MODEL_LOG_PROB_GRAD_BATCH_HPP
+#define STAN_MODEL_LOG_PROB_GRAD_BATCH_HPP
+
+#include <stan/math/rev.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace model {
+
+/**
+ * Compute the log density and its gradient at each column of the
+ * specified matrix of unconstrained parameters using reverse-mode
+ * automatic differentiation.
+ *
+ * <p>Columns are evaluated in parallel on the TBB thread pool when the
+ * program is built with <code>STAN_THREADS</code>, so that each runs
+ * in a nested autodiff scope on the AD tape of the thread executing
+ * it; otherwise they are evaluated serially on the calling thread.
+ * Messages written by the model are buffered per column and written
+ * to the specified stream in column order, so output does not depend
+ * on the number of threads.
+ *
+ * <p>If the log density throws for any column, the exception is
+ * rethrown after all running evaluations finish and the contents of
+ * the outputs are unspecified.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] Q Unconstrained parameters, one point per column.
+ * @param[out] lp Log density at each column, resized to the number of
+ * columns of <code>Q</code>.
+ * @param[out] G Gradient at each column, resized to the size of
+ * <code>Q</code>.
+ * @param[in,out] msgs Stream to which messages are written.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void log_prob_grad_batch(const M& model, const Eigen::MatrixXd& Q,
+                         Eigen::VectorXd& lp, Eigen::MatrixXd& G,
+                         std::ostream* msgs = 0) {
+  using stan::math::var;
+  const Eigen::Index num_points = Q.cols();
+  lp.resize(num_points);
+  G.resize(Q.rows(), num_points);
+  std::vector<std::string> point_msgs(msgs ? num_points : 0);
+  const auto evaluate_range = [&](Eigen::Index begin, Eigen::Index end) {
+    std::stringstream ss;
+    for (Eigen::Index n = begin; n < end; ++n) {
+      stan::math::nested_rev_autodiff nested;
+      Eigen::Matrix<var, Eigen::Dynamic, 1> ad_params_r
+          = Q.col(n).cast<var>();
+      var adLogProb
+          = model.template log_prob<propto, jacobian_adjust_transform>(
+              ad_params_r, msgs ? &ss : 0);
+      lp(n) = adLogProb.val();
+      adLogProb.grad();
+      G.col(n) = ad_params_r.adj();
+      if (msgs) {
+        point_msgs[n] = ss.str();
+        ss.str(std::string());
+      }
+    }
+  };
+
+#ifdef STAN_THREADS
+  tbb::parallel_for(tbb::blocked_range<Eigen::Index>(0, num_points),
+                    [&](const tbb::blocked_range<Eigen::Index>& r) {
+                      evaluate_range(r.begin(), r.end());
+                    });
+#else
+  evaluate_range(0, num_points);
+#endif
+
+  for (const auto& msg : point_msgs)
+    *msgs << msg;
+}
+
+}  // namespace model
+}  // namespace stan
+#endif
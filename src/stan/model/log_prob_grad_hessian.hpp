@@ -0,0 +1,255 @@
+#ifndef STAN_MODEL_LOG_PROB_GRAD_HESSIAN_HPP
+#define STAN_MODEL_LOG_PROB_GRAD_HESSIAN_HPP
+
+#include <stan/math/mix.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace model {
+namespace internal {
+
+/**
+ * Compute the columns of a matrix, one call of the column functor per
+ * column, and return the symmetric part of the matrix.
+ *
+ * <p>Columns are computed in parallel on the TBB thread pool when the
+ * program is built with <code>STAN_THREADS</code>, so that each runs
+ * on the AD tape of the thread executing it; otherwise they are
+ * computed serially on the calling thread.  Every column is written to
+ * its own slot and the matrix is symmetrized on the calling thread, so
+ * the result does not depend on the number of threads.  Messages are
+ * buffered per column and written to the stream in column order.
+ *
+ * @tparam F Type of functor with signature
+ * <code>void(Eigen::Index, Eigen::VectorXd&, std::ostream*)</code>
+ * @param[in] n Number of rows and columns.
+ * @param[in] column Computes the specified column into its second
+ * argument, writing messages to its third argument if it is not null.
+ * @param[out] hessian Symmetric part of the computed matrix.
+ * @param[in,out] msgs Stream to which messages are written, or null.
+ */
+template <typename F>
+void symmetric_columns(Eigen::Index n, const F& column,
+                       Eigen::MatrixXd& hessian, std::ostream* msgs) {
+  Eigen::MatrixXd columns(n, n);
+  std::vector<std::string> column_msgs(msgs ? n : 0);
+
+  const auto compute_range = [&](Eigen::Index begin, Eigen::Index end) {
+    std::stringstream ss;
+    Eigen::VectorXd col(n);
+    for (Eigen::Index i = begin; i < end; ++i) {
+      column(i, col, msgs ? &ss : 0);
+      columns.col(i) = col;
+      if (msgs) {
+        column_msgs[i] = ss.str();
+        ss.str(std::string());
+      }
+    }
+  };
+
+#ifdef STAN_THREADS
+  tbb::parallel_for(tbb::blocked_range<Eigen::Index>(0, n),
+                    [&](const tbb::blocked_range<Eigen::Index>& r) {
+                      compute_range(r.begin(), r.end());
+                    });
+#else
+  compute_range(0, n);
+#endif
+
+  for (const auto& msg : column_msgs)
+    *msgs << msg;
+  hessian = 0.5 * (columns + columns.transpose());
+}
+
+/**
+ * Return the log density and write its gradient at the specified point
+ * using reverse-mode automatic differentiation in a nested scope.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+double nested_log_prob_grad(const M& model, const Eigen::VectorXd& x,
+                            Eigen::VectorXd& grad, std::ostream* msgs) {
+  stan::math::nested_rev_autodiff nested;
+  Eigen::Matrix<stan::math::var, Eigen::Dynamic, 1> ad_x
+      = x.cast<stan::math::var>();
+  stan::math::var lp
+      = model.template log_prob<propto, jacobian_adjust_transform>(ad_x, msgs);
+  lp.grad();
+  grad = ad_x.adj();
+  return lp.val();
+}
+
+/**
+ * Compute the Hessian of the log density by finite differences of
+ * reverse-mode gradients.  Column <code>d</code> is
+ * <code>sum_i coefficients[i] * grad(x + offsets[i] * h(d) * e_d) /
+ * h(d)</code> and the Hessian is the symmetric part of the matrix of
+ * columns.
+ *
+ * @param[in] model Model.
+ * @param[in] x Point at which to evaluate the Hessian.
+ * @param[in] h Step size for each dimension.
+ * @param[in] offsets Stencil offsets in units of the step size.
+ * @param[in] coefficients Stencil coefficients.
+ * @param[out] hessian Hessian of the log density.
+ * @param[in,out] msgs Stream to which messages are written, or null.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void finite_diff_hessian(const M& model, const Eigen::VectorXd& x,
+                         const Eigen::VectorXd& h,
+                         const std::vector<double>& offsets,
+                         const std::vector<double>& coefficients,
+                         Eigen::MatrixXd& hessian, std::ostream* msgs) {
+  symmetric_columns(
+      x.size(),
+      [&](Eigen::Index d, Eigen::VectorXd& col, std::ostream* col_msgs) {
+        Eigen::VectorXd perturbed = x;
+        Eigen::VectorXd grad(x.size());
+        col.setZero();
+        for (size_t i = 0; i < offsets.size(); ++i) {
+          perturbed(d) = x(d) + offsets[i] * h(d);
+          nested_log_prob_grad<propto, jacobian_adjust_transform>(
+              model, perturbed, grad, col_msgs);
+          col += (coefficients[i] / h(d)) * grad;
+        }
+      },
+      hessian, msgs);
+}
+
+}  // namespace internal
+
+/**
+ * Compute the Hessian of the log density by forward-over-reverse
+ * automatic differentiation, one forward sweep per column.  This
+ * requires the log density of the model to be instantiable with
+ * <code>fvar<var></code> arguments.
+ *
+ * <p>Columns are computed in parallel when the program is built with
+ * <code>STAN_THREADS</code>.  Messages written by the model are
+ * buffered per column and written to the stream in column order, after
+ * those of the gradient evaluation.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] x Unconstrained parameters.
+ * @param[out] grad Gradient of the log density.
+ * @param[out] hessian Hessian of the log density.
+ * @param[in,out] msgs Stream to which messages are written.
+ * @return Log density.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+double autodiff_log_prob_grad_hessian(const M& model, const Eigen::VectorXd& x,
+                                      Eigen::VectorXd& grad,
+                                      Eigen::MatrixXd& hessian,
+                                      std::ostream* msgs = 0) {
+  using stan::math::fvar;
+  using stan::math::var;
+  double lp = internal::nested_log_prob_grad<propto, jacobian_adjust_transform>(
+      model, x, grad, msgs);
+  internal::symmetric_columns(
+      x.size(),
+      [&](Eigen::Index d, Eigen::VectorXd& col, std::ostream* col_msgs) {
+        stan::math::nested_rev_autodiff nested;
+        Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> ad_x(x.size());
+        for (Eigen::Index i = 0; i < x.size(); ++i)
+          ad_x(i) = fvar<var>(x(i), i == d ? 1.0 : 0.0);
+        fvar<var> ad_lp
+            = model.template log_prob<propto, jacobian_adjust_transform,
+                                      fvar<var>>(ad_x, col_msgs);
+        ad_lp.d_.grad();
+        for (Eigen::Index i = 0; i < x.size(); ++i)
+          col(i) = ad_x(i).val_.adj();
+      },
+      hessian, msgs);
+  return lp;
+}
+
+/**
+ * Compute the Hessian of the log density by central finite differences
+ * of reverse-mode gradients, with the step size for each dimension
+ * scaled to the magnitude of the parameter, at a cost of
+ * <code>2 * x.size()</code> gradient evaluations.
+ *
+ * <p>Gradient evaluations are distributed over the TBB thread pool when
+ * the program is built with <code>STAN_THREADS</code>; the result does
+ * not depend on the number of threads.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] x Unconstrained parameters.
+ * @param[out] grad Gradient of the log density.
+ * @param[out] hessian Hessian of the log density.
+ * @param[in,out] msgs Stream to which messages are written.
+ * @return Log density.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+double finite_diff_log_prob_grad_hessian(const M& model,
+                                         const Eigen::VectorXd& x,
+                                         Eigen::VectorXd& grad,
+                                         Eigen::MatrixXd& hessian,
+                                         std::ostream* msgs = 0) {
+  static const double cbrt_epsilon
+      = std::cbrt(std::numeric_limits<double>::epsilon());
+  Eigen::VectorXd h(x.size());
+  for (Eigen::Index d = 0; d < x.size(); ++d)
+    h(d) = cbrt_epsilon * std::max(1.0, std::fabs(x(d)));
+  internal::finite_diff_hessian<propto, jacobian_adjust_transform>(
+      model, x, h, {-1, 1}, {-0.5, 0.5}, hessian, msgs);
+  return internal::nested_log_prob_grad<propto, jacobian_adjust_transform>(
+      model, x, grad, msgs);
+}
+
+/**
+ * Compute the log density, its gradient, and its Hessian.  When the
+ * program is built with <code>STAN_MODEL_FVAR_VAR</code>, which
+ * declares that the log density of the model supports
+ * <code>fvar<var></code> arguments, the Hessian is computed by
+ * forward-over-reverse automatic differentiation; otherwise it is
+ * computed by finite differences of gradients.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] x Unconstrained parameters.
+ * @param[out] grad Gradient of the log density.
+ * @param[out] hessian Hessian of the log density.
+ * @param[in,out] msgs Stream to which messages are written.
+ * @return Log density.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+double log_prob_grad_hessian(const M& model, const Eigen::VectorXd& x,
+                             Eigen::VectorXd& grad, Eigen::MatrixXd& hessian,
+                             std::ostream* msgs = 0) {
+#ifdef STAN_MODEL_FVAR_VAR
+  return autodiff_log_prob_grad_hessian<propto, jacobian_adjust_transform>(
+      model, x, grad, hessian, msgs);
+#else
+  return finite_diff_log_prob_grad_hessian<propto, jacobian_adjust_transform>(
+      model, x, grad, hessian, msgs);
+#endif
+}
+
+}  // namespace model
+}  // namespace stan
+#endif
@@ -335,6 +335,48 @@ class model_base : public prob_grad {
       return log_prob(params_r, msgs);
   }
 
+  /**
+   * Compute the log density and its gradient at each column of the
+   * specified matrix of unconstrained parameters.  Models may override
+   * this method with a vectorized implementation; the default
+   * evaluates the columns serially with one reverse-mode pass per
+   * column.  <code>model_base_crtp</code> overrides it to evaluate the
+   * columns in parallel when the program is built with
+   * <code>STAN_THREADS</code>.
+   *
+   * @param[in] Q unconstrained parameters, one point per column
+   * @param[out] lp log density at each column
+   * @param[out] G gradient of the log density at each column
+   * @param[in] propto true if normalizing constants are dropped
+   * @param[in] jacobian true if the Jacobian adjustment for
+   * constrained parameters is included
+   * @param[in,out] msgs stream to which messages are written
+   */
+  virtual void log_prob_grad_batch(const Eigen::MatrixXd& Q,
+                                   Eigen::VectorXd& lp, Eigen::MatrixXd& G,
+                                   bool propto = true, bool jacobian = true,
+                                   std::ostream* msgs = 0) const {
+    lp.resize(Q.cols());
+    G.resize(Q.rows(), Q.cols());
+    for (Eigen::Index n = 0; n < Q.cols(); ++n) {
+      math::nested_rev_autodiff nested;
+      Eigen::Matrix<math::var, -1, 1> params_r = Q.col(n).cast<math::var>();
+      math::var lp_n;
+      if (propto && jacobian)
+        lp_n = log_prob_propto_jacobian(params_r, msgs);
+      else if (propto && !jacobian)
+        lp_n = log_prob_propto(params_r, msgs);
+      else if (!propto && jacobian)
+        lp_n = log_prob_jacobian(params_r, msgs);
+      else  // if (!propto && !jacobian)
+        lp_n = log_prob(params_r, msgs);
+      lp(n) = lp_n.val();
+      lp_n.grad();
+      for (Eigen::Index i = 0; i < Q.rows(); ++i)
+        G(i, n) = params_r(i).adj();
+    }
+  }
+
   /**
    * Read constrained parameter values from the specified context,
    * unconstrain them, then concatenate the unconstrained sequences
@@ -4,6 +4,7 @@
 #ifdef STAN_MODEL_FVAR_VAR
 #include <stan/math/mix.hpp>
 #endif
+#include <stan/model/log_prob_grad_batch.hpp>
 #include <stan/model/model_base.hpp>
 #include <iostream>
 #include <utility>
@@ -217,6 +218,21 @@ class model_base_crtp : public stan::model::model_base {
                                                           params_r, msgs);
   }
 
+  void log_prob_grad_batch(const Eigen::MatrixXd& Q, Eigen::VectorXd& lp,
+                           Eigen::MatrixXd& G, bool propto = true,
+                           bool jacobian = true,
+                           std::ostream* msgs = 0) const override {
+    const M& model = *static_cast<const M*>(this);
+    if (propto && jacobian)
+      stan::model::log_prob_grad_batch<true, true>(model, Q, lp, G, msgs);
+    else if (propto && !jacobian)
+      stan::model::log_prob_grad_batch<true, false>(model, Q, lp, G, msgs);
+    else if (!propto && jacobian)
+      stan::model::log_prob_grad_batch<false, true>(model, Q, lp, G, msgs);
+    else  // if (!propto && !jacobian)
+      stan::model::log_prob_grad_batch<false, false>(model, Q, lp, G, msgs);
+  }
+
   void transform_inits(const io::var_context& context,
                        Eigen::VectorXd& params_r,
                        std::ostream* msgs) const override {
@@ -6,17 +6,89 @@
 #include <stan/model/finite_diff_grad.hpp>
 #include <stan/model/log_prob_grad.hpp>
 #include <cmath>
+#include <iomanip>
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace stan {
 namespace model {
 
+namespace internal {
+
+/**
+ * Write the log density and the header of a gradient comparison table
+ * to the logger and the writer.
+ */
+inline void write_gradient_test_header(double lp, const std::string& index_name,
+                                       const std::string& value_name,
+                                       stan::callbacks::logger& logger,
+                                       stan::callbacks::writer& writer) {
+  std::stringstream lp_msg;
+  lp_msg << " Log probability=" << lp;
+
+  writer();
+  writer(lp_msg.str());
+  writer();
+
+  logger.info("");
+  logger.info(lp_msg);
+  logger.info("");
+
+  std::stringstream header;
+  header << std::setw(10) << index_name << std::setw(16) << value_name
+         << std::setw(16) << "model" << std::setw(16) << "finite diff"
+         << std::setw(16) << "error";
+
+  writer(header.str());
+  logger.info(header);
+}
+
+/**
+ * Write one row of a gradient comparison table to the logger and the
+ * writer and return true if the error is within the allowed error.
+ */
+inline bool write_gradient_test_row(size_t index, double value, double model,
+                                    double finite_diff, double error,
+                                    stan::callbacks::logger& logger,
+                                    stan::callbacks::writer& writer) {
+  std::stringstream line;
+  line << std::setw(10) << index << std::setw(16) << value << std::setw(16)
+       << model << std::setw(16) << finite_diff << std::setw(16)
+       << (model - finite_diff);
+  writer(line.str());
+  logger.info(line);
+  return !(std::fabs(model - finite_diff) > error);
+}
+
+/**
+ * Return the log density and write its gradient, flushing any messages
+ * to the logger and the writer.
+ */
+template <bool propto, bool jacobian_adjust_transform, class Model>
+double logged_log_prob_grad(const Model& model, std::vector<double>& params_r,
+                            std::vector<int>& params_i,
+                            std::vector<double>& grad,
+                            stan::callbacks::logger& logger,
+                            stan::callbacks::writer& writer) {
+  std::stringstream msg;
+  double lp = log_prob_grad<propto, jacobian_adjust_transform>(
+      model, params_r, params_i, grad, &msg);
+  if (msg.str().length() > 0) {
+    logger.info(msg);
+    writer(msg.str());
+  }
+  return lp;
+}
+
+}  // namespace internal
+
 /**
  * Test the log_prob_grad() function's ability to produce
- * accurate gradients using finite differences.  This shouldn't
- * be necessary when using autodiff, but is useful for finding
- * bugs in hand-written code (or var).
+ * accurate gradients using finite differences, checking only the
+ * partial derivatives with respect to the specified coordinates.
+ * Finite differences are computed in parallel when the program is
+ * built with <code>STAN_THREADS</code>.
  *
  * @tparam propto True if calculation is up to proportion
  * (double-only terms dropped).
@@ -27,6 +99,7 @@ namespace model {
  * @param[in] model Model.
  * @param[in] params_r Real-valued parameter vector.
  * @param[in] params_i Integer-valued parameter vector.
+ * @param[in] coordinates Indexes of the parameters to check.
  * @param[in] epsilon Real-valued scalar saying how much to perturb.
  *   Reasonable value is 1e-6.
  * @param[in] error Real-valued scalar saying how much error to allow.
@@ -36,59 +109,151 @@ namespace model {
  * @param[in,out] parameter_writer Writer callback for file output
  * @return number of failed gradient comparisons versus allowed
  * error, so 0 if all gradients pass
+ * @throw std::out_of_range if a coordinate is not an index of the
+ * parameters
  */
 template <bool propto, bool jacobian_adjust_transform, class Model>
 int test_gradients(const Model& model, std::vector<double>& params_r,
-                   std::vector<int>& params_i, double epsilon, double error,
-                   stan::callbacks::interrupt& interrupt,
+                   std::vector<int>& params_i,
+                   const std::vector<size_t>& coordinates, double epsilon,
+                   double error, stan::callbacks::interrupt& interrupt,
                    stan::callbacks::logger& logger,
                    stan::callbacks::writer& parameter_writer) {
-  std::stringstream msg;
   std::vector<double> grad;
-  double lp = log_prob_grad<propto, jacobian_adjust_transform>(
-      model, params_r, params_i, grad, &msg);
-  if (msg.str().length() > 0) {
-    logger.info(msg);
-    parameter_writer(msg.str());
-  }
+  double lp
+      = internal::logged_log_prob_grad<propto, jacobian_adjust_transform>(
+          model, params_r, params_i, grad, logger, parameter_writer);
 
+  std::stringstream msg;
   std::vector<double> grad_fd;
-  finite_diff_grad<false, true, Model>(model, interrupt, params_r, params_i,
-                                       grad_fd, epsilon, &msg);
+  finite_diff_grad<false, jacobian_adjust_transform, Model>(
+      model, interrupt, params_r, params_i, coordinates, grad_fd, epsilon,
+      &msg);
   if (msg.str().length() > 0) {
     logger.info(msg);
     parameter_writer(msg.str());
   }
 
-  int num_failed = 0;
+  internal::write_gradient_test_header(lp, "param idx", "value", logger,
+                                       parameter_writer);
 
-  std::stringstream lp_msg;
-  lp_msg << " Log probability=" << lp;
+  int num_failed = 0;
+  for (size_t j = 0; j < coordinates.size(); j++) {
+    size_t k = coordinates[j];
+    if (!internal::write_gradient_test_row(k, params_r[k], grad[k],
+                                           grad_fd[j], error, logger,
+                                           parameter_writer))
+      num_failed++;
+  }
+  return num_failed;
+}
 
-  parameter_writer();
-  parameter_writer(lp_msg.str());
-  parameter_writer();
+/**
+ * Test the log_prob_grad() function's ability to produce
+ * accurate gradients using finite differences.  This shouldn't
+ * be necessary when using autodiff, but is useful for finding
+ * bugs in hand-written code (or var).
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam Model Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameter vector.
+ * @param[in] params_i Integer-valued parameter vector.
+ * @param[in] epsilon Real-valued scalar saying how much to perturb.
+ *   Reasonable value is 1e-6.
+ * @param[in] error Real-valued scalar saying how much error to allow.
+ *   Reasonable value is 1e-6.
+ * @param[in,out] interrupt callback to be called at every iteration
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] parameter_writer Writer callback for file output
+ * @return number of failed gradient comparisons versus allowed
+ * error, so 0 if all gradients pass
+ */
+template <bool propto, bool jacobian_adjust_transform, class Model>
+int test_gradients(const Model& model, std::vector<double>& params_r,
+                   std::vector<int>& params_i, double epsilon, double error,
+                   stan::callbacks::interrupt& interrupt,
+                   stan::callbacks::logger& logger,
+                   stan::callbacks::writer& parameter_writer) {
+  std::vector<size_t> coordinates(params_r.size());
+  for (size_t k = 0; k < coordinates.size(); ++k)
+    coordinates[k] = k;
+  return test_gradients<propto, jacobian_adjust_transform>(
+      model, params_r, params_i, coordinates, epsilon, error, interrupt,
+      logger, parameter_writer);
+}
 
-  logger.info("");
-  logger.info(lp_msg);
-  logger.info("");
+/**
+ * Test the log_prob_grad() function's gradient against finite
+ * difference directional derivatives along the specified directions.
+ * Each direction costs two evaluations of the log density regardless
+ * of the number of parameters, so a few random directions give a cheap
+ * check of the full gradient of a large model.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam Model Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameter vector.
+ * @param[in] params_i Integer-valued parameter vector.
+ * @param[in] directions Directions, each the size of the parameters.
+ *   Unit vectors make the allowed error comparable to that of a
+ *   single partial derivative.
+ * @param[in] epsilon Real-valued scalar saying how much to perturb.
+ *   Reasonable value is 1e-6.
+ * @param[in] error Real-valued scalar saying how much error to allow.
+ *   Reasonable value is 1e-6.
+ * @param[in,out] interrupt callback to be called at every iteration
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] parameter_writer Writer callback for file output
+ * @return number of failed directional derivative comparisons versus
+ * allowed error, so 0 if all directions pass
+ */
+template <bool propto, bool jacobian_adjust_transform, class Model>
+int test_directional_derivatives(
+    const Model& model, std::vector<double>& params_r,
+    std::vector<int>& params_i,
+    const std::vector<std::vector<double>>& directions, double epsilon,
+    double error, stan::callbacks::interrupt& interrupt,
+    stan::callbacks::logger& logger,
+    stan::callbacks::writer& parameter_writer) {
+  std::vector<double> grad;
+  double lp
+      = internal::logged_log_prob_grad<propto, jacobian_adjust_transform>(
+          model, params_r, params_i, grad, logger, parameter_writer);
 
-  std::stringstream header;
-  header << std::setw(10) << "param idx" << std::setw(16) << "value"
-         << std::setw(16) << "model" << std::setw(16) << "finite diff"
-         << std::setw(16) << "error";
+  std::stringstream msg;
+  std::vector<double> derivatives_fd;
+  finite_diff_directional_derivatives<false, jacobian_adjust_transform,
+                                      Model>(model, interrupt, params_r,
+                                             params_i, directions,
+                                             derivatives_fd, epsilon, &msg);
+  if (msg.str().length() > 0) {
+    logger.info(msg);
+    parameter_writer(msg.str());
+  }
 
-  parameter_writer(header.str());
-  logger.info(header);
+  internal::write_gradient_test_header(lp, "direction", "norm", logger,
+                                       parameter_writer);
 
-  for (size_t k = 0; k < params_r.size(); k++) {
-    std::stringstream line;
-    line << std::setw(10) << k << std::setw(16) << params_r[k] << std::setw(16)
-         << grad[k] << std::setw(16) << grad_fd[k] << std::setw(16)
-         << (grad[k] - grad_fd[k]);
-    parameter_writer(line.str());
-    logger.info(line);
-    if (std::fabs(grad[k] - grad_fd[k]) > error)
+  int num_failed = 0;
+  for (size_t j = 0; j < directions.size(); j++) {
+    double derivative = 0;
+    double squared_norm = 0;
+    for (size_t k = 0; k < grad.size(); k++) {
+      derivative += grad[k] * directions[j][k];
+      squared_norm += directions[j][k] * directions[j][k];
+    }
+    if (!internal::write_gradient_test_row(j, std::sqrt(squared_norm),
+                                           derivative, derivatives_fd[j],
+                                           error, logger, parameter_writer))
       num_failed++;
   }
   return num_failed;
@@ -8,6 +8,7 @@
 #include <stan/optimization/bfgs_update.hpp>
 #include <stan/optimization/lbfgs_update.hpp>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <limits>
@@ -290,12 +291,21 @@ class ModelAdaptor {
   std::ostream *_msgs;
   std::vector<double> _x, _g;
   size_t _fevals;
+  double _grad_seconds;
+  bool _time_grads;
 
  public:
   ModelAdaptor(M &model, const std::vector<int> &params_i, std::ostream *msgs)
-      : _model(model), _params_i(params_i), _msgs(msgs), _fevals(0) {}
+      : _model(model),
+        _params_i(params_i),
+        _msgs(msgs),
+        _fevals(0),
+        _grad_seconds(0),
+        _time_grads(false) {}
 
   size_t fevals() const { return _fevals; }
+  double grad_seconds() const { return _grad_seconds; }
+  void set_grad_timing(bool time_grads) { _time_grads = time_grads; }
   int operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1> &x, double &f) {
     using Eigen::Dynamic;
     using Eigen::Matrix;
@@ -339,6 +349,9 @@ class ModelAdaptor {
 
     _fevals++;
 
+    std::chrono::steady_clock::time_point start;
+    if (_time_grads)
+      start = std::chrono::steady_clock::now();
     try {
       f = -log_prob_grad<true, jacobian>(_model, _x, _params_i, _g, _msgs);
     } catch (const std::domain_error &e) {
@@ -346,6 +359,10 @@ class ModelAdaptor {
         (*_msgs) << e.what() << std::endl;
       return 1;
     }
+    if (_time_grads)
+      _grad_seconds += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
 
     g.resize(_g.size());
     for (size_t i = 0; i < _g.size(); i++) {
@@ -413,6 +430,14 @@ class BFGSLineSearch
   }
 
   size_t grad_evals() { return this->_func.fevals(); }
+  /**
+   * Return the seconds spent evaluating gradients since timing was
+   * enabled with <code>set_grad_timing</code>.
+   */
+  double grad_seconds() { return this->_func.grad_seconds(); }
+  void set_grad_timing(bool time_grads) {
+    this->_func.set_grad_timing(time_grads);
+  }
   double logp() { return -(this->curr_f()); }
   double grad_norm() { return this->curr_g().norm(); }
   void grad(std::vector<double> &g) {
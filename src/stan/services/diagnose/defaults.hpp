@@ -69,6 +69,79 @@ struct error {
   static double default_value() { return 1e-6; }
 };
 
+/**
+ * Number of parameters whose partial derivatives are checked, drawn at
+ * random without replacement.
+ */
+struct num_coordinates {
+  /**
+   * Return the string description of num_coordinates.
+   *
+   * @return description
+   */
+  static std::string description() {
+    return "Number of randomly chosen parameters to check, "
+           "or -1 to check all parameters.";
+  }
+
+  /**
+   * Validates num_coordinates; num_coordinates must be greater than or
+   * equal to -1.
+   *
+   * @param[in] num_coordinates argument to validate
+   * @throw std::invalid_argument unless num_coordinates is greater than
+   * or equal to -1
+   */
+  static void validate(int num_coordinates) {
+    if (!(num_coordinates >= -1))
+      throw std::invalid_argument(
+          "num_coordinates must be greater than or equal to -1.");
+  }
+
+  /**
+   * Return the default num_coordinates value.
+   *
+   * @return -1
+   */
+  static int default_value() { return -1; }
+};
+
+/**
+ * Number of random directions along which directional derivatives
+ * are checked.
+ */
+struct num_directions {
+  /**
+   * Return the string description of num_directions.
+   *
+   * @return description
+   */
+  static std::string description() {
+    return "Number of random directions to check.";
+  }
+
+  /**
+   * Validates num_directions; num_directions must be greater than or
+   * equal to 0.
+   *
+   * @param[in] num_directions argument to validate
+   * @throw std::invalid_argument unless num_directions is greater than
+   * or equal to 0
+   */
+  static void validate(int num_directions) {
+    if (!(num_directions >= 0))
+      throw std::invalid_argument(
+          "num_directions must be greater than or equal to 0.");
+  }
+
+  /**
+   * Return the default num_directions value.
+   *
+   * @return 0
+   */
+  static int default_value() { return 0; }
+};
+
 }  // namespace diagnose
 }  // namespace services
 }  // namespace stan
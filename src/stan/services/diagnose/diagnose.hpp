@@ -8,6 +8,10 @@
 #include <stan/model/test_gradients.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace stan {
@@ -16,11 +20,14 @@ namespace diagnose {
 
 /**
  * Checks the gradients of the model computed using reverse mode
- * autodiff against finite differences.
+ * autodiff against finite differences, either for all parameters, a
+ * specified list of parameters, or a random subset of them, and
+ * optionally against directional derivatives along random directions.
  *
  * This will test the first order gradients using reverse mode
- * at the value specified in cont_params. This method only
- * outputs to the logger.
+ * at the value specified in cont_params. Finite differences are
+ * computed in parallel when the program is built with
+ * <code>STAN_THREADS</code>. This method only outputs to the logger.
  *
  * @tparam Model A model implementation
  * @param[in] model Input model to test (with data already instantiated)
@@ -30,17 +37,28 @@ namespace diagnose {
  * @param[in] init_radius radius to initialize
  * @param[in] epsilon epsilon to use for finite differences
  * @param[in] error amount of absolute error to allow
+ * @param[in] coordinates indexes of the parameters to check; if
+ * nonempty, num_coordinates is ignored
+ * @param[in] num_coordinates number of parameters to check, drawn at
+ * random without replacement; all parameters are checked if negative
+ * or at least the number of parameters
+ * @param[in] num_directions number of random unit directions along
+ * which to check directional derivatives
  * @param[in,out] interrupt interrupt callback
  * @param[in,out] logger Logger for messages
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] parameter_writer Writer callback for file output
- * @return the number of parameters that are not within epsilon
- * of the finite difference calculation
+ * @return the number of parameters and directions that are not within
+ * epsilon of the finite difference calculation
+ * @throw std::out_of_range if a coordinate is not an index of the
+ * parameters
  */
 template <class Model>
 int diagnose(Model& model, const stan::io::var_context& init,
              unsigned int random_seed, unsigned int chain, double init_radius,
-             double epsilon, double error, callbacks::interrupt& interrupt,
+             double epsilon, double error,
+             const std::vector<size_t>& coordinates, int num_coordinates,
+             int num_directions, callbacks::interrupt& interrupt,
              callbacks::logger& logger, callbacks::writer& init_writer,
              callbacks::writer& parameter_writer) {
   stan::rng_t rng = util::create_rng(random_seed, chain);
@@ -51,13 +69,93 @@ int diagnose(Model& model, const stan::io::var_context& init,
 
   logger.info("TEST GRADIENT MODE");
 
-  int num_failed = stan::model::test_gradients<true, true>(
-      model, cont_vector, disc_vector, epsilon, error, interrupt, logger,
-      parameter_writer);
+  const size_t num_params = cont_vector.size();
+  std::vector<size_t> checked(coordinates);
+  if (checked.empty()) {
+    checked.resize(num_params);
+    for (size_t k = 0; k < num_params; ++k)
+      checked[k] = k;
+    if (num_coordinates >= 0
+        && static_cast<size_t>(num_coordinates) < num_params) {
+      // Partial Fisher-Yates shuffle, reported in increasing order
+      for (size_t k = 0; k < static_cast<size_t>(num_coordinates); ++k) {
+        boost::random::uniform_int_distribution<size_t> index(k,
+                                                              num_params - 1);
+        std::swap(checked[k], checked[index(rng)]);
+      }
+      checked.resize(num_coordinates);
+      std::sort(checked.begin(), checked.end());
+    }
+  }
+
+  // Without parameters there are no directions either, so write the
+  // empty gradient table rather than nothing
+  int num_failed = 0;
+  if (!checked.empty() || num_directions <= 0 || num_params == 0)
+    num_failed += stan::model::test_gradients<true, true>(
+        model, cont_vector, disc_vector, checked, epsilon, error, interrupt,
+        logger, parameter_writer);
+
+  if (num_directions > 0 && num_params > 0) {
+    boost::random::normal_distribution<double> std_normal;
+    std::vector<std::vector<double>> directions(
+        num_directions, std::vector<double>(num_params));
+    for (auto& direction : directions) {
+      double squared_norm = 0;
+      while (!(squared_norm > 0)) {
+        for (auto& v : direction)
+          v = std_normal(rng);
+        squared_norm = 0;
+        for (double v : direction)
+          squared_norm += v * v;
+      }
+      for (auto& v : direction)
+        v /= std::sqrt(squared_norm);
+    }
+    logger.info("TEST DIRECTIONAL DERIVATIVE MODE");
+    parameter_writer("TEST DIRECTIONAL DERIVATIVE MODE");
+    num_failed += stan::model::test_directional_derivatives<true, true>(
+        model, cont_vector, disc_vector, directions, epsilon, error,
+        interrupt, logger, parameter_writer);
+  }
 
   return num_failed;
 }
 
+/**
+ * Checks the gradients of the model computed using reverse mode
+ * autodiff against finite differences.
+ *
+ * This will test the first order gradients using reverse mode
+ * at the value specified in cont_params. This method only
+ * outputs to the logger.
+ *
+ * @tparam Model A model implementation
+ * @param[in] model Input model to test (with data already instantiated)
+ * @param[in] init var context for initialization
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] chain chain id to advance the pseudo random number generator
+ * @param[in] init_radius radius to initialize
+ * @param[in] epsilon epsilon to use for finite differences
+ * @param[in] error amount of absolute error to allow
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] init_writer Writer callback for unconstrained inits
+ * @param[in,out] parameter_writer Writer callback for file output
+ * @return the number of parameters that are not within epsilon
+ * of the finite difference calculation
+ */
+template <class Model>
+int diagnose(Model& model, const stan::io::var_context& init,
+             unsigned int random_seed, unsigned int chain, double init_radius,
+             double epsilon, double error, callbacks::interrupt& interrupt,
+             callbacks::logger& logger, callbacks::writer& init_writer,
+             callbacks::writer& parameter_writer) {
+  return diagnose(model, init, random_seed, chain, init_radius, epsilon,
+                  error, std::vector<size_t>(), -1, 0, interrupt, logger,
+                  init_writer, parameter_writer);
+}
+
 }  // namespace diagnose
 }  // namespace services
 }  // namespace stan
@@ -3,12 +3,14 @@
 
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/optimization/bfgs.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/create_rng.hpp>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -47,6 +49,8 @@ namespace optimize {
  * @param[in,out] logger Logger for messages
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] parameter_writer output for parameter values
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each iteration if it is enabled
  * @return error_codes::OK if successful
  */
 template <class Model, bool jacobian = false>
@@ -56,7 +60,8 @@ int bfgs(Model& model, const stan::io::var_context& init,
          double tol_rel_grad, double tol_param, int num_iterations,
          bool save_iterations, int refresh, callbacks::interrupt& interrupt,
          callbacks::logger& logger, callbacks::writer& init_writer,
-         callbacks::writer& parameter_writer) {
+         callbacks::writer& parameter_writer,
+         callbacks::telemetry& telemetry) {
   stan::rng_t rng = util::create_rng(random_seed, chain);
 
   std::vector<int> disc_vector;
@@ -81,6 +86,8 @@ int bfgs(Model& model, const stan::io::var_context& init,
   bfgs._conv_opts.tolRelGrad = tol_rel_grad;
   bfgs._conv_opts.tolAbsX = tol_param;
   bfgs._conv_opts.maxIts = num_iterations;
+  if (telemetry.enabled())
+    bfgs.set_grad_timing(true);
 
   double lp = bfgs.logp();
 
@@ -129,8 +136,24 @@ int bfgs(Model& model, const stan::io::var_context& init,
             "  # evals"
             "  Notes ");
 
+      callbacks::transition_stats stats;
+      std::chrono::steady_clock::time_point start;
+      if (telemetry.enabled()) {
+        stats.gradient_evals = bfgs.grad_evals();
+        stats.gradient_seconds = bfgs.grad_seconds();
+        start = std::chrono::steady_clock::now();
+      }
+
       ret = bfgs.step();
 
+      if (telemetry.enabled()) {
+        stats.transition_seconds = std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count();
+        stats.gradient_evals = bfgs.grad_evals() - stats.gradient_evals;
+        stats.gradient_seconds = bfgs.grad_seconds() - stats.gradient_seconds;
+      }
+
       lp = bfgs.logp();
       bfgs.params_r(cont_vector);
 
@@ -161,8 +184,13 @@ int bfgs(Model& model, const stan::io::var_context& init,
       if (save_iterations) {
         std::vector<double> values;
         std::stringstream msg;
+        if (telemetry.enabled())
+          start = std::chrono::steady_clock::now();
         model.write_array(rng, cont_vector, disc_vector, values, true, true,
                           &msg);
+        std::chrono::steady_clock::time_point end_write_array;
+        if (telemetry.enabled())
+          end_write_array = std::chrono::steady_clock::now();
 
         // This if is here to match the pre-refactor behavior
         if (msg.str().length() > 0)
@@ -170,7 +198,17 @@ int bfgs(Model& model, const stan::io::var_context& init,
 
         values.insert(values.begin(), lp);
         parameter_writer(values);
+        if (telemetry.enabled()) {
+          stats.write_array_seconds
+              = std::chrono::duration<double>(end_write_array - start).count();
+          stats.writer_seconds = std::chrono::duration<double>(
+                                     std::chrono::steady_clock::now()
+                                     - end_write_array)
+                                     .count();
+        }
       }
+      if (telemetry.enabled())
+        telemetry(stats);
     }
   } catch (const std::exception& e) {
     logger.error(e.what());
@@ -211,6 +249,27 @@ int bfgs(Model& model, const stan::io::var_context& init,
   return return_code;
 }
 
+/**
+ * Runs the BFGS algorithm for a model without measuring its
+ * iterations.  See the overload taking a <code>telemetry</code> callback
+ * for the parameters.
+ */
+template <class Model, bool jacobian = false>
+int bfgs(Model& model, const stan::io::var_context& init,
+         unsigned int random_seed, unsigned int chain, double init_radius,
+         double init_alpha, double tol_obj, double tol_rel_obj, double tol_grad,
+         double tol_rel_grad, double tol_param, int num_iterations,
+         bool save_iterations, int refresh, callbacks::interrupt& interrupt,
+         callbacks::logger& logger, callbacks::writer& init_writer,
+         callbacks::writer& parameter_writer) {
+  callbacks::telemetry no_telemetry;
+  return bfgs<Model, jacobian>(model, init, random_seed, chain, init_radius,
+                               init_alpha, tol_obj, tol_rel_obj, tol_grad,
+                               tol_rel_grad, tol_param, num_iterations,
+                               save_iterations, refresh, interrupt, logger,
+                               init_writer, parameter_writer, no_telemetry);
+}
+
 }  // namespace optimize
 }  // namespace services
 }  // namespace stan
@@ -1,13 +1,20 @@
 #ifndef STAN_SERVICES_OPTIMIZE_LAPLACE_SAMPLE_HPP
 #define STAN_SERVICES_OPTIMIZE_LAPLACE_SAMPLE_HPP
 
+#include <stan/callbacks/async_writer.hpp>
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/callbacks/structured_writer.hpp>
 #include <stan/math/rev.hpp>
+#include <stan/model/log_prob_grad_hessian.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/create_rng.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -52,25 +59,17 @@ void laplace_sample(const Model& model, const Eigen::VectorXd& theta_hat,
   model.constrained_param_names(names, include_tp, include_gq);
   sample_writer(names);
 
-  // create log density functor for vars and vals
   std::stringstream log_density_msgs;
-  auto log_density_fun
-      = [&](const Eigen::Matrix<stan::math::var, -1, 1>& theta) {
-          return model.template log_prob<true, jacobian, stan::math::var>(
-              const_cast<Eigen::Matrix<stan::math::var, -1, 1>&>(theta),
-              &log_density_msgs);
-        };
 
   // calculate inverse negative Hessian's Cholesky factor
   if (refresh > 0) {
     logger.info("Calculating Hessian");
   }
-  double log_p;          // dummy
-  Eigen::VectorXd grad;  // dummy
+  Eigen::VectorXd grad;
   Eigen::MatrixXd hessian;
   interrupt();
-  math::internal::finite_diff_hessian_auto(log_density_fun, theta_hat, log_p,
-                                           grad, hessian);
+  double log_p = stan::model::log_prob_grad_hessian<true, jacobian>(
+      model, theta_hat, grad, hessian, &log_density_msgs);
   if (refresh > 0 && log_density_msgs.peek() != std::char_traits<char>::eof())
     logger.info(log_density_msgs);
 
@@ -90,47 +89,94 @@ void laplace_sample(const Model& model, const Eigen::VectorXd& theta_hat,
   interrupt();
   Eigen::MatrixXd inv_sqrt_neg_hessian = L_neg_hessian.inverse().transpose();
   interrupt();
-  Eigen::MatrixXd half_hessian = 0.5 * hessian;
 
   if (refresh > 0) {
     logger.info("Generating draws");
   }
-  // generate draws
-  std::stringstream refresh_msg;
-  stan::rng_t rng = util::create_rng(random_seed, 0);
-  Eigen::VectorXd draw_vec;  // declare draw_vec, msgs here to avoid re-alloc
-  for (int m = 0; m < draws; ++m) {
-    interrupt();  // allow interpution each iteration
-    if (refresh > 0 && m % refresh == 0) {
-      refresh_msg << "iteration: " << std::to_string(m);
-      logger.info(refresh_msg);
-      refresh_msg.str(std::string());
-    }
-    Eigen::VectorXd z(num_unc_params);
-    for (int n = 0; n < num_unc_params; ++n) {
-      z(n) = math::std_normal_rng(rng);
+  // Draws are generated in blocks of a fixed size, each with its own
+  // RNG, and blocks are evaluated in parallel in rounds.  Rows and
+  // messages are emitted in draw order after each round, so the output
+  // for a given seed does not depend on the number of threads.
+  static constexpr int block_size = 64;
+  static constexpr int blocks_per_round = 64;
+  const int num_blocks = (draws + block_size - 1) / block_size;
+  std::vector<std::vector<double>> rows(block_size * blocks_per_round);
+  std::vector<std::string> draw_msgs(block_size * blocks_per_round);
+
+  const auto generate_block = [&](int block, int slot) {
+    const int begin = block * block_size;
+    const int size = std::min(draws - begin, block_size);
+    stan::rng_t rng = util::create_rng(random_seed, block);
+    Eigen::MatrixXd z(num_unc_params, size);
+    for (int m = 0; m < size; ++m) {
+      for (int n = 0; n < num_unc_params; ++n) {
+        z(n, m) = math::std_normal_rng(rng);
+      }
     }
-    Eigen::VectorXd unc_draw = theta_hat + inv_sqrt_neg_hessian * z;
+    Eigen::MatrixXd unc_draws
+        = inv_sqrt_neg_hessian.triangularView<Eigen::Upper>() * z;
+    unc_draws.colwise() += theta_hat;
+
     std::stringstream write_array_msgs;
-    model.write_array(rng, unc_draw, draw_vec, include_tp, include_gq,
-                      &write_array_msgs);
-    if (refresh > 0 && write_array_msgs.peek() != std::char_traits<char>::eof())
-      logger.info(write_array_msgs);
-    // output draw, log_p, log_q
-    std::vector<double> draw(&draw_vec(0), &draw_vec(0) + draw_size);
-
-    double log_p;
-    if (calculate_lp) {
-      log_p = log_density_fun(unc_draw).val();
-    } else {
-      log_p = std::numeric_limits<double>::quiet_NaN();
+    Eigen::VectorXd draw_vec;
+    for (int m = 0; m < size; ++m) {
+      Eigen::VectorXd unc_draw = unc_draws.col(m);
+      model.write_array(rng, unc_draw, draw_vec, include_tp, include_gq,
+                        &write_array_msgs);
+      // output draw, log_p, log_q
+      std::vector<double>& draw = rows[slot * block_size + m];
+      draw.resize(draw_size + 2);
+      if (calculate_lp) {
+        math::nested_rev_autodiff nested;
+        Eigen::Matrix<math::var, -1, 1> ad_draw = unc_draw.cast<math::var>();
+        math::var lp = model.template log_prob<true, jacobian, math::var>(
+            ad_draw, nullptr);
+        draw[0] = lp.val();
+      } else {
+        draw[0] = std::numeric_limits<double>::quiet_NaN();
+      }
+      // the quadratic form of the approximation reduces to -0.5 |z|^2
+      draw[1] = -0.5 * z.col(m).squaredNorm();
+      std::copy(draw_vec.data(), draw_vec.data() + draw_size,
+                draw.begin() + 2);
+      draw_msgs[slot * block_size + m] = write_array_msgs.str();
+      write_array_msgs.str(std::string());
+    }
+  };
+
+  callbacks::async_write_queue write_queue;
+  callbacks::async_writer draw_writer(write_queue, sample_writer);
+  std::stringstream refresh_msg;
+  for (int first = 0; first < num_blocks; first += blocks_per_round) {
+    interrupt();  // allow interruption each round
+    const int last = std::min(num_blocks, first + blocks_per_round);
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<int>(first, last),
+                      [&](const tbb::blocked_range<int>& r) {
+                        for (int block = r.begin(); block < r.end(); ++block) {
+                          generate_block(block, block - first);
+                        }
+                      });
+#else
+    for (int block = first; block < last; ++block) {
+      generate_block(block, block - first);
+    }
+#endif
+    const int begin = first * block_size;
+    const int end = std::min(draws, last * block_size);
+    for (int m = begin; m < end; ++m) {
+      if (refresh > 0 && m % refresh == 0) {
+        refresh_msg << "iteration: " << std::to_string(m);
+        logger.info(refresh_msg);
+        refresh_msg.str(std::string());
+      }
+      if (refresh > 0 && !draw_msgs[m - begin].empty()) {
+        logger.info(draw_msgs[m - begin]);
+      }
+      draw_writer(std::move(rows[m - begin]));
     }
-    draw.insert(draw.begin(), log_p);
-    Eigen::VectorXd diff = unc_draw - theta_hat;
-    double log_q = diff.transpose() * half_hessian * diff;
-    draw.insert(draw.begin() + 1, log_q);
-    sample_writer(draw);
   }
+  write_queue.close();
 }  // namespace internal
 }  // namespace internal
 
@@ -3,12 +3,14 @@
 
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/optimization/bfgs.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/create_rng.hpp>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -48,6 +50,8 @@ namespace optimize {
  * @param[in,out] logger Logger for messages
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] parameter_writer output for parameter values
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each iteration if it is enabled
  * @return error_codes::OK if successful
  */
 template <class Model, bool jacobian = false>
@@ -58,7 +62,8 @@ int lbfgs(Model& model, const stan::io::var_context& init,
           double tol_param, int num_iterations, bool save_iterations,
           int refresh, callbacks::interrupt& interrupt,
           callbacks::logger& logger, callbacks::writer& init_writer,
-          callbacks::writer& parameter_writer) {
+          callbacks::writer& parameter_writer,
+          callbacks::telemetry& telemetry) {
   stan::rng_t rng = util::create_rng(random_seed, chain);
 
   std::vector<int> disc_vector;
@@ -85,6 +90,8 @@ int lbfgs(Model& model, const stan::io::var_context& init,
   lbfgs._conv_opts.tolRelGrad = tol_rel_grad;
   lbfgs._conv_opts.tolAbsX = tol_param;
   lbfgs._conv_opts.maxIts = num_iterations;
+  if (telemetry.enabled())
+    lbfgs.set_grad_timing(true);
 
   double lp = lbfgs.logp();
 
@@ -124,8 +131,24 @@ int lbfgs(Model& model, const stan::io::var_context& init,
             "  # evals"
             "  Notes ");
 
+      callbacks::transition_stats stats;
+      std::chrono::steady_clock::time_point start;
+      if (telemetry.enabled()) {
+        stats.gradient_evals = lbfgs.grad_evals();
+        stats.gradient_seconds = lbfgs.grad_seconds();
+        start = std::chrono::steady_clock::now();
+      }
+
       ret = lbfgs.step();
 
+      if (telemetry.enabled()) {
+        stats.transition_seconds = std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count();
+        stats.gradient_evals = lbfgs.grad_evals() - stats.gradient_evals;
+        stats.gradient_seconds = lbfgs.grad_seconds() - stats.gradient_seconds;
+      }
+
       lp = lbfgs.logp();
       lbfgs.params_r(cont_vector);
 
@@ -156,14 +179,29 @@ int lbfgs(Model& model, const stan::io::var_context& init,
       if (save_iterations) {
         std::vector<double> values;
         std::stringstream msg;
+        if (telemetry.enabled())
+          start = std::chrono::steady_clock::now();
         model.write_array(rng, cont_vector, disc_vector, values, true, true,
                           &msg);
+        std::chrono::steady_clock::time_point end_write_array;
+        if (telemetry.enabled())
+          end_write_array = std::chrono::steady_clock::now();
         if (msg.str().length() > 0)
           logger.info(msg);
 
         values.insert(values.begin(), lp);
         parameter_writer(values);
+        if (telemetry.enabled()) {
+          stats.write_array_seconds
+              = std::chrono::duration<double>(end_write_array - start).count();
+          stats.writer_seconds = std::chrono::duration<double>(
+                                     std::chrono::steady_clock::now()
+                                     - end_write_array)
+                                     .count();
+        }
       }
+      if (telemetry.enabled())
+        telemetry(stats);
     }
   } catch (const std::exception& e) {
     logger.error(e.what());
@@ -206,6 +244,29 @@ int lbfgs(Model& model, const stan::io::var_context& init,
   return return_code;
 }
 
+/**
+ * Runs the L-BFGS algorithm for a model without measuring its
+ * iterations.  See the overload taking a <code>telemetry</code> callback
+ * for the parameters.
+ */
+template <class Model, bool jacobian = false>
+int lbfgs(Model& model, const stan::io::var_context& init,
+          unsigned int random_seed, unsigned int chain, double init_radius,
+          int history_size, double init_alpha, double tol_obj,
+          double tol_rel_obj, double tol_grad, double tol_rel_grad,
+          double tol_param, int num_iterations, bool save_iterations,
+          int refresh, callbacks::interrupt& interrupt,
+          callbacks::logger& logger, callbacks::writer& init_writer,
+          callbacks::writer& parameter_writer) {
+  callbacks::telemetry no_telemetry;
+  return lbfgs<Model, jacobian>(model, init, random_seed, chain, init_radius,
+                                history_size, init_alpha, tol_obj, tol_rel_obj,
+                                tol_grad, tol_rel_grad, tol_param,
+                                num_iterations, save_iterations, refresh,
+                                interrupt, logger, init_writer,
+                                parameter_writer, no_telemetry);
+}
+
 }  // namespace optimize
 }  // namespace services
 }  // namespace stan
@@ -87,6 +87,8 @@ namespace pathfinder {
  *  samples are written to `parameter_writer`. If `false`, no psis resampling is
  * performed and (`num_paths` * `num_draws`) samples are written to
  * `parameter_writer`.
+ * @param[in] elbo_mcse_tol If positive, each ELBO estimate stops evaluating
+ * draws once its Monte Carlo standard error is at most this value.
  * @return error_codes::OK if successful
  */
 template <class Model, typename InitContext, typename InitWriter,
@@ -103,7 +105,8 @@ inline int pathfinder_lbfgs_multi(
     std::vector<SingleParamWriter>& single_path_parameter_writer,
     std::vector<SingleDiagnosticWriter>& single_path_diagnostic_writer,
     ParamWriter& parameter_writer, DiagnosticWriter& diagnostic_writer,
-    bool calculate_lp = true, bool psis_resample = true) {
+    bool calculate_lp = true, bool psis_resample = true,
+    double elbo_mcse_tol = 0.0) {
   const auto start_pathfinders_time = std::chrono::steady_clock::now();
   std::vector<std::string> param_names;
   param_names.push_back("lp_approx__");
@@ -129,7 +132,8 @@ inline int pathfinder_lbfgs_multi(
                     num_elbo_draws, num_draws, save_iterations, refresh,
                     interrupt, logger, init_writers[iter],
                     single_path_parameter_writer[iter],
-                    single_path_diagnostic_writer[iter], calculate_lp);
+                    single_path_diagnostic_writer[iter], calculate_lp,
+                    elbo_mcse_tol);
             if (unlikely(std::get<0>(pathfinder_ret) != error_codes::OK)) {
               logger.error(std::string("Pathfinder iteration: ")
                            + std::to_string(iter) + " failed.");
@@ -12,9 +12,13 @@
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/duration_diff.hpp>
 #include <boost/circular_buffer.hpp>
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/concurrent_queue.h>
 #include <tbb/task_group.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <atomic>
@@ -210,6 +214,11 @@ generate_matrix(Generator&& variate_generator, const Eigen::Index num_params,
  * @param logger A callback writer for messages
  * @param calculate_lp If true, calculate the log probability of the samples.
  * Else set to `NaN` for each sample.
+ * @param elbo_mcse_tol If positive and `ReturnElbo` is true, stop evaluating
+ * draws once the Monte Carlo standard error of the ELBO estimate is at most
+ * this value. Draws are evaluated in batches of 16, 32, 64, ... draws and the
+ * samples and log probabilities of unevaluated draws are dropped from the
+ * result.
  * @return A struct with the ELBO estimate along with the samples and log
  * probability ratios.
  */
@@ -220,7 +229,8 @@ inline elbo_est_t est_approx_draws(LPF&& lp_fun, ConstrainF&& constrain_fun,
                                    const taylor_approx_t& taylor_approx,
                                    size_t num_samples, const EigVec& alpha,
                                    const std::string& iter_msg, Logger&& logger,
-                                   bool calculate_lp = true) {
+                                   bool calculate_lp = true,
+                                   double elbo_mcse_tol = 0.0) {
   boost::variate_generator<stan::rng_t&, boost::normal_distribution<>>
       rand_unit_gaus(rng, boost::normal_distribution<>());
   const auto num_params = taylor_approx.x_center.size();
@@ -234,26 +244,62 @@ inline elbo_est_t est_approx_draws(LPF&& lp_fun, ConstrainF&& constrain_fun,
                            + num_params * stan::math::LOG_TWO_PI);
   Eigen::MatrixXd approx_samples
       = approximate_samples(std::move(unit_samps), taylor_approx);
-  const auto log_stream
-      = [](auto& logger, auto& pathfinder_ss, const auto& iter_msg) {
-          if (pathfinder_ss.str().length() == 0)
-            return;
-          logger.info(iter_msg + pathfinder_ss.str());
-          pathfinder_ss.str(std::string());
-        };
-  Eigen::VectorXd approx_samples_col;
-  std::stringstream pathfinder_ss;
   Eigen::Array<double, Eigen::Dynamic, 1> lp_ratio;
   if (calculate_lp) {
-    for (Eigen::Index i = 0; i < num_samples; ++i) {
-      try {
-        approx_samples_col = approx_samples.col(i);
-        ++lp_fun_calls;
-        lp_mat.coeffRef(i, 1) = lp_fun(approx_samples_col, pathfinder_ss);
-      } catch (const std::domain_error& e) {
-        lp_mat.coeffRef(i, 1) = -std::numeric_limits<double>::infinity();
+    // Draws are evaluated in parallel. Messages are buffered per draw and
+    // logged in draw order so the output does not depend on the threads.
+    std::vector<std::string> draw_msgs(num_samples);
+    const auto eval_draws = [&](Eigen::Index begin, Eigen::Index end) {
+      tbb::parallel_for(
+          tbb::blocked_range<Eigen::Index>(begin, end),
+          [&](const tbb::blocked_range<Eigen::Index>& r) {
+            Eigen::VectorXd approx_samples_col;
+            std::stringstream pathfinder_ss;
+            for (Eigen::Index i = r.begin(); i < r.end(); ++i) {
+              try {
+                approx_samples_col = approx_samples.col(i);
+                lp_mat.coeffRef(i, 1)
+                    = lp_fun(approx_samples_col, pathfinder_ss);
+              } catch (const std::domain_error& e) {
+                lp_mat.coeffRef(i, 1)
+                    = -std::numeric_limits<double>::infinity();
+              }
+              if (pathfinder_ss.str().length() != 0) {
+                draw_msgs[i] = pathfinder_ss.str();
+                pathfinder_ss.str(std::string());
+              }
+            }
+          });
+      for (Eigen::Index i = begin; i < end; ++i) {
+        if (draw_msgs[i].length() != 0) {
+          logger.info(iter_msg + draw_msgs[i]);
+        }
       }
-      log_stream(logger, pathfinder_ss, iter_msg);
+      lp_fun_calls += end - begin;
+    };
+    Eigen::Index num_evaluated = num_samples;
+    if (ReturnElbo && elbo_mcse_tol > 0) {
+      num_evaluated = std::min<Eigen::Index>(num_samples, 16);
+      eval_draws(0, num_evaluated);
+      const auto elbo_mcse = [&lp_mat](Eigen::Index n) {
+        auto ratio = (lp_mat.col(1).head(n) - lp_mat.col(0).head(n)).eval();
+        double var = (ratio - ratio.mean()).square().sum() / (n - 1);
+        return std::sqrt(var / n);
+      };
+      // a NaN standard error, e.g. from a failed evaluation, never stops
+      while (num_evaluated < static_cast<Eigen::Index>(num_samples)
+             && !(elbo_mcse(num_evaluated) <= elbo_mcse_tol)) {
+        Eigen::Index next
+            = std::min<Eigen::Index>(num_samples, 2 * num_evaluated);
+        eval_draws(num_evaluated, next);
+        num_evaluated = next;
+      }
+      if (num_evaluated < static_cast<Eigen::Index>(num_samples)) {
+        approx_samples = approx_samples.leftCols(num_evaluated).eval();
+        lp_mat = lp_mat.topRows(num_evaluated).eval();
+      }
+    } else {
+      eval_draws(0, num_samples);
     }
     lp_ratio = lp_mat.col(1) - lp_mat.col(0);
   } else {
@@ -504,6 +550,8 @@ inline auto ret_pathfinder(int return_code, EigVec&& lp_ratio, EigMat&& samples,
  * @param num_elbo_draws Number of draws for the ELBO estimation
  * @param iter_msg The beginning of messages that includes the iteration number
  * @param logger A callback writer for messages
+ * @param elbo_mcse_tol If positive, stop the ELBO estimation once its Monte
+ * Carlo standard error is at most this value
  * @return A pair holding the elbo estimate information and the taylor
  * approximation information.
  */
@@ -514,7 +562,8 @@ auto pathfinder_impl(RNG&& rng, LPFun&& lp_fun, ConstrainFun&& constrain_fun,
                      AlphaVec&& alpha, CurrentParams&& current_params,
                      CurrentGrads&& current_grads, GradMat&& Ykt_mat,
                      ParamMat&& Skt_mat, std::size_t num_elbo_draws,
-                     const std::string& iter_msg, Logger&& logger) {
+                     const std::string& iter_msg, Logger&& logger,
+                     double elbo_mcse_tol = 0.0) {
   const auto history_size = Ykt_mat.cols();
   Eigen::MatrixXd Rk = Eigen::MatrixXd::Zero(history_size, history_size);
   Rk.template triangularView<Eigen::Upper>() = Skt_mat.transpose() * Ykt_mat;
@@ -528,7 +577,8 @@ auto pathfinder_impl(RNG&& rng, LPFun&& lp_fun, ConstrainFun&& constrain_fun,
   try {
     return std::make_pair(internal::est_approx_draws<true>(
                               lp_fun, constrain_fun, rng, taylor_appx,
-                              num_elbo_draws, alpha, iter_msg, logger),
+                              num_elbo_draws, alpha, iter_msg, logger,
+                              true, elbo_mcse_tol),
                           taylor_appx);
   } catch (const std::domain_error& e) {
     logger.warn(iter_msg + "ELBO estimation failed "
@@ -590,6 +640,10 @@ auto pathfinder_impl(RNG&& rng, LPFun&& lp_fun, ConstrainFun&& constrain_fun,
  * probability calculations will be `NA` and psis resampling will not be
  * performed. Setting this parameter to `false` will also set all of the lp
  * ratios to `NaN`.
+ * @param[in] elbo_mcse_tol If positive, the ELBO estimate at each iteration
+ * stops evaluating draws once its Monte Carlo standard error is at most this
+ * value, so fewer than `num_elbo_draws` draws may be used. The draws of each
+ * ELBO estimate are evaluated in parallel.
  * @return If `ReturnLpSamples` is `true`, returns a tuple of the error code,
  * approximate draws, and a vector of the lp ratio. If `false`, only returns an
  * error code `error_codes::OK` if successful, `error_codes::SOFTWARE`
@@ -605,7 +659,8 @@ inline auto pathfinder_lbfgs_single(
     int num_elbo_draws, int num_draws, bool save_iterations, int refresh,
     callbacks::interrupt& interrupt, callbacks::logger& logger,
     callbacks::writer& init_writer, ParamWriter& parameter_writer,
-    DiagnosticWriter& diagnostic_writer, bool calculate_lp = true) {
+    DiagnosticWriter& diagnostic_writer, bool calculate_lp = true,
+    double elbo_mcse_tol = 0.0) {
   const auto start_pathfinder_time = std::chrono::steady_clock::now();
   stan::rng_t rng = util::create_rng(random_seed, stride_id);
   std::vector<int> disc_vector;
@@ -778,7 +833,7 @@ inline auto pathfinder_lbfgs_single(
 
       auto pathfinder_res = internal::pathfinder_impl(
           rng, lp_fun, constrain_fun, alpha, lbfgs.curr_x(), lbfgs.curr_g(),
-          Ykt_map, Skt_map, num_elbo_draws, iter_msg, logger);
+          Ykt_map, Skt_map, num_elbo_draws, iter_msg, logger, elbo_mcse_tol);
       num_evals += pathfinder_res.first.fn_calls;
       print_log_remainder(write_log_cond, msg, ret, num_evals, lbfgs,
                           pathfinder_res.first.elbo, pathfinder_res.first.elbo,
@@ -400,6 +400,41 @@ struct max_depth {
   static int default_value() { return 10; }
 };
 
+/**
+ * Maximum rank of the low-rank part of the metric.
+ */
+struct metric_rank {
+  /**
+   * Return the string description of metric_rank.
+   *
+   * @return description
+   */
+  static std::string description() {
+    return "Maximum rank of the low-rank part of the metric.";
+  }
+
+  /**
+   * Validates metric_rank; metric_rank must be greater than or equal
+   * to 0.
+   *
+   * @param[in] metric_rank argument to validate
+   * @throw std::invalid_argument unless metric_rank is greater than or
+   *   equal to zero
+   */
+  static void validate(int metric_rank) {
+    if (!(metric_rank >= 0))
+      throw std::invalid_argument(
+          "metric_rank must be greater than or equal to 0.");
+  }
+
+  /**
+   * Return the default metric_rank value.
+   *
+   * @return 10
+   */
+  static int default_value() { return 10; }
+};
+
 /**
  * Step size for discrete evolution
  */
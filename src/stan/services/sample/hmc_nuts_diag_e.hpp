@@ -3,12 +3,14 @@
 
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/math/prim.hpp>
 #include <stan/mcmc/hmc/nuts/diag_e_nuts.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/run_sampler.hpp>
+#include <stan/services/util/async_writers.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/inv_metric.hpp>
@@ -43,6 +45,8 @@ namespace sample {
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] sample_writer Writer for draws
  * @param[in,out] diagnostic_writer Writer for diagnostic information
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each transition if it is enabled
  * @return error_codes::OK if successful
  */
 template <class Model>
@@ -55,7 +59,8 @@ int hmc_nuts_diag_e(Model& model, const stan::io::var_context& init,
                     callbacks::interrupt& interrupt, callbacks::logger& logger,
                     callbacks::writer& init_writer,
                     callbacks::writer& sample_writer,
-                    callbacks::writer& diagnostic_writer) {
+                    callbacks::writer& diagnostic_writer,
+                    callbacks::telemetry& telemetry) {
   stan::rng_t rng = util::create_rng(random_seed, chain);
   std::vector<int> disc_vector;
   std::vector<double> cont_vector;
@@ -82,7 +87,7 @@ int hmc_nuts_diag_e(Model& model, const stan::io::var_context& init,
   try {
     util::run_sampler(sampler, model, cont_vector, num_warmup, num_samples,
                       num_thin, refresh, save_warmup, rng, interrupt, logger,
-                      sample_writer, diagnostic_writer);
+                      sample_writer, diagnostic_writer, telemetry);
   } catch (const std::exception& e) {
     logger.error(e.what());
     return error_codes::SOFTWARE;
@@ -90,6 +95,31 @@ int hmc_nuts_diag_e(Model& model, const stan::io::var_context& init,
   return error_codes::OK;
 }
 
+/**
+ * Runs HMC with NUTS without adaptation using diagonal Euclidean metric
+ * with a pre-specified diagonal metric, without measuring its transitions.
+ * See the overload taking a <code>telemetry</code> callback for the
+ * parameters.
+ */
+template <class Model>
+int hmc_nuts_diag_e(Model& model, const stan::io::var_context& init,
+                    const stan::io::var_context& init_inv_metric,
+                    unsigned int random_seed, unsigned int chain,
+                    double init_radius, int num_warmup, int num_samples,
+                    int num_thin, bool save_warmup, int refresh,
+                    double stepsize, double stepsize_jitter, int max_depth,
+                    callbacks::interrupt& interrupt, callbacks::logger& logger,
+                    callbacks::writer& init_writer,
+                    callbacks::writer& sample_writer,
+                    callbacks::writer& diagnostic_writer) {
+  callbacks::telemetry no_telemetry;
+  return hmc_nuts_diag_e(
+      model, init, init_inv_metric, random_seed, chain, init_radius, num_warmup,
+      num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
+      max_depth, interrupt, logger, init_writer, sample_writer,
+      diagnostic_writer, no_telemetry);
+}
+
 /**
  * Runs HMC with NUTS without adaptation using diagonal Euclidean metric,
  * with identity matrix as initial inv_metric.
@@ -146,6 +176,7 @@ int hmc_nuts_diag_e(Model& model, const stan::io::var_context& init,
  * @tparam SamplerWriter A type derived from `stan::callbacks::writer`
  * @tparam DiagnosticWriter A type derived from `stan::callbacks::writer`
  * @tparam InitWriter A type derived from `stan::callbacks::writer`
+ * @tparam Telemetry A type derived from `stan::callbacks::telemetry`
  * @param[in] model Input model to test (with data already instantiated)
  * @param[in] num_chains The number of chains to run in parallel. `init`,
  * `init_inv_metric`, `init_writer`, `sample_writer`, and `diagnostic_writer`
@@ -174,10 +205,13 @@ int hmc_nuts_diag_e(Model& model, const stan::io::var_context& init,
  * @param[in,out] sample_writer std vector of Writers for draws of each chain.
  * @param[in,out] diagnostic_writer std vector of Writers for diagnostic
  * information of each chain.
+ * @param[in,out] telemetry std vector of callbacks called with the
+ * measurements of each transition of each chain if they are enabled.
  * @return error_codes::OK if successful
  */
 template <class Model, typename InitContextPtr, typename InitInvContextPtr,
-          typename InitWriter, typename SampleWriter, typename DiagnosticWriter>
+          typename InitWriter, typename SampleWriter, typename DiagnosticWriter,
+          typename Telemetry>
 int hmc_nuts_diag_e(Model& model, size_t num_chains,
                     const std::vector<InitContextPtr>& init,
                     const std::vector<InitInvContextPtr>& init_inv_metric,
@@ -188,13 +222,14 @@ int hmc_nuts_diag_e(Model& model, size_t num_chains,
                     callbacks::interrupt& interrupt, callbacks::logger& logger,
                     std::vector<InitWriter>& init_writer,
                     std::vector<SampleWriter>& sample_writer,
-                    std::vector<DiagnosticWriter>& diagnostic_writer) {
+                    std::vector<DiagnosticWriter>& diagnostic_writer,
+                    std::vector<Telemetry>& telemetry) {
   if (num_chains == 1) {
     return hmc_nuts_diag_e(
         model, *init[0], *init_inv_metric[0], random_seed, init_chain_id,
         init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
         stepsize, stepsize_jitter, max_depth, interrupt, logger, init_writer[0],
-        sample_writer[0], diagnostic_writer[0]);
+        sample_writer[0], diagnostic_writer[0], telemetry[0]);
   }
   std::vector<stan::rng_t> rngs;
   rngs.reserve(num_chains);
@@ -222,24 +257,63 @@ int hmc_nuts_diag_e(Model& model, size_t num_chains,
     logger.error(e.what());
     return error_codes::CONFIG;
   }
-  tbb::parallel_for(
-      tbb::blocked_range<size_t>(0, num_chains, 1),
-      [num_warmup, num_samples, num_thin, refresh, save_warmup, num_chains,
-       init_chain_id, &samplers, &model, &rngs, &interrupt, &logger,
-       &sample_writer, &cont_vectors,
-       &diagnostic_writer](const tbb::blocked_range<size_t>& r) {
-        for (size_t i = r.begin(); i != r.end(); ++i) {
-          util::run_sampler(samplers[i], model, cont_vectors[i], num_warmup,
-                            num_samples, num_thin, refresh, save_warmup,
-                            rngs[i], interrupt, logger, sample_writer[i],
-                            diagnostic_writer[i], init_chain_id + i,
-                            num_chains);
-        }
-      },
-      tbb::simple_partitioner());
+  callbacks::async_write_queue write_queue;
+  auto async_sample_writer
+      = util::make_async_writers(write_queue, sample_writer);
+  auto async_diagnostic_writer
+      = util::make_async_writers(write_queue, diagnostic_writer);
+  try {
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_chains, 1),
+        [num_warmup, num_samples, num_thin, refresh, save_warmup, num_chains,
+         init_chain_id, &samplers, &model, &rngs, &interrupt, &logger,
+         &async_sample_writer, &cont_vectors, &telemetry,
+         &async_diagnostic_writer](const tbb::blocked_range<size_t>& r) {
+          for (size_t i = r.begin(); i != r.end(); ++i) {
+            util::run_sampler(samplers[i], model, cont_vectors[i], num_warmup,
+                              num_samples, num_thin, refresh, save_warmup,
+                              rngs[i], interrupt, logger,
+                              async_sample_writer[i],
+                              async_diagnostic_writer[i], telemetry[i],
+                              init_chain_id + i, num_chains);
+          }
+        },
+        tbb::simple_partitioner());
+    write_queue.close();
+  } catch (const std::exception& e) {
+    logger.error(e.what());
+    return error_codes::SOFTWARE;
+  }
   return error_codes::OK;
 }
 
+/**
+ * Runs multiple chains of HMC with NUTS without adaptation using diagonal
+ * Euclidean metric with a pre-specified diagonal metric, without measuring
+ * their transitions.  See the overload taking <code>telemetry</code>
+ * callbacks for the parameters.
+ */
+template <class Model, typename InitContextPtr, typename InitInvContextPtr,
+          typename InitWriter, typename SampleWriter, typename DiagnosticWriter>
+int hmc_nuts_diag_e(Model& model, size_t num_chains,
+                    const std::vector<InitContextPtr>& init,
+                    const std::vector<InitInvContextPtr>& init_inv_metric,
+                    unsigned int random_seed, unsigned int init_chain_id,
+                    double init_radius, int num_warmup, int num_samples,
+                    int num_thin, bool save_warmup, int refresh,
+                    double stepsize, double stepsize_jitter, int max_depth,
+                    callbacks::interrupt& interrupt, callbacks::logger& logger,
+                    std::vector<InitWriter>& init_writer,
+                    std::vector<SampleWriter>& sample_writer,
+                    std::vector<DiagnosticWriter>& diagnostic_writer) {
+  std::vector<callbacks::telemetry> no_telemetry(num_chains);
+  return hmc_nuts_diag_e(
+      model, num_chains, init, init_inv_metric, random_seed, init_chain_id,
+      init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
+      stepsize, stepsize_jitter, max_depth, interrupt, logger, init_writer,
+      sample_writer, diagnostic_writer, no_telemetry);
+}
+
 /**
  * Runs HMC with NUTS with adaptation using diagonal Euclidean metric.
  *
@@ -4,15 +4,18 @@
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/math/prim.hpp>
 #include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
 #include <stan/services/error_codes.hpp>
+#include <stan/services/util/async_writers.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/inv_metric.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/run_adaptive_sampler.hpp>
+#include <stan/services/util/run_lockstep_adaptive_sampler.hpp>
 #include <vector>
 
 namespace stan {
@@ -52,6 +55,8 @@ namespace sample {
  * @param[in,out] sample_writer Writer for draws
  * @param[in,out] diagnostic_writer Writer for diagnostic information
  * @param[in,out] metric_writer Writer for tuning params
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each transition if it is enabled
  * @return error_codes::OK if successful
  */
 template <class Model>
@@ -65,7 +70,8 @@ int hmc_nuts_diag_e_adapt(
     unsigned int window, callbacks::interrupt& interrupt,
     callbacks::logger& logger, callbacks::writer& init_writer,
     callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer,
-    callbacks::structured_writer& metric_writer) {
+    callbacks::structured_writer& metric_writer,
+    callbacks::telemetry& telemetry) {
   stan::rng_t rng = util::create_rng(random_seed, chain);
 
   std::vector<double> cont_vector;
@@ -103,7 +109,7 @@ int hmc_nuts_diag_e_adapt(
     util::run_adaptive_sampler(sampler, model, cont_vector, num_warmup,
                                num_samples, num_thin, refresh, save_warmup, rng,
                                interrupt, logger, sample_writer,
-                               diagnostic_writer, metric_writer);
+                               diagnostic_writer, metric_writer, telemetry);
   } catch (const std::exception& e) {
     logger.error(e.what());
     return error_codes::SOFTWARE;
@@ -111,6 +117,33 @@ int hmc_nuts_diag_e_adapt(
   return error_codes::OK;
 }
 
+/**
+ * Runs HMC with NUTS with adaptation using diagonal Euclidean metric with a
+ * pre-specified diagonal metric and saves adapted tuning parameters,
+ * without measuring its transitions.  See the overload taking a
+ * <code>telemetry</code> callback for the parameters.
+ */
+template <class Model>
+int hmc_nuts_diag_e_adapt(
+    Model& model, const stan::io::var_context& init,
+    const stan::io::var_context& init_inv_metric, unsigned int random_seed,
+    unsigned int chain, double init_radius, int num_warmup, int num_samples,
+    int num_thin, bool save_warmup, int refresh, double stepsize,
+    double stepsize_jitter, int max_depth, double delta, double gamma,
+    double kappa, double t0, unsigned int init_buffer, unsigned int term_buffer,
+    unsigned int window, callbacks::interrupt& interrupt,
+    callbacks::logger& logger, callbacks::writer& init_writer,
+    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer,
+    callbacks::structured_writer& metric_writer) {
+  callbacks::telemetry no_telemetry;
+  return hmc_nuts_diag_e_adapt(
+      model, init, init_inv_metric, random_seed, chain, init_radius, num_warmup,
+      num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
+      max_depth, delta, gamma, kappa, t0, init_buffer, term_buffer, window,
+      interrupt, logger, init_writer, sample_writer, diagnostic_writer,
+      metric_writer, no_telemetry);
+}
+
 /**
  * Runs HMC with NUTS with adaptation using diagonal Euclidean metric
  * with a pre-specified diagonal metric.
@@ -287,6 +320,7 @@ int hmc_nuts_diag_e_adapt(
  * @tparam SamplerWriter A type derived from `stan::callbacks::writer`
  * @tparam DiagnosticWriter A type derived from `stan::callbacks::writer`
  * @tparam MetricWriter A type derived from `stan::callbacks::structured_writer`
+ * @tparam Telemetry A type derived from `stan::callbacks::telemetry`
  * @param[in] model Input model (with data already instantiated)
  * @param[in] num_chains The number of chains to run in parallel. `init`,
  * `init_inv_metric`, `init_writer`, `sample_writer`, and `diagnostic_writer`
@@ -323,11 +357,19 @@ int hmc_nuts_diag_e_adapt(
  * @param[in,out] diagnostic_writer std vector of Writers for diagnostic
  * information of each chain.
  * @param[in,out] metric_writer std vector of Writers for tuning params
+ * @param[in,out] telemetry std vector of callbacks called with the
+ * measurements of each transition of each chain if they are enabled.
+ * @param[in] pool_adaptation whether to estimate the inverse metric from
+ * the warmup draws of all chains together rather than per chain, which is
+ * the same with a single chain (optional, default false)
+ * @param[in] convergence criteria for ending warmup and sampling early
+ * once the chains have converged, also applied to a single chain
+ * (optional, default disabled)
  * @return error_codes::OK if successful
  */
 template <class Model, typename InitContextPtr, typename InitInvContextPtr,
           typename InitWriter, typename SampleWriter, typename DiagnosticWriter,
-          typename MetricWriter>
+          typename MetricWriter, typename Telemetry>
 int hmc_nuts_diag_e_adapt(
     Model& model, size_t num_chains, const std::vector<InitContextPtr>& init,
     const std::vector<InitInvContextPtr>& init_inv_metric,
@@ -340,14 +382,17 @@ int hmc_nuts_diag_e_adapt(
     std::vector<InitWriter>& init_writer,
     std::vector<SampleWriter>& sample_writer,
     std::vector<DiagnosticWriter>& diagnostic_writer,
-    std::vector<MetricWriter>& metric_writer) {
-  if (num_chains == 1) {
+    std::vector<MetricWriter>& metric_writer,
+    std::vector<Telemetry>& telemetry,
+    bool pool_adaptation = false,
+    const util::convergence_criteria& convergence = {}) {
+  if (num_chains == 1 && !convergence.enabled()) {
     return hmc_nuts_diag_e_adapt(
         model, *init[0], *init_inv_metric[0], random_seed, init_chain_id,
         init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
         stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
         init_buffer, term_buffer, window, interrupt, logger, init_writer[0],
-        sample_writer[0], diagnostic_writer[0], metric_writer[0]);
+        sample_writer[0], diagnostic_writer[0], metric_writer[0], telemetry[0]);
   }
   using sample_t = stan::mcmc::adapt_diag_e_nuts<Model, stan::rng_t>;
   std::vector<stan::rng_t> rngs;
@@ -383,22 +428,37 @@ int hmc_nuts_diag_e_adapt(
     logger.error(e.what());
     return error_codes::CONFIG;
   }
+  callbacks::async_write_queue write_queue;
+  auto async_sample_writer
+      = util::make_async_writers(write_queue, sample_writer);
+  auto async_diagnostic_writer
+      = util::make_async_writers(write_queue, diagnostic_writer);
   try {
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, num_chains, 1),
-        [num_warmup, num_samples, num_thin, refresh, save_warmup, num_chains,
-         init_chain_id, &samplers, &model, &rngs, &interrupt, &logger,
-         &sample_writer, &cont_vectors, &diagnostic_writer,
-         &metric_writer](const tbb::blocked_range<size_t>& r) {
-          for (size_t i = r.begin(); i != r.end(); ++i) {
-            util::run_adaptive_sampler(
-                samplers[i], model, cont_vectors[i], num_warmup, num_samples,
-                num_thin, refresh, save_warmup, rngs[i], interrupt, logger,
-                sample_writer[i], diagnostic_writer[i], metric_writer[i],
-                init_chain_id + i, num_chains);
-          }
-        },
-        tbb::simple_partitioner());
+    if (pool_adaptation || convergence.enabled()) {
+      util::run_lockstep_adaptive_sampler(
+          samplers, model, cont_vectors, num_warmup, num_samples, num_thin,
+          refresh, save_warmup, rngs, interrupt, logger, async_sample_writer,
+          async_diagnostic_writer, metric_writer, telemetry, pool_adaptation,
+          convergence, init_chain_id);
+    } else {
+      tbb::parallel_for(
+          tbb::blocked_range<size_t>(0, num_chains, 1),
+          [num_warmup, num_samples, num_thin, refresh, save_warmup, num_chains,
+           init_chain_id, &samplers, &model, &rngs, &interrupt, &logger,
+           &async_sample_writer, &cont_vectors, &async_diagnostic_writer,
+           &metric_writer, &telemetry](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i != r.end(); ++i) {
+              util::run_adaptive_sampler(
+                  samplers[i], model, cont_vectors[i], num_warmup, num_samples,
+                  num_thin, refresh, save_warmup, rngs[i], interrupt, logger,
+                  async_sample_writer[i], async_diagnostic_writer[i],
+                  metric_writer[i], telemetry[i], init_chain_id + i,
+                  num_chains);
+            }
+          },
+          tbb::simple_partitioner());
+    }
+    write_queue.close();
   } catch (const std::exception& e) {
     logger.error(e.what());
     return error_codes::SOFTWARE;
@@ -406,6 +466,40 @@ int hmc_nuts_diag_e_adapt(
   return error_codes::OK;
 }
 
+/**
+ * Runs multiple chains of HMC with NUTS with adaptation using diagonal
+ * Euclidean metric with a pre-specified diagonal metric and saves adapted
+ * tuning parameters, without measuring their transitions.  See the overload
+ * taking <code>telemetry</code> callbacks for the parameters.
+ */
+template <class Model, typename InitContextPtr, typename InitInvContextPtr,
+          typename InitWriter, typename SampleWriter, typename DiagnosticWriter,
+          typename MetricWriter>
+int hmc_nuts_diag_e_adapt(
+    Model& model, size_t num_chains, const std::vector<InitContextPtr>& init,
+    const std::vector<InitInvContextPtr>& init_inv_metric,
+    unsigned int random_seed, unsigned int init_chain_id, double init_radius,
+    int num_warmup, int num_samples, int num_thin, bool save_warmup,
+    int refresh, double stepsize, double stepsize_jitter, int max_depth,
+    double delta, double gamma, double kappa, double t0,
+    unsigned int init_buffer, unsigned int term_buffer, unsigned int window,
+    callbacks::interrupt& interrupt, callbacks::logger& logger,
+    std::vector<InitWriter>& init_writer,
+    std::vector<SampleWriter>& sample_writer,
+    std::vector<DiagnosticWriter>& diagnostic_writer,
+    std::vector<MetricWriter>& metric_writer,
+    bool pool_adaptation = false,
+    const util::convergence_criteria& convergence = {}) {
+  std::vector<callbacks::telemetry> no_telemetry(num_chains);
+  return hmc_nuts_diag_e_adapt(
+      model, num_chains, init, init_inv_metric, random_seed, init_chain_id,
+      init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
+      stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
+      init_buffer, term_buffer, window, interrupt, logger, init_writer,
+      sample_writer, diagnostic_writer, metric_writer, no_telemetry,
+      pool_adaptation, convergence);
+}
+
 /**
  * Runs multiple chains of HMC with NUTS with adaptation using diagonal
  * Euclidean metric with a pre-specified diagonal metric.
@@ -453,6 +547,12 @@ int hmc_nuts_diag_e_adapt(
  * @param[in,out] sample_writer std vector of Writers for draws of each chain.
  * @param[in,out] diagnostic_writer std vector of Writers for diagnostic
  * information of each chain.
+ * @param[in] pool_adaptation whether to estimate the inverse metric from
+ * the warmup draws of all chains together rather than per chain, which is
+ * the same with a single chain (optional, default false)
+ * @param[in] convergence criteria for ending warmup and sampling early
+ * once the chains have converged, also applied to a single chain
+ * (optional, default disabled)
  * @return error_codes::OK if successful
  */
 template <class Model, typename InitContextPtr, typename InitInvContextPtr,
@@ -468,10 +568,12 @@ int hmc_nuts_diag_e_adapt(
     callbacks::interrupt& interrupt, callbacks::logger& logger,
     std::vector<InitWriter>& init_writer,
     std::vector<SampleWriter>& sample_writer,
-    std::vector<DiagnosticWriter>& diagnostic_writer) {
+    std::vector<DiagnosticWriter>& diagnostic_writer,
+    bool pool_adaptation = false,
+    const util::convergence_criteria& convergence = {}) {
   std::vector<stan::callbacks::structured_writer> dummy_metric_writer(
       num_chains);
-  if (num_chains == 1) {
+  if (num_chains == 1 && !convergence.enabled()) {
     return hmc_nuts_diag_e_adapt(
         model, *init[0], *init_inv_metric[0], random_seed, init_chain_id,
         init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
@@ -484,7 +586,8 @@ int hmc_nuts_diag_e_adapt(
       init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
       stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
       init_buffer, term_buffer, window, interrupt, logger, init_writer,
-      sample_writer, diagnostic_writer, dummy_metric_writer);
+      sample_writer, diagnostic_writer, dummy_metric_writer, pool_adaptation,
+      convergence);
 }
 
 /**
@@ -533,6 +636,12 @@ int hmc_nuts_diag_e_adapt(
  * @param[in,out] diagnostic_writer std vector of Writers for diagnostic
  * information of each chain.
  * @param[in,out] metric_writer std vector of Writers for tuning params
+ * @param[in] pool_adaptation whether to estimate the inverse metric from
+ * the warmup draws of all chains together rather than per chain, which is
+ * the same with a single chain (optional, default false)
+ * @param[in] convergence criteria for ending warmup and sampling early
+ * once the chains have converged, also applied to a single chain
+ * (optional, default disabled)
  * @return error_codes::OK if successful
  */
 template <class Model, typename InitContextPtr, typename InitWriter,
@@ -549,14 +658,16 @@ int hmc_nuts_diag_e_adapt(
     std::vector<InitWriter>& init_writer,
     std::vector<SampleWriter>& sample_writer,
     std::vector<DiagnosticWriter>& diagnostic_writer,
-    std::vector<MetricWriter>& metric_writer) {
+    std::vector<MetricWriter>& metric_writer,
+    bool pool_adaptation = false,
+    const util::convergence_criteria& convergence = {}) {
   std::vector<std::unique_ptr<stan::io::array_var_context>> unit_e_metric;
   unit_e_metric.reserve(num_chains);
   for (size_t i = 0; i < num_chains; ++i) {
     unit_e_metric.emplace_back(std::make_unique<stan::io::array_var_context>(
         util::create_unit_e_diag_inv_metric(model.num_params_r())));
   }
-  if (num_chains == 1) {
+  if (num_chains == 1 && !convergence.enabled()) {
     return hmc_nuts_diag_e_adapt(
         model, *init[0], *unit_e_metric[0], random_seed, init_chain_id,
         init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
@@ -569,7 +680,8 @@ int hmc_nuts_diag_e_adapt(
       init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
       stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
       init_buffer, term_buffer, window, interrupt, logger, init_writer,
-      sample_writer, diagnostic_writer, metric_writer);
+      sample_writer, diagnostic_writer, metric_writer, pool_adaptation,
+      convergence);
 }
 
 /**
@@ -615,6 +727,12 @@ int hmc_nuts_diag_e_adapt(
  * @param[in,out] sample_writer std vector of Writers for draws of each chain.
  * @param[in,out] diagnostic_writer std vector of Writers for diagnostic
  * information of each chain.
+ * @param[in] pool_adaptation whether to estimate the inverse metric from
+ * the warmup draws of all chains together rather than per chain, which is
+ * the same with a single chain (optional, default false)
+ * @param[in] convergence criteria for ending warmup and sampling early
+ * once the chains have converged, also applied to a single chain
+ * (optional, default disabled)
  * @return error_codes::OK if successful
  */
 template <class Model, typename InitContextPtr, typename InitWriter,
@@ -629,7 +747,9 @@ int hmc_nuts_diag_e_adapt(
     callbacks::interrupt& interrupt, callbacks::logger& logger,
     std::vector<InitWriter>& init_writer,
     std::vector<SampleWriter>& sample_writer,
-    std::vector<DiagnosticWriter>& diagnostic_writer) {
+    std::vector<DiagnosticWriter>& diagnostic_writer,
+    bool pool_adaptation = false,
+    const util::convergence_criteria& convergence = {}) {
   std::vector<std::unique_ptr<stan::io::array_var_context>> unit_e_metric;
   unit_e_metric.reserve(num_chains);
   for (size_t i = 0; i < num_chains; ++i) {
@@ -638,7 +758,7 @@ int hmc_nuts_diag_e_adapt(
   }
   std::vector<stan::callbacks::structured_writer> dummy_metric_writer(
       num_chains);
-  if (num_chains == 1) {
+  if (num_chains == 1 && !convergence.enabled()) {
     return hmc_nuts_diag_e_adapt(
         model, *init[0], *unit_e_metric[0], random_seed, init_chain_id,
         init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
@@ -651,7 +771,8 @@ int hmc_nuts_diag_e_adapt(
       init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
       stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
       init_buffer, term_buffer, window, interrupt, logger, init_writer,
-      sample_writer, diagnostic_writer, dummy_metric_writer);
+      sample_writer, diagnostic_writer, dummy_metric_writer, pool_adaptation,
+      convergence);
 }
 
 }  // namespace sample
@@ -9,25 +9,119 @@
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/gq_writer.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <vector>
 
 namespace stan {
 namespace services {
+namespace internal {
+
+/**
+ * Generate the quantities of interest for the draws of one chain and
+ * write them to the specified writer in draw order.
+ *
+ * <p>Draws are processed in rounds.  Within a round, the draws are
+ * unconstrained and their quantities generated in parallel on the TBB
+ * thread pool.  Draw <code>i</code> uses substream <code>i + 1</code>
+ * of the chain as its generator, so the output is identical for any
+ * number of threads.  After each round the results are written in
+ * draw order on the calling thread.  The interrupt callback is called
+ * before each round.
+ *
+ * @tparam Model model class
+ * @param[in] model instantiated model
+ * @param[in] draws sequence of draws of constrained parameters
+ * @param[in] seed seed to use for randomization
+ * @param[in] chain chain id
+ * @param[in, out] interrupt called every round of draws
+ * @param[in, out] logger logger to which to write warning and error messages
+ * @param[in, out] writer writer of the generated quantities
+ * @param[in, out] error_any set on error; processing stops early when
+ * it is set by another chain
+ * @return error code
+ */
+template <class Model>
+int generate_chain(const Model &model, const Eigen::MatrixXd &draws,
+                   unsigned int seed, unsigned int chain,
+                   callbacks::interrupt &interrupt, callbacks::logger &logger,
+                   util::gq_writer &writer, std::atomic<bool> &error_any) {
+  struct draw_result {
+    util::gq_writer::gq_draw gq;
+    bool unconstrain_failed = false;
+    std::string msg;
+    std::string what;
+  };
+  static constexpr size_t draws_per_round = 256;
+  const size_t num_draws = draws.rows();
+  std::vector<draw_result> results(std::min(num_draws, draws_per_round));
+
+  for (size_t round_begin = 0; round_begin < num_draws;
+       round_begin += draws_per_round) {
+    if (error_any)
+      return error_codes::DATAERR;
+    interrupt();  // call out to interrupt and fail
+    const size_t round_end = std::min(num_draws, round_begin + draws_per_round);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(round_begin, round_end),
+        [&](const tbb::blocked_range<size_t> &r) {
+          std::vector<double> row(draws.cols());
+          std::vector<double> unconstrained_params_r;
+          std::stringstream msg;
+          for (size_t i = r.begin(); i != r.end(); ++i) {
+            draw_result &result = results[i - round_begin];
+            result.unconstrain_failed = false;
+            Eigen::Map<Eigen::VectorXd>(row.data(), draws.cols())
+                = draws.row(i);
+            try {
+              msg.str(std::string());
+              model.unconstrain_array(row, unconstrained_params_r, &msg);
+            } catch (const std::exception &e) {
+              result.unconstrain_failed = true;
+              result.msg = msg.str();
+              result.what = e.what();
+              continue;
+            }
+            stan::rng_t rng = util::create_rng(seed, chain, i + 1);
+            writer.generate_gq_values(model, rng, unconstrained_params_r,
+                                      result.gq);
+          }
+        });
+    for (size_t i = round_begin; i < round_end; ++i) {
+      draw_result &result = results[i - round_begin];
+      if (result.unconstrain_failed) {
+        if (result.msg.length() > 0)
+          logger.error(result.msg);
+        logger.error(result.what);
+        error_any = true;
+        return error_codes::DATAERR;
+      }
+      writer.write_gq_draw(result.gq);
+    }
+  }
+  return error_codes::OK;
+}
+
+}  // namespace internal
 
 /**
  * Given a set of draws from a fitted model, generate corresponding
  * quantities of interest which are written to callback writer.
  * Matrix of draws consists of one row per draw, one column per parameter.
- * Draws are processed one row at a time.
+ * Draws are processed in parallel, each with its own pseudo random
+ * number generator, and written in order, so the output does not
+ * depend on the number of threads.
  * Return code indicates success or type of error.
  *
  * @tparam Model model class
  * @param[in] model instantiated model
  * @param[in] draws sequence of draws of constrained parameters
  * @param[in] seed seed to use for randomization
- * @param[in, out] interrupt called every iteration
+ * @param[in, out] interrupt called every round of draws
  * @param[in, out] logger logger to which to write warning and error messages
  * @param[in, out] sample_writer writer to which draws are written
  * @return error code
@@ -63,36 +157,23 @@ int standalone_generate(const Model &model, const Eigen::MatrixXd &draws,
   util::gq_writer writer(sample_writer, logger, p_names.size());
   writer.write_gq_names(model);
 
-  stan::rng_t rng = util::create_rng(seed, 1);
-
-  std::vector<double> unconstrained_params_r;
-  std::vector<double> row(draws.cols());
+  std::atomic<bool> error_any{false};
   try {
-    for (size_t i = 0; i < draws.rows(); ++i) {
-      Eigen::Map<Eigen::VectorXd>(&row[0], draws.cols()) = draws.row(i);
-      try {
-        model.unconstrain_array(row, unconstrained_params_r, &msg);
-      } catch (const std::exception &e) {
-        if (msg.str().length() > 0)
-          logger.error(msg);
-        logger.error(e.what());
-        return error_codes::DATAERR;
-      }
-      interrupt();  // call out to interrupt and fail
-      writer.write_gq_values(model, rng, unconstrained_params_r);
-    }
+    return internal::generate_chain(model, draws, seed, 1, interrupt, logger,
+                                    writer, error_any);
   } catch (const std::exception &e) {
     logger.error(e.what());
     return error_codes::SOFTWARE;
   }
-  return error_codes::OK;
 }
 
 /**
  * Given a set of draws from a fitted model, generate corresponding
  * quantities of interest which are written to callback writer.
  * Matrix of draws consists of one row per draw, one column per parameter.
- * Draws are processed one row at a time.
+ * Chains are processed in parallel, and the draws within each chain
+ * are processed in parallel as well, each with its own pseudo random
+ * number generator, and written in order.
  * Return code indicates success or type of error.
  *
  * @tparam Model model class
@@ -102,7 +183,7 @@ int standalone_generate(const Model &model, const Eigen::MatrixXd &draws,
  * @param[in] draws standard vector containing sequence of draws of constrained
  * parameters
  * @param[in] seed seed to use for randomization
- * @param[in, out] interrupt called every iteration
+ * @param[in, out] interrupt called every round of draws
  * @param[in, out] logger logger to which to write warning and error messages
  * @param[in, out] sample_writers A vector of writers to which draws for each
  * chain are written
@@ -129,8 +210,6 @@ int standalone_generate(const Model &model, const int num_chains,
   }
   std::vector<util::gq_writer> writers;
   writers.reserve(num_chains);
-  std::vector<stan::rng_t> rngs;
-  rngs.reserve(num_chains);
   for (int i = 0; i < num_chains; ++i) {
     if (draws[i].size() == 0) {
       logger.error("Empty set of draws from fitted model.");
@@ -148,36 +227,20 @@ int standalone_generate(const Model &model, const int num_chains,
     }
     writers.emplace_back(sample_writers[i], logger, p_names.size());
     writers[i].write_gq_names(model);
-    rngs.emplace_back(util::create_rng(seed, i + 1));
   }
-  bool error_any = false;
+  std::atomic<bool> error_any{false};
   try {
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, num_chains, 1),
-        [&draws, &model, &logger, &interrupt, &writers, &rngs,
+        [&draws, &model, seed, &logger, &interrupt, &writers,
          &error_any](const tbb::blocked_range<size_t> &r) {
-          Eigen::VectorXd unconstrained_params_r(draws[0].cols());
-          Eigen::VectorXd row(draws[0].cols());
-          std::stringstream msg;
           for (size_t slice_idx = r.begin(); slice_idx != r.end();
                ++slice_idx) {
-            for (size_t i = 0; i < draws[slice_idx].rows(); ++i) {
-              if (error_any)
-                return;
-              try {
-                row = draws[slice_idx].row(i);
-                model.unconstrain_array(row, unconstrained_params_r, &msg);
-              } catch (const std::domain_error &e) {
-                if (msg.str().length() > 0)
-                  logger.error(msg);
-                logger.error(e.what());
-                error_any = true;
-                return;
-              }
-              interrupt();  // call out to interrupt and fail
-              writers[slice_idx].write_gq_values(model, rngs[slice_idx],
-                                                 unconstrained_params_r);
-            }
+            if (internal::generate_chain(model, draws[slice_idx], seed,
+                                         slice_idx + 1, interrupt, logger,
+                                         writers[slice_idx], error_any)
+                != error_codes::OK)
+              return;
           }
         },
         tbb::simple_partitioner());
@@ -0,0 +1,36 @@
+#ifndef STAN_SERVICES_UTIL_ASYNC_WRITERS_HPP
+#define STAN_SERVICES_UTIL_ASYNC_WRITERS_HPP
+
+#include <stan/callbacks/async_writer.hpp>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Wrap each of the specified writers in a <code>callbacks::async_writer</code>
+ * queuing its calls on the specified queue, so that the chains of the
+ * multi-chain services hand their output to the queue's I/O thread
+ * instead of writing it themselves.
+ *
+ * @tparam Writer A type derived from <code>stan::callbacks::writer</code>
+ * @param[in, out] queue queue and I/O thread making the calls
+ * @param[in, out] writers writers receiving the calls, one per chain
+ * @return asynchronous writers, one per chain
+ */
+template <typename Writer>
+inline std::vector<callbacks::async_writer> make_async_writers(
+    callbacks::async_write_queue& queue, std::vector<Writer>& writers) {
+  std::vector<callbacks::async_writer> async_writers;
+  async_writers.reserve(writers.size());
+  for (auto& writer : writers) {
+    async_writers.emplace_back(queue, writer);
+  }
+  return async_writers;
+}
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
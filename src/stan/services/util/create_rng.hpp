@@ -33,6 +33,25 @@ inline rng_t create_rng(unsigned int seed, unsigned int chain) {
   return rng;
 }
 
+/**
+ * Creates a pseudo random number generator for a substream of a chain
+ * from a random seed, a chain id, and a substream id.  Distinct
+ * substreams of the same chain are distinct segments of the pseudo
+ * random number sequence, so work items such as individual draws can
+ * be given their own generator and evaluated in any order.  Substream
+ * zero is the generator returned by <code>create_rng(seed, chain)</code>.
+ *
+ * @param[in] seed the random seed
+ * @param[in] chain the chain id
+ * @param[in] substream the substream id
+ * @return an stan::rng_t instance
+ */
+inline rng_t create_rng(unsigned int seed, unsigned int chain,
+                        unsigned int substream) {
+  rng_t rng(substream, 1, seed, chain);
+  return rng;
+}
+
 }  // namespace util
 }  // namespace services
 }  // namespace stan
@@ -2,14 +2,81 @@
 #define STAN_SERVICES_UTIL_GENERATE_TRANSITIONS_HPP
 
 #include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
+#include <chrono>
 #include <string>
 
 namespace stan {
 namespace services {
 namespace util {
 
+namespace internal {
+
+/**
+ * Generates the MCMC transition of iteration <code>m</code> of a run of
+ * transitions, which determines whether the draw is thinned and whether
+ * an iteration number message is printed.  See
+ * <code>generate_transitions</code> for the parameters.
+ */
+template <class Model, class RNG>
+void generate_transition(stan::mcmc::base_mcmc& sampler, int m, int start,
+                         int finish, int num_thin, int refresh, bool save,
+                         bool warmup, util::mcmc_writer& mcmc_writer,
+                         stan::mcmc::sample& init_s, Model& model,
+                         RNG& base_rng, callbacks::interrupt& callback,
+                         callbacks::logger& logger,
+                         callbacks::telemetry& telemetry, size_t chain_id,
+                         size_t num_chains) {
+  callback();
+
+  if (refresh > 0
+      && (start + m + 1 == finish || m == 0 || (m + 1) % refresh == 0)) {
+    int it_print_width = std::ceil(std::log10(static_cast<double>(finish)));
+    std::stringstream message;
+    if (num_chains != 1) {
+      message << "Chain [" << chain_id << "] ";
+    }
+    message << "Iteration: ";
+    message << std::setw(it_print_width) << m + 1 + start << " / " << finish;
+    message << " [" << std::setw(3)
+            << static_cast<int>((100.0 * (start + m + 1)) / finish) << "%] ";
+    message << (warmup ? " (Warmup)" : " (Sampling)");
+
+    logger.info(message);
+  }
+
+  if (!telemetry.enabled()) {
+    init_s = sampler.transition(init_s, logger);
+    if (save && ((m % num_thin) == 0)) {
+      mcmc_writer.write_sample_params(base_rng, init_s, sampler, model);
+      mcmc_writer.write_diagnostic_params(init_s, sampler);
+    }
+    return;
+  }
+
+  using clock = std::chrono::steady_clock;
+  callbacks::transition_stats stats;
+  stats.warmup = warmup;
+  auto begin = clock::now();
+  init_s = sampler.transition(init_s, logger);
+  auto end = clock::now();
+  stats.transition_seconds = std::chrono::duration<double>(end - begin).count();
+  sampler.collect_telemetry(stats);
+
+  if (save && ((m % num_thin) == 0)) {
+    mcmc_writer.write_sample_params(base_rng, init_s, sampler, model, &stats);
+    mcmc_writer.write_diagnostic_params(init_s, sampler);
+    stats.writer_seconds
+        = std::chrono::duration<double>(clock::now() - end).count()
+          - stats.write_array_seconds;
+  }
+  telemetry(stats);
+}
+
+}  // namespace internal
+
 /**
  * Generates MCMC transitions.
  *
@@ -35,6 +102,8 @@ namespace util {
  * @param[in,out] base_rng random number generator
  * @param[in,out] callback interrupt callback called once an iteration
  * @param[in,out] logger logger for messages
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each transition if it is enabled
  * @param[in] chain_id The id of the current chain, used in output.
  * @param[in] num_chains The number of chains used in the program. This
  *  is used in generate transitions to print out the chain number.
@@ -46,34 +115,36 @@ void generate_transitions(stan::mcmc::base_mcmc& sampler, int num_iterations,
                           util::mcmc_writer& mcmc_writer,
                           stan::mcmc::sample& init_s, Model& model,
                           RNG& base_rng, callbacks::interrupt& callback,
-                          callbacks::logger& logger, size_t chain_id = 1,
+                          callbacks::logger& logger,
+                          callbacks::telemetry& telemetry, size_t chain_id = 1,
                           size_t num_chains = 1) {
-  for (int m = 0; m < num_iterations; ++m) {
-    callback();
-
-    if (refresh > 0
-        && (start + m + 1 == finish || m == 0 || (m + 1) % refresh == 0)) {
-      int it_print_width = std::ceil(std::log10(static_cast<double>(finish)));
-      std::stringstream message;
-      if (num_chains != 1) {
-        message << "Chain [" << chain_id << "] ";
-      }
-      message << "Iteration: ";
-      message << std::setw(it_print_width) << m + 1 + start << " / " << finish;
-      message << " [" << std::setw(3)
-              << static_cast<int>((100.0 * (start + m + 1)) / finish) << "%] ";
-      message << (warmup ? " (Warmup)" : " (Sampling)");
-
-      logger.info(message);
-    }
-
-    init_s = sampler.transition(init_s, logger);
+  if (telemetry.enabled())
+    sampler.enable_telemetry();
+  for (int m = 0; m < num_iterations; ++m)
+    internal::generate_transition(sampler, m, start, finish, num_thin, refresh,
+                                  save, warmup, mcmc_writer, init_s, model,
+                                  base_rng, callback, logger, telemetry,
+                                  chain_id, num_chains);
+}
 
-    if (save && ((m % num_thin) == 0)) {
-      mcmc_writer.write_sample_params(base_rng, init_s, sampler, model);
-      mcmc_writer.write_diagnostic_params(init_s, sampler);
-    }
-  }
+/**
+ * Generates MCMC transitions without measuring them.  See the overload
+ * taking a <code>telemetry</code> callback for the parameters.
+ */
+template <class Model, class RNG>
+void generate_transitions(stan::mcmc::base_mcmc& sampler, int num_iterations,
+                          int start, int finish, int num_thin, int refresh,
+                          bool save, bool warmup,
+                          util::mcmc_writer& mcmc_writer,
+                          stan::mcmc::sample& init_s, Model& model,
+                          RNG& base_rng, callbacks::interrupt& callback,
+                          callbacks::logger& logger, size_t chain_id = 1,
+                          size_t num_chains = 1) {
+  callbacks::telemetry no_telemetry;
+  generate_transitions(sampler, num_iterations, start, finish, num_thin,
+                       refresh, save, warmup, mcmc_writer, init_s, model,
+                       base_rng, callback, logger, no_telemetry, chain_id,
+                       num_chains);
 }
 
 }  // namespace util
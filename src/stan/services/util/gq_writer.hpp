@@ -7,9 +7,11 @@
 #include <stan/mcmc/sample.hpp>
 #include <stan/model/prob_grad.hpp>
 #include <stan/math/prim/meta.hpp>
+#include <exception>
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -59,41 +61,93 @@ class gq_writer {
   }
 
   /**
-   * Calls model's `write_array` method and writes values of
-   * variables defined in the generated quantities block
-   * to stream `sample_writer_`.
+   * Values of the generated quantities for one draw together with the
+   * messages produced while generating them, held until they are
+   * written with `write_gq_draw`.
+   */
+  struct gq_draw {
+    std::vector<double> values;
+    std::vector<std::string> messages;
+    std::exception_ptr error;
+  };
+
+  /**
+   * Calls model's `write_array` method and stores the values of
+   * variables defined in the generated quantities block, along with
+   * any messages, without writing anything.  This does not touch the
+   * writer or the logger, so it may be called concurrently for
+   * different draws.
    *
    * @tparam M model class
    * @tparam RNG pseudo random number generator class
    * @param[in] model instantiated model
    * @param[in] rng instantiated RNG
    * @param[in] draw sequence unconstrained parameters values.
+   * @param[out] gq generated quantities and messages
    */
   template <class Model, class RNG>
-  void write_gq_values(const Model& model, RNG& rng,
-                       std::vector<double>& draw) {
+  void generate_gq_values(const Model& model, RNG& rng,
+                          std::vector<double>& draw, gq_draw& gq) const {
     std::vector<double> values;
     std::vector<int> params_i;  // unused - no discrete params
     std::stringstream ss;
+    gq.messages.clear();
+    gq.error = nullptr;
     try {
       model.write_array(rng, draw, params_i, values, false, true, &ss);
       if (ss.str().length() > 0)
-        logger_.info(ss);
+        gq.messages.push_back(ss.str());
     } catch (const std::domain_error& e) {
       if (ss.str().length() > 0)
-        logger_.info(ss);
-      logger_.info(e.what());
+        gq.messages.push_back(ss.str());
+      gq.messages.push_back(e.what());
     } catch (const std::exception& e) {
       if (ss.str().length() > 0)
-        logger_.info(ss);
-      logger_.info(e.what());
-      throw;
+        gq.messages.push_back(ss.str());
+      gq.messages.push_back(e.what());
+      gq.error = std::current_exception();
+      gq.values.clear();
+      return;
     }
+    gq.values.assign(values.begin() + num_constrained_params_, values.end());
+  }
+
+  /**
+   * Writes the messages of a draw generated by `generate_gq_values` to
+   * the logger and its values to stream `sample_writer_`.
+   *
+   * @param[in,out] gq generated quantities and messages; the values are
+   * moved to the writer
+   * @throw the exception thrown by `write_array`, if it was not a
+   * domain error, after writing the messages
+   */
+  void write_gq_draw(gq_draw& gq) {
+    for (const auto& message : gq.messages)
+      logger_.info(message);
+    if (gq.error)
+      std::rethrow_exception(gq.error);
+    sample_writer_(std::move(gq.values));
+  }
 
-    std::vector<double> gq_values(values.begin() + num_constrained_params_,
-                                  values.end());
-    sample_writer_(gq_values);
+  /**
+   * Calls model's `write_array` method and writes values of
+   * variables defined in the generated quantities block
+   * to stream `sample_writer_`.
+   *
+   * @tparam M model class
+   * @tparam RNG pseudo random number generator class
+   * @param[in] model instantiated model
+   * @param[in] rng instantiated RNG
+   * @param[in] draw sequence unconstrained parameters values.
+   */
+  template <class Model, class RNG>
+  void write_gq_values(const Model& model, RNG& rng,
+                       std::vector<double>& draw) {
+    gq_draw gq;
+    generate_gq_values(model, rng, draw, gq);
+    write_gq_draw(gq);
   }
+
   /**
    * Calls model's `write_array` method and writes values of
    * variables defined in the generated quantities block
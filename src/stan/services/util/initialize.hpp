@@ -8,21 +8,316 @@
 #include <stan/io/chained_var_context.hpp>
 #include <stan/model/log_prob_grad.hpp>
 #include <stan/math/prim.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace stan {
 namespace services {
 namespace util {
 
+namespace internal {
+
+/**
+ * A logger which keeps the messages it receives so that they can be
+ * written to another logger later, in the order they were received.
+ */
+class buffered_logger : public stan::callbacks::logger {
+ public:
+  void debug(const std::string& message) { add(level_debug, message, false); }
+  void debug(const std::stringstream& message) {
+    add(level_debug, message.str(), true);
+  }
+  void info(const std::string& message) { add(level_info, message, false); }
+  void info(const std::stringstream& message) {
+    add(level_info, message.str(), true);
+  }
+  void warn(const std::string& message) { add(level_warn, message, false); }
+  void warn(const std::stringstream& message) {
+    add(level_warn, message.str(), true);
+  }
+  void error(const std::string& message) { add(level_error, message, false); }
+  void error(const std::stringstream& message) {
+    add(level_error, message.str(), true);
+  }
+  void fatal(const std::string& message) { add(level_fatal, message, false); }
+  void fatal(const std::stringstream& message) {
+    add(level_fatal, message.str(), true);
+  }
+
+  /**
+   * Write the buffered messages to the specified logger, using the
+   * same overload that each message was received with.
+   *
+   * @param[in,out] logger logger for messages
+   */
+  void write(stan::callbacks::logger& logger) const {
+    for (const auto& m : messages_) {
+      if (m.is_stream) {
+        std::stringstream ss;
+        ss << m.text;
+        write(logger, m.level, ss);
+      } else {
+        write(logger, m.level, m.text);
+      }
+    }
+  }
+
+ private:
+  enum message_level {
+    level_debug,
+    level_info,
+    level_warn,
+    level_error,
+    level_fatal
+  };
+
+  struct message {
+    message_level level;
+    std::string text;
+    bool is_stream;
+  };
+
+  std::vector<message> messages_;
+
+  void add(message_level level, const std::string& text, bool is_stream) {
+    messages_.push_back(message{level, text, is_stream});
+  }
+
+  template <typename T>
+  static void write(stan::callbacks::logger& logger, message_level level,
+                    const T& message) {
+    switch (level) {
+      case level_debug:
+        logger.debug(message);
+        break;
+      case level_info:
+        logger.info(message);
+        break;
+      case level_warn:
+        logger.warn(message);
+        break;
+      case level_error:
+        logger.error(message);
+        break;
+      case level_fatal:
+        logger.fatal(message);
+        break;
+    }
+  }
+};
+
+/**
+ * A candidate initial value and the outcome of evaluating it.
+ */
+struct init_candidate {
+  std::vector<double> unconstrained;
+  double log_prob = 0;
+  double gradient_seconds = 0;
+  bool valid = false;
+  std::exception_ptr error;
+  buffered_logger logger;
+};
+
+/**
+ * Evaluate a candidate initial value: construct it from the random
+ * draws, check that the log density is finite and that its gradient is
+ * finite.  Messages are written to the logger of the candidate and an
+ * unrecoverable error is stored in the candidate rather than thrown,
+ * so that candidates can be evaluated concurrently and reported in
+ * order.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in] any_initialized whether init provides any parameters
+ * @param[in,out] rng copy of the random number generator passed to
+ *   the model
+ * @param[in] draws random values on the unconstrained scale
+ * @param[out] candidate candidate to evaluate
+ */
+template <bool Jacobian, typename Model, typename InitContext, typename RNG>
+void evaluate_init_candidate(Model& model, const InitContext& init,
+                             bool any_initialized, RNG& rng,
+                             std::vector<double> draws,
+                             init_candidate& candidate) {
+  stan::callbacks::logger& logger = candidate.logger;
+  std::vector<double>& unconstrained = candidate.unconstrained;
+  std::vector<int> disc_vector;
+  std::stringstream msg;
+  try {
+    stan::io::random_var_context random_context(model, rng, std::move(draws));
+
+    if (!any_initialized) {
+      unconstrained = random_context.get_unconstrained();
+    } else {
+      stan::io::chained_var_context context(init, random_context);
+
+      model.transform_inits(context, disc_vector, unconstrained, &msg);
+    }
+  } catch (std::domain_error& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.warn("Rejecting initial value:");
+    logger.warn(
+        "  Error evaluating the log probability"
+        " at the initial value.");
+    logger.warn(e.what());
+    return;
+  } catch (std::exception& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.error(
+        "Unrecoverable error evaluating the log probability"
+        " at the initial value.");
+    candidate.error = std::current_exception();
+    return;
+  }
+
+  msg.str("");
+  double log_prob(0);
+  try {
+    // we evaluate the log_prob function with propto=false
+    // because we're evaluating with `double` as the type of
+    // the parameters.
+    log_prob = model.template log_prob<false, Jacobian>(unconstrained,
+                                                        disc_vector, &msg);
+    if (msg.str().length() > 0)
+      logger.info(msg);
+  } catch (std::domain_error& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.warn("Rejecting initial value:");
+    logger.warn(
+        "  Error evaluating the log probability"
+        " at the initial value.");
+    logger.warn(e.what());
+    return;
+  } catch (std::exception& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.error(
+        "Unrecoverable error evaluating the log probability"
+        " at the initial value.");
+    candidate.error = std::current_exception();
+    return;
+  }
+  if (!std::isfinite(log_prob)) {
+    logger.warn("Rejecting initial value:");
+    logger.warn(
+        "  Log probability evaluates to log(0),"
+        " i.e. negative infinity.");
+    logger.warn(
+        "  Stan can't start sampling from this"
+        " initial value.");
+    return;
+  }
+  candidate.log_prob = log_prob;
+  std::stringstream log_prob_msg;
+  std::vector<double> gradient;
+  auto start = std::chrono::steady_clock::now();
+  try {
+    // we evaluate this with propto=true since we're
+    // evaluating with autodiff variables
+    stan::model::log_prob_grad<true, Jacobian>(
+        model, unconstrained, disc_vector, gradient, &log_prob_msg);
+  } catch (const std::exception& e) {
+    if (log_prob_msg.str().length() > 0)
+      logger.info(log_prob_msg);
+    logger.error(e.what());
+    candidate.error = std::current_exception();
+    return;
+  }
+  auto end = std::chrono::steady_clock::now();
+  candidate.gradient_seconds
+      = std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count()
+        / 1000000.0;
+  if (log_prob_msg.str().length() > 0)
+    logger.info(log_prob_msg);
+
+  candidate.valid = std::isfinite(stan::math::sum(gradient));
+
+  if (!candidate.valid) {
+    logger.warn("Rejecting initial value:");
+    logger.warn(
+        "  Gradient evaluated at the initial value"
+        " is not finite.");
+    logger.warn(
+        "  Stan can't start sampling from this"
+        " initial value.");
+  }
+}
+
+/**
+ * Reservation of TBB threads for evaluating a batch of initial values.
+ * The threads reserved by all live reservations are counted process
+ * wide, so that chains initializing concurrently share the arena
+ * rather than each speculating on all of it.  At least one thread is
+ * always reserved.  Without <code>STAN_THREADS</code> candidates are
+ * evaluated one at a time.
+ */
+class init_thread_reservation {
+ public:
+  /**
+   * Reserve up to the specified number of threads, limited to the
+   * threads of the arena not reserved by others.
+   *
+   * @param requested number of threads wanted
+   */
+  explicit init_thread_reservation(int requested) : size_(1) {
+#ifdef STAN_THREADS
+    int in_use = threads_in_use().load();
+    do {
+      int available = tbb::this_task_arena::max_concurrency() - in_use;
+      size_ = std::max(1, std::min(requested, available));
+    } while (
+        !threads_in_use().compare_exchange_weak(in_use, in_use + size_));
+#endif
+  }
+
+  ~init_thread_reservation() {
+#ifdef STAN_THREADS
+    threads_in_use() -= size_;
+#endif
+  }
+
+  init_thread_reservation(const init_thread_reservation&) = delete;
+  init_thread_reservation& operator=(const init_thread_reservation&)
+      = delete;
+
+  /**
+   * Return the number of threads reserved.
+   */
+  int size() const { return size_; }
+
+ private:
+  int size_;
+
+  static std::atomic<int>& threads_in_use() {
+    static std::atomic<int> threads_in_use(0);
+    return threads_in_use;
+  }
+};
+
+}  // namespace internal
+
 /**
  * Returns a valid initial value of the parameters of the model
  * on the unconstrained scale.
  *
- * For identical inputs (model, init, rng, init_radius), this
- * function will produce the same initialization.
+ * For identical inputs (model, init, rng, init_radius,
+ * num_init_candidates), this function will produce the same
+ * initialization.
  *
  * Initialization first tries to use the provided
  * <code>stan::io::var_context</code>, then it will generate
@@ -43,6 +338,24 @@ namespace util {
  * evaluation of the log probability density function and all its
  * gradients.
  *
+ * When the program is built with <code>STAN_THREADS</code>, the first
+ * random initial value is evaluated alone and, after each batch in
+ * which none is accepted, the next batch is speculatively twice as
+ * large, capped by the TBB threads not already evaluating initial
+ * values for other chains.  The random draws for a batch are taken in
+ * sequence from the random number generator and the candidates are
+ * then checked in parallel.  Candidates are accepted in the order in
+ * which they were drawn and the generator is left in the state that
+ * follows the draws for the accepted candidate, so the result and the
+ * messages written to the logger do not depend on the number of
+ * threads.
+ *
+ * When <code>num_init_candidates</code> is greater than one, the
+ * first <code>num_init_candidates</code> random initial values are
+ * all evaluated and the valid one with the highest log density is
+ * returned.  If none of them is valid, the first valid initial value
+ * after them is returned.
+ *
  * @tparam Jacobian indicates whether to include the Jacobian term when
  *   evaluating the log density function
  * @tparam Model the type of the model class
@@ -58,6 +371,8 @@ namespace util {
  *   be printed to the logger
  * @param[in,out] logger logger for messages
  * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @param[in] num_init_candidates number of random initial values from
+ *   which the one with the highest log density is chosen
  * @throws exception passed through from the model if the model has a
  *   fatal error (not a std::domain_error)
  * @throws std::domain_error if the model can not be initialized and
@@ -70,10 +385,8 @@ template <bool Jacobian = true, typename Model, typename InitContext,
 std::vector<double> initialize(Model& model, const InitContext& init, RNG& rng,
                                double init_radius, bool print_timing,
                                stan::callbacks::logger& logger,
-                               stan::callbacks::writer& init_writer) {
-  std::vector<double> unconstrained;
-  std::vector<int> disc_vector;
-
+                               stan::callbacks::writer& init_writer,
+                               int num_init_candidates = 1) {
   bool is_fully_initialized = true;
   bool any_initialized = false;
   std::vector<std::string> param_names;
@@ -87,128 +400,81 @@ std::vector<double> initialize(Model& model, const InitContext& init, RNG& rng,
 
   int MAX_INIT_TRIES
       = is_fully_initialized || is_initialized_with_zero ? 1 : 100;
+  int speculation = 1;
+  internal::init_candidate best;
   int num_init_tries = 0;
-  for (; num_init_tries < MAX_INIT_TRIES; num_init_tries++) {
-    std::stringstream msg;
-    try {
-      stan::io::random_var_context random_context(model, rng, init_radius,
-                                                  is_initialized_with_zero);
-
-      if (!any_initialized) {
-        unconstrained = random_context.get_unconstrained();
-      } else {
-        stan::io::chained_var_context context(init, random_context);
+  while (num_init_tries < MAX_INIT_TRIES) {
+    internal::init_thread_reservation threads(std::min(
+        MAX_INIT_TRIES - num_init_tries,
+        std::max(speculation, num_init_candidates - num_init_tries)));
+    speculation *= 2;
+    int num_candidates = threads.size();
+    std::vector<std::vector<double>> draws;
+    std::vector<RNG> rngs;
+    for (int k = 0; k < num_candidates; ++k) {
+      draws.push_back(stan::io::random_var_context::draw_unconstrained(
+          model, rng, init_radius, is_initialized_with_zero));
+      rngs.push_back(rng);
+    }
 
-        model.transform_inits(context, disc_vector, unconstrained, &msg);
+    std::vector<internal::init_candidate> candidates(num_candidates);
+    const auto evaluate_range = [&](int begin, int end) {
+      for (int k = begin; k < end; ++k) {
+        RNG candidate_rng = rngs[k];
+        internal::evaluate_init_candidate<Jacobian>(
+            model, init, any_initialized, candidate_rng, std::move(draws[k]),
+            candidates[k]);
       }
-    } catch (std::domain_error& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.warn("Rejecting initial value:");
-      logger.warn(
-          "  Error evaluating the log probability"
-          " at the initial value.");
-      logger.warn(e.what());
-      continue;
-    } catch (std::exception& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.error(
-          "Unrecoverable error evaluating the log probability"
-          " at the initial value.");
-      throw;
-    }
+    };
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<int>(0, num_candidates, 1),
+                      [&](const tbb::blocked_range<int>& r) {
+                        evaluate_range(r.begin(), r.end());
+                      });
+#else
+    evaluate_range(0, num_candidates);
+#endif
 
-    msg.str("");
-    double log_prob(0);
-    try {
-      // we evaluate the log_prob function with propto=false
-      // because we're evaluating with `double` as the type of
-      // the parameters.
-      log_prob = model.template log_prob<false, Jacobian>(unconstrained,
-                                                          disc_vector, &msg);
-      if (msg.str().length() > 0)
-        logger.info(msg);
-    } catch (std::domain_error& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.warn("Rejecting initial value:");
-      logger.warn(
-          "  Error evaluating the log probability"
-          " at the initial value.");
-      logger.warn(e.what());
-      continue;
-    } catch (std::exception& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.error(
-          "Unrecoverable error evaluating the log probability"
-          " at the initial value.");
-      throw;
-    }
-    if (!std::isfinite(log_prob)) {
-      logger.warn("Rejecting initial value:");
-      logger.warn(
-          "  Log probability evaluates to log(0),"
-          " i.e. negative infinity.");
-      logger.warn(
-          "  Stan can't start sampling from this"
-          " initial value.");
-      continue;
-    }
-    std::stringstream log_prob_msg;
-    std::vector<double> gradient;
-    auto start = std::chrono::steady_clock::now();
-    try {
-      // we evaluate this with propto=true since we're
-      // evaluating with autodiff variables
-      log_prob = stan::model::log_prob_grad<true, Jacobian>(
-          model, unconstrained, disc_vector, gradient, &log_prob_msg);
-    } catch (const std::exception& e) {
-      if (log_prob_msg.str().length() > 0)
-        logger.info(log_prob_msg);
-      logger.error(e.what());
-      throw;
+    for (int k = 0; k < num_candidates; ++k) {
+      internal::init_candidate& candidate = candidates[k];
+      ++num_init_tries;
+      candidate.logger.write(logger);
+      if (candidate.error) {
+        rng = rngs[k];
+        std::rethrow_exception(candidate.error);
+      }
+      if (candidate.valid
+          && (!best.valid || candidate.log_prob > best.log_prob))
+        best = std::move(candidate);
+      if (best.valid && num_init_tries >= num_init_candidates) {
+        rng = rngs[k];
+        break;
+      }
     }
-    auto end = std::chrono::steady_clock::now();
-    double deltaT
-        = std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-              .count()
-          / 1000000.0;
-    if (log_prob_msg.str().length() > 0)
-      logger.info(log_prob_msg);
-
-    bool gradient_ok = std::isfinite(stan::math::sum(gradient));
+    if (best.valid && num_init_tries >= num_init_candidates)
+      break;
+  }
 
-    if (!gradient_ok) {
-      logger.warn("Rejecting initial value:");
-      logger.warn(
-          "  Gradient evaluated at the initial value"
-          " is not finite.");
-      logger.warn(
-          "  Stan can't start sampling from this"
-          " initial value.");
-    }
-    if (gradient_ok && print_timing) {
+  if (best.valid) {
+    if (print_timing) {
       logger.info("");
       std::stringstream msg1;
-      msg1 << "Gradient evaluation took " << deltaT << " seconds";
+      msg1 << "Gradient evaluation took " << best.gradient_seconds
+           << " seconds";
       logger.info(msg1);
 
       std::stringstream msg2;
       msg2 << "1000 transitions using 10 leapfrog steps"
            << " per transition would take"
-           << " " << 1e4 * deltaT << " seconds.";
+           << " " << 1e4 * best.gradient_seconds << " seconds.";
       logger.info(msg2);
 
       logger.info("Adjust your expectations accordingly!");
       logger.info("");
       logger.info("");
     }
-    if (gradient_ok) {
-      init_writer(unconstrained);
-      return unconstrained;
-    }
+    init_writer(best.unconstrained);
+    return best.unconstrained;
   }
 
   if (!is_initialized_with_zero) {
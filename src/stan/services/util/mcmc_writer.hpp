@@ -2,14 +2,17 @@
 #define STAN_SERVICES_UTIL_MCMC_WRITER_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <stan/model/prob_grad.hpp>
+#include <chrono>
 #include <iomanip>
 #include <limits>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -93,10 +96,13 @@ class mcmc_writer {
    * @param[in] sample the sample in constrained space
    * @param[in] sampler the sampler
    * @param[in] model the model
+   * @param[in,out] stats if not null, the time spent in
+   *   model.write_array() is recorded in its write_array_seconds
    */
   template <class Model, class RNG>
   void write_sample_params(RNG& rng, stan::mcmc::sample& sample,
-                           stan::mcmc::base_mcmc& sampler, Model& model) {
+                           stan::mcmc::base_mcmc& sampler, Model& model,
+                           callbacks::transition_stats* stats = nullptr) {
     std::vector<double> values;
 
     sample.get_sample_params(values);
@@ -105,6 +111,9 @@ class mcmc_writer {
     std::vector<double> model_values;
     std::vector<int> params_i;
     std::stringstream ss;
+    std::chrono::steady_clock::time_point start;
+    if (stats)
+      start = std::chrono::steady_clock::now();
     try {
       std::vector<double> cont_params(
           sample.cont_params().data(),
@@ -122,6 +131,10 @@ class mcmc_writer {
       logger_.info(e.what());
       throw;
     }
+    if (stats)
+      stats->write_array_seconds = std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count();
     if (ss.str().length() > 0)
       logger_.info(ss);
 
@@ -131,7 +144,7 @@ class mcmc_writer {
       values.insert(values.end(), num_model_params_ - model_values.size(),
                     std::numeric_limits<double>::quiet_NaN());
 
-    sample_writer_(values);
+    sample_writer_(std::move(values));
   }
 
   /**
@@ -183,7 +196,7 @@ class mcmc_writer {
     sampler.get_sampler_params(values);
     sampler.get_sampler_diagnostics(values);
 
-    diagnostic_writer_(values);
+    diagnostic_writer_(std::move(values));
   }
 
   /**
@@ -217,6 +230,22 @@ class mcmc_writer {
     writer();
   }
 
+  /**
+   * Print the numbers of warmup and sampling iterations that were run,
+   * for runs that may stop before the configured numbers.
+   *
+   * @param[in] num_warmup number of warmup iterations run
+   * @param[in] num_samples number of sampling iterations run
+   */
+  void write_iterations(int num_warmup, int num_samples) {
+    std::stringstream ss;
+    ss << " Iterations: " << num_warmup << " warmup, " << num_samples
+       << " sampling";
+    sample_writer_(ss.str());
+    diagnostic_writer_(ss.str());
+    logger_.info(ss);
+  }
+
   /**
    * Internal method
    *
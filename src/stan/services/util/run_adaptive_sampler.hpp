@@ -3,6 +3,7 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/services/util/generate_transitions.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
@@ -38,6 +39,8 @@ namespace util {
  * @param[in,out] sample_writer writer for draws
  * @param[in,out] diagnostic_writer writer for diagnostic information
  * @param[in,out] metric_writer writer for adapted stepsize, metric
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each transition if it is enabled
  * @param[in] chain_id The id for a given chain, (optional, default == 1)
  * @param[in] num_chains The number of chains used in the program. This
  *  is used in generate transitions to print out the chain number,
@@ -53,7 +56,8 @@ void run_adaptive_sampler(Sampler& sampler, Model& model,
                           callbacks::writer& sample_writer,
                           callbacks::writer& diagnostic_writer,
                           callbacks::structured_writer& metric_writer,
-                          size_t chain_id = 1, size_t num_chains = 1) {
+                          callbacks::telemetry& telemetry, size_t chain_id = 1,
+                          size_t num_chains = 1) {
   Eigen::Map<Eigen::VectorXd> cont_params(cont_vector.data(),
                                           cont_vector.size());
 
@@ -77,8 +81,8 @@ void run_adaptive_sampler(Sampler& sampler, Model& model,
   auto start_warm = std::chrono::steady_clock::now();
   util::generate_transitions(sampler, num_warmup, 0, num_warmup + num_samples,
                              num_thin, refresh, save_warmup, true, writer, s,
-                             model, rng, interrupt, logger, chain_id,
-                             num_chains);
+                             model, rng, interrupt, logger, telemetry,
+                             chain_id, num_chains);
   auto end_warm = std::chrono::steady_clock::now();
   double warm_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
                             end_warm - start_warm)
@@ -93,7 +97,7 @@ void run_adaptive_sampler(Sampler& sampler, Model& model,
   util::generate_transitions(sampler, num_samples, num_warmup,
                              num_warmup + num_samples, num_thin, refresh, true,
                              false, writer, s, model, rng, interrupt, logger,
-                             chain_id, num_chains);
+                             telemetry, chain_id, num_chains);
   auto end_sample = std::chrono::steady_clock::now();
   double sample_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
                               end_sample - start_sample)
@@ -102,6 +106,52 @@ void run_adaptive_sampler(Sampler& sampler, Model& model,
   writer.write_timing(warm_delta_t, sample_delta_t);
 }
 
+/**
+ * Runs the sampler with adaptation, with writers for the sample,
+ * diagnostics, and the adapted hmc tuning parameters.
+ *
+ * @tparam Sampler Type of adaptive sampler.
+ * @tparam Model Type of model
+ * @tparam RNG Type of random number generator
+ * @param[in,out] sampler the mcmc sampler to use on the model
+ * @param[in] model the model concept to use for computing log probability
+ * @param[in] cont_vector initial parameter values
+ * @param[in] num_warmup number of warmup draws
+ * @param[in] num_samples number of post warmup draws
+ * @param[in] num_thin number to thin the draws. Must be greater than
+ *   or equal to 1.
+ * @param[in] refresh controls output to the <code>logger</code>
+ * @param[in] save_warmup indicates whether the warmup draws should be
+ *   sent to the sample writer
+ * @param[in,out] rng random number generator
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger logger for messages
+ * @param[in,out] sample_writer writer for draws
+ * @param[in,out] diagnostic_writer writer for diagnostic information
+ * @param[in,out] metric_writer writer for adapted stepsize, metric
+ * @param[in] chain_id The id for a given chain, (optional, default == 1)
+ * @param[in] num_chains The number of chains used in the program. This
+ *  is used in generate transitions to print out the chain number,
+ *  (optional, default == 1)
+ */
+template <typename Sampler, typename Model, typename RNG>
+void run_adaptive_sampler(Sampler& sampler, Model& model,
+                          std::vector<double>& cont_vector, int num_warmup,
+                          int num_samples, int num_thin, int refresh,
+                          bool save_warmup, RNG& rng,
+                          callbacks::interrupt& interrupt,
+                          callbacks::logger& logger,
+                          callbacks::writer& sample_writer,
+                          callbacks::writer& diagnostic_writer,
+                          callbacks::structured_writer& metric_writer,
+                          size_t chain_id = 1, size_t num_chains = 1) {
+  callbacks::telemetry no_telemetry;
+  run_adaptive_sampler(sampler, model, cont_vector, num_warmup, num_samples,
+                       num_thin, refresh, save_warmup, rng, interrupt, logger,
+                       sample_writer, diagnostic_writer, metric_writer,
+                       no_telemetry, chain_id, num_chains);
+}
+
 /**
  * Runs the sampler with adaptation.
  *
@@ -0,0 +1,345 @@
+#ifndef STAN_SERVICES_UTIL_RUN_LOCKSTEP_ADAPTIVE_SAMPLER_HPP
+#define STAN_SERVICES_UTIL_RUN_LOCKSTEP_ADAPTIVE_SAMPLER_HPP
+
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
+#include <stan/mcmc/convergence_monitor.hpp>
+#include <stan/mcmc/covar_adaptation.hpp>
+#include <stan/mcmc/stepsize_covar_adapter.hpp>
+#include <stan/mcmc/stepsize_var_adapter.hpp>
+#include <stan/mcmc/var_adaptation.hpp>
+#include <stan/services/util/generate_transitions.hpp>
+#include <stan/services/util/mcmc_writer.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Criteria for stopping a multi-chain run once its draws are good
+ * enough rather than after a fixed number of iterations.  Monitoring
+ * is disabled when <code>check_interval</code> is zero.
+ *
+ * <p>Every <code>check_interval</code> iterations the split
+ * rank-normalized Rhat and ESS of the log density and of each
+ * unconstrained parameter are computed across the chains.  Warmup ends
+ * early once the Rhat over the second half of the warmup draws so far
+ * is at most <code>max_rhat</code>; the current metric adaptation
+ * window is closed and warmup finishes after the terminal buffer.
+ * Sampling stops once, over all of the sampling draws, the Rhat is at
+ * most <code>max_rhat</code> and the bulk and tail ESS are at least
+ * <code>target_ess</code>.  The configured numbers of warmup and
+ * sampling iterations remain the maximums.
+ */
+struct convergence_criteria {
+  int check_interval = 0;
+  double max_rhat = 1.01;
+  double target_ess = 400;
+
+  bool enabled() const { return check_interval > 0; }
+};
+
+namespace internal {
+
+inline stan::mcmc::var_adaptation& metric_adaptation(
+    stan::mcmc::stepsize_var_adapter& sampler) {
+  return sampler.get_var_adaptation();
+}
+
+inline stan::mcmc::covar_adaptation& metric_adaptation(
+    stan::mcmc::stepsize_covar_adapter& sampler) {
+  return sampler.get_covar_adaptation();
+}
+
+inline void pool_metric(
+    const std::vector<stan::mcmc::var_adaptation*>& adaptations,
+    Eigen::VectorXd& inv_metric) {
+  stan::mcmc::var_adaptation::pool_variance(adaptations, inv_metric);
+}
+
+inline void pool_metric(
+    const std::vector<stan::mcmc::covar_adaptation*>& adaptations,
+    Eigen::MatrixXd& inv_metric) {
+  stan::mcmc::covar_adaptation::pool_covariance(adaptations, inv_metric);
+}
+
+/**
+ * Call the specified functor with the index of each of the specified
+ * chains, in parallel.
+ */
+template <typename F>
+void for_each_chain(const std::vector<size_t>& chains, const F& f) {
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, chains.size(), 1),
+      [&](const tbb::blocked_range<size_t>& r) {
+        for (size_t k = r.begin(); k != r.end(); ++k)
+          f(chains[k]);
+      },
+      tbb::simple_partitioner());
+}
+
+/**
+ * Log a stopping decision together with the diagnostics behind it.
+ */
+inline void log_convergence(callbacks::logger& logger,
+                            const std::string& decision, int iterations,
+                            const stan::mcmc::convergence_monitor::summary& s) {
+  std::stringstream msg;
+  msg << decision << " after " << iterations << " iterations: max Rhat = "
+      << s.max_rhat << ", min bulk ESS = " << s.min_ess_bulk
+      << ", min tail ESS = " << s.min_ess_tail;
+  logger.info(msg);
+}
+
+}  // namespace internal
+
+/**
+ * Runs several chains of an adaptive sampler in lockstep segments,
+ * synchronizing the chains between segments to pool their metric
+ * adaptation, to monitor their convergence, or both.
+ *
+ * <p>Within a segment the chains run in parallel and independently.
+ * Segments end at the end of each metric adaptation window when
+ * adaptation is pooled, and every
+ * <code>criteria.check_interval</code> iterations when convergence is
+ * monitored.  Work between segments is done on the calling thread, so
+ * chains never block inside a parallel task.
+ *
+ * <p>With pooled adaptation, the window statistics of every chain are
+ * merged at the end of each window into a single inverse metric, which
+ * all chains adopt before restarting their step size adaptation.  With
+ * convergence monitoring, warmup and sampling stop early as described
+ * by <code>convergence_criteria</code>, each stop decision is logged,
+ * and the numbers of iterations run are written with the timing.
+ * Otherwise the output of each chain is that of
+ * <code>run_adaptive_sampler</code>.
+ *
+ * <p>The samplers must already be configured, including their
+ * adaptation windows, which must be the same for every chain.
+ *
+ * @tparam Sampler Type of adaptive sampler, one of the samplers with an
+ * adaptive diagonal or dense Euclidean metric
+ * @tparam Model Type of model
+ * @tparam RNG Type of random number generator
+ * @tparam SampleWriter Type of writer for draws
+ * @tparam DiagnosticWriter Type of writer for diagnostic information
+ * @tparam MetricWriter Type of writer for adapted tuning parameters
+ * @tparam Telemetry Type of performance instrumentation callback
+ * @param[in,out] samplers the mcmc sampler of each chain
+ * @param[in] model the model concept to use for computing log probability
+ * @param[in] cont_vectors initial parameter values of each chain
+ * @param[in] num_warmup number of warmup draws
+ * @param[in] num_samples number of post warmup draws
+ * @param[in] num_thin number to thin the draws. Must be greater than
+ *   or equal to 1.
+ * @param[in] refresh controls output to the <code>logger</code>
+ * @param[in] save_warmup indicates whether the warmup draws should be
+ *   sent to the sample writer
+ * @param[in,out] rngs random number generator of each chain
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger logger for messages
+ * @param[in,out] sample_writer writer for draws of each chain
+ * @param[in,out] diagnostic_writer writer for diagnostic information of
+ *   each chain
+ * @param[in,out] metric_writer writer for adapted stepsize, metric of
+ *   each chain
+ * @param[in,out] telemetry callback of each chain called with the
+ *   measurements of each transition if it is enabled
+ * @param[in] pool_adaptation whether to estimate the inverse metric from
+ *   the warmup draws of all chains together
+ * @param[in] criteria convergence criteria for stopping early
+ * @param[in] init_chain_id id of the first chain
+ */
+template <typename Sampler, typename Model, typename RNG,
+          typename SampleWriter, typename DiagnosticWriter,
+          typename MetricWriter, typename Telemetry>
+void run_lockstep_adaptive_sampler(
+    std::vector<Sampler>& samplers, Model& model,
+    std::vector<std::vector<double>>& cont_vectors, int num_warmup,
+    int num_samples, int num_thin, int refresh, bool save_warmup,
+    std::vector<RNG>& rngs, callbacks::interrupt& interrupt,
+    callbacks::logger& logger, std::vector<SampleWriter>& sample_writer,
+    std::vector<DiagnosticWriter>& diagnostic_writer,
+    std::vector<MetricWriter>& metric_writer,
+    std::vector<Telemetry>& telemetry, bool pool_adaptation,
+    const convergence_criteria& criteria, size_t init_chain_id = 1) {
+  const size_t num_chains = samplers.size();
+  int finish = num_warmup + num_samples;
+  const bool monitor = criteria.enabled();
+
+  std::vector<services::util::mcmc_writer> writers;
+  writers.reserve(num_chains);
+  std::vector<stan::mcmc::sample> samples;
+  samples.reserve(num_chains);
+  for (size_t i = 0; i < num_chains; ++i) {
+    writers.emplace_back(sample_writer[i], diagnostic_writer[i], logger);
+    samples.emplace_back(Eigen::Map<Eigen::VectorXd>(cont_vectors[i].data(),
+                                                     cont_vectors[i].size()),
+                         0, 0);
+  }
+
+  std::vector<size_t> all_chains(num_chains);
+  for (size_t i = 0; i < num_chains; ++i)
+    all_chains[i] = i;
+  std::vector<char> initialized(num_chains, 0);
+  internal::for_each_chain(all_chains, [&](size_t i) {
+    samplers[i].engage_adaptation();
+    if (telemetry[i].enabled())
+      samplers[i].enable_telemetry();
+    internal::metric_adaptation(samplers[i]).set_pooled(pool_adaptation);
+    try {
+      samplers[i].z().q = samples[i].cont_params();
+      samplers[i].init_stepsize(logger);
+    } catch (const std::exception& e) {
+      logger.error("Exception initializing step size.");
+      logger.error(e.what());
+      return;
+    }
+    initialized[i] = 1;
+    writers[i].write_sample_names(samples[i], samplers[i], model);
+    writers[i].write_diagnostic_names(samples[i], samplers[i], model);
+  });
+  std::vector<size_t> chains;
+  for (size_t i = 0; i < num_chains; ++i) {
+    if (initialized[i])
+      chains.push_back(i);
+  }
+  if (chains.empty())
+    return;
+
+  using adaptation_t = std::remove_reference_t<decltype(
+      internal::metric_adaptation(samplers[0]))>;
+  std::vector<adaptation_t*> adaptations;
+  for (size_t i : chains)
+    adaptations.push_back(&internal::metric_adaptation(samplers[i]));
+
+  // The log density and the unconstrained parameters of each chain
+  stan::mcmc::convergence_monitor monitor_draws(
+      chains.size(), monitor ? 1 + model.num_params_r() : 0);
+  std::vector<size_t> monitor_index(num_chains);
+  for (size_t k = 0; k < chains.size(); ++k)
+    monitor_index[chains[k]] = k;
+  std::vector<Eigen::VectorXd> draw(num_chains);
+  const auto run_segment = [&](int start, int first, int last, bool save,
+                               bool warmup) {
+    internal::for_each_chain(chains, [&](size_t i) {
+      for (int m = first; m < last; ++m) {
+        internal::generate_transition(samplers[i], m, start, finish, num_thin,
+                                      refresh, save, warmup, writers[i],
+                                      samples[i], model, rngs[i], interrupt,
+                                      logger, telemetry[i], init_chain_id + i,
+                                      num_chains);
+        if (monitor) {
+          draw[i].resize(monitor_draws.num_params());
+          draw[i](0) = samples[i].log_prob();
+          draw[i].tail(draw[i].size() - 1) = samples[i].cont_params();
+          monitor_draws.add_draw(monitor_index[i], draw[i]);
+        }
+      }
+    });
+  };
+
+  auto start_warm = std::chrono::steady_clock::now();
+  int warmup_end = num_warmup;
+  int m = 0;
+  while (m < warmup_end) {
+    int end = warmup_end;
+    unsigned int window_end = 0;
+    if (pool_adaptation) {
+      std::vector<unsigned int> window_ends
+          = adaptations[0]->adaptation_window_ends();
+      if (!window_ends.empty()) {
+        window_end = window_ends[0];
+        end = std::min(end, static_cast<int>(window_end) + 1);
+      }
+    }
+    if (monitor)
+      end = std::min(end, (m / criteria.check_interval + 1)
+                              * criteria.check_interval);
+    run_segment(0, m, end, save_warmup, true);
+    m = end;
+
+    if (pool_adaptation && m == static_cast<int>(window_end) + 1) {
+      auto inv_metric = samplers[chains[0]].z().inv_e_metric();
+      internal::pool_metric(adaptations, inv_metric);
+      internal::for_each_chain(chains, [&](size_t i) {
+        samplers[i].set_adapted_metric(inv_metric, logger);
+      });
+    }
+
+    if (monitor && m < warmup_end && m % criteria.check_interval == 0) {
+      auto summary = stan::mcmc::convergence_monitor::summarize(
+          monitor_draws.diagnostics(m / 2));
+      if (summary.max_rhat <= criteria.max_rhat) {
+        bool shortened = true;
+        for (adaptation_t* adaptation : adaptations)
+          shortened = adaptation->end_adaptation_early() && shortened;
+        if (shortened) {
+          warmup_end = adaptations[0]->num_warmup();
+          finish = warmup_end + num_samples;
+          internal::log_convergence(logger, "Ending warmup early", m,
+                                    summary);
+        }
+      }
+    }
+  }
+  monitor_draws.clear();
+  auto end_warm = std::chrono::steady_clock::now();
+  double warm_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            end_warm - start_warm)
+                            .count()
+                        / 1000.0;
+
+  internal::for_each_chain(chains, [&](size_t i) {
+    samplers[i].disengage_adaptation();
+    internal::metric_adaptation(samplers[i]).set_pooled(false);
+    writers[i].write_adapt_finish(samplers[i]);
+    samplers[i].write_sampler_state(sample_writer[i]);
+    samplers[i].write_sampler_state_struct(metric_writer[i]);
+  });
+
+  auto start_sample = std::chrono::steady_clock::now();
+  int sampling_end = num_samples;
+  for (m = 0; m < sampling_end;) {
+    int end = sampling_end;
+    if (monitor)
+      end = std::min(end, m + criteria.check_interval);
+    run_segment(warmup_end, m, end, true, false);
+    m = end;
+
+    if (monitor && m < sampling_end) {
+      auto summary = stan::mcmc::convergence_monitor::summarize(
+          monitor_draws.diagnostics());
+      if (summary.max_rhat <= criteria.max_rhat
+          && summary.min_ess_bulk >= criteria.target_ess
+          && summary.min_ess_tail >= criteria.target_ess) {
+        sampling_end = m;
+        internal::log_convergence(logger, "Stopping sampling", m, summary);
+      }
+    }
+  }
+  auto end_sample = std::chrono::steady_clock::now();
+  double sample_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              end_sample - start_sample)
+                              .count()
+                          / 1000.0;
+
+  for (size_t i : chains) {
+    if (monitor)
+      writers[i].write_iterations(warmup_end, sampling_end);
+    writers[i].write_timing(warm_delta_t, sample_delta_t);
+  }
+}
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
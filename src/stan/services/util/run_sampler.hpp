@@ -2,6 +2,7 @@
 #define STAN_SERVICES_UTIL_RUN_SAMPLER_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/telemetry.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/services/util/generate_transitions.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
@@ -32,6 +33,8 @@ namespace util {
  * @param[in,out] logger logger for messages
  * @param[in,out] sample_writer writer for draws
  * @param[in,out] diagnostic_writer writer for diagnostic information
+ * @param[in,out] telemetry callback called with the measurements of
+ *   each transition if it is enabled
  * @param[in] chain_id The id for a given chain.
  * @param[in] num_chains The number of chains used in the program. This
  *  is used in generate transitions to print out the chain number.
@@ -42,7 +45,8 @@ void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
                  int num_samples, int num_thin, int refresh, bool save_warmup,
                  RNG& rng, callbacks::interrupt& interrupt,
                  callbacks::logger& logger, callbacks::writer& sample_writer,
-                 callbacks::writer& diagnostic_writer, size_t chain_id = 1,
+                 callbacks::writer& diagnostic_writer,
+                 callbacks::telemetry& telemetry, size_t chain_id = 1,
                  size_t num_chains = 1) {
   Eigen::Map<Eigen::VectorXd> cont_params(cont_vector.data(),
                                           cont_vector.size());
@@ -56,8 +60,8 @@ void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
   auto start_warm = std::chrono::steady_clock::now();
   util::generate_transitions(sampler, num_warmup, 0, num_warmup + num_samples,
                              num_thin, refresh, save_warmup, true, writer, s,
-                             model, rng, interrupt, logger, chain_id,
-                             num_chains);
+                             model, rng, interrupt, logger, telemetry,
+                             chain_id, num_chains);
   auto end_warm = std::chrono::steady_clock::now();
   double warm_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
                             end_warm - start_warm)
@@ -70,7 +74,7 @@ void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
   util::generate_transitions(sampler, num_samples, num_warmup,
                              num_warmup + num_samples, num_thin, refresh, true,
                              false, writer, s, model, rng, interrupt, logger,
-                             chain_id, num_chains);
+                             telemetry, chain_id, num_chains);
   auto end_sample = std::chrono::steady_clock::now();
   double sample_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
                               end_sample - start_sample)
@@ -78,6 +82,44 @@ void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
                           / 1000.0;
   writer.write_timing(warm_delta_t, sample_delta_t);
 }
+
+/**
+ * Runs the sampler without adaptation.
+ *
+ * @tparam Model Type of model
+ * @tparam RNG Type of random number generator
+ * @param[in,out] sampler the mcmc sampler to use on the model
+ * @param[in] model the model concept to use for computing log probability
+ * @param[in] cont_vector initial parameter values
+ * @param[in] num_warmup number of warmup draws
+ * @param[in] num_samples number of post warmup draws
+ * @param[in] num_thin number to thin the draws. Must be greater than or
+ *   equal to 1.
+ * @param[in] refresh controls output to the <code>logger</code>
+ * @param[in] save_warmup indicates whether the warmup draws should be
+ *   sent to the sample writer
+ * @param[in,out] rng random number generator
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger logger for messages
+ * @param[in,out] sample_writer writer for draws
+ * @param[in,out] diagnostic_writer writer for diagnostic information
+ * @param[in] chain_id The id for a given chain.
+ * @param[in] num_chains The number of chains used in the program. This
+ *  is used in generate transitions to print out the chain number.
+ */
+template <class Model, class RNG>
+void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
+                 std::vector<double>& cont_vector, int num_warmup,
+                 int num_samples, int num_thin, int refresh, bool save_warmup,
+                 RNG& rng, callbacks::interrupt& interrupt,
+                 callbacks::logger& logger, callbacks::writer& sample_writer,
+                 callbacks::writer& diagnostic_writer, size_t chain_id = 1,
+                 size_t num_chains = 1) {
+  callbacks::telemetry no_telemetry;
+  run_sampler(sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+              refresh, save_warmup, rng, interrupt, logger, sample_writer,
+              diagnostic_writer, no_telemetry, chain_id, num_chains);
+}
 }  // namespace util
 }  // namespace services
 }  // namespace stan
@@ -9,6 +9,7 @@
 #include <stan/variational/print_progress.hpp>
 #include <stan/variational/families/normal_fullrank.hpp>
 #include <stan/variational/families/normal_meanfield.hpp>
+#include <stan/variational/parallel_monte_carlo.hpp>
 #include <boost/circular_buffer.hpp>
 #include <algorithm>
 #include <chrono>
@@ -92,23 +93,17 @@ class advi {
     static const char* function = "stan::variational::advi::calc_ELBO";
 
     double elbo = 0.0;
-    int dim = variational.dimension();
-    Eigen::VectorXd zeta(dim);
-
-    int n_dropped_evaluations = 0;
-    for (int i = 0; i < n_monte_carlo_elbo_;) {
-      variational.sample(rng_, zeta);
-      try {
-        std::stringstream ss;
-        double log_prob = model_.template log_prob<false, true>(zeta, &ss);
-        if (ss.str().length() > 0)
-          logger.info(ss);
-        stan::math::check_finite(function, "log_prob", log_prob);
-        elbo += log_prob;
-        ++i;
-      } catch (const std::domain_error& e) {
-        ++n_dropped_evaluations;
-        if (n_dropped_evaluations >= n_monte_carlo_elbo_) {
+    internal::parallel_monte_carlo<std::domain_error>(
+        variational.dimension(), n_monte_carlo_elbo_, n_monte_carlo_elbo_,
+        [&](Eigen::VectorXd& zeta) { variational.sample(rng_, zeta); },
+        [&](Eigen::VectorXd& zeta, std::ostream& msgs) {
+          double log_prob
+              = model_.template log_prob<false, true>(zeta, &msgs);
+          stan::math::check_finite(function, "log_prob", log_prob);
+          return log_prob;
+        },
+        [&](const Eigen::VectorXd& zeta, double log_prob) { elbo += log_prob; },
+        [&]() {
           const char* name = "The number of dropped evaluations";
           const char* msg1 = "has reached its maximum amount (";
           const char* msg2
@@ -116,9 +111,8 @@ class advi {
                 "ill-conditioned or misspecified.";
           stan::math::throw_domain_error(function, name, n_monte_carlo_elbo_,
                                          msg1, msg2);
-        }
-      }
-    }
+        },
+        logger);
     elbo /= n_monte_carlo_elbo_;
     elbo += variational.entropy();
     return elbo;
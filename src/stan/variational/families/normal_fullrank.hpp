@@ -5,6 +5,7 @@
 #include <stan/math/prim.hpp>
 #include <stan/model/gradient.hpp>
 #include <stan/variational/base_family.hpp>
+#include <stan/variational/parallel_monte_carlo.hpp>
 #include <algorithm>
 #include <ostream>
 #include <vector>
@@ -412,36 +413,35 @@ class normal_fullrank : public base_family {
 
     Eigen::VectorXd mu_grad = Eigen::VectorXd::Zero(dimension());
     Eigen::MatrixXd L_grad = Eigen::MatrixXd::Zero(dimension(), dimension());
-    double tmp_lp = 0.0;
-    Eigen::VectorXd tmp_mu_grad = Eigen::VectorXd::Zero(dimension());
-    Eigen::VectorXd eta = Eigen::VectorXd::Zero(dimension());
-    Eigen::VectorXd zeta = Eigen::VectorXd::Zero(dimension());
 
-    // Naive Monte Carlo integration
+    // Naive Monte Carlo integration, evaluated in parallel
     static const int n_retries = 10;
-    for (int i = 0, n_monte_carlo_drop = 0; i < n_monte_carlo_grad;) {
-      // Draw from standard normal and transform to real-coordinate space
-      for (int d = 0; d < dimension(); ++d) {
-        eta(d) = stan::math::normal_rng(0, 1, rng);
-      }
-      zeta = transform(eta);
-      try {
-        std::stringstream ss;
-        stan::model::gradient(m, zeta, tmp_lp, tmp_mu_grad, &ss);
-        if (ss.str().length() > 0)
-          logger.info(ss);
-        stan::math::check_finite(function, "Gradient of mu", tmp_mu_grad);
-
-        mu_grad += tmp_mu_grad;
-        for (int ii = 0; ii < dimension(); ++ii) {
-          for (int jj = 0; jj <= ii; ++jj) {
-            L_grad(ii, jj) += tmp_mu_grad(ii) * eta(jj);
+    internal::parallel_monte_carlo<std::exception>(
+        dimension(), n_monte_carlo_grad, n_retries * n_monte_carlo_grad,
+        [&](Eigen::VectorXd& eta) {
+          // Draw from standard normal
+          for (int d = 0; d < dimension(); ++d) {
+            eta(d) = stan::math::normal_rng(0, 1, rng);
           }
-        }
-        ++i;
-      } catch (const std::exception& e) {
-        ++n_monte_carlo_drop;
-        if (n_monte_carlo_drop >= n_retries * n_monte_carlo_grad) {
+        },
+        [&](const Eigen::VectorXd& eta, std::ostream& msgs) {
+          // Transform to real-coordinate space
+          Eigen::VectorXd zeta = transform(eta);
+          double tmp_lp = 0.0;
+          Eigen::VectorXd tmp_mu_grad = Eigen::VectorXd::Zero(dimension());
+          stan::model::gradient(m, zeta, tmp_lp, tmp_mu_grad, &msgs);
+          stan::math::check_finite(function, "Gradient of mu", tmp_mu_grad);
+          return tmp_mu_grad;
+        },
+        [&](const Eigen::VectorXd& eta, const Eigen::VectorXd& tmp_mu_grad) {
+          mu_grad += tmp_mu_grad;
+          for (int ii = 0; ii < dimension(); ++ii) {
+            for (int jj = 0; jj <= ii; ++jj) {
+              L_grad(ii, jj) += tmp_mu_grad(ii) * eta(jj);
+            }
+          }
+        },
+        [&]() {
           const char* name = "The number of dropped evaluations";
           const char* msg1 = "has reached its maximum amount (";
           int y = n_retries * n_monte_carlo_grad;
@@ -449,9 +449,8 @@ class normal_fullrank : public base_family {
               = "). Your model may be either severely "
                 "ill-conditioned or misspecified.";
           stan::math::throw_domain_error(function, name, y, msg1, msg2);
-        }
-      }
-    }
+        },
+        logger);
     mu_grad /= static_cast<double>(n_monte_carlo_grad);
     L_grad /= static_cast<double>(n_monte_carlo_grad);
 
@@ -0,0 +1,118 @@
+#ifndef STAN_VARIATIONAL_PARALLEL_MONTE_CARLO_HPP
+#define STAN_VARIATIONAL_PARALLEL_MONTE_CARLO_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/math/prim.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace variational {
+namespace internal {
+
+/**
+ * Evaluate the draws of a Monte Carlo estimate in parallel and reduce
+ * them in draw order.
+ *
+ * <p>Draws are generated serially on the calling thread, evaluated in
+ * parallel on the TBB thread pool, and then passed to the accumulator
+ * in the order they were drawn.  A draw whose evaluation throws an
+ * exception of type <code>Dropped</code> is dropped and a replacement
+ * is generated in the next round, until <code>n_draws</code> draws have
+ * been accepted.  Because the random number generator is only used on
+ * the calling thread and the reduction is done in draw order, the
+ * estimate for a given seed does not depend on the number of threads.
+ * When no draw is dropped the draws, the order of the reduction and so
+ * the estimate equal those of a serial loop.
+ *
+ * <p>Messages written by an evaluation are logged as info messages in
+ * draw order.  Evaluations of reverse-mode gradients run on the AD tape
+ * of the thread executing them, so draws are only evaluated in parallel
+ * when the program is built with <code>STAN_THREADS</code>; otherwise
+ * they are evaluated serially on the calling thread.
+ *
+ * @tparam Dropped Type of exception which drops a draw.
+ * @tparam Draw Type of functor with signature
+ * <code>void(Eigen::VectorXd&)</code>.
+ * @tparam Eval Type of functor with signature
+ * <code>T(Eigen::VectorXd&, std::ostream&)</code>.
+ * @tparam Accumulate Type of functor with signature
+ * <code>void(const Eigen::VectorXd&, const T&)</code>.
+ * @tparam OnMaxDropped Type of functor with signature <code>void()</code>.
+ * @param[in] dim Dimension of each draw.
+ * @param[in] n_draws Number of draws to accept.
+ * @param[in] max_dropped Number of dropped draws at which
+ * <code>on_max_dropped</code> is called.
+ * @param[in] draw Assigns a new draw to its argument.
+ * @param[in] eval Evaluates a draw, writing messages to the stream.
+ * @param[in] accumulate Called with each accepted draw and its value.
+ * @param[in] on_max_dropped Called when too many draws are dropped; it is
+ * expected to throw.
+ * @param[in,out] logger Logger for messages.
+ */
+template <typename Dropped, typename Draw, typename Eval, typename Accumulate,
+          typename OnMaxDropped>
+void parallel_monte_carlo(int dim, int n_draws, int max_dropped, Draw&& draw,
+                          Eval&& eval, Accumulate&& accumulate,
+                          OnMaxDropped&& on_max_dropped,
+                          callbacks::logger& logger) {
+  using value_t = std::decay_t<decltype(eval(
+      std::declval<Eigen::VectorXd&>(), std::declval<std::ostream&>()))>;
+  std::vector<Eigen::VectorXd> draws(n_draws, Eigen::VectorXd(dim));
+  std::vector<value_t> values(n_draws);
+  std::vector<char> accepted(n_draws);
+  std::vector<std::string> msgs(n_draws);
+
+  const auto eval_range = [&](int begin, int end) {
+    std::stringstream ss;
+    for (int k = begin; k < end; ++k) {
+      try {
+        values[k] = eval(draws[k], ss);
+        accepted[k] = true;
+      } catch (const Dropped& e) {
+        accepted[k] = false;
+      }
+      msgs[k] = ss.str();
+      ss.str(std::string());
+    }
+  };
+
+  int n_accepted = 0;
+  int n_dropped = 0;
+  while (n_accepted < n_draws) {
+    const int n_round = n_draws - n_accepted;
+    for (int k = 0; k < n_round; ++k) {
+      draw(draws[k]);
+    }
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<int>(0, n_round),
+                      [&](const tbb::blocked_range<int>& r) {
+                        eval_range(r.begin(), r.end());
+                      });
+#else
+    eval_range(0, n_round);
+#endif
+    for (int k = 0; k < n_round; ++k) {
+      if (msgs[k].length() > 0) {
+        logger.info(msgs[k]);
+      }
+      if (accepted[k]) {
+        accumulate(draws[k], values[k]);
+        ++n_accepted;
+      } else if (++n_dropped >= max_dropped) {
+        on_max_dropped();
+      }
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace variational
+}  // namespace stan
+#endif
@@ -0,0 +1,127 @@
+#ifndef STAN_SRC_TEST_PERFORMANCE_BENCHMARK_HPP
+#define STAN_SRC_TEST_PERFORMANCE_BENCHMARK_HPP
+
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace test {
+namespace performance {
+
+/**
+ * Return the wall clock seconds taken by a call to the specified
+ * function.
+ *
+ * @tparam F type of function
+ * @param f function taking no arguments
+ * @return elapsed seconds
+ */
+template <typename F>
+double seconds(F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+/**
+ * Return the median of the specified values.
+ *
+ * @param values values, at least one
+ * @return median
+ */
+inline double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+/**
+ * Return the median of the wall clock seconds taken by the specified
+ * number of calls to the specified function.
+ *
+ * @tparam F type of function
+ * @param repeats number of calls, at least one
+ * @param f function taking no arguments
+ * @return median elapsed seconds
+ */
+template <typename F>
+double median_seconds(int repeats, F&& f) {
+  std::vector<double> times;
+  for (int i = 0; i < repeats; ++i)
+    times.push_back(seconds(f));
+  return median(times);
+}
+
+/**
+ * Report a measurement on standard output and as a property of the
+ * current test, so that it is included in the output of
+ * <code>--gtest_output=json</code>.
+ *
+ * <p>The name of a rate, where higher is better, ends in
+ * <code>_per_second</code>, and the name of a time, where lower is
+ * better, ends in <code>_seconds</code>.  The comparison with a
+ * baseline relies on these suffixes.
+ *
+ * @param name name of the measurement
+ * @param value value of the measurement
+ */
+inline void report(const std::string& name, double value) {
+  std::stringstream ss;
+  ss.precision(6);
+  ss << value;
+  std::cout << name << ": " << ss.str() << std::endl;
+  testing::Test::RecordProperty(name, ss.str());
+}
+
+/**
+ * Return the column names of a sampler's output with the specified
+ * number of model parameters.
+ *
+ * @param num_params number of model parameters
+ * @return <code>lp__</code>, the NUTS sampler parameters and
+ *   <code>x.1</code>, ..., <code>x.num_params</code>
+ */
+inline std::vector<std::string> draw_names(int num_params) {
+  std::vector<std::string> names{"lp__",         "accept_stat__",
+                                 "stepsize__",   "treedepth__",
+                                 "n_leapfrog__", "divergent__",
+                                 "energy__"};
+  for (int i = 1; i <= num_params; ++i)
+    names.push_back("x." + std::to_string(i));
+  return names;
+}
+
+/**
+ * Return standard normal draws, one row per draw, so that formatted
+ * output has as many digits as real sampler output.
+ *
+ * @param num_draws number of rows
+ * @param num_cols number of columns
+ * @param seed seed of the random number generator
+ * @return matrix of draws
+ */
+inline Eigen::MatrixXd random_draws(int num_draws, int num_cols,
+                                    unsigned int seed = 0) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> normal;
+  Eigen::MatrixXd draws(num_draws, num_cols);
+  for (int j = 0; j < num_cols; ++j)
+    for (int i = 0; i < num_draws; ++i)
+      draws(i, j) = normal(rng);
+  return draws;
+}
+
+}  // namespace performance
+}  // namespace test
+}  // namespace stan
+
+#endif
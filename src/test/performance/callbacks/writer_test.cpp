@@ -0,0 +1,84 @@
+#include <stan/callbacks/async_writer.hpp>
+#include <stan/callbacks/binary_writer.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <test/performance/benchmark.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the throughput of the writers a sampler sends its draws to,
+// writing 10000 draws of 1000 parameters to memory.
+
+namespace {
+
+const int num_draws = 10000;
+const int num_params = 1000;
+
+struct deleter_noop {
+  template <typename T>
+  constexpr void operator()(T* arg) const {}
+};
+
+std::vector<std::vector<double>> draw_rows() {
+  Eigen::MatrixXd draws = stan::test::performance::random_draws(
+      num_draws, stan::test::performance::draw_names(num_params).size());
+  std::vector<std::vector<double>> rows;
+  for (int i = 0; i < num_draws; ++i) {
+    Eigen::RowVectorXd draw = draws.row(i);
+    rows.emplace_back(draw.data(), draw.data() + draw.size());
+  }
+  return rows;
+}
+
+template <typename Writer>
+void write_rows(Writer& writer,
+                const std::vector<std::vector<double>>& rows) {
+  writer(stan::test::performance::draw_names(num_params));
+  for (const auto& row : rows)
+    writer(row);
+}
+
+void report(const std::string& writer, double seconds, std::size_t bytes) {
+  stan::test::performance::report(writer + "_draws_per_second",
+                                  num_draws / seconds);
+  stan::test::performance::report(writer + "_megabytes_per_second",
+                                  bytes / seconds / 1e6);
+}
+
+}  // namespace
+
+TEST(callbacksWriterPerformance, stream_writer) {
+  const auto rows = draw_rows();
+  std::stringstream out;
+  double elapsed = stan::test::performance::seconds([&]() {
+    stan::callbacks::stream_writer writer(out, "# ");
+    write_rows(writer, rows);
+  });
+  report("stream_writer", elapsed, out.str().size());
+}
+
+TEST(callbacksWriterPerformance, binary_writer) {
+  const auto rows = draw_rows();
+  std::stringstream out;
+  double elapsed = stan::test::performance::seconds([&]() {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&out)};
+    write_rows(writer, rows);
+  });
+  report("binary_writer", elapsed, out.str().size());
+}
+
+TEST(callbacksWriterPerformance, async_stream_writer) {
+  const auto rows = draw_rows();
+  std::stringstream out;
+  double elapsed = stan::test::performance::seconds([&]() {
+    stan::callbacks::stream_writer target(out, "# ");
+    stan::callbacks::async_write_queue queue;
+    stan::callbacks::async_writer writer(queue, target);
+    write_rows(writer, rows);
+    queue.close();
+  });
+  report("async_stream_writer", elapsed, out.str().size());
+}
@@ -0,0 +1,134 @@
+#!/usr/bin/python
+
+"""
+Compare the results of the benchmarks in src/test/performance with a
+baseline.
+
+Results are the files written by the benchmark executables with
+--gtest_output=json.  Each measurement is a property of a test, named
+<suite>.<test>.<property>.  Properties ending in _per_second are rates,
+where higher is better, and properties ending in _seconds are times,
+where lower is better; other properties are ignored.
+
+The comparison is written as JSON and the script exits with status 1 if
+any measurement is worse than the baseline by more than the tolerance.
+"""
+
+from __future__ import print_function
+from argparse import ArgumentParser
+import glob
+import json
+import os
+import sys
+
+
+def processCLIArgs():
+    parser = ArgumentParser(description="Compare benchmark results with a baseline.")
+    parser.add_argument(
+        "baseline", help="baseline results: a JSON file or a directory of them"
+    )
+    parser.add_argument(
+        "current", help="current results: a JSON file or a directory of them"
+    )
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=0.1,
+        help="relative slowdown reported as a regression (default 0.1)",
+    )
+    parser.add_argument(
+        "--output", help="file to write the comparison to (default stdout)"
+    )
+    return parser.parse_args()
+
+
+def resultFiles(path):
+    if os.path.isdir(path):
+        return sorted(glob.glob(os.path.join(path, "*.json")))
+    return [path]
+
+
+def isMeasurement(name):
+    return name.endswith("_per_second") or name.endswith("_seconds")
+
+
+def readResults(path):
+    """Return a dict from measurement name to value."""
+    results = {}
+    for filename in resultFiles(path):
+        with open(filename) as file:
+            output = json.load(file)
+        for suite in output.get("testsuites", []):
+            for test in suite.get("testsuite", []):
+                for key, value in test.items():
+                    if not isMeasurement(key):
+                        continue
+                    name = "%s.%s.%s" % (suite["name"], test["name"], key)
+                    try:
+                        results[name] = float(value)
+                    except ValueError:
+                        pass
+    return results
+
+
+def compare(baseline, current, tolerance):
+    """Return the comparison of every measurement in both results."""
+    comparison = []
+    for name in sorted(set(baseline) & set(current)):
+        base, value = baseline[name], current[name]
+        if base <= 0 or value <= 0:
+            continue
+        # speedup > 1 is an improvement for rates and for times alike
+        if name.endswith("_per_second"):
+            speedup = value / base
+        else:
+            speedup = base / value
+        if speedup < 1 / (1 + tolerance):
+            status = "regressed"
+        elif speedup > 1 + tolerance:
+            status = "improved"
+        else:
+            status = "unchanged"
+        comparison.append(
+            {
+                "name": name,
+                "baseline": base,
+                "current": value,
+                "speedup": speedup,
+                "status": status,
+            }
+        )
+    return comparison
+
+
+def main():
+    args = processCLIArgs()
+    baseline = readResults(args.baseline)
+    current = readResults(args.current)
+    comparison = compare(baseline, current, args.tolerance)
+    regressions = [c for c in comparison if c["status"] == "regressed"]
+
+    report = {
+        "tolerance": args.tolerance,
+        "regressions": len(regressions),
+        "missing": sorted(set(baseline) - set(current)),
+        "new": sorted(set(current) - set(baseline)),
+        "measurements": comparison,
+    }
+    text = json.dumps(report, indent=2)
+    if args.output:
+        with open(args.output, "w") as file:
+            file.write(text + "\n")
+    else:
+        print(text)
+
+    for c in regressions:
+        sys.stderr.write(
+            "regression: %s %g -> %g (speedup %.3f)\n"
+            % (c["name"], c["baseline"], c["current"], c["speedup"])
+        )
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
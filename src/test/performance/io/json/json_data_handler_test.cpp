@@ -0,0 +1,65 @@
+#include <stan/io/json/json_data_handler.hpp>
+#include <stan/io/json/rapidjson_parser.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Compares the numeric array fast path of json_data_handler with the
+// general path on arrays of 10^7 values.  Timings are reported on
+// standard output and as test properties, so that they are included in
+// the output of --gtest_output=json.
+
+namespace {
+
+const size_t N = 10000000;
+
+double parse_seconds(const std::string& text, bool fast_arrays) {
+  stan::json::vars_map_r vars_r;
+  stan::json::vars_map_i vars_i;
+  stan::json::json_data_handler handler(vars_r, vars_i, fast_arrays);
+  std::stringstream in(text);
+  auto start = std::chrono::steady_clock::now();
+  stan::json::rapidjson_parse(in, handler);
+  std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(N, vars_r.empty() ? vars_i["x"].first.size()
+                              : vars_r["x"].first.size());
+  return elapsed.count();
+}
+
+void benchmark(const std::string& name, const std::string& text) {
+  double general = parse_seconds(text, false);
+  double fast = parse_seconds(text, true);
+  std::cout << name << ": general path " << general << "s, fast path "
+            << fast << "s, speedup " << general / fast << std::endl;
+  testing::Test::RecordProperty(name + "_general_seconds",
+                                std::to_string(general));
+  testing::Test::RecordProperty(name + "_fast_seconds", std::to_string(fast));
+}
+
+}  // namespace
+
+TEST(ioJsonPerformance, real_vector) {
+  std::stringstream text;
+  text << "{ \"x\" : [";
+  for (size_t i = 0; i < N; ++i)
+    text << (i ? ", " : "") << i + 0.5;
+  text << "] }";
+  benchmark("real_vector", text.str());
+}
+
+TEST(ioJsonPerformance, int_matrix) {
+  const size_t cols = 1000;
+  std::stringstream text;
+  text << "{ \"x\" : [";
+  for (size_t i = 0; i < N / cols; ++i) {
+    text << (i ? ", [" : "[");
+    for (size_t j = 0; j < cols; ++j)
+      text << (j ? ", " : "") << (i + j) % 1000;
+    text << "]";
+  }
+  text << "] }";
+  benchmark("int_matrix", text.str());
+}
@@ -0,0 +1,66 @@
+#include <stan/callbacks/binary_writer.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <test/performance/benchmark.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the parse throughput of stan_csv_reader on the CSV and binary
+// output of a sampler with 1000 draws of 1000 parameters.
+
+namespace {
+
+const int num_draws = 1000;
+const int num_params = 1000;
+
+struct deleter_noop {
+  template <typename T>
+  constexpr void operator()(T* arg) const {}
+};
+
+template <typename Writer>
+void write_draws(Writer& writer) {
+  std::vector<std::string> names
+      = stan::test::performance::draw_names(num_params);
+  Eigen::MatrixXd draws
+      = stan::test::performance::random_draws(num_draws, names.size());
+  writer(names);
+  for (int i = 0; i < num_draws; ++i) {
+    Eigen::RowVectorXd draw = draws.row(i);
+    writer(std::vector<double>(draw.data(), draw.data() + draw.size()));
+  }
+}
+
+void benchmark(const std::string& format, const std::string& text) {
+  double median = stan::test::performance::median_seconds(5, [&]() {
+    std::stringstream in(text);
+    stan::io::stan_csv csv = stan::io::stan_csv_reader::parse(in, nullptr);
+    ASSERT_EQ(num_draws, csv.samples.rows());
+  });
+  stan::test::performance::report(format + "_megabytes_per_second",
+                                  text.size() / median / 1e6);
+  stan::test::performance::report(format + "_draws_per_second",
+                                  num_draws / median);
+}
+
+}  // namespace
+
+TEST(ioStanCsvReaderPerformance, csv) {
+  std::stringstream out;
+  stan::callbacks::stream_writer writer(out, "# ");
+  write_draws(writer);
+  benchmark("csv", out.str());
+}
+
+TEST(ioStanCsvReaderPerformance, binary) {
+  std::stringstream out;
+  {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&out)};
+    write_draws(writer);
+  }
+  benchmark("binary", out.str());
+}
@@ -0,0 +1,30 @@
+#include <stan/io/stan_csv_reader.hpp>
+#include <stan/mcmc/chainset.hpp>
+#include <test/performance/benchmark.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Measures the time chainset takes to summarize 4 chains of 1000 draws
+// of 1000 parameters: means, standard deviations, quantiles, Rhat, ESS
+// and MCSE of every column.
+
+TEST(mcmcChainsetPerformance, summary) {
+  const int num_chains = 4;
+  const int num_draws = 1000;
+  const int num_params = 1000;
+  std::vector<stan::io::stan_csv> chains(num_chains);
+  for (int c = 0; c < num_chains; ++c) {
+    chains[c].header = stan::test::performance::draw_names(num_params);
+    chains[c].samples = stan::test::performance::random_draws(
+        num_draws, chains[c].header.size(), c);
+  }
+  stan::mcmc::chainset chainset(chains);
+
+  double median = stan::test::performance::median_seconds(3, [&]() {
+    auto summary = chainset.summary();
+    ASSERT_EQ(chainset.num_params(), summary.size());
+  });
+  stan::test::performance::report("summary_seconds", median);
+  stan::test::performance::report("summary_params_per_second",
+                                  chainset.num_params() / median);
+}
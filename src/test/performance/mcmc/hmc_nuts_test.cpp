@@ -0,0 +1,111 @@
+#include <stan/callbacks/histogram_telemetry.hpp>
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/array_var_context.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_dense_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_unit_e_nuts.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/services/util/run_adaptive_sampler.hpp>
+#include <test/performance/benchmark.hpp>
+#include <test/test-models/performance/correlated_normal.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures NUTS transitions and gradient evaluations per second with
+// the unit, diagonal and dense metrics on correlated normal targets of
+// increasing dimension.  The draws are discarded, so the measurements
+// exclude output, and the times are medians over repeated runs.
+
+namespace {
+
+const int num_warmup = 200;
+const int num_samples = 200;
+const int num_repeats = 3;
+const std::vector<int> sizes{16, 64, 256};
+
+stan::io::array_var_context data(int N) {
+  return stan::io::array_var_context({"rho"}, std::vector<double>{0.9}, {{}},
+                                     {"N"}, std::vector<int>{N}, {{}});
+}
+
+template <typename Sampler>
+void set_windows(Sampler& sampler, stan::callbacks::logger& logger) {
+  sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+}
+
+template <typename Model, typename RNG>
+void set_windows(stan::mcmc::adapt_unit_e_nuts<Model, RNG>& sampler,
+                 stan::callbacks::logger& logger) {}
+
+template <template <class, class> class Sampler>
+void benchmark(const std::string& metric) {
+  for (int N : sizes) {
+    std::stringstream model_log;
+    stan::io::array_var_context context = data(N);
+    stan_model model(context, 0, &model_log);
+    stan::callbacks::interrupt interrupt;
+    stan::callbacks::logger logger;
+    stan::callbacks::writer sample_writer, diagnostic_writer;
+    stan::callbacks::structured_writer metric_writer;
+    stan::callbacks::histogram_telemetry telemetry;
+
+    // Every repeat runs from the same seed, so it does the same work
+    std::vector<double> sampling_seconds;
+    const auto run = [&]() {
+      stan::rng_t rng = stan::services::util::create_rng(0, 1);
+      Sampler<stan_model, stan::rng_t> sampler(model, rng);
+      sampler.set_nominal_stepsize(1);
+      sampler.set_stepsize_jitter(0);
+      sampler.set_max_depth(10);
+      sampler.get_stepsize_adaptation().set_mu(std::log(10));
+      sampler.get_stepsize_adaptation().set_delta(0.8);
+      sampler.get_stepsize_adaptation().set_gamma(0.05);
+      sampler.get_stepsize_adaptation().set_kappa(0.75);
+      sampler.get_stepsize_adaptation().set_t0(10);
+      set_windows(sampler, logger);
+
+      std::vector<double> cont_vector(N, 0);
+      telemetry = stan::callbacks::histogram_telemetry();
+      stan::services::util::run_adaptive_sampler(
+          sampler, model, cont_vector, num_warmup, num_samples, 1, 0, false,
+          rng, interrupt, logger, sample_writer, diagnostic_writer,
+          metric_writer, telemetry);
+      sampling_seconds.push_back(telemetry.main().transition_seconds.sum());
+    };
+    double elapsed = stan::test::performance::median_seconds(num_repeats, run);
+    ASSERT_EQ(static_cast<std::size_t>(num_samples),
+              telemetry.main().transitions);
+
+    double gradients = telemetry.warmup().gradient_evals.sum()
+                       + telemetry.main().gradient_evals.sum();
+    std::string name = metric + "_" + std::to_string(N);
+    stan::test::performance::report(name + "_transitions_per_second",
+                                    (num_warmup + num_samples) / elapsed);
+    stan::test::performance::report(name + "_gradients_per_second",
+                                    gradients / elapsed);
+    stan::test::performance::report(
+        name + "_sampling_transitions_per_second",
+        num_samples / stan::test::performance::median(sampling_seconds));
+  }
+}
+
+}  // namespace
+
+TEST(mcmcNutsPerformance, unit_e) {
+  benchmark<stan::mcmc::adapt_unit_e_nuts>("unit_e");
+}
+
+TEST(mcmcNutsPerformance, diag_e) {
+  benchmark<stan::mcmc::adapt_diag_e_nuts>("diag_e");
+}
+
+TEST(mcmcNutsPerformance, dense_e) {
+  benchmark<stan::mcmc::adapt_dense_e_nuts>("dense_e");
+}
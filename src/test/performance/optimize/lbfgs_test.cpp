@@ -0,0 +1,50 @@
+#include <stan/callbacks/histogram_telemetry.hpp>
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stan/io/json/json_data.hpp>
+#include <stan/services/optimize/lbfgs.hpp>
+#include <test/performance/benchmark.hpp>
+#include <test/test-models/performance/logistic.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+// Measures L-BFGS iterations and gradient evaluations per second on the
+// logistic regression model, from a series of random initializations.
+// Times are the median over repeats of the series.
+
+TEST(optimizeLbfgsPerformance, logistic) {
+  const int num_runs = 10;
+  std::fstream data_stream(
+      "src/test/test-models/performance/logistic.data.json",
+      std::fstream::in);
+  stan::json::json_data data(data_stream);
+  std::stringstream model_log;
+  stan_model model(data, 0, &model_log);
+  stan::io::empty_var_context init;
+  stan::callbacks::interrupt interrupt;
+  stan::callbacks::logger logger;
+  stan::callbacks::writer init_writer, parameter_writer;
+  stan::callbacks::histogram_telemetry telemetry;
+
+  // Every repeat runs from the same seeds, so it does the same work
+  double elapsed = stan::test::performance::median_seconds(5, [&]() {
+    telemetry = stan::callbacks::histogram_telemetry();
+    for (int run = 0; run < num_runs; ++run) {
+      int return_code = stan::services::optimize::lbfgs(
+          model, init, 1234, run + 1, 2, 5, 0.001, 1e-12, 1e4, 1e-8, 1e7,
+          1e-8, 2000, false, 0, interrupt, logger, init_writer,
+          parameter_writer, telemetry);
+      ASSERT_EQ(0, return_code);
+    }
+  });
+
+  const auto& iterations = telemetry.main();
+  stan::test::performance::report("iterations_per_second",
+                                  iterations.transitions / elapsed);
+  stan::test::performance::report(
+      "gradients_per_second", iterations.gradient_evals.sum() / elapsed);
+  stan::test::performance::report("run_seconds", elapsed / num_runs);
+}
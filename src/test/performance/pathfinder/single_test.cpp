@@ -0,0 +1,40 @@
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/structured_writer.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stan/io/json/json_data.hpp>
+#include <stan/services/pathfinder/single.hpp>
+#include <test/performance/benchmark.hpp>
+#include <test/test-models/performance/logistic.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+// Measures the end-to-end time of single-path Pathfinder on the logistic
+// regression model: the L-BFGS path, the ELBO evaluations and the final
+// draws.  The output is discarded.
+
+TEST(pathfinderSinglePerformance, logistic) {
+  std::fstream data_stream(
+      "src/test/test-models/performance/logistic.data.json",
+      std::fstream::in);
+  stan::json::json_data data(data_stream);
+  std::stringstream model_log;
+  stan_model model(data, 0, &model_log);
+  stan::io::empty_var_context init;
+  stan::callbacks::interrupt interrupt;
+  stan::callbacks::logger logger;
+  stan::callbacks::writer init_writer, parameter_writer;
+  stan::callbacks::structured_writer diagnostic_writer;
+
+  unsigned int run = 0;
+  double median = stan::test::performance::median_seconds(5, [&]() {
+    int return_code = stan::services::pathfinder::pathfinder_lbfgs_single(
+        model, init, 1234, ++run, 2, 5, 0.001, 1e-12, 1e4, 1e-8, 1e7, 1e-8,
+        1000, 100, 1000, false, 0, interrupt, logger, init_writer,
+        parameter_writer, diagnostic_writer);
+    ASSERT_EQ(0, return_code);
+  });
+  stan::test::performance::report("end_to_end_seconds", median);
+}
@@ -58,3 +58,79 @@ TEST(ProbAutocovariance, test2) {
   EXPECT_NEAR(1.10, ac(4), 0.01);
   EXPECT_NEAR(0.89, ac(5), 0.01);
 }
+
+TEST(ProbAutocovariance, workspace) {
+  std::fstream f("src/test/unit/analyze/mcmc/ar1.csv");
+  size_t N = 1000;
+  Eigen::VectorXd y(N);
+  for (size_t i = 0; i < N; ++i) {
+    f >> y(i);
+  }
+
+  Eigen::VectorXd ac_expected(N);
+  stan::analyze::autocovariance<double>(y, ac_expected);
+
+  stan::analyze::autocovariance_workspace ws(N);
+  EXPECT_EQ(N, ws.size());
+  Eigen::VectorXd ac(N);
+  for (int reuse = 0; reuse < 2; ++reuse) {
+    stan::analyze::autocovariance(y, ac, ws);
+    for (size_t i = 0; i < N; ++i) {
+      EXPECT_DOUBLE_EQ(ac_expected(i), ac(i));
+    }
+  }
+
+  // the workspace resizes itself for sequences of another length
+  Eigen::VectorXd y_head = y.head(100);
+  Eigen::VectorXd ac_head_expected(100);
+  stan::analyze::autocovariance<double>(y_head, ac_head_expected);
+  Eigen::VectorXd ac_head(100);
+  stan::analyze::autocovariance(y_head, ac_head, ws);
+  EXPECT_EQ(100, ws.size());
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_DOUBLE_EQ(ac_head_expected(i), ac_head(i));
+  }
+
+  // alternating lengths reuse the larger buffers
+  for (int reuse = 0; reuse < 2; ++reuse) {
+    stan::analyze::autocovariance(y, ac, ws);
+    for (size_t i = 0; i < N; ++i) {
+      EXPECT_DOUBLE_EQ(ac_expected(i), ac(i));
+    }
+    stan::analyze::autocovariance(y_head, ac_head, ws);
+    for (size_t i = 0; i < 100; ++i) {
+      EXPECT_DOUBLE_EQ(ac_head_expected(i), ac_head(i));
+    }
+  }
+}
+
+TEST(ProbAutocovariance, batch) {
+  std::fstream f("src/test/unit/analyze/mcmc/ar1.csv");
+  size_t N = 1000;
+  Eigen::VectorXd y(N);
+  for (size_t i = 0; i < N; ++i) {
+    f >> y(i);
+  }
+
+  // five columns exercise both the paired and the single transform
+  const int num_cols = 5;
+  const int rows = 200;
+  Eigen::MatrixXd Y(rows, num_cols);
+  for (int j = 0; j < num_cols; ++j) {
+    Y.col(j) = y.segment(j * rows, rows) * (j + 1);
+  }
+
+  stan::analyze::autocovariance_workspace ws;
+  Eigen::MatrixXd acov;
+  stan::analyze::autocovariance_batch(Y, acov, ws);
+  ASSERT_EQ(rows, acov.rows());
+  ASSERT_EQ(num_cols, acov.cols());
+  for (int j = 0; j < num_cols; ++j) {
+    Eigen::VectorXd y_j = Y.col(j);
+    Eigen::VectorXd ac_expected(rows);
+    stan::analyze::autocovariance<double>(y_j, ac_expected);
+    for (int i = 0; i < rows; ++i) {
+      EXPECT_NEAR(ac_expected(i), acov(i, j), 1e-10 * ac_expected(0));
+    }
+  }
+}
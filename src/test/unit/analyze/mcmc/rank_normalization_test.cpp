@@ -1,5 +1,6 @@
 #include <stan/analyze/mcmc/rank_normalization.hpp>
 #include <stan/io/stan_csv_reader.hpp>
+#include <boost/math/distributions/normal.hpp>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <fstream>
@@ -7,6 +8,8 @@
 #include <string>
 #include <cmath>
 #include <limits>
+#include <utility>
+#include <vector>
 
 class RankNormalization : public testing::Test {
  public:
@@ -83,3 +86,58 @@ TEST_F(RankNormalization, test_symmetry) {
     EXPECT_NEAR(boz(0, col), -boz(1, col), 1e-10);
   }
 }
+
+TEST(RankNormalizationKernel, inv_normal_cdf) {
+  boost::math::normal_distribution<double> dist;
+  for (double p : {1e-300, 1e-20, 1e-10, 1e-5, 0.001, 0.02, 0.0749, 0.075,
+                   0.1, 0.3, 0.5, 0.6, 0.9, 0.925, 0.93, 0.999, 1 - 1e-10}) {
+    double expected = boost::math::quantile(dist, p);
+    EXPECT_NEAR(expected, stan::analyze::internal::inv_normal_cdf(p),
+                1e-14 * std::max(1.0, std::fabs(expected)))
+        << "p = " << p;
+  }
+  EXPECT_EQ(0.0, stan::analyze::internal::inv_normal_cdf(0.5));
+}
+
+TEST_F(RankNormalization, matches_boost_quantile) {
+  // ties are given the same, averaged rank
+  chains_theta(3, 1) = chains_theta(7, 2);
+  chains_theta(5, 0) = chains_theta(7, 2);
+
+  const Eigen::Index size = chains_theta.size();
+  std::vector<std::pair<double, int>> value_with_index(size);
+  for (Eigen::Index i = 0; i < size; ++i) {
+    value_with_index[i] = {chains_theta(i), i};
+  }
+  std::sort(value_with_index.begin(), value_with_index.end());
+  Eigen::MatrixXd expected(chains_theta.rows(), chains_theta.cols());
+  boost::math::normal_distribution<double> dist;
+  for (Eigen::Index i = 0; i < size;) {
+    Eigen::Index j = i + 1;
+    while (j < size && value_with_index[j].first == value_with_index[i].first)
+      ++j;
+    double p = ((i + 1 + j) / 2.0 - 0.375) / (size + 0.25);
+    for (Eigen::Index k = i; k < j; ++k)
+      expected(value_with_index[k].second) = boost::math::quantile(dist, p);
+    i = j;
+  }
+
+  Eigen::MatrixXd ranks = stan::analyze::rank_transform(chains_theta);
+  EXPECT_DOUBLE_EQ(ranks(3, 1), ranks(7, 2));
+  EXPECT_DOUBLE_EQ(ranks(5, 0), ranks(7, 2));
+  for (Eigen::Index i = 0; i < size; ++i) {
+    EXPECT_NEAR(expected(i), ranks(i), 1e-14);
+  }
+
+  // reusing the output and scratch space, and sorting in parallel
+  Eigen::MatrixXd reused;
+  std::vector<Eigen::Index> order;
+  for (Eigen::Index threshold : {Eigen::Index(1 << 16), Eigen::Index(0)}) {
+    stan::analyze::rank_transform(chains_theta, reused, order, threshold);
+    ASSERT_EQ(chains_theta.rows(), reused.rows());
+    ASSERT_EQ(chains_theta.cols(), reused.cols());
+    for (Eigen::Index i = 0; i < size; ++i) {
+      EXPECT_EQ(ranks(i), reused(i));
+    }
+  }
+}
@@ -0,0 +1,131 @@
+#include <stan/callbacks/async_writer.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace test {
+class recording_writer : public stan::callbacks::writer {
+ public:
+  std::vector<std::vector<double>> rows;
+  std::vector<const double*> row_data;
+  std::chrono::milliseconds delay{0};
+
+  void operator()(const std::vector<double>& state) {
+    std::this_thread::sleep_for(delay);
+    rows.push_back(state);
+  }
+
+  void operator()(std::vector<double>&& state) {
+    std::this_thread::sleep_for(delay);
+    row_data.push_back(state.data());
+    rows.push_back(std::move(state));
+  }
+};
+
+class throwing_writer : public stan::callbacks::writer {
+ public:
+  void operator()(const std::string& message) {
+    throw std::runtime_error("write failed");
+  }
+};
+}  // namespace test
+
+TEST(StanCallbacksAsyncWriter, matches_stream_writer) {
+  std::stringstream expected_ss, ss;
+  stan::callbacks::stream_writer expected(expected_ss, "# ");
+  stan::callbacks::stream_writer target(ss, "# ");
+  Eigen::MatrixXd m(2, 3);
+  m << 1, 2, 3, 4, 5, 6;
+  {
+    stan::callbacks::async_write_queue queue;
+    stan::callbacks::async_writer writer(queue, target);
+    for (stan::callbacks::writer* w :
+         {static_cast<stan::callbacks::writer*>(&expected),
+          static_cast<stan::callbacks::writer*>(&writer)}) {
+      (*w)(std::vector<std::string>{"a", "b"});
+      (*w)(std::vector<double>{1.5, 2.5});
+      std::vector<double> row{3, 4};
+      (*w)(row);
+      (*w)();
+      (*w)(std::string("comment"));
+      (*w)(m);
+    }
+    queue.close();
+  }
+  EXPECT_EQ(expected_ss.str(), ss.str());
+}
+
+TEST(StanCallbacksAsyncWriter, moves_rows) {
+  test::recording_writer target;
+  stan::callbacks::async_write_queue queue;
+  stan::callbacks::async_writer writer(queue, target);
+  std::vector<const double*> sent;
+  for (int n = 0; n < 10; ++n) {
+    std::vector<double> row{static_cast<double>(n)};
+    sent.push_back(row.data());
+    static_cast<stan::callbacks::writer&>(writer)(std::move(row));
+  }
+  queue.close();
+  ASSERT_EQ(10u, target.rows.size());
+  EXPECT_EQ(sent, target.row_data);
+  for (int n = 0; n < 10; ++n)
+    EXPECT_EQ(n, target.rows[n][0]);
+}
+
+TEST(StanCallbacksAsyncWriter, keeps_order_per_producer) {
+  const int num_producers = 4;
+  const int num_rows = 500;
+  std::vector<test::recording_writer> targets(num_producers);
+  stan::callbacks::async_write_queue queue(8);
+  std::vector<stan::callbacks::async_writer> writers;
+  for (auto& target : targets)
+    writers.emplace_back(queue, target);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p)
+    producers.emplace_back([&writers, p]() {
+      for (int n = 0; n < num_rows; ++n)
+        writers[p](std::vector<double>{static_cast<double>(n)});
+    });
+  for (auto& producer : producers)
+    producer.join();
+  queue.close();
+  for (const auto& target : targets) {
+    ASSERT_EQ(static_cast<std::size_t>(num_rows), target.rows.size());
+    for (int n = 0; n < num_rows; ++n)
+      EXPECT_EQ(n, target.rows[n][0]);
+  }
+  EXPECT_EQ(static_cast<std::size_t>(num_producers * num_rows),
+            queue.statistics().writes);
+}
+
+TEST(StanCallbacksAsyncWriter, statistics) {
+  test::recording_writer target;
+  target.delay = std::chrono::milliseconds(1);
+  stan::callbacks::async_write_queue queue(1);
+  stan::callbacks::async_writer writer(queue, target);
+  for (int n = 0; n < 20; ++n)
+    writer(std::vector<double>{1.0});
+  queue.close();
+  auto stats = queue.statistics();
+  EXPECT_EQ(20u, stats.writes);
+  EXPECT_GT(stats.blocked_writes, 0u);
+  EXPECT_LE(stats.blocked_writes, 20u);
+  EXPECT_GT(stats.blocked_seconds, 0.0);
+  EXPECT_EQ(20u, target.rows.size());
+}
+
+TEST(StanCallbacksAsyncWriter, close_rethrows_errors) {
+  test::throwing_writer target;
+  stan::callbacks::async_write_queue queue;
+  stan::callbacks::async_writer writer(queue, target);
+  writer(std::string("message"));
+  writer(std::string("message"));
+  EXPECT_THROW(queue.close(), std::runtime_error);
+  EXPECT_NO_THROW(queue.close());
+  writer(std::string("discarded"));
+}
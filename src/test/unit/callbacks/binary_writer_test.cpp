@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <stan/callbacks/binary_writer.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct deleter_noop {
+  template <typename T>
+  constexpr void operator()(T* arg) const {}
+};
+
+class sync_counter : public std::stringbuf {
+ public:
+  int syncs{0};
+
+ protected:
+  int sync() override {
+    ++syncs;
+    return std::stringbuf::sync();
+  }
+};
+
+class StanInterfaceCallbacksBinaryWriter : public ::testing::Test {
+ public:
+  StanInterfaceCallbacksBinaryWriter()
+      : ss(std::ios_base::in | std::ios_base::out | std::ios_base::binary) {}
+
+  void expect_preamble() {
+    stan::io::binary_draws::read_preamble(ss);
+    EXPECT_TRUE(ss.good());
+  }
+
+  void expect_draws(const Eigen::MatrixXd& expected) {
+    EXPECT_EQ(stan::io::binary_draws::draws_record, ss.get());
+    std::size_t rows = stan::io::binary_draws::read_uint64(ss);
+    std::size_t cols = stan::io::binary_draws::read_uint64(ss);
+    ASSERT_EQ(expected.rows(), rows);
+    ASSERT_EQ(expected.cols(), cols);
+    Eigen::MatrixXd draws(rows, cols);
+    stan::io::binary_draws::read_values(ss, draws.data(), rows * cols);
+    for (std::size_t i = 0; i < rows; ++i)
+      for (std::size_t j = 0; j < cols; ++j)
+        EXPECT_EQ(expected(i, j), draws(i, j));
+  }
+
+  void expect_comment(const std::string& expected) {
+    EXPECT_EQ(stan::io::binary_draws::comment_record, ss.get());
+    EXPECT_EQ(expected, stan::io::binary_draws::read_string(ss));
+  }
+
+  std::stringstream ss;
+};
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, names) {
+  {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&ss)};
+    writer(std::vector<std::string>{"lp__", "theta.1", ""});
+  }
+  expect_preamble();
+  EXPECT_EQ(stan::io::binary_draws::names_record, ss.get());
+  ASSERT_EQ(3, stan::io::binary_draws::read_uint64(ss));
+  EXPECT_EQ("lp__", stan::io::binary_draws::read_string(ss));
+  EXPECT_EQ("theta.1", stan::io::binary_draws::read_string(ss));
+  EXPECT_EQ("", stan::io::binary_draws::read_string(ss));
+  EXPECT_EQ(std::char_traits<char>::eof(), ss.get());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, blocks) {
+  Eigen::MatrixXd expected(5, 3);
+  for (int i = 0; i < expected.size(); ++i)
+    expected(i) = 0.1 * i - 1;
+  {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&ss), 2};
+    for (int i = 0; i < expected.rows(); ++i) {
+      Eigen::VectorXd row = expected.row(i);
+      writer(std::vector<double>(row.data(), row.data() + row.size()));
+    }
+  }
+  expect_preamble();
+  expect_draws(expected.topRows(2));
+  expect_draws(expected.middleRows(2, 2));
+  expect_draws(expected.bottomRows(1));
+  EXPECT_EQ(std::char_traits<char>::eof(), ss.get());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, comments_keep_order) {
+  Eigen::MatrixXd first(1, 2);
+  first << 1, 2;
+  Eigen::MatrixXd second(2, 2);
+  second << 3, 4, 5, 6;
+  {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&ss)};
+    writer(std::vector<double>{1, 2});
+    writer("Adaptation terminated");
+    writer();
+    writer(std::vector<double>{3, 4});
+    writer(std::vector<double>{5, 6});
+  }
+  expect_preamble();
+  expect_draws(first);
+  expect_comment("Adaptation terminated");
+  expect_comment("");
+  expect_draws(second);
+  EXPECT_EQ(std::char_traits<char>::eof(), ss.get());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, eigen_matrix) {
+  // parameters in rows and draws in columns
+  Eigen::MatrixXd values(2, 3);
+  values << 1, 2, 3, 4, 5, 6;
+  {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&ss)};
+    writer(values);
+  }
+  expect_preamble();
+  expect_draws(values.transpose());
+  EXPECT_EQ(std::char_traits<char>::eof(), ss.get());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, flushes_only_on_request) {
+  sync_counter buf;
+  std::ostream out(&buf);
+  {
+    stan::callbacks::binary_writer<std::ostream, deleter_noop> writer{
+        std::unique_ptr<std::ostream, deleter_noop>(&out), 2};
+    writer(std::vector<std::string>{"lp__", "theta"});
+    writer(std::vector<double>{1, 2});
+    writer(std::vector<double>{3, 4});
+    writer("Adaptation terminated");
+    writer(std::vector<double>{5, 6});
+    writer();
+    EXPECT_EQ(0, buf.syncs);
+    writer.flush();
+    EXPECT_EQ(1, buf.syncs);
+  }
+  EXPECT_EQ(2, buf.syncs);
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, null) {
+  stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+      std::unique_ptr<std::stringstream, deleter_noop>(nullptr)};
+  EXPECT_NO_THROW(writer(std::vector<double>{1, 2}));
+  EXPECT_NO_THROW(writer("message"));
+  EXPECT_NO_THROW(writer.flush());
+  EXPECT_EQ("", ss.str());
+}
@@ -0,0 +1,99 @@
+#include <stan/callbacks/histogram_telemetry.hpp>
+#include <stan/callbacks/json_writer.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(StanInterfaceCallbacksHistogramTelemetry, histogram_bins) {
+  using histogram = stan::callbacks::histogram_telemetry::histogram;
+  histogram h = histogram::geometric(1, 2, 4);
+  EXPECT_EQ(std::vector<double>({1, 2, 4, 8}), h.edges());
+  EXPECT_TRUE(std::isnan(h.mean()));
+  EXPECT_TRUE(std::isnan(h.min()));
+
+  for (double x : {0.5, 1.0, 1.5, 2.0, 7.0, 8.0, 100.0})
+    h.add(x);
+  EXPECT_EQ(std::vector<int>({1, 2, 1, 1, 2}), h.counts());
+  EXPECT_EQ(7, h.count());
+  EXPECT_FLOAT_EQ(120, h.sum());
+  EXPECT_FLOAT_EQ(120.0 / 7, h.mean());
+  EXPECT_FLOAT_EQ(0.5, h.min());
+  EXPECT_FLOAT_EQ(100, h.max());
+
+  histogram depth = histogram::linear(0, 1, 3);
+  EXPECT_EQ(std::vector<double>({0, 1, 2}), depth.edges());
+  depth.add(1);
+  depth.add(1);
+  depth.add(5);
+  EXPECT_EQ(std::vector<int>({0, 0, 2, 1}), depth.counts());
+}
+
+TEST(StanInterfaceCallbacksHistogramTelemetry, phases) {
+  stan::callbacks::histogram_telemetry telemetry;
+  EXPECT_TRUE(telemetry.enabled());
+  EXPECT_FALSE(stan::callbacks::telemetry().enabled());
+
+  stan::callbacks::transition_stats stats;
+  stats.warmup = true;
+  stats.transition_seconds = 3e-3;
+  stats.gradient_evals = 7;
+  stats.gradient_seconds = 2e-3;
+  stats.tree_depth = 3;
+  telemetry(stats);
+  telemetry(stats);
+
+  stats.warmup = false;
+  stats.tree_depth = -1;
+  stats.write_array_seconds = 1e-4;
+  stats.writer_seconds = 2e-4;
+  telemetry(stats);
+
+  const auto& warmup = telemetry.warmup();
+  EXPECT_EQ(2, warmup.transitions);
+  EXPECT_EQ(2, warmup.tree_depth.count());
+  EXPECT_EQ(2, warmup.tree_depth.counts()[4]);
+  EXPECT_FLOAT_EQ(14, warmup.gradient_evals.sum());
+  EXPECT_FLOAT_EQ(2e-3, warmup.integrator_seconds.sum());
+  EXPECT_FLOAT_EQ(0, warmup.write_array_seconds.sum());
+
+  const auto& main = telemetry.main();
+  EXPECT_EQ(1, main.transitions);
+  EXPECT_EQ(0, main.tree_depth.count()) << "no tree";
+  EXPECT_FLOAT_EQ(1e-4, main.write_array_seconds.sum());
+  EXPECT_FLOAT_EQ(2e-4, main.writer_seconds.sum());
+}
+
+struct deleter_noop {
+  template <typename T>
+  constexpr void operator()(T* arg) const {}
+};
+
+TEST(StanInterfaceCallbacksHistogramTelemetry, write_json) {
+  stan::callbacks::histogram_telemetry telemetry;
+  stan::callbacks::transition_stats stats;
+  stats.gradient_evals = 3;
+  stats.tree_depth = 2;
+  telemetry(stats);
+
+  std::stringstream ss;
+  stan::callbacks::json_writer<std::stringstream, deleter_noop> writer{
+      std::unique_ptr<std::stringstream, deleter_noop>(&ss)};
+  telemetry.write(writer);
+  std::string out = ss.str();
+  out.erase(std::remove_if(out.begin(), out.end(),
+                           [](char c) { return c == ' ' || c == '\n'; }),
+            out.end());
+
+  EXPECT_EQ('{', out.front());
+  EXPECT_EQ('}', out.back());
+  EXPECT_NE(std::string::npos, out.find("\"warmup\":{\"transitions\":0"));
+  EXPECT_NE(std::string::npos, out.find("\"main\":{\"transitions\":1"));
+  EXPECT_NE(std::string::npos,
+            out.find("\"tree_depth\":{\"count\":1,\"sum\":2,\"mean\":2"));
+  EXPECT_NE(std::string::npos, out.find("\"mean\":NaN"))
+      << "empty histograms have no mean";
+}
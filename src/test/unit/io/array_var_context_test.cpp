@@ -307,3 +307,44 @@ TEST(array_var_context, ctor_complex) {
   std::vector<std::complex<double>> eta;
   EXPECT_EQ(eta, avc.vals_c("eta"));
 }
+
+TEST(array_var_context, vals_span) {
+  std::vector<double> v_r{1.5, 2.5, 3.5, 4.5};
+  std::vector<int> v_i{7, 8, 9};
+  std::vector<std::string> names_r{"a", "b"};
+  std::vector<std::vector<size_t>> dims_r{{}, {3}};
+  std::vector<std::string> names_i{"n"};
+  std::vector<std::vector<size_t>> dims_i{{3}};
+  stan::io::array_var_context avc(names_r, v_r, dims_r, names_i, v_i, dims_i);
+
+  stan::io::var_span<double> b = avc.vals_r_span("b");
+  EXPECT_EQ(avc.vals_r("b"), b.to_vector());
+  // Views refer to the storage of the context rather than copies
+  EXPECT_EQ(b.data(), avc.vals_r_span("b").data());
+
+  stan::io::var_span<int> n = avc.vals_i_span("n");
+  EXPECT_EQ(avc.vals_i("n"), n.to_vector());
+  EXPECT_EQ(n.data(), avc.vals_i_span("n").data());
+
+  // Integer values are converted when read as reals
+  EXPECT_EQ((std::vector<double>{7, 8, 9}), avc.vals_r_span("n").to_vector());
+
+  EXPECT_TRUE(avc.vals_r_span("c").empty());
+  EXPECT_TRUE(avc.vals_i_span("a").empty());
+}
+
+TEST(array_var_context, names) {
+  std::vector<double> v_r{1.5, 2.5};
+  std::vector<int> v_i{7, 8, 9};
+  std::vector<std::string> names_r{"a", "b"};
+  std::vector<std::vector<size_t>> dims_r{{}, {}};
+  std::vector<std::string> names_i{"n"};
+  std::vector<std::vector<size_t>> dims_i{{3}};
+  stan::io::array_var_context avc(names_r, v_r, dims_r, names_i, v_i, dims_i);
+
+  std::vector<std::string> names;
+  avc.names_r(names);
+  EXPECT_EQ(names_r, names);
+  avc.names_i(names);
+  EXPECT_EQ(names_i, names);
+}
@@ -0,0 +1,166 @@
+#include <stan/io/binary_var_context.hpp>
+#include <stan/io/binary_data.hpp>
+#include <stan/io/array_var_context.hpp>
+#include <stan/io/dump.hpp>
+#include <stan/io/json/json_data.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class binary_var_context_test : public testing::Test {
+ public:
+  binary_var_context_test() : path("binary_var_context_test.bin") {}
+
+  void TearDown() { std::remove(path.c_str()); }
+
+  void write(const stan::io::var_context& context) {
+    std::ofstream out(path, std::ios::binary);
+    stan::io::binary_data::write_binary_data(context, out);
+  }
+
+  void write_bytes(const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary);
+    out << bytes;
+  }
+
+  std::string path;
+};
+
+TEST_F(binary_var_context_test, round_trip_json) {
+  std::stringstream in(
+      "{ \"N\" : 3, \"y\" : [1, 0, 1], \"x\" : [[1.5, 2.5], [3.5, 4.5], "
+      "[5.5, 6.5]], \"sigma\" : 0.25, \"empty\" : [] }");
+  stan::json::json_data json(in);
+  write(json);
+  stan::io::binary_var_context binary(path);
+
+  std::vector<std::string> names;
+  binary.names_i(names);
+  EXPECT_EQ((std::vector<std::string>{"N", "empty", "y"}), names);
+  binary.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"sigma", "x"}), names);
+
+  for (const std::string name : {"N", "y", "empty"}) {
+    EXPECT_TRUE(binary.contains_i(name));
+    EXPECT_TRUE(binary.contains_r(name));
+    EXPECT_EQ(json.vals_i(name), binary.vals_i(name));
+    EXPECT_EQ(json.vals_r(name), binary.vals_r(name));
+    EXPECT_EQ(json.dims_i(name), binary.dims_i(name));
+    EXPECT_EQ(json.dims_r(name), binary.dims_r(name));
+  }
+  for (const std::string name : {"x", "sigma"}) {
+    EXPECT_FALSE(binary.contains_i(name));
+    EXPECT_TRUE(binary.contains_r(name));
+    EXPECT_EQ(json.vals_r(name), binary.vals_r(name));
+    EXPECT_EQ(json.dims_r(name), binary.dims_r(name));
+  }
+  EXPECT_EQ(json.vals_c("x"), binary.vals_c("x"));
+  EXPECT_TRUE(binary.vals_c("sigma").empty());
+  EXPECT_FALSE(binary.contains_r("z"));
+  EXPECT_TRUE(binary.vals_r("z").empty());
+  EXPECT_TRUE(binary.dims_r("z").empty());
+
+  EXPECT_NO_THROW(binary.validate_dims("data", "x", "double", {3, 2}));
+  EXPECT_NO_THROW(binary.validate_dims("data", "y", "int", {3}));
+  EXPECT_THROW(binary.validate_dims("data", "x", "double", {2, 3}),
+               std::runtime_error);
+  EXPECT_THROW(binary.validate_dims("data", "x", "int", {3, 2}),
+               std::runtime_error);
+}
+
+TEST_F(binary_var_context_test, round_trip_dump) {
+  std::stringstream in(
+      "n <- c(4L, 5L)\nz <- structure(c(1.5, 2.5, 3.5, 4.5), .Dim = c(2, 2))");
+  stan::io::dump dump(in);
+  write(dump);
+  stan::io::binary_var_context binary(path);
+
+  EXPECT_EQ(dump.vals_i("n"), binary.vals_i("n"));
+  EXPECT_EQ(dump.vals_r("z"), binary.vals_r("z"));
+  EXPECT_EQ(dump.dims_r("z"), binary.dims_r("z"));
+}
+
+TEST_F(binary_var_context_test, spans_read_in_place) {
+  std::vector<std::string> names_r{"a"};
+  std::vector<double> values_r{1, 2, 3, 4, 5};
+  std::vector<std::vector<size_t>> dims_r{{5}};
+  std::vector<std::string> names_i{"n"};
+  std::vector<int> values_i{7, 8};
+  std::vector<std::vector<size_t>> dims_i{{2}};
+  stan::io::array_var_context avc(names_r, values_r, dims_r, names_i,
+                                  values_i, dims_i);
+  write(avc);
+
+  stan::io::var_span<double> a;
+  stan::io::var_span<int> n;
+  {
+    stan::io::binary_var_context binary(path);
+    a = binary.vals_r_span("a");
+    n = binary.vals_i_span("n");
+    EXPECT_EQ(a.data(), binary.vals_r_span("a").data());
+    EXPECT_EQ(n.data(), binary.vals_i_span("n").data());
+    EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(a.data())
+                      % stan::io::binary_data::alignment);
+    EXPECT_EQ((std::vector<double>{7, 8}), binary.vals_r_span("n").to_vector());
+    EXPECT_TRUE(binary.vals_i_span("a").empty());
+  }
+  // Views keep the mapped file alive
+  EXPECT_EQ(values_r, a.to_vector());
+  EXPECT_EQ(values_i, n.to_vector());
+}
+
+TEST_F(binary_var_context_test, invalid_files) {
+  EXPECT_THROW(stan::io::binary_var_context("no_such_file.bin"),
+               std::invalid_argument);
+
+  write_bytes("");
+  EXPECT_THROW(stan::io::binary_var_context binary(path),
+               std::invalid_argument);
+
+  write_bytes("{ \"N\" : 3 }");
+  EXPECT_THROW(stan::io::binary_var_context binary(path),
+               std::invalid_argument);
+
+  std::stringstream in("{ \"x\" : [1.5, 2.5] }");
+  stan::json::json_data json(in);
+  std::stringstream out;
+  stan::io::binary_data::write_binary_data(json, out);
+  std::string bytes = out.str();
+  write_bytes(bytes.substr(0, bytes.size() - 1));
+  EXPECT_THROW(stan::io::binary_var_context binary(path),
+               std::invalid_argument);
+  write_bytes(bytes.substr(0, 30));
+  EXPECT_THROW(stan::io::binary_var_context binary(path),
+               std::invalid_argument);
+
+  bytes[8] = 2;
+  write_bytes(bytes);
+  EXPECT_THROW(stan::io::binary_var_context binary(path),
+               std::invalid_argument);
+}
+
+TEST_F(binary_var_context_test, overflowing_dims) {
+  // One double variable x with dimensions (2^63 + 1, 2), whose product
+  // wraps around to 2 in 64 bits
+  const auto uint64_bytes = [](std::uint64_t n) {
+    std::string bytes;
+    for (int i = 0; i < 8; ++i)
+      bytes += static_cast<char>((n >> (8 * i)) & 0xff);
+    return bytes;
+  };
+  std::string bytes(stan::io::binary_data::magic,
+                    sizeof(stan::io::binary_data::magic));
+  bytes += std::string("\x01\x00\x00\x00\x00\x00\x00\x00", 8);
+  bytes += uint64_bytes(1) + uint64_bytes(1) + "x";
+  bytes += stan::io::binary_data::real_type;
+  bytes += uint64_bytes(2) + uint64_bytes((std::uint64_t{1} << 63) + 1)
+           + uint64_bytes(2) + uint64_bytes(128);
+  bytes.resize(128 + 2 * sizeof(double), '\0');
+  write_bytes(bytes);
+  EXPECT_THROW(stan::io::binary_var_context binary(path),
+               std::invalid_argument);
+}
@@ -53,3 +53,26 @@ TEST(chained_var_context, ctor) {
   std::vector<double> alpha(1, 0);
   EXPECT_EQ(alpha, vcc.vals_r("alpha"));
 }
+
+TEST(chained_var_context, vals_span) {
+  std::vector<double> v1{1, 2, 3};
+  std::vector<std::string> names1{"a"};
+  std::vector<std::vector<size_t>> dims1{{3}};
+  stan::io::array_var_context avc1(names1, v1, dims1);
+
+  std::vector<double> v2{10, 20};
+  std::vector<std::string> names2{"a", "b"};
+  std::vector<std::vector<size_t>> dims2{{}, {}};
+  std::vector<int> v2_i{7};
+  std::vector<std::string> names2_i{"n"};
+  std::vector<std::vector<size_t>> dims2_i{{}};
+  stan::io::array_var_context avc2(names2, v2, dims2, names2_i, v2_i,
+                                   dims2_i);
+
+  stan::io::chained_var_context cvc(avc1, avc2);
+  EXPECT_EQ(avc1.vals_r_span("a").data(), cvc.vals_r_span("a").data());
+  EXPECT_EQ(avc2.vals_r_span("b").data(), cvc.vals_r_span("b").data());
+  EXPECT_EQ(avc2.vals_i_span("n").data(), cvc.vals_i_span("n").data());
+  EXPECT_EQ((std::vector<double>{1, 2, 3}), cvc.vals_r_span("a").to_vector());
+  EXPECT_TRUE(cvc.vals_r_span("c").empty());
+}
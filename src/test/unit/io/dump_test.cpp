@@ -683,3 +683,21 @@ TEST(io_dump, too_large_zero_array) {
   test_exception(
       "a <- structure(double(999918446744073709551616L), .Dim = c(2,3))");
 }
+
+TEST(io_dump, vals_span) {
+  std::string txt = "a <- c(1.5, 2.5, 3.5)\nn <- c(4L, 5L)";
+  std::stringstream in(txt);
+  stan::io::dump dump(in);
+
+  stan::io::var_span<double> a = dump.vals_r_span("a");
+  EXPECT_EQ(dump.vals_r("a"), a.to_vector());
+  EXPECT_EQ(a.data(), dump.vals_r_span("a").data());
+
+  stan::io::var_span<int> n = dump.vals_i_span("n");
+  EXPECT_EQ(dump.vals_i("n"), n.to_vector());
+  EXPECT_EQ(n.data(), dump.vals_i_span("n").data());
+  EXPECT_EQ((std::vector<double>{4, 5}), dump.vals_r_span("n").to_vector());
+
+  EXPECT_TRUE(dump.vals_r_span("b").empty());
+  EXPECT_TRUE(dump.vals_i_span("a").empty());
+}
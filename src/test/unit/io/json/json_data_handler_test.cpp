@@ -79,3 +79,91 @@ TEST(ioJson, rtl_2_ltr_err_3n) {
   dims[1] = 4;
   test_exception(11, "Variable: foo, ill-formed data.", dims);
 }
+
+void parse_json(const std::string &text, bool fast_arrays,
+                stan::json::vars_map_r &vars_r,
+                stan::json::vars_map_i &vars_i) {
+  stan::json::json_data_handler handler(vars_r, vars_i, fast_arrays);
+  std::stringstream in(text);
+  stan::json::rapidjson_parse(in, handler);
+}
+
+void test_fast_arrays(const std::string &text) {
+  stan::json::vars_map_r fast_r, general_r;
+  stan::json::vars_map_i fast_i, general_i;
+  parse_json(text, true, fast_r, fast_i);
+  parse_json(text, false, general_r, general_i);
+  EXPECT_EQ(general_r, fast_r) << text;
+  EXPECT_EQ(general_i, fast_i) << text;
+}
+
+void test_fast_arrays_error(const std::string &text) {
+  stan::json::vars_map_r vars_r;
+  stan::json::vars_map_i vars_i;
+  std::string general_msg;
+  try {
+    parse_json(text, false, vars_r, vars_i);
+  } catch (const std::exception &e) {
+    general_msg = e.what();
+  }
+  EXPECT_FALSE(general_msg.empty()) << text;
+  try {
+    parse_json(text, true, vars_r, vars_i);
+  } catch (const std::exception &e) {
+    EXPECT_EQ(general_msg, e.what());
+    return;
+  }
+  FAIL() << text;
+}
+
+TEST(ioJson, fast_arrays_match_general_path) {
+  test_fast_arrays("{ \"a\" : [1, 2, 3] }");
+  test_fast_arrays("{ \"a\" : [1.5, 2, 3] }");
+  test_fast_arrays("{ \"a\" : [1, 2, 3.5] }");
+  test_fast_arrays("{ \"a\" : [1, \"Inf\", -Infinity] }");
+  test_fast_arrays("{ \"a\" : [1, 4294967295] }");
+  test_fast_arrays("{ \"a\" : [] }");
+  test_fast_arrays("{ \"a\" : [[], []] }");
+  test_fast_arrays("{ \"a\" : [[1, 2, 3], [4, 5, 6]] }");
+  test_fast_arrays("{ \"a\" : [[1, 2, 3], [4, 5.5, 6]] }");
+  test_fast_arrays(
+      "{ \"a\" : [[[1, 2], [3, 4], [5, 6]], [[7, 8], [9, 10], [11, 12]]] }");
+  test_fast_arrays("{ \"N\" : 2, \"a\" : [[1], [2]], \"b\" : [0.5, 1.5] }");
+  test_fast_arrays("{ \"a\" : [{\"1\" : 1, \"2\" : [1, 2]}] }");
+  test_fast_arrays(
+      "{ \"a\" : [[{\"1\" : 1.5, \"2\" : 2}], [{\"1\" : 3, \"2\" : 4}]] }");
+  test_fast_arrays("{ \"t\" : {\"1\" : [1, 2], \"2\" : [[3.5]]} }");
+  test_fast_arrays("{ \"1a\" : [1, 2], \"a\" : [3] }");
+}
+
+TEST(ioJson, fast_arrays_errors_match_general_path) {
+  test_fast_arrays_error("{ \"a\" : [[1, 2, 3], [4, 5]] }");
+  test_fast_arrays_error("{ \"a\" : [[1, 2], 3] }");
+  test_fast_arrays_error("{ \"a\" : [1, [2, 3]] }");
+  test_fast_arrays_error("{ \"a\" : [1, null] }");
+  test_fast_arrays_error("{ \"a\" : [1, true] }");
+  test_fast_arrays_error("{ \"a\" : [1, \"b\"] }");
+  test_fast_arrays_error("{ \"a\" : [1], \"a\" : [2] }");
+}
+
+TEST(ioJson, fast_arrays_large) {
+  std::stringstream text;
+  text << "{ \"a\" : [";
+  for (int i = 0; i < 50; ++i) {
+    text << (i ? ", [" : "[");
+    for (int j = 0; j < 40; ++j)
+      text << (j ? ", " : "") << i * 40 + j;
+    text << "]";
+  }
+  text << "] }";
+  stan::json::vars_map_r vars_r;
+  stan::json::vars_map_i vars_i;
+  parse_json(text.str(), true, vars_r, vars_i);
+  const std::vector<int> &values = vars_i["a"].first;
+  EXPECT_EQ((std::vector<size_t>{50, 40}), vars_i["a"].second);
+  ASSERT_EQ(2000U, values.size());
+  for (int i = 0; i < 50; ++i)
+    for (int j = 0; j < 40; ++j)
+      EXPECT_EQ(i * 40 + j, values[i + 50 * j]);
+  test_fast_arrays(text.str());
+}
@@ -494,3 +494,21 @@ TEST(ioJson, jsonData_promote_extra_large_int_to_double) {
   test_real_var(jdata, "foo", foo_vals_r, expected_dims);
   test_real_var(jdata, "bar", bar_vals_r, expected_dims);
 }
+
+TEST(ioJson, jsonData_vals_span) {
+  std::string txt = "{ \"a\" : [[1.5, 2.5], [3.5, 4.5]], \"n\" : [4, 5] }";
+  std::stringstream in(txt);
+  stan::json::json_data jdata(in);
+
+  stan::io::var_span<double> a = jdata.vals_r_span("a");
+  EXPECT_EQ(jdata.vals_r("a"), a.to_vector());
+  EXPECT_EQ(a.data(), jdata.vals_r_span("a").data());
+
+  stan::io::var_span<int> n = jdata.vals_i_span("n");
+  EXPECT_EQ(jdata.vals_i("n"), n.to_vector());
+  EXPECT_EQ(n.data(), jdata.vals_i_span("n").data());
+  EXPECT_EQ((std::vector<double>{4, 5}), jdata.vals_r_span("n").to_vector());
+
+  EXPECT_TRUE(jdata.vals_r_span("b").empty());
+  EXPECT_TRUE(jdata.vals_i_span("a").empty());
+}
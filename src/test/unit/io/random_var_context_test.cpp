@@ -174,3 +174,25 @@ TEST_F(random_var_context, construct) {
   EXPECT_THROW_MSG(stan::io::random_var_context(throwing_model, rng, 2, false),
                    std::domain_error, "throwing within write_array");
 }
+
+TEST_F(random_var_context, construct_from_draws) {
+  stan::rng_t draw_rng = rng;
+  std::vector<double> draws
+      = stan::io::random_var_context::draw_unconstrained(model, draw_rng, 2,
+                                                         false);
+  ASSERT_EQ(model.num_params_r(), draws.size());
+  stan::io::random_var_context from_draws(model, draw_rng, draws);
+
+  stan::io::random_var_context context(model, rng, 2, false);
+  EXPECT_EQ(context.get_unconstrained(), from_draws.get_unconstrained());
+  EXPECT_EQ(context.vals_r("y"), from_draws.vals_r("y"));
+  // Both leave the generator in the same state
+  EXPECT_EQ(rng(), draw_rng());
+
+  std::vector<double> zeros
+      = stan::io::random_var_context::draw_unconstrained(model, draw_rng, 2,
+                                                         true);
+  EXPECT_EQ(std::vector<double>(model.num_params_r(), 0.0), zeros);
+  // Nothing is drawn for zero initial values
+  EXPECT_EQ(rng(), draw_rng());
+}
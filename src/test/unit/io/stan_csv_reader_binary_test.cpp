@@ -0,0 +1,183 @@
+#include <stan/callbacks/binary_writer.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+struct deleter_noop {
+  template <typename T>
+  constexpr void operator()(T* arg) const {}
+};
+
+/**
+ * Replays a csv output file through a binary_writer, in the same
+ * sequence of writer calls the services used to produce it.
+ */
+void csv_to_binary(const std::string& path, std::stringstream& binary) {
+  std::ifstream csv(path);
+  stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+      std::unique_ptr<std::stringstream, deleter_noop>(&binary), 7};
+  std::string line;
+  while (std::getline(csv, line)) {
+    if (line.empty())
+      continue;
+    if (line[0] == '#') {
+      writer(line.substr(line.size() > 1 && line[1] == ' ' ? 2 : 1));
+      continue;
+    }
+    std::vector<std::string> cells;
+    std::stringstream ls(line);
+    std::string cell;
+    while (std::getline(ls, cell, ','))
+      cells.push_back(cell);
+    if (std::isalpha(line[0])) {
+      writer(cells);
+    } else {
+      std::vector<double> values;
+      for (const auto& c : cells)
+        values.push_back(std::strtod(c.c_str(), nullptr));
+      writer(values);
+    }
+  }
+}
+
+void expect_same_parse(const std::string& path) {
+  std::ifstream csv(path);
+  std::stringstream csv_out;
+  stan::io::stan_csv expected = stan::io::stan_csv_reader::parse(csv, &csv_out);
+
+  std::stringstream binary(std::ios_base::in | std::ios_base::out
+                           | std::ios_base::binary);
+  csv_to_binary(path, binary);
+  std::stringstream binary_out;
+  stan::io::stan_csv result
+      = stan::io::stan_csv_reader::parse(binary, &binary_out);
+
+  EXPECT_EQ(csv_out.str(), binary_out.str());
+
+  EXPECT_EQ(expected.metadata.stan_version_major,
+            result.metadata.stan_version_major);
+  EXPECT_EQ(expected.metadata.model, result.metadata.model);
+  EXPECT_EQ(expected.metadata.data, result.metadata.data);
+  EXPECT_EQ(expected.metadata.init, result.metadata.init);
+  EXPECT_EQ(expected.metadata.seed, result.metadata.seed);
+  EXPECT_EQ(expected.metadata.num_samples, result.metadata.num_samples);
+  EXPECT_EQ(expected.metadata.num_warmup, result.metadata.num_warmup);
+  EXPECT_EQ(expected.metadata.save_warmup, result.metadata.save_warmup);
+  EXPECT_EQ(expected.metadata.thin, result.metadata.thin);
+  EXPECT_EQ(expected.metadata.method, result.metadata.method);
+  EXPECT_EQ(expected.metadata.algorithm, result.metadata.algorithm);
+  EXPECT_EQ(expected.metadata.engine, result.metadata.engine);
+
+  EXPECT_EQ(expected.header, result.header);
+
+  EXPECT_FLOAT_EQ(expected.adaptation.step_size, result.adaptation.step_size);
+  ASSERT_EQ(expected.adaptation.metric.rows(),
+            result.adaptation.metric.rows());
+  ASSERT_EQ(expected.adaptation.metric.cols(),
+            result.adaptation.metric.cols());
+  for (int i = 0; i < expected.adaptation.metric.size(); ++i)
+    EXPECT_FLOAT_EQ(expected.adaptation.metric(i), result.adaptation.metric(i));
+
+  ASSERT_EQ(expected.samples.rows(), result.samples.rows());
+  ASSERT_EQ(expected.samples.cols(), result.samples.cols());
+  for (int i = 0; i < expected.samples.size(); ++i)
+    EXPECT_EQ(expected.samples(i), result.samples(i));
+
+  EXPECT_FLOAT_EQ(expected.timing.warmup, result.timing.warmup);
+  EXPECT_FLOAT_EQ(expected.timing.sampling, result.timing.sampling);
+}
+}  // namespace
+
+TEST(StanIoStanCsvReaderBinary, eight_schools) {
+  expect_same_parse("src/test/unit/io/test_csv_files/eight_schools.csv");
+}
+
+TEST(StanIoStanCsvReaderBinary, blocker) {
+  expect_same_parse("src/test/unit/io/test_csv_files/blocker.0.csv");
+}
+
+TEST(StanIoStanCsvReaderBinary, skip_warmup) {
+  expect_same_parse("src/test/unit/io/test_csv_files/bernoulli_warmup.csv");
+}
+
+TEST(StanIoStanCsvReaderBinary, fixed_param) {
+  expect_same_parse("src/test/unit/io/test_csv_files/fixed_param_output.csv");
+}
+
+TEST(StanIoStanCsvReaderBinary, variational) {
+  expect_same_parse("src/test/unit/io/test_csv_files/bernoulli_variational.csv");
+}
+
+TEST(StanIoStanCsvReaderBinary, no_samples) {
+  expect_same_parse("src/test/unit/io/test_csv_files/bernoulli_no_samples.csv");
+}
+
+TEST(StanIoStanCsvReaderBinary, bad_preamble) {
+  std::stringstream in(std::string("\x89STANBIX\x01\0\0\0", 12));
+  EXPECT_THROW(stan::io::stan_csv_reader::parse(in, nullptr),
+               std::invalid_argument);
+}
+
+TEST(StanIoStanCsvReaderBinary, truncated) {
+  std::stringstream binary(std::ios_base::in | std::ios_base::out
+                           | std::ios_base::binary);
+  {
+    stan::callbacks::binary_writer<std::stringstream, deleter_noop> writer{
+        std::unique_ptr<std::stringstream, deleter_noop>(&binary)};
+    writer(std::vector<std::string>{"lp__", "theta"});
+    writer(std::vector<double>{1, 2});
+  }
+  std::string bytes = binary.str();
+  std::stringstream in(bytes.substr(0, bytes.size() - 3));
+  EXPECT_THROW(stan::io::stan_csv_reader::parse(in, nullptr),
+               std::domain_error);
+}
+
+TEST(StanIoStanCsvReaderBinary, corrupt_lengths) {
+  std::string preamble;
+  {
+    std::stringstream binary(std::ios_base::in | std::ios_base::out
+                             | std::ios_base::binary);
+    stan::io::binary_draws::write_preamble(binary);
+    preamble = binary.str();
+  }
+  std::string huge(8, '\xff');
+  std::stringstream comment(preamble + "C" + huge + "lp__");
+  EXPECT_THROW(stan::io::stan_csv_reader::parse(comment, nullptr),
+               std::domain_error);
+  std::stringstream names(preamble + "N" + huge);
+  EXPECT_THROW(stan::io::stan_csv_reader::parse(names, nullptr),
+               std::domain_error);
+  std::stringstream draws(preamble + "D" + huge + huge);
+  EXPECT_THROW(stan::io::stan_csv_reader::parse(draws, nullptr),
+               std::domain_error);
+}
+
+TEST(StanIoStanCsvReaderBinary, unseekable) {
+  std::stringstream binary(std::ios_base::in | std::ios_base::out
+                           | std::ios_base::binary);
+  csv_to_binary("src/test/unit/io/test_csv_files/eight_schools.csv", binary);
+  std::stringstream expected_in(binary.str());
+  stan::io::stan_csv expected
+      = stan::io::stan_csv_reader::parse(expected_in, nullptr);
+
+  // a stream buffer that does not support seeking
+  struct unseekable_buf : public std::streambuf {
+    explicit unseekable_buf(std::string& bytes) {
+      setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+    }
+  };
+  std::string bytes = binary.str();
+  unseekable_buf buf(bytes);
+  std::istream in(&buf);
+  stan::io::stan_csv result = stan::io::stan_csv_reader::parse(in, nullptr);
+  EXPECT_EQ(expected.header, result.header);
+  ASSERT_EQ(expected.samples.rows(), result.samples.rows());
+  ASSERT_EQ(expected.samples.cols(), result.samples.cols());
+  EXPECT_TRUE(expected.samples == result.samples);
+}
@@ -591,3 +591,83 @@ TEST_F(StanIoStanCsvReader, variational) {
   variational_stream.close();
   ASSERT_EQ(1000, variational.metadata.num_samples);
 }
+
+TEST_F(StanIoStanCsvReader, read_samples_special_values) {
+  std::stringstream in(
+      "1, +2.5 ,nan\r\n"
+      "\n"
+      "-inf,inf,6.77055e-309\n"
+      "#  Elapsed Time: 0.5 seconds (Warm-up)\n"
+      "#                1.5 seconds (Sampling)\n"
+      "1e3,-0,x");
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(stan::io::stan_csv_reader::read_samples(in, samples, timing));
+
+  ASSERT_EQ(3, samples.rows());
+  ASSERT_EQ(3, samples.cols());
+  EXPECT_FLOAT_EQ(1, samples(0, 0));
+  EXPECT_FLOAT_EQ(2.5, samples(0, 1));
+  EXPECT_TRUE(std::isnan(samples(0, 2)));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), samples(1, 0));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), samples(1, 1));
+  EXPECT_FLOAT_EQ(6.77055e-309, samples(1, 2));
+  EXPECT_FLOAT_EQ(1000, samples(2, 0));
+  EXPECT_FLOAT_EQ(0, samples(2, 1));
+  EXPECT_FLOAT_EQ(0, samples(2, 2));
+
+  EXPECT_FLOAT_EQ(0.5, timing.warmup);
+  EXPECT_FLOAT_EQ(1.5, timing.sampling);
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_ragged) {
+  std::stringstream in("1,2,3\n4,5,6\n7,8\n");
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  try {
+    stan::io::stan_csv_reader::read_samples(in, samples, timing);
+    FAIL() << "expected std::invalid_argument";
+  } catch (const std::invalid_argument& e) {
+    EXPECT_EQ(std::string("Error: expected 3 columns, but found 2 instead "
+                          "for row 3"),
+              e.what());
+  }
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_ragged_many_rows) {
+  std::stringstream in;
+  const int rows = 5000;
+  for (int i = 0; i < rows; ++i) {
+    in << i << "," << i << "," << i;
+    if (i == 3000 || i == 4500)
+      in << "," << i;
+    in << "\n";
+  }
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  try {
+    stan::io::stan_csv_reader::read_samples(in, samples, timing);
+    FAIL() << "expected std::invalid_argument";
+  } catch (const std::invalid_argument& e) {
+    EXPECT_EQ(std::string("Error: expected 3 columns, but found 4 instead "
+                          "for row 3001"),
+              e.what());
+  }
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_many_rows) {
+  std::stringstream in;
+  const int rows = 5000;
+  for (int i = 0; i < rows; ++i)
+    in << i << "," << -0.5 * i << "," << i * 1e-3 << "\n";
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(stan::io::stan_csv_reader::read_samples(in, samples, timing));
+  ASSERT_EQ(rows, samples.rows());
+  ASSERT_EQ(3, samples.cols());
+  for (int i = 0; i < rows; ++i) {
+    EXPECT_FLOAT_EQ(i, samples(i, 0));
+    EXPECT_FLOAT_EQ(-0.5 * i, samples(i, 1));
+    EXPECT_FLOAT_EQ(i * 1e-3, samples(i, 2));
+  }
+}
@@ -0,0 +1,60 @@
+#include <stan/io/var_span.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+TEST(var_span, empty) {
+  stan::io::var_span<double> span;
+  EXPECT_TRUE(span.empty());
+  EXPECT_EQ(0U, span.size());
+  EXPECT_EQ(span.begin(), span.end());
+  EXPECT_EQ(std::vector<double>(), span.to_vector());
+}
+
+TEST(var_span, view) {
+  std::vector<double> values{1.5, 2.5, 3.5};
+  stan::io::var_span<double> span(values);
+  EXPECT_EQ(values.data(), span.data());
+  ASSERT_EQ(3U, span.size());
+  EXPECT_FLOAT_EQ(2.5, span[1]);
+  EXPECT_EQ(values, span.to_vector());
+
+  stan::io::var_span<double> copy(span);
+  EXPECT_EQ(values.data(), copy.data());
+  EXPECT_EQ(3U, copy.size());
+}
+
+TEST(var_span, owning) {
+  std::vector<int> values{4, 5, 6, 7};
+  const int* data = values.data();
+  stan::io::var_span<int> copy;
+  {
+    stan::io::var_span<int> span(std::move(values));
+    EXPECT_EQ(data, span.data());
+    copy = span;
+  }
+  EXPECT_EQ(data, copy.data());
+  EXPECT_EQ((std::vector<int>{4, 5, 6, 7}), copy.to_vector());
+
+  int sum = 0;
+  for (int x : copy)
+    sum += x;
+  EXPECT_EQ(22, sum);
+}
+
+TEST(var_span, shared) {
+  auto buffer = std::make_shared<const std::vector<double>>(
+      std::vector<double>{1, 2});
+  stan::io::var_span<double> span(buffer);
+  EXPECT_EQ(buffer->data(), span.data());
+  EXPECT_EQ(2, buffer.use_count());
+  buffer.reset();
+  EXPECT_FLOAT_EQ(2, span[1]);
+}
+
+TEST(var_span, default_var_context) {
+  stan::io::empty_var_context context;
+  EXPECT_TRUE(context.vals_r_span("foo").empty());
+  EXPECT_TRUE(context.vals_i_span("foo").empty());
+}
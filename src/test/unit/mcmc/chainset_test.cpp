@@ -2,7 +2,9 @@
 #include <stan/io/stan_csv_reader.hpp>
 #include <gtest/gtest.h>
 #include <set>
+#include <cmath>
 #include <exception>
+#include <limits>
 #include <utility>
 #include <fstream>
 #include <sstream>
@@ -207,3 +209,68 @@ TEST_F(McmcChains, summary_stats) {
     EXPECT_NEAR(theta_ac(i), theta_ac_expect(i), 0.0005);
   }
 }
+
+TEST_F(McmcChains, summary) {
+  std::vector<stan::io::stan_csv> eight_schools;
+  eight_schools.push_back(eight_schools_1);
+  eight_schools.push_back(eight_schools_2);
+  stan::mcmc::chainset chains(eight_schools);
+
+  Eigen::VectorXd probs(3);
+  probs << 0.1, 0.5, 0.9;
+  auto summary = chains.summary(probs);
+  ASSERT_EQ(chains.num_params(), summary.size());
+  for (int i = 0; i < chains.num_params(); ++i) {
+    const auto& stats = summary[i];
+    EXPECT_DOUBLE_EQ(chains.mean(i), stats.mean);
+    EXPECT_DOUBLE_EQ(chains.sd(i), stats.sd);
+    EXPECT_DOUBLE_EQ(chains.median(i), stats.median);
+    EXPECT_DOUBLE_EQ(chains.max_abs_deviation(i), stats.max_abs_deviation);
+    Eigen::VectorXd quantiles = chains.quantiles(i, probs);
+    ASSERT_EQ(probs.size(), stats.quantiles.size());
+    for (int j = 0; j < probs.size(); ++j) {
+      EXPECT_DOUBLE_EQ(quantiles(j), stats.quantiles(j));
+    }
+    // constant columns such as the sampler diagnostics give NaN
+    double mcse_mean = chains.mcse_mean(i);
+    double mcse_sd = chains.mcse_sd(i);
+    auto rhat = chains.split_rank_normalized_rhat(i);
+    auto ess = chains.split_rank_normalized_ess(i);
+    if (std::isnan(rhat.first)) {
+      EXPECT_TRUE(std::isnan(stats.rhat_bulk));
+      EXPECT_TRUE(std::isnan(stats.rhat_tail));
+      EXPECT_TRUE(std::isnan(stats.ess_bulk));
+      EXPECT_TRUE(std::isnan(stats.ess_tail));
+      EXPECT_TRUE(std::isnan(stats.mcse_mean));
+      EXPECT_TRUE(std::isnan(stats.mcse_sd));
+      continue;
+    }
+    EXPECT_DOUBLE_EQ(mcse_mean, stats.mcse_mean);
+    EXPECT_DOUBLE_EQ(mcse_sd, stats.mcse_sd);
+    EXPECT_DOUBLE_EQ(rhat.first, stats.rhat_bulk);
+    EXPECT_DOUBLE_EQ(rhat.second, stats.rhat_tail);
+    EXPECT_DOUBLE_EQ(ess.first, stats.ess_bulk);
+    EXPECT_DOUBLE_EQ(ess.second, stats.ess_tail);
+  }
+
+  auto default_summary = chains.summary();
+  ASSERT_EQ(chains.num_params(), default_summary.size());
+  EXPECT_EQ(3, default_summary[0].quantiles.size());
+  EXPECT_DOUBLE_EQ(summary[0].median, default_summary[0].quantiles(1));
+}
+
+TEST_F(McmcChains, summary_nan_draws) {
+  stan::io::stan_csv csv = eight_schools_1;
+  csv.samples(3, 7) = std::numeric_limits<double>::quiet_NaN();
+  stan::mcmc::chainset chains(csv);
+  EXPECT_THROW(chains.quantile(7, 0.5), std::invalid_argument);
+
+  auto summary = chains.summary();
+  EXPECT_TRUE(std::isnan(summary[7].mean));
+  EXPECT_TRUE(std::isnan(summary[7].median));
+  EXPECT_TRUE(std::isnan(summary[7].max_abs_deviation));
+  EXPECT_TRUE(std::isnan(summary[7].quantiles(0)));
+  EXPECT_TRUE(std::isnan(summary[7].rhat_bulk));
+  EXPECT_TRUE(std::isnan(summary[7].ess_bulk));
+  EXPECT_DOUBLE_EQ(chains.mean(8), summary[8].mean);
+}
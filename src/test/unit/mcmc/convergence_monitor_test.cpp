@@ -0,0 +1,105 @@
+#include <stan/mcmc/convergence_monitor.hpp>
+#include <stan/analyze/mcmc/split_rank_normalized_ess.hpp>
+#include <stan/analyze/mcmc/split_rank_normalized_rhat.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <cmath>
+#include <vector>
+
+class McmcConvergenceMonitor : public testing::Test {
+ public:
+  McmcConvergenceMonitor()
+      : rng(1234), normal(rng, boost::normal_distribution<>()) {}
+
+  // Draws of two quantities: independent standard normals, and an AR(1)
+  // process whose mean is offset by the chain index
+  void add_draws(stan::mcmc::convergence_monitor& monitor, int num_draws,
+                 double offset) {
+    for (size_t chain = 0; chain < monitor.num_chains(); ++chain) {
+      for (int n = 0; n < num_draws; ++n) {
+        Eigen::VectorXd draw(2);
+        ar[chain] = 0.8 * ar[chain] + normal();
+        draw << normal(), ar[chain] + offset * chain;
+        monitor.add_draw(chain, draw);
+        chains[0](n, chain) = draw(0);
+        chains[1](n, chain) = draw(1);
+      }
+    }
+  }
+
+  boost::ecuyer1988 rng;
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<>>
+      normal;
+  std::vector<double> ar = std::vector<double>(4, 0.0);
+  std::vector<Eigen::MatrixXd> chains
+      = std::vector<Eigen::MatrixXd>(2, Eigen::MatrixXd(200, 4));
+};
+
+TEST_F(McmcConvergenceMonitor, matches_analyze) {
+  stan::mcmc::convergence_monitor monitor(4, 2);
+  EXPECT_EQ(0, monitor.num_draws());
+  add_draws(monitor, 200, 0);
+  EXPECT_EQ(200, monitor.num_draws());
+
+  auto diagnostics = monitor.diagnostics();
+  ASSERT_EQ(2, diagnostics.size());
+  for (int i = 0; i < 2; ++i) {
+    auto rhat = stan::analyze::split_rank_normalized_rhat(chains[i]);
+    auto ess = stan::analyze::split_rank_normalized_ess(chains[i]);
+    EXPECT_FLOAT_EQ(rhat.first, diagnostics[i].rhat_bulk);
+    EXPECT_FLOAT_EQ(rhat.second, diagnostics[i].rhat_tail);
+    EXPECT_FLOAT_EQ(ess.first, diagnostics[i].ess_bulk);
+    EXPECT_FLOAT_EQ(ess.second, diagnostics[i].ess_tail);
+  }
+
+  auto summary = stan::mcmc::convergence_monitor::summarize(diagnostics);
+  EXPECT_FLOAT_EQ(std::max({diagnostics[0].rhat_bulk, diagnostics[0].rhat_tail,
+                            diagnostics[1].rhat_bulk,
+                            diagnostics[1].rhat_tail}),
+                  summary.max_rhat);
+  EXPECT_FLOAT_EQ(std::min(diagnostics[0].ess_bulk, diagnostics[1].ess_bulk),
+                  summary.min_ess_bulk);
+  EXPECT_FLOAT_EQ(std::min(diagnostics[0].ess_tail, diagnostics[1].ess_tail),
+                  summary.min_ess_tail);
+  EXPECT_LT(summary.max_rhat, 1.05);
+}
+
+TEST_F(McmcConvergenceMonitor, first_draw) {
+  stan::mcmc::convergence_monitor monitor(4, 2);
+  add_draws(monitor, 200, 0);
+
+  auto diagnostics = monitor.diagnostics(100);
+  for (int i = 0; i < 2; ++i) {
+    Eigen::MatrixXd second_half = chains[i].bottomRows(100);
+    auto rhat = stan::analyze::split_rank_normalized_rhat(second_half);
+    EXPECT_FLOAT_EQ(rhat.first, diagnostics[i].rhat_bulk);
+    EXPECT_FLOAT_EQ(rhat.second, diagnostics[i].rhat_tail);
+  }
+}
+
+TEST_F(McmcConvergenceMonitor, unmixed_chains) {
+  stan::mcmc::convergence_monitor monitor(4, 2);
+  add_draws(monitor, 200, 5);
+
+  auto summary
+      = stan::mcmc::convergence_monitor::summarize(monitor.diagnostics());
+  EXPECT_GT(summary.max_rhat, 1.5);
+
+  monitor.clear();
+  EXPECT_EQ(0, monitor.num_draws());
+}
+
+TEST_F(McmcConvergenceMonitor, too_few_draws) {
+  stan::mcmc::convergence_monitor monitor(4, 2);
+  add_draws(monitor, 1, 0);
+
+  auto diagnostics = monitor.diagnostics();
+  EXPECT_TRUE(std::isnan(diagnostics[0].rhat_bulk));
+  EXPECT_TRUE(std::isnan(diagnostics[0].ess_bulk));
+  auto summary = stan::mcmc::convergence_monitor::summarize(diagnostics);
+  EXPECT_TRUE(std::isnan(summary.max_rhat));
+  EXPECT_TRUE(std::isnan(summary.min_ess_bulk));
+  EXPECT_FALSE(summary.max_rhat <= 1.01);
+}
@@ -27,3 +27,45 @@ TEST(McmcCovarAdaptation, learn_covariance) {
   }
   EXPECT_EQ(0, logger.call_count());
 }
+
+TEST(McmcCovarAdaptation, pool_covariance) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 3;
+  const int n_learn = 20;
+  stan::mcmc::covar_adaptation single(n);
+  single.set_window_params(50, 0, 0, 2 * n_learn, logger);
+  stan::mcmc::covar_adaptation first(n);
+  first.set_window_params(50, 0, 0, n_learn, logger);
+  first.set_pooled(true);
+  stan::mcmc::covar_adaptation second(n);
+  second.set_window_params(50, 0, 0, n_learn, logger);
+  second.set_pooled(true);
+
+  Eigen::MatrixXd covar_single(Eigen::MatrixXd::Zero(n, n));
+  Eigen::MatrixXd covar_first(Eigen::MatrixXd::Zero(n, n));
+  Eigen::MatrixXd covar_second(Eigen::MatrixXd::Zero(n, n));
+  for (int i = 0; i < n_learn; ++i) {
+    Eigen::VectorXd q_first(n);
+    q_first << i, i * i, -0.5 * i;
+    Eigen::VectorXd q_second(n);
+    q_second << 3.0 - i, 0.25 * i * i, 10.0 + i;
+    single.learn_covariance(covar_single, q_first);
+    single.learn_covariance(covar_single, q_second);
+    EXPECT_FALSE(first.learn_covariance(covar_first, q_first));
+    EXPECT_FALSE(second.learn_covariance(covar_second, q_second));
+  }
+  EXPECT_TRUE(covar_first.isZero());
+  EXPECT_TRUE(covar_second.isZero());
+
+  Eigen::MatrixXd covar_pooled(Eigen::MatrixXd::Zero(n, n));
+  stan::mcmc::covar_adaptation::pool_covariance({&first, &second},
+                                                covar_pooled);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      EXPECT_NEAR(covar_single(i, j), covar_pooled(i, j),
+                  1e-10 * std::fabs(covar_single(i, j)) + 1e-12);
+    }
+  }
+  EXPECT_EQ(0, logger.call_count());
+}
@@ -168,3 +168,36 @@ TEST(McmcDenseEMetric, streams) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(McmcDenseEMetric, kinetic_energy_uses_metric) {
+  Eigen::Matrix3d m_inv;
+  m_inv << 2.0, 0.5, -0.3, 0.5, 1.5, 0.2, -0.3, 0.2, 0.8;
+
+  stan::mcmc::mock_model model(3);
+  stan::mcmc::dense_e_metric<stan::mcmc::mock_model, stan::rng_t> metric(model);
+  stan::mcmc::dense_e_point z(3);
+  z.p << 0.3, -1.2, 0.7;
+
+  EXPECT_FLOAT_EQ(0.5 * z.p.squaredNorm(), metric.T(z));
+
+  z.set_metric(m_inv);
+  EXPECT_FLOAT_EQ(0.5 * z.p.dot(m_inv * z.p), metric.T(z));
+  Eigen::VectorXd p_sharp = metric.dtau_dp(z);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_FLOAT_EQ((m_inv * z.p)(i), p_sharp(i));
+
+  // Metric adaptation updates the metric in place and refactors it
+  EXPECT_TRUE(z.update_metric([](Eigen::MatrixXd& inv_metric) {
+    inv_metric *= 2.0;
+    return true;
+  }));
+  EXPECT_FLOAT_EQ(z.p.dot(m_inv * z.p), metric.T(z));
+
+  // and keeps the factorization in step with it if the update throws
+  auto overflow = [](Eigen::MatrixXd& inv_metric) -> bool {
+    inv_metric *= 0.5;
+    throw std::runtime_error("overflow");
+  };
+  EXPECT_THROW(z.update_metric(overflow), std::runtime_error);
+  EXPECT_FLOAT_EQ(0.5 * z.p.dot(m_inv * z.p), metric.T(z));
+}
@@ -0,0 +1,197 @@
+#include <string>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_e_metric.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/funnel.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+
+TEST(McmcLowrankEMetric, sample_p) {
+  stan::rng_t base_rng = stan::services::util::create_rng(0, 0);
+
+  Eigen::VectorXd d(2);
+  d << 0.5, 0.25;
+  Eigen::MatrixXd U(2, 1);
+  U << 0.4, -0.3;
+  Eigen::Matrix2d m_inv = Eigen::Matrix2d(d.asDiagonal()) + U * U.transpose();
+  Eigen::Matrix2d m = m_inv.inverse();
+
+  stan::mcmc::mock_model model(2);
+
+  stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, stan::rng_t> metric(
+      model);
+  stan::mcmc::lowrank_e_point z(2);
+  z.set_metric(d, U);
+
+  int n_samples = 1000;
+
+  Eigen::Matrix2d sample_cov = Eigen::Matrix2d::Zero();
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    sample_cov += z.p * z.p.transpose() / n_samples;
+  }
+
+  Eigen::Matrix2d var(2, 2);
+  var(0, 0) = 2 * m(0, 0) * m(0, 0);
+  var(1, 0) = m(1, 0) * m(1, 0) + m(1, 1) * m(0, 0);
+  var(0, 1) = m(0, 1) * m(0, 1) + m(1, 1) * m(0, 0);
+  var(1, 1) = 2 * m(1, 1) * m(1, 1);
+
+  // Covariance matrix within 5sigma of expected value (comes from a Wishart
+  // distribution)
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 2; ++j)
+      EXPECT_LT(std::fabs(m(i, j) - sample_cov(i, j)),
+                5.0 * sqrt(var(i, j) / n_samples));
+}
+
+TEST(McmcLowrankEMetric, matches_dense_metric) {
+  const int n = 4;
+  Eigen::VectorXd d(n);
+  d << 1.0, 2.0, 0.5, 1.5;
+  Eigen::MatrixXd U(n, 2);
+  U << 0.3, -0.1, 0.5, 0.2, -0.4, 0.6, 0.1, 0.0;
+  Eigen::MatrixXd m_inv = Eigen::MatrixXd(d.asDiagonal()) + U * U.transpose();
+
+  stan::mcmc::mock_model model(n);
+  stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, stan::rng_t> metric(
+      model);
+  stan::mcmc::lowrank_e_point z(n);
+  z.set_metric(d, U);
+  z.p << 0.3, -1.2, 0.7, 2.0;
+
+  EXPECT_FLOAT_EQ(0.5 * z.p.dot(m_inv * z.p), metric.T(z));
+  Eigen::VectorXd p_sharp = metric.dtau_dp(z);
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ((m_inv * z.p)(i), p_sharp(i));
+
+  // Momenta are drawn with covariance equal to the mass matrix
+  Eigen::MatrixXd factor(n, n);
+  for (int i = 0; i < n; ++i)
+    factor.col(i) = z.momentum_from_std_normal(Eigen::VectorXd::Unit(n, i));
+  Eigen::MatrixXd m = factor * factor.transpose();
+  Eigen::MatrixXd identity = m * m_inv;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      EXPECT_NEAR(i == j ? 1.0 : 0.0, identity(i, j), 1e-12);
+
+  // Without a low-rank part the metric is diagonal
+  z.set_metric(d);
+  EXPECT_EQ(0, z.inv_e_metric_lowrank_.cols());
+  EXPECT_FLOAT_EQ(0.5 * z.p.dot(d.cwiseProduct(z.p)), metric.T(z));
+}
+
+TEST(McmcLowrankEMetric, gradients) {
+  Eigen::VectorXd q = Eigen::VectorXd::Ones(11);
+
+  stan::mcmc::lowrank_e_point z(q.size());
+  z.q = q;
+  z.p.setOnes();
+  z.set_metric(Eigen::VectorXd::LinSpaced(q.size(), 0.5, 1.5),
+               Eigen::MatrixXd::Constant(q.size(), 2, 0.3));
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  funnel_model_namespace::funnel_model model(data_var_context, 0,
+                                             &model_output);
+
+  stan::mcmc::lowrank_e_metric<funnel_model_namespace::funnel_model,
+                               stan::rng_t>
+      metric(model);
+
+  double epsilon = 1e-6;
+
+  metric.init(z, logger);
+  Eigen::VectorXd g1 = metric.dtau_dq(z, logger);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta = 0;
+
+    z.q(i) += epsilon;
+    metric.update_potential(z, logger);
+    delta += metric.tau(z);
+
+    z.q(i) -= 2 * epsilon;
+    metric.update_potential(z, logger);
+    delta -= metric.tau(z);
+
+    z.q(i) += epsilon;
+    metric.update_potential(z, logger);
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g1(i), epsilon);
+  }
+
+  Eigen::VectorXd g2 = metric.dtau_dp(z);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta = 0;
+
+    z.p(i) += epsilon;
+    delta += metric.tau(z);
+
+    z.p(i) -= 2 * epsilon;
+    delta -= metric.tau(z);
+
+    z.p(i) += epsilon;
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g2(i), epsilon);
+  }
+
+  Eigen::VectorXd g3 = metric.dphi_dq(z, logger);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta = 0;
+
+    z.q(i) += epsilon;
+    metric.update_potential(z, logger);
+    delta += metric.phi(z);
+
+    z.q(i) -= 2 * epsilon;
+    metric.update_potential(z, logger);
+    delta -= metric.phi(z);
+
+    z.q(i) += epsilon;
+    metric.update_potential(z, logger);
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g3(i), epsilon);
+  }
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", debug.str());
+  EXPECT_EQ("", info.str());
+  EXPECT_EQ("", warn.str());
+  EXPECT_EQ("", error.str());
+  EXPECT_EQ("", fatal.str());
+}
+
+TEST(McmcLowrankEMetric, streams) {
+  stan::test::capture_std_streams();
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+
+  stan::mcmc::mock_model model(q.size());
+
+  // typedef to use within Google Test macros
+  typedef stan::mcmc::lowrank_e_metric<stan::mcmc::mock_model, stan::rng_t>
+      lowrank_e;
+
+  EXPECT_NO_THROW(lowrank_e metric(model));
+
+  stan::test::reset_std_streams();
+  EXPECT_EQ("", stan::test::cout_ss.str());
+  EXPECT_EQ("", stan::test::cerr_ss.str());
+}
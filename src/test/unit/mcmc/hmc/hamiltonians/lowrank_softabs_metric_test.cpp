@@ -0,0 +1,355 @@
+#include <stan/io/empty_var_context.hpp>
+#include <stan/mcmc/hmc/hamiltonians/lowrank_softabs_metric.hpp>
+#include <stan/mcmc/hmc/hamiltonians/softabs_metric.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/funnel.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/rank_two.hpp>
+#include <test/unit/util.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(McmcLowrankSoftAbs, sample_p) {
+  stan::rng_t base_rng = stan::services::util::create_rng(0, 0);
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+
+  stan::mcmc::mock_model model(q.size());
+  stan::mcmc::lowrank_softabs_metric<stan::mcmc::mock_model, stan::rng_t>
+      metric(model);
+  stan::mcmc::lowrank_softabs_point z(q.size());
+
+  int n_samples = 1000;
+  double m = 0;
+  double m2 = 0;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  metric.update_metric(z, logger);
+
+  for (int i = 0; i < n_samples; ++i) {
+    metric.sample_p(z, base_rng);
+    double tau = metric.tau(z);
+
+    double delta = tau - m;
+    m += delta / static_cast<double>(i + 1);
+    m2 += delta * (tau - m);
+  }
+
+  double var = m2 / (n_samples + 1.0);
+
+  // Mean within 5sigma of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(m - 0.5 * q.size()) < 5.0 * sqrt(var));
+
+  // Variance within 10% of expected value (d / 2)
+  EXPECT_TRUE(std::fabs(var - 0.5 * q.size()) < 0.1 * q.size());
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", debug.str());
+  EXPECT_EQ("", info.str());
+  EXPECT_EQ("", warn.str());
+  EXPECT_EQ("", error.str());
+  EXPECT_EQ("", fatal.str());
+}
+
+TEST(McmcLowrankSoftAbs, full_rank_matches_softabs_metric) {
+  Eigen::VectorXd q = Eigen::VectorXd::LinSpaced(11, -0.5, 0.5);
+  Eigen::VectorXd p = Eigen::VectorXd::LinSpaced(11, 1, -1);
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  funnel_model_namespace::funnel_model model(data_var_context, 0,
+                                             &model_output);
+
+  stan::mcmc::softabs_metric<funnel_model_namespace::funnel_model, stan::rng_t>
+      dense_metric(model);
+  stan::mcmc::softabs_point z_dense(q.size());
+  z_dense.q = q;
+  z_dense.p = p;
+  dense_metric.init(z_dense, logger);
+
+  stan::mcmc::lowrank_softabs_metric<funnel_model_namespace::funnel_model,
+                                     stan::rng_t>
+      metric(model);
+  stan::mcmc::lowrank_softabs_point z(q.size());
+  z.rank = q.size();
+  z.q = q;
+  z.p = p;
+  metric.init(z, logger);
+
+  EXPECT_NEAR(dense_metric.T(z_dense), metric.T(z), 1e-8);
+  EXPECT_NEAR(dense_metric.phi(z_dense), metric.phi(z), 1e-8);
+  EXPECT_TRUE(
+      dense_metric.dtau_dp(z_dense).isApprox(metric.dtau_dp(z), 1e-8));
+  EXPECT_TRUE(dense_metric.dtau_dq(z_dense, logger)
+                  .isApprox(metric.dtau_dq(z, logger), 1e-8));
+  EXPECT_TRUE(dense_metric.dphi_dq(z_dense, logger)
+                  .isApprox(metric.dphi_dq(z, logger), 1e-8));
+
+  EXPECT_EQ("", error.str());
+}
+
+TEST(McmcLowrankSoftAbs, truncated_metric) {
+  Eigen::VectorXd q = Eigen::VectorXd::LinSpaced(11, -0.5, 0.5);
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  funnel_model_namespace::funnel_model model(data_var_context, 0,
+                                             &model_output);
+
+  stan::mcmc::lowrank_softabs_metric<funnel_model_namespace::funnel_model,
+                                     stan::rng_t>
+      metric(model);
+  stan::mcmc::lowrank_softabs_point z(q.size());
+  z.rank = 3;
+  z.q = q;
+  z.p = Eigen::VectorXd::LinSpaced(11, 1, -1);
+  metric.init(z, logger);
+
+  ASSERT_EQ(3, z.eigenvectors.cols());
+  EXPECT_TRUE((z.eigenvectors.transpose() * z.eigenvectors)
+                  .isApprox(Eigen::MatrixXd::Identity(3, 3), 1e-10));
+
+  // The metric is softabs on the resolved eigenvectors and 1 / alpha
+  // on their orthogonal complement
+  Eigen::MatrixXd P = z.eigenvectors * z.eigenvectors.transpose();
+  Eigen::MatrixXd G
+      = z.eigenvectors * z.softabs_lambda.asDiagonal()
+            * z.eigenvectors.transpose()
+        + (Eigen::MatrixXd::Identity(11, 11) - P) / z.alpha;
+  EXPECT_TRUE(metric.dtau_dp(z).isApprox(G.ldlt().solve(z.p), 1e-8));
+  EXPECT_NEAR(0.5 * z.p.dot(G.ldlt().solve(z.p)), metric.tau(z), 1e-8);
+  EXPECT_NEAR(std::log(G.determinant()), z.log_det_metric, 1e-8);
+
+  // The resolved eigenpairs are those of largest magnitude
+  stan::mcmc::softabs_metric<funnel_model_namespace::funnel_model, stan::rng_t>
+      dense_metric(model);
+  stan::mcmc::softabs_point z_dense(q.size());
+  z_dense.q = q;
+  dense_metric.init(z_dense, logger);
+  Eigen::VectorXd lambda = z_dense.eigen_deco.eigenvalues().cwiseAbs();
+  std::sort(lambda.data(), lambda.data() + lambda.size());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_NEAR(lambda(10 - i), std::fabs(z.hessian_lambda(i)), 1e-8);
+
+  EXPECT_EQ("", error.str());
+}
+
+TEST(McmcLowrankSoftAbs, gradients) {
+  Eigen::VectorXd q = Eigen::VectorXd::Ones(11);
+
+  stan::mcmc::lowrank_softabs_point z(q.size());
+  z.rank = q.size();
+  z.q = q;
+  z.p.setOnes();
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  funnel_model_namespace::funnel_model model(data_var_context, 0,
+                                             &model_output);
+
+  stan::mcmc::lowrank_softabs_metric<funnel_model_namespace::funnel_model,
+                                     stan::rng_t>
+      metric(model);
+
+  double epsilon = 1e-6;
+
+  metric.init(z, logger);
+  Eigen::VectorXd g1 = metric.dtau_dq(z, logger);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta = 0;
+
+    z.q(i) += epsilon;
+    metric.init(z, logger);
+    delta += metric.tau(z);
+
+    z.q(i) -= 2 * epsilon;
+    metric.init(z, logger);
+    delta -= metric.tau(z);
+
+    z.q(i) += epsilon;
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g1(i), epsilon);
+  }
+
+  metric.init(z, logger);
+  Eigen::VectorXd g2 = metric.dtau_dp(z);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta = 0;
+
+    z.p(i) += epsilon;
+    delta += metric.tau(z);
+
+    z.p(i) -= 2 * epsilon;
+    delta -= metric.tau(z);
+
+    z.p(i) += epsilon;
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g2(i), epsilon);
+  }
+
+  Eigen::VectorXd g3 = metric.dphi_dq(z, logger);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta = 0;
+
+    z.q(i) += epsilon;
+    metric.init(z, logger);
+    delta += metric.phi(z);
+
+    z.q(i) -= 2 * epsilon;
+    metric.init(z, logger);
+    delta -= metric.phi(z);
+
+    z.q(i) += epsilon;
+
+    delta /= 2 * epsilon;
+
+    EXPECT_NEAR(delta, g3(i), epsilon);
+  }
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", debug.str());
+  EXPECT_EQ("", info.str());
+  EXPECT_EQ("", warn.str());
+  EXPECT_EQ("", error.str());
+  EXPECT_EQ("", fatal.str());
+}
+
+TEST(McmcLowrankSoftAbs, truncated_gradients) {
+  // The Hessian of this model has rank two everywhere, so truncating
+  // to the two eigenpairs of largest magnitude drops only zero
+  // eigenvalues and the gradients of the truncated metric are exact
+  Eigen::VectorXd q(4);
+  q << 0.3, -0.1, 0.5, -0.2;
+
+  stan::mcmc::lowrank_softabs_point z(q.size());
+  z.rank = 2;
+  z.q = q;
+  z.p = Eigen::VectorXd::LinSpaced(4, 1, -0.5);
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  rank_two_model_namespace::rank_two_model model(data_var_context, 0,
+                                                 &model_output);
+
+  stan::mcmc::lowrank_softabs_metric<rank_two_model_namespace::rank_two_model,
+                                     stan::rng_t>
+      metric(model);
+
+  double epsilon = 1e-6;
+
+  metric.init(z, logger);
+  ASSERT_EQ(2, z.eigenvectors.cols());
+  Eigen::VectorXd g1 = metric.dtau_dq(z, logger);
+  Eigen::VectorXd g2 = metric.dphi_dq(z, logger);
+
+  for (int i = 0; i < z.q.size(); ++i) {
+    double delta_tau = 0;
+    double delta_phi = 0;
+
+    z.q(i) += epsilon;
+    metric.init(z, logger);
+    delta_tau += metric.tau(z);
+    delta_phi += metric.phi(z);
+
+    z.q(i) -= 2 * epsilon;
+    metric.init(z, logger);
+    delta_tau -= metric.tau(z);
+    delta_phi -= metric.phi(z);
+
+    z.q(i) += epsilon;
+
+    EXPECT_NEAR(delta_tau / (2 * epsilon), g1(i), epsilon);
+    EXPECT_NEAR(delta_phi / (2 * epsilon), g2(i), epsilon);
+  }
+
+  EXPECT_EQ("", model_output.str());
+  EXPECT_EQ("", error.str());
+}
+
+TEST(McmcLowrankSoftAbs, streams) {
+  stan::test::capture_std_streams();
+
+  Eigen::VectorXd q(2);
+  q(0) = 5;
+  q(1) = 1;
+  stan::mcmc::mock_model model(q.size());
+
+  // for use in Google Test macros below
+  typedef stan::mcmc::lowrank_softabs_metric<stan::mcmc::mock_model,
+                                             stan::rng_t>
+      softabs;
+
+  EXPECT_NO_THROW(softabs metric(model));
+
+  stan::test::reset_std_streams();
+  EXPECT_EQ("", stan::test::cout_ss.str());
+  EXPECT_EQ("", stan::test::cerr_ss.str());
+}
+
+TEST(McmcLowrankSoftAbs, gradient_stats) {
+  Eigen::VectorXd q = Eigen::VectorXd::Ones(11);
+
+  stan::mcmc::lowrank_softabs_point z(q.size());
+  z.rank = 3;
+  z.q = q;
+  z.p.setOnes();
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  funnel_model_namespace::funnel_model model(data_var_context, 0,
+                                             &model_output);
+
+  stan::mcmc::lowrank_softabs_metric<funnel_model_namespace::funnel_model,
+                                     stan::rng_t>
+      metric(model);
+
+  metric.set_gradient_timing(true);
+  metric.init(z, logger);
+  EXPECT_EQ(1, metric.gradient_evals());
+  double init_seconds = metric.gradient_seconds();
+  EXPECT_GT(init_seconds, 0);
+
+  metric.dtau_dq(z, logger);
+  metric.dphi_dq(z, logger);
+  EXPECT_EQ(1, metric.gradient_evals());
+  EXPECT_GT(metric.gradient_seconds(), init_seconds);
+
+  metric.reset_gradient_stats();
+  EXPECT_EQ(0, metric.gradient_evals());
+  EXPECT_EQ(0, metric.gradient_seconds());
+}
@@ -163,3 +163,38 @@ TEST(McmcSoftAbs, streams) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(McmcSoftAbs, gradient_stats) {
+  Eigen::VectorXd q = Eigen::VectorXd::Ones(11);
+
+  stan::mcmc::softabs_point z(q.size());
+  z.q = q;
+  z.p.setOnes();
+
+  stan::io::empty_var_context data_var_context;
+
+  std::stringstream model_output;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  funnel_model_namespace::funnel_model model(data_var_context, 0,
+                                             &model_output);
+
+  stan::mcmc::softabs_metric<funnel_model_namespace::funnel_model, stan::rng_t>
+      metric(model);
+
+  metric.set_gradient_timing(true);
+  metric.init(z, logger);
+  EXPECT_EQ(1, metric.gradient_evals());
+  double init_seconds = metric.gradient_seconds();
+  EXPECT_GT(init_seconds, 0);
+
+  metric.dtau_dq(z, logger);
+  metric.dphi_dq(z, logger);
+  EXPECT_EQ(1, metric.gradient_evals());
+  EXPECT_GT(metric.gradient_seconds(), init_seconds);
+
+  metric.reset_gradient_stats();
+  EXPECT_EQ(0, metric.gradient_evals());
+  EXPECT_EQ(0, metric.gradient_seconds());
+}
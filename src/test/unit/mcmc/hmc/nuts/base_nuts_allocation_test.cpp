@@ -0,0 +1,133 @@
+// Count the allocations of dense Eigen storage through Eigen's
+// EIGEN_DENSE_STORAGE_CTOR_PLUGIN hook.  Eigen runs the hook, as a
+// statement, whenever it allocates storage for a matrix or a product
+// temporary, with the variable size holding the number of coefficients.
+#include <cstddef>
+static std::size_t num_allocations = 0;
+#define EIGEN_DENSE_STORAGE_CTOR_PLUGIN \
+  if (size > 0)                         \
+    ++num_allocations;
+
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <stan/mcmc/hmc/nuts/base_nuts.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+// Count allocations made through operator new as well.  Replacing the
+// global operator new and operator delete affects the whole executable,
+// so this file must stay a test executable of its own and must not be
+// linked together with other tests.
+void* operator new(std::size_t size) {
+  ++num_allocations;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace stan {
+namespace mcmc {
+
+// Hamiltonian that evaluates its derivatives without allocating
+template <typename Model, typename BaseRNG>
+class quiet_hamiltonian : public base_hamiltonian<Model, ps_point, BaseRNG> {
+ public:
+  explicit quiet_hamiltonian(const Model& model)
+      : base_hamiltonian<Model, ps_point, BaseRNG>(model) {}
+
+  double T(ps_point& z) { return 0; }
+
+  double tau(ps_point& z) { return T(z); }
+  double phi(ps_point& z) { return this->V(z); }
+
+  double dG_dt(ps_point& z, callbacks::logger& logger) { return 2; }
+
+  Eigen::VectorXd dtau_dq(ps_point& z, callbacks::logger& logger) {
+    return Eigen::VectorXd::Zero(this->model_.num_params_r());
+  }
+
+  // Ensures that NUTS non-termination criterion is always true
+  Eigen::VectorXd dtau_dp(ps_point& z) { return z.q; }
+
+  void eval_dtau_dp(ps_point& z, Eigen::VectorXd& p_sharp) { p_sharp = z.q; }
+
+  Eigen::VectorXd dphi_dq(ps_point& z, callbacks::logger& logger) {
+    return Eigen::VectorXd::Zero(this->model_.num_params_r());
+  }
+
+  void init(ps_point& z, callbacks::logger& logger) { z.V = 0; }
+
+  void sample_p(ps_point& z, BaseRNG& rng) {}
+};
+
+class allocation_mock_nuts : public base_nuts<mock_model, quiet_hamiltonian,
+                                              mock_integrator, stan::rng_t> {
+ public:
+  allocation_mock_nuts(const mock_model& m, stan::rng_t& rng)
+      : base_nuts<mock_model, quiet_hamiltonian, mock_integrator, stan::rng_t>(
+          m, rng) {}
+
+  bool compute_criterion(Eigen::VectorXd& p_sharp_minus,
+                         Eigen::VectorXd& p_sharp_plus, Eigen::VectorXd& rho) {
+    return true;
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+
+TEST(McmcNutsBaseNuts, transition_allocations) {
+  stan::rng_t base_rng = stan::services::util::create_rng(0, 0);
+
+  int model_size = 100;
+  stan::mcmc::ps_point z_init(model_size);
+  z_init.q.setZero();
+  z_init.p.setConstant(1.5);
+
+  stan::mcmc::mock_model model(model_size);
+  stan::mcmc::allocation_mock_nuts sampler(model, base_rng);
+
+  sampler.set_max_depth(8);
+  sampler.set_nominal_stepsize(1);
+  sampler.set_stepsize_jitter(0);
+  sampler.z() = z_init;
+
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  stan::mcmc::sample init_sample(z_init.q, 0, 0);
+
+  // The first transition sizes the per-depth workspaces
+  stan::mcmc::sample s = sampler.transition(init_sample, logger);
+  EXPECT_EQ(sampler.get_max_depth(), sampler.depth_);
+
+  const int num_transitions = 10;
+  std::size_t total_allocations = 0;
+  std::size_t total_leapfrog = 0;
+  for (int n = 0; n < num_transitions; ++n) {
+    std::size_t before = num_allocations;
+    stan::mcmc::sample s_n = sampler.transition(init_sample, logger);
+    std::size_t allocations = num_allocations - before;
+    total_allocations += allocations;
+    total_leapfrog += sampler.n_leapfrog_;
+
+    // Only the returned sample allocates; the trajectory bookkeeping
+    // and the sharp momenta reuse the workspaces.
+    EXPECT_EQ(1, allocations);
+  }
+
+  RecordProperty("allocations_per_transition",
+                 std::to_string(static_cast<double>(total_allocations)
+                                / num_transitions));
+  RecordProperty("leapfrog_per_transition",
+                 std::to_string(static_cast<double>(total_leapfrog)
+                                / num_transitions));
+}
@@ -112,8 +112,8 @@ TEST(McmcNutsDerivedNuts, compute_criterion_dense_e) {
   finish.q(0) = 2;
   finish.p(0) = 1;
 
-  p_sharp_start = start.inv_e_metric_ * start.p;
-  p_sharp_finish = finish.inv_e_metric_ * finish.p;
+  p_sharp_start = start.inv_e_metric() * start.p;
+  p_sharp_finish = finish.inv_e_metric() * finish.p;
   rho = start.p + finish.p;
 
   EXPECT_TRUE(sampler.compute_criterion(p_sharp_start, p_sharp_finish, rho));
@@ -124,8 +124,8 @@ TEST(McmcNutsDerivedNuts, compute_criterion_dense_e) {
   finish.q(0) = 2;
   finish.p(0) = -1;
 
-  p_sharp_start = start.inv_e_metric_ * start.p;
-  p_sharp_finish = finish.inv_e_metric_ * finish.p;
+  p_sharp_start = start.inv_e_metric() * start.p;
+  p_sharp_finish = finish.inv_e_metric() * finish.p;
   rho = start.p + finish.p;
 
   EXPECT_FALSE(sampler.compute_criterion(p_sharp_start, p_sharp_finish, rho));
@@ -6,6 +6,8 @@
 #include <stan/mcmc/hmc/nuts/adapt_unit_e_nuts.hpp>
 #include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
 #include <stan/mcmc/hmc/nuts/adapt_dense_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/lowrank_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_lowrank_e_nuts.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/io/empty_var_context.hpp>
 #include <fstream>
@@ -43,4 +45,12 @@ TEST(McmcNuts, instantiaton_test) {
   stan::mcmc::adapt_dense_e_nuts<gauss3D_model_namespace::gauss3D_model,
                                  stan::rng_t>
       adapt_dense_e_sampler(model, base_rng);
+
+  stan::mcmc::lowrank_e_nuts<gauss3D_model_namespace::gauss3D_model,
+                             stan::rng_t>
+      lowrank_e_sampler(model, base_rng);
+
+  stan::mcmc::adapt_lowrank_e_nuts<gauss3D_model_namespace::gauss3D_model,
+                                   stan::rng_t>
+      adapt_lowrank_e_sampler(model, base_rng, 2);
 }
@@ -0,0 +1,40 @@
+#include <test/test-models/good/mcmc/hmc/common/gauss3D.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <stan/mcmc/hmc/nuts/lowrank_softabs_nuts.hpp>
+#include <stan/mcmc/hmc/static/lowrank_softabs_static_hmc.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+TEST(McmcLowrankSoftAbsNuts, rejects_truncated_rank) {
+  stan::rng_t base_rng = stan::services::util::create_rng(4839294, 0);
+
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  stan::io::empty_var_context data_var_context;
+  gauss3D_model_namespace::gauss3D_model model(data_var_context);
+
+  stan::mcmc::lowrank_softabs_nuts<gauss3D_model_namespace::gauss3D_model,
+                                   stan::rng_t>
+      sampler(model, base_rng);
+  sampler.set_nominal_stepsize(0.1);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(3);
+  stan::mcmc::sample s(q, 0, 0);
+
+  EXPECT_EQ(3, sampler.z().rank);
+  EXPECT_NO_THROW(sampler.transition(s, logger));
+
+  sampler.z().rank = 2;
+  EXPECT_THROW(sampler.transition(s, logger), std::invalid_argument);
+
+  stan::mcmc::lowrank_softabs_static_hmc<
+      gauss3D_model_namespace::gauss3D_model, stan::rng_t>
+      static_sampler(model, base_rng);
+  static_sampler.set_nominal_stepsize_and_T(0.1, 0.5);
+  static_sampler.z().rank = 2;
+  EXPECT_THROW(static_sampler.transition(s, logger), std::invalid_argument);
+}
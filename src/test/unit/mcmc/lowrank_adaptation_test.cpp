@@ -0,0 +1,96 @@
+#include <stan/mcmc/lowrank_adaptation.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+
+TEST(McmcLowrankAdaptation, learn_metric_constant_draws) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 10;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+  Eigen::MatrixXd lowrank(n, 0);
+
+  const int n_learn = 10;
+
+  Eigen::VectorXd target_var(Eigen::VectorXd::Ones(n));
+  target_var *= 1e-3 * 5.0 / (n_learn + 5.0);
+
+  stan::mcmc::lowrank_adaptation adapter(n, 3);
+  adapter.set_window_params(50, 0, 0, n_learn, logger);
+
+  bool update = false;
+  for (int i = 0; i < n_learn; ++i)
+    update = adapter.learn_metric(var, lowrank, q);
+
+  EXPECT_TRUE(update);
+  for (int i = 0; i < n; ++i)
+    EXPECT_EQ(target_var(i), var(i));
+  EXPECT_EQ(n, lowrank.rows());
+  EXPECT_EQ(0, lowrank.cols());
+  EXPECT_EQ(0, logger.call_count());
+}
+
+TEST(McmcLowrankAdaptation, learn_metric_correlated_draws) {
+  stan::test::unit::instrumented_logger logger;
+
+  // Draws with unit variance plus a strongly correlated direction
+  const int n = 50;
+  Eigen::VectorXd direction = Eigen::VectorXd::LinSpaced(n, 1, 2);
+  direction.normalize();
+  const double excess_sd = 5;
+
+  const int n_learn = 400;
+  stan::mcmc::lowrank_adaptation adapter(n, 2);
+  adapter.set_window_params(1000, 0, 0, n_learn, logger);
+
+  boost::random::mt19937 rng(1234);
+  boost::random::normal_distribution<double> std_normal;
+  Eigen::VectorXd var(Eigen::VectorXd::Ones(n));
+  Eigen::MatrixXd lowrank(n, 0);
+  bool update = false;
+  for (int i = 0; i < n_learn && !update; ++i) {
+    Eigen::VectorXd q(n);
+    for (int j = 0; j < n; ++j)
+      q(j) = std_normal(rng);
+    q += excess_sd * std_normal(rng) * direction;
+    update = adapter.learn_metric(var, lowrank, q);
+  }
+
+  ASSERT_TRUE(update);
+  ASSERT_GE(lowrank.cols(), 1);
+  EXPECT_LE(lowrank.cols(), 2);
+
+  // The leading column points along the correlated direction and the
+  // metric recovers most of the variance along it
+  Eigen::VectorXd u = lowrank.col(0);
+  EXPECT_GT(std::fabs(u.normalized().dot(direction)), 0.95);
+  double total_var = direction.dot(var.cwiseProduct(direction))
+                     + (lowrank.transpose() * direction).squaredNorm();
+  EXPECT_NEAR(1 + excess_sd * excess_sd, total_var, 6);
+  EXPECT_EQ(0, logger.call_count());
+}
+
+TEST(McmcLowrankAdaptation, zero_rank) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 5;
+  const int n_learn = 20;
+  stan::mcmc::lowrank_adaptation adapter(n, 0);
+  adapter.set_window_params(50, 0, 0, n_learn, logger);
+
+  boost::random::mt19937 rng(99);
+  boost::random::normal_distribution<double> std_normal;
+  Eigen::VectorXd var(Eigen::VectorXd::Ones(n));
+  Eigen::MatrixXd lowrank(n, 0);
+  for (int i = 0; i < n_learn; ++i) {
+    Eigen::VectorXd q(n);
+    for (int j = 0; j < n; ++j)
+      q(j) = std_normal(rng);
+    adapter.learn_metric(var, lowrank, q);
+  }
+  EXPECT_EQ(0, lowrank.cols());
+  EXPECT_TRUE((var.array() > 0).all());
+}
@@ -25,3 +25,90 @@ TEST(McmcVarAdaptation, learn_variance) {
 
   EXPECT_EQ(0, logger.call_count());
 }
+
+TEST(McmcVarAdaptation, adaptation_window_ends) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 2;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation adapter(n);
+  adapter.set_window_params(1000, 75, 50, 25, logger);
+  std::vector<unsigned int> ends = adapter.adaptation_window_ends();
+
+  std::vector<unsigned int> updates;
+  for (unsigned int m = 0; m < 1000; ++m) {
+    if (adapter.learn_variance(var, q))
+      updates.push_back(m);
+  }
+  EXPECT_EQ(ends, updates);
+  EXPECT_TRUE(adapter.adaptation_window_ends().empty());
+}
+
+TEST(McmcVarAdaptation, end_adaptation_early) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 2;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation adapter(n);
+  adapter.set_window_params(1000, 75, 50, 25, logger);
+  EXPECT_FALSE(adapter.end_adaptation_early()) << "initial buffer";
+  EXPECT_EQ(1000, adapter.num_warmup());
+
+  for (unsigned int m = 0; m < 200; ++m)
+    adapter.learn_variance(var, q);
+  // The window from 150 to 249 runs to its end before the terminal
+  // buffer
+  EXPECT_TRUE(adapter.end_adaptation_early());
+  EXPECT_EQ(249 + 50 + 1, adapter.num_warmup());
+  EXPECT_EQ(std::vector<unsigned int>{249}, adapter.adaptation_window_ends());
+  EXPECT_FALSE(adapter.end_adaptation_early()) << "already the last window";
+
+  std::vector<unsigned int> updates;
+  for (unsigned int m = 200; m < adapter.num_warmup(); ++m) {
+    if (adapter.learn_variance(var, q))
+      updates.push_back(m);
+  }
+  EXPECT_EQ(std::vector<unsigned int>{249}, updates);
+  EXPECT_FALSE(adapter.end_adaptation_early()) << "warmup finished";
+}
+
+TEST(McmcVarAdaptation, pool_variance) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 3;
+  const int n_learn = 20;
+  stan::mcmc::var_adaptation single(n);
+  single.set_window_params(50, 0, 0, 2 * n_learn, logger);
+  stan::mcmc::var_adaptation first(n);
+  first.set_window_params(50, 0, 0, n_learn, logger);
+  first.set_pooled(true);
+  stan::mcmc::var_adaptation second(n);
+  second.set_window_params(50, 0, 0, n_learn, logger);
+  second.set_pooled(true);
+
+  Eigen::VectorXd var_single(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd var_first(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd var_second(Eigen::VectorXd::Zero(n));
+  for (int i = 0; i < n_learn; ++i) {
+    Eigen::VectorXd q_first(n);
+    q_first << i, i * i, -0.5 * i;
+    Eigen::VectorXd q_second(n);
+    q_second << 3.0 - i, 0.25 * i * i, 10.0 + i;
+    single.learn_variance(var_single, q_first);
+    single.learn_variance(var_single, q_second);
+    EXPECT_FALSE(first.learn_variance(var_first, q_first));
+    EXPECT_FALSE(second.learn_variance(var_second, q_second));
+  }
+  EXPECT_TRUE(var_first.isZero());
+  EXPECT_TRUE(var_second.isZero());
+
+  Eigen::VectorXd var_pooled(Eigen::VectorXd::Zero(n));
+  stan::mcmc::var_adaptation::pool_variance({&first, &second}, var_pooled);
+  for (int i = 0; i < n; ++i)
+    EXPECT_NEAR(var_single(i), var_pooled(i), 1e-10 * var_single(i));
+  EXPECT_EQ(0, logger.call_count());
+}
@@ -46,3 +46,19 @@ TEST(McmcWindowedAdaptation, set_window_params3) {
   ASSERT_EQ(0, logger.call_count());
   ASSERT_EQ(0, logger.call_count_info());
 }
+
+TEST(McmcWindowedAdaptation, adaptation_window_ends) {
+  stan::test::unit::instrumented_logger logger;
+
+  stan::mcmc::windowed_adaptation adapter("test");
+  adapter.set_window_params(1000, 75, 50, 25, logger);
+
+  std::vector<unsigned int> ends = adapter.adaptation_window_ends();
+  std::vector<unsigned int> expected = {99, 149, 249, 449, 949};
+  EXPECT_EQ(expected, ends);
+  EXPECT_EQ(expected, adapter.adaptation_window_ends());
+
+  stan::mcmc::windowed_adaptation short_adapter("test");
+  short_adapter.set_window_params(10, 1, 1, 1, logger);
+  EXPECT_TRUE(short_adapter.adaptation_window_ends().empty());
+}
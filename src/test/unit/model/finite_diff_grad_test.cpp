@@ -86,6 +86,63 @@ TEST(ModelUtil, finite_diff_grad__true_true) {
   }
 }
 
+TEST(ModelUtil, finite_diff_grad__coordinates) {
+  TestModel_uniform_01 model;
+  std::vector<double> params_r(1);
+  std::vector<int> params_i(0);
+  std::vector<double> gradient;
+  stan::callbacks::interrupt interrupt;
+
+  double x = 1.5;
+  params_r[0] = x;
+
+  std::vector<size_t> coordinates(2, 0);
+  stan::model::finite_diff_grad<false, true, TestModel_uniform_01>(
+      model, interrupt, params_r, params_i, coordinates, gradient);
+  ASSERT_EQ(2U, gradient.size());
+  EXPECT_FLOAT_EQ(-std::tanh(0.5 * x), gradient[0]);
+  EXPECT_FLOAT_EQ(-std::tanh(0.5 * x), gradient[1]);
+
+  coordinates.clear();
+  stan::model::finite_diff_grad<false, true, TestModel_uniform_01>(
+      model, interrupt, params_r, params_i, coordinates, gradient);
+  EXPECT_EQ(0U, gradient.size());
+
+  coordinates.push_back(1);
+  EXPECT_THROW((stan::model::finite_diff_grad<false, true,
+                                              TestModel_uniform_01>(
+                   model, interrupt, params_r, params_i, coordinates,
+                   gradient)),
+               std::out_of_range);
+}
+
+TEST(ModelUtil, finite_diff_directional_derivatives) {
+  TestModel_uniform_01 model;
+  std::vector<double> params_r(1);
+  std::vector<int> params_i(0);
+  std::vector<double> derivatives;
+  stan::callbacks::interrupt interrupt;
+
+  double x = -0.75;
+  params_r[0] = x;
+
+  std::vector<std::vector<double>> directions{{1}, {-2}, {0}};
+  stan::model::finite_diff_directional_derivatives<false, true,
+                                                   TestModel_uniform_01>(
+      model, interrupt, params_r, params_i, directions, derivatives);
+  ASSERT_EQ(3U, derivatives.size());
+  EXPECT_FLOAT_EQ(-std::tanh(0.5 * x), derivatives[0]);
+  EXPECT_FLOAT_EQ(2 * std::tanh(0.5 * x), derivatives[1]);
+  EXPECT_FLOAT_EQ(0.0, derivatives[2]);
+
+  directions.push_back({1, 1});
+  EXPECT_THROW((stan::model::finite_diff_directional_derivatives<
+                   false, true, TestModel_uniform_01>(
+                   model, interrupt, params_r, params_i, directions,
+                   derivatives)),
+               std::invalid_argument);
+}
+
 TEST(ModelUtil, streams) {
   stan::test::capture_std_streams();
 
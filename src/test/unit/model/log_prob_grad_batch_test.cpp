@@ -0,0 +1,98 @@
+#include <stan/model/log_prob_grad_batch.hpp>
+#include <stan/model/log_prob_grad.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/mcmc/hmc/common/gauss3D.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+class ModelLogProbGradBatch : public testing::Test {
+ public:
+  ModelLogProbGradBatch() : model(context, 0, &model_log), Q(3, 17) {
+    Q.setRandom();
+  }
+
+  stan::io::empty_var_context context;
+  std::stringstream model_log;
+  gauss3D_model_namespace::gauss3D_model model;
+  Eigen::MatrixXd Q;
+};
+
+TEST_F(ModelLogProbGradBatch, matches_log_prob_grad) {
+  Eigen::VectorXd lp;
+  Eigen::MatrixXd G;
+  std::stringstream msgs;
+  stan::model::log_prob_grad_batch<true, true>(model, Q, lp, G, &msgs);
+
+  ASSERT_EQ(Q.cols(), lp.size());
+  ASSERT_EQ(Q.rows(), G.rows());
+  ASSERT_EQ(Q.cols(), G.cols());
+  for (Eigen::Index n = 0; n < Q.cols(); ++n) {
+    Eigen::VectorXd q = Q.col(n);
+    Eigen::VectorXd g;
+    double lp_n = stan::model::log_prob_grad<true, true>(model, q, g);
+    EXPECT_FLOAT_EQ(lp_n, lp(n));
+    EXPECT_FLOAT_EQ(-0.5 * q.squaredNorm(), lp(n));
+    for (Eigen::Index i = 0; i < Q.rows(); ++i) {
+      EXPECT_FLOAT_EQ(g(i), G(i, n));
+      EXPECT_FLOAT_EQ(-q(i), G(i, n));
+    }
+  }
+  EXPECT_EQ("", msgs.str());
+}
+
+TEST_F(ModelLogProbGradBatch, model_base) {
+  const stan::model::model_base& base = model;
+  Eigen::VectorXd lp;
+  Eigen::MatrixXd G;
+  base.log_prob_grad_batch(Q, lp, G);
+
+  Eigen::VectorXd lp_expected;
+  Eigen::MatrixXd G_expected;
+  stan::model::log_prob_grad_batch<true, true>(model, Q, lp_expected,
+                                               G_expected);
+  for (Eigen::Index n = 0; n < Q.cols(); ++n) {
+    EXPECT_FLOAT_EQ(lp_expected(n), lp(n));
+    for (Eigen::Index i = 0; i < Q.rows(); ++i)
+      EXPECT_FLOAT_EQ(G_expected(i, n), G(i, n));
+  }
+
+  base.log_prob_grad_batch(Q, lp, G, false, false);
+  for (Eigen::Index n = 0; n < Q.cols(); ++n) {
+    Eigen::VectorXd q = Q.col(n);
+    Eigen::VectorXd g;
+    double lp_n = stan::model::log_prob_grad<false, false>(model, q, g);
+    EXPECT_FLOAT_EQ(lp_n, lp(n));
+  }
+}
+
+TEST_F(ModelLogProbGradBatch, model_base_default) {
+  const stan::model::model_base& base = model;
+  Eigen::VectorXd lp;
+  Eigen::MatrixXd G;
+  Eigen::VectorXd lp_expected;
+  Eigen::MatrixXd G_expected;
+  for (bool propto : {true, false}) {
+    for (bool jacobian : {true, false}) {
+      base.model_base::log_prob_grad_batch(Q, lp, G, propto, jacobian);
+      base.log_prob_grad_batch(Q, lp_expected, G_expected, propto, jacobian);
+      ASSERT_EQ(Q.cols(), lp.size());
+      ASSERT_EQ(Q.rows(), G.rows());
+      ASSERT_EQ(Q.cols(), G.cols());
+      for (Eigen::Index n = 0; n < Q.cols(); ++n) {
+        EXPECT_FLOAT_EQ(lp_expected(n), lp(n));
+        for (Eigen::Index i = 0; i < Q.rows(); ++i)
+          EXPECT_FLOAT_EQ(G_expected(i, n), G(i, n));
+      }
+    }
+  }
+}
+
+TEST_F(ModelLogProbGradBatch, empty_batch) {
+  Eigen::MatrixXd Q_empty(3, 0);
+  Eigen::VectorXd lp;
+  Eigen::MatrixXd G;
+  stan::model::log_prob_grad_batch<true, true>(model, Q_empty, lp, G);
+  EXPECT_EQ(0, lp.size());
+  EXPECT_EQ(3, G.rows());
+  EXPECT_EQ(0, G.cols());
+}
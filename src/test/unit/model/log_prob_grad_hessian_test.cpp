@@ -0,0 +1,122 @@
+#include <stan/model/log_prob_grad_hessian.hpp>
+#include <stan/model/grad_hess_log_prob.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/services/multi_normal.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Standard normal log density which writes a message per evaluation
+struct printing_model {
+  template <bool propto, bool jacobian, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& x,
+             std::ostream* msgs) const {
+    if (msgs)
+      *msgs << "evaluated;";
+    T lp = 0;
+    for (Eigen::Index i = 0; i < x.size(); ++i)
+      lp -= 0.5 * x(i) * x(i);
+    return lp;
+  }
+};
+
+int count_messages(const std::string& msgs) {
+  int count = 0;
+  for (size_t pos = msgs.find("evaluated;"); pos != std::string::npos;
+       pos = msgs.find("evaluated;", pos + 1))
+    ++count;
+  return count;
+}
+
+}  // namespace
+
+class ModelLogProbGradHessian : public ::testing::Test {
+ public:
+  ModelLogProbGradHessian() : model(context, 0, &model_output), x(2) {
+    x << 1.5, -0.5;
+    Eigen::MatrixXd Sigma(2, 2);
+    Sigma << 1, 0.8, 0.8, 1;
+    Eigen::VectorXd mu(2);
+    mu << 2, 3;
+    expected_hessian = -Sigma.inverse();
+    expected_grad = expected_hessian * (x - mu);
+  }
+
+  stan::io::empty_var_context context;
+  std::stringstream model_output;
+  stan_model model;
+  Eigen::VectorXd x;
+  Eigen::VectorXd expected_grad;
+  Eigen::MatrixXd expected_hessian;
+};
+
+TEST_F(ModelLogProbGradHessian, finite_diff) {
+  Eigen::VectorXd grad;
+  Eigen::MatrixXd hessian;
+  std::stringstream msgs;
+  double lp = stan::model::finite_diff_log_prob_grad_hessian<true, true>(
+      model, x, grad, hessian, &msgs);
+
+  Eigen::VectorXd lp_grad;
+  EXPECT_FLOAT_EQ(
+      stan::model::log_prob_grad<true, true>(model, x, lp_grad), lp);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_FLOAT_EQ(expected_grad(i), grad(i));
+    for (int j = 0; j < 2; ++j)
+      EXPECT_NEAR(expected_hessian(i, j), hessian(i, j), 1e-6);
+  }
+  EXPECT_EQ(hessian, hessian.transpose());
+  EXPECT_EQ("", msgs.str());
+}
+
+TEST_F(ModelLogProbGradHessian, autodiff) {
+  Eigen::VectorXd grad;
+  Eigen::MatrixXd hessian;
+  double lp = stan::model::autodiff_log_prob_grad_hessian<true, true>(
+      model, x, grad, hessian);
+
+  Eigen::VectorXd lp_grad;
+  EXPECT_FLOAT_EQ(
+      stan::model::log_prob_grad<true, true>(model, x, lp_grad), lp);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_FLOAT_EQ(expected_grad(i), grad(i));
+    for (int j = 0; j < 2; ++j)
+      EXPECT_FLOAT_EQ(expected_hessian(i, j), hessian(i, j));
+  }
+}
+
+TEST_F(ModelLogProbGradHessian, messages) {
+  printing_model printing;
+  Eigen::VectorXd grad;
+  Eigen::MatrixXd hessian;
+
+  std::stringstream autodiff_msgs;
+  stan::model::autodiff_log_prob_grad_hessian<true, true>(
+      printing, x, grad, hessian, &autodiff_msgs);
+  EXPECT_EQ(1 + x.size(), count_messages(autodiff_msgs.str()));
+  EXPECT_FLOAT_EQ(-1, hessian(0, 0));
+
+  std::stringstream finite_diff_msgs;
+  stan::model::finite_diff_log_prob_grad_hessian<true, true>(
+      printing, x, grad, hessian, &finite_diff_msgs);
+  EXPECT_EQ(1 + 2 * x.size(), count_messages(finite_diff_msgs.str()));
+}
+
+TEST_F(ModelLogProbGradHessian, grad_hess_log_prob) {
+  std::vector<double> params_r(x.data(), x.data() + x.size());
+  std::vector<int> params_i;
+  std::vector<double> gradient;
+  std::vector<double> hessian;
+  stan::model::grad_hess_log_prob<true, true>(model, params_r, params_i,
+                                              gradient, hessian);
+
+  ASSERT_EQ(4u, hessian.size());
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_FLOAT_EQ(expected_grad(i), gradient[i]);
+    for (int j = 0; j < 2; ++j)
+      EXPECT_NEAR(expected_hessian(i, j), hessian[i * 2 + j], 1e-6);
+  }
+}
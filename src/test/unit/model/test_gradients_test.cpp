@@ -63,3 +63,61 @@ TEST(ModelUtil, streams) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(ModelUtil, test_gradients_coordinates) {
+  stan::io::empty_var_context data_var_context;
+
+  stan_model model(data_var_context, 0, static_cast<std::stringstream*>(0));
+  std::vector<double> params_r(1);
+  std::vector<int> params_i(0);
+  stan::callbacks::interrupt interrupt;
+  stan::test::unit::instrumented_logger logger;
+
+  std::stringstream out;
+  stan::callbacks::stream_writer writer(out);
+
+  std::vector<size_t> coordinates(1, 0);
+  EXPECT_EQ(0, (stan::model::test_gradients<true, true, stan_model>(
+                   model, params_r, params_i, coordinates, 1e-6, 1e-6,
+                   interrupt, logger, writer)));
+  EXPECT_EQ(
+      "\n Log probability=0\n\n param idx           value           model    "
+      " finite diff           error\n         0               0              "
+      " 0               0               0\n",
+      out.str());
+
+  out.str("");
+  coordinates.clear();
+  EXPECT_EQ(0, (stan::model::test_gradients<true, true, stan_model>(
+                   model, params_r, params_i, coordinates, 1e-6, 1e-6,
+                   interrupt, logger, writer)));
+  EXPECT_EQ(
+      "\n Log probability=0\n\n param idx           value           model    "
+      " finite diff           error\n",
+      out.str());
+}
+
+TEST(ModelUtil, test_directional_derivatives) {
+  stan::io::empty_var_context data_var_context;
+
+  stan_model model(data_var_context, 0, static_cast<std::stringstream*>(0));
+  std::vector<double> params_r(1);
+  std::vector<int> params_i(0);
+  stan::callbacks::interrupt interrupt;
+  stan::test::unit::instrumented_logger logger;
+
+  std::stringstream out;
+  stan::callbacks::stream_writer writer(out);
+
+  std::vector<std::vector<double>> directions{{1}, {-1}};
+  EXPECT_EQ(0, (stan::model::test_directional_derivatives<true, true,
+                                                          stan_model>(
+                   model, params_r, params_i, directions, 1e-6, 1e-6,
+                   interrupt, logger, writer)));
+  EXPECT_EQ(
+      "\n Log probability=0\n\n direction            norm           model    "
+      " finite diff           error\n         0               1              "
+      " 0               0               0\n         1               1       "
+      "        0               0               0\n",
+      out.str());
+}
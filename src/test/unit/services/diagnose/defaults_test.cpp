@@ -22,3 +22,30 @@ TEST(diagnose_defaults, error) {
 
   EXPECT_FLOAT_EQ(1e-6, error::default_value());
 }
+
+TEST(diagnose_defaults, num_coordinates) {
+  using stan::services::diagnose::num_coordinates;
+  EXPECT_EQ(
+      "Number of randomly chosen parameters to check, "
+      "or -1 to check all parameters.",
+      num_coordinates::description());
+
+  EXPECT_NO_THROW(num_coordinates::validate(num_coordinates::default_value()));
+  EXPECT_NO_THROW(num_coordinates::validate(0));
+  EXPECT_NO_THROW(num_coordinates::validate(100));
+  EXPECT_THROW(num_coordinates::validate(-2), std::invalid_argument);
+
+  EXPECT_EQ(-1, num_coordinates::default_value());
+}
+
+TEST(diagnose_defaults, num_directions) {
+  using stan::services::diagnose::num_directions;
+  EXPECT_EQ("Number of random directions to check.",
+            num_directions::description());
+
+  EXPECT_NO_THROW(num_directions::validate(num_directions::default_value()));
+  EXPECT_NO_THROW(num_directions::validate(3));
+  EXPECT_THROW(num_directions::validate(-1), std::invalid_argument);
+
+  EXPECT_EQ(0, num_directions::default_value());
+}
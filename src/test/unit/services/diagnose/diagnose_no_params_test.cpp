@@ -0,0 +1,35 @@
+#include <stan/services/diagnose/diagnose.hpp>
+#include <gtest/gtest.h>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/services/zero_params.hpp>
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+
+class ServicesDiagnoseNoParams : public testing::Test {
+ public:
+  ServicesDiagnoseNoParams()
+      : init(init_ss), parameter(parameter_ss), model(context, 0, &model_ss) {}
+
+  std::stringstream init_ss, parameter_ss, model_ss;
+  stan::test::unit::instrumented_logger logger;
+  stan::callbacks::stream_writer init, parameter;
+  stan::io::empty_var_context context;
+  stan::callbacks::interrupt interrupt;
+  stan_model model;
+};
+
+TEST_F(ServicesDiagnoseNoParams, diagnose_directions_only) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+
+  int num_failed = stan::services::diagnose::diagnose(
+      model, context, seed, chain, init_radius, 1e-6, 1e-6,
+      std::vector<size_t>(), 0, 2, interrupt, logger, init, parameter);
+  EXPECT_EQ(0, num_failed);
+  EXPECT_EQ(1, logger.find_info("TEST GRADIENT MODE"));
+  EXPECT_EQ(1, logger.find_info("param idx"));
+  EXPECT_EQ(0, logger.find_info("TEST DIRECTIONAL DERIVATIVE MODE"));
+  EXPECT_TRUE(parameter_ss.str().find("param idx") != std::string::npos);
+}
@@ -37,3 +37,52 @@ TEST_F(ServicesDiagnose, diagnose) {
   EXPECT_TRUE(parameter_ss.str().find("Log probability=3.218")
               != std::string::npos);
 }
+
+TEST_F(ServicesDiagnose, diagnose_coordinates) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+
+  std::vector<size_t> coordinates(1, 1);
+  int num_failed = stan::services::diagnose::diagnose(
+      model, context, seed, chain, init_radius, 1e-6, 1e-6, coordinates, -1,
+      0, interrupt, logger, init, parameter);
+  EXPECT_EQ(0, num_failed);
+  EXPECT_EQ("", model_ss.str());
+
+  EXPECT_EQ(1, logger.find_info("TEST GRADIENT MODE"));
+  EXPECT_EQ(0, logger.find_info("TEST DIRECTIONAL DERIVATIVE MODE"));
+  EXPECT_EQ(1, logger.find_info("         1               0"));
+}
+
+TEST_F(ServicesDiagnose, diagnose_random_subset_and_directions) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+
+  int num_failed = stan::services::diagnose::diagnose(
+      model, context, seed, chain, init_radius, 1e-6, 1e-6,
+      std::vector<size_t>(), 1, 3, interrupt, logger, init, parameter);
+  EXPECT_EQ(0, num_failed);
+  EXPECT_EQ("", model_ss.str());
+
+  EXPECT_EQ(1, logger.find_info("TEST GRADIENT MODE"));
+  EXPECT_EQ(1, logger.find_info("TEST DIRECTIONAL DERIVATIVE MODE"));
+  EXPECT_EQ(1, logger.find_info("param idx"));
+  EXPECT_EQ(1, logger.find_info("direction"));
+  EXPECT_EQ(2, logger.find_info("Log probability=3.218"));
+  EXPECT_EQ("0,0\n", init_ss.str());
+}
+
+TEST_F(ServicesDiagnose, diagnose_directions_only) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+
+  int num_failed = stan::services::diagnose::diagnose(
+      model, context, seed, chain, init_radius, 1e-6, 1e-6,
+      std::vector<size_t>(), 0, 2, interrupt, logger, init, parameter);
+  EXPECT_EQ(0, num_failed);
+  EXPECT_EQ(0, logger.find_info("param idx"));
+  EXPECT_EQ(1, logger.find_info("direction"));
+}
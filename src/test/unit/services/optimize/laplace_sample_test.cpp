@@ -205,3 +205,34 @@ TEST_F(ServicesLaplaceSample, consoleOutput) {
   EXPECT_EQ(1, count_matches("Generating draws\niteration: 0\niteration: 1",
                              console_str));
 }
+
+TEST_F(ServicesLaplaceSample, reproducible) {
+  Eigen::VectorXd theta_hat(2);
+  theta_hat << 2, 3;
+  int draws = 300;
+  int refresh = 0;
+  stan::callbacks::structured_writer dummy_hessian_writer;
+
+  std::vector<std::string> outputs;
+  for (unsigned int seed : {1234u, 1234u, 4321u}) {
+    std::stringstream sample_ss;
+    stan::callbacks::stream_writer sample_writer(sample_ss, "");
+    int return_code = stan::services::laplace_sample<true>(
+        *model, theta_hat, draws, true, seed, refresh, interrupt, logger,
+        sample_writer, dummy_hessian_writer);
+    EXPECT_EQ(stan::services::error_codes::OK, return_code);
+    outputs.push_back(sample_ss.str());
+  }
+  EXPECT_EQ(outputs[0], outputs[1]);
+  EXPECT_NE(outputs[0], outputs[2]);
+
+  std::stringstream draws_ss(outputs[0]);
+  std::stringstream out;
+  stan::io::stan_csv draws_csv
+      = stan::io::stan_csv_reader::parse(draws_ss, &out);
+  ASSERT_EQ(draws, draws_csv.samples.rows());
+
+  // draws in different blocks come from different RNG streams
+  for (int m = 0; m < 64; ++m)
+    EXPECT_NE(draws_csv.samples(m, 2), draws_csv.samples(m + 64, 2));
+}
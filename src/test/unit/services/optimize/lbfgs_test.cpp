@@ -3,6 +3,7 @@
 #include <stan/io/empty_var_context.hpp>
 #include <test/test-models/good/optimization/rosenbrock.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
+#include <stan/callbacks/histogram_telemetry.hpp>
 #include <stan/callbacks/stream_writer.hpp>
 
 struct ServicesOptimize : public testing::Test {
@@ -57,3 +58,22 @@ TEST_F(ServicesOptimize, rosenbrock) {
   EXPECT_FLOAT_EQ(return_code, 0);
   EXPECT_EQ(22, interrupt.call_count());
 }
+
+TEST_F(ServicesOptimize, rosenbrock_telemetry) {
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::callbacks::histogram_telemetry telemetry;
+
+  int return_code = stan::services::optimize::lbfgs(
+      model, context, 0, 1, 0, 5, 0.001, 1e-12, 10000, 1e-8, 10000000, 1e-8,
+      2000, true, 0, interrupt, logger, init, parameter, telemetry);
+
+  EXPECT_FLOAT_EQ(return_code, 0);
+  EXPECT_EQ(0, telemetry.warmup().transitions);
+  EXPECT_EQ(interrupt.call_count(), telemetry.main().transitions)
+      << "one record per iteration";
+  EXPECT_EQ(0, telemetry.main().tree_depth.count());
+  EXPECT_LE(1, telemetry.main().gradient_evals.min());
+  EXPECT_LE(telemetry.main().gradient_seconds.sum(),
+            telemetry.main().transition_seconds.sum());
+  EXPECT_EQ(interrupt.call_count(), telemetry.main().writer_seconds.count());
+}
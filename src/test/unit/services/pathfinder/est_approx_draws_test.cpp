@@ -0,0 +1,102 @@
+#include <stan/services/pathfinder/single.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+class ServicesPathfinderEstApproxDraws : public testing::Test {
+ public:
+  ServicesPathfinderEstApproxDraws() : num_params(3) {
+    taylor_approx.x_center = Eigen::VectorXd::Zero(num_params);
+    taylor_approx.logdetcholHk = 0;
+    taylor_approx.L_approx = Eigen::MatrixXd::Identity(num_params, num_params);
+    taylor_approx.alpha = Eigen::VectorXd::Ones(num_params);
+    taylor_approx.use_full = true;
+  }
+
+  Eigen::Index num_params;
+  stan::services::pathfinder::internal::taylor_approx_t taylor_approx;
+  stan::test::unit::instrumented_logger logger;
+};
+
+// The approximation is a standard normal, so this log density equals the
+// approximate log density and every lp ratio is zero.
+auto std_normal_lp = [](auto&& u, auto&& msgs) {
+  if (u(0) > 1.5) {
+    msgs << "large draw";
+  }
+  if (u(1) > 2.5) {
+    throw std::domain_error("rejected");
+  }
+  return -0.5 * (u.squaredNorm() + u.size() * stan::math::LOG_TWO_PI);
+};
+
+auto no_constrain = [](auto&& rng, auto&& u, auto&& c) { return c; };
+
+TEST_F(ServicesPathfinderEstApproxDraws, evaluates_every_draw) {
+  const Eigen::Index num_draws = 200;
+  stan::rng_t rng = stan::services::util::create_rng(123, 0);
+  auto est = stan::services::pathfinder::internal::est_approx_draws<true>(
+      std_normal_lp, no_constrain, rng, taylor_approx, num_draws,
+      taylor_approx.alpha, "iter ", logger);
+
+  EXPECT_EQ(static_cast<size_t>(num_draws), est.fn_calls);
+  ASSERT_EQ(num_draws, est.repeat_draws.cols());
+  ASSERT_EQ(num_draws, est.lp_mat.rows());
+  ASSERT_EQ(num_draws, est.lp_ratio.rows());
+  unsigned int num_msgs = 0;
+  for (Eigen::Index i = 0; i < est.repeat_draws.cols(); ++i) {
+    Eigen::VectorXd u = est.repeat_draws.col(i);
+    if (u(1) > 2.5) {
+      EXPECT_EQ(-std::numeric_limits<double>::infinity(), est.lp_mat(i, 1));
+    } else {
+      EXPECT_NEAR(0, est.lp_ratio(i), 1e-12);
+    }
+    if (u(0) > 1.5) {
+      ++num_msgs;
+    }
+  }
+  // messages are logged once per draw that wrote one
+  EXPECT_EQ(num_msgs, logger.call_count_info());
+  EXPECT_EQ(num_msgs, logger.find_info("iter large draw"));
+
+  // the result does not depend on how draws are split across threads
+  stan::rng_t rng_2 = stan::services::util::create_rng(123, 0);
+  auto est_2 = stan::services::pathfinder::internal::est_approx_draws<true>(
+      std_normal_lp, no_constrain, rng_2, taylor_approx, num_draws,
+      taylor_approx.alpha, "iter ", logger);
+  for (Eigen::Index i = 0; i < est.lp_mat.rows(); ++i) {
+    EXPECT_EQ(est.lp_mat(i, 1), est_2.lp_mat(i, 1));
+  }
+  EXPECT_EQ(est.elbo, est_2.elbo);
+}
+
+TEST_F(ServicesPathfinderEstApproxDraws, mcse_early_stop) {
+  auto lp = [](auto&& u, auto&& msgs) {
+    return -0.5 * (u.squaredNorm() + u.size() * stan::math::LOG_TWO_PI);
+  };
+  const Eigen::Index num_draws = 200;
+  stan::rng_t rng = stan::services::util::create_rng(123, 0);
+  // every lp ratio is zero, so the first batch has zero standard error
+  auto est = stan::services::pathfinder::internal::est_approx_draws<true>(
+      lp, no_constrain, rng, taylor_approx, num_draws, taylor_approx.alpha,
+      "iter ", logger, true, 1e-8);
+  EXPECT_EQ(16u, est.fn_calls);
+  EXPECT_EQ(16, est.repeat_draws.cols());
+  EXPECT_EQ(16, est.lp_mat.rows());
+  EXPECT_EQ(16, est.lp_ratio.rows());
+  EXPECT_NEAR(0, est.elbo, 1e-12);
+
+  // a noisy log density needs more draws
+  auto noisy_lp = [](auto&& u, auto&& msgs) { return u(0); };
+  stan::rng_t rng_2 = stan::services::util::create_rng(123, 0);
+  auto noisy_est = stan::services::pathfinder::internal::est_approx_draws<true>(
+      noisy_lp, no_constrain, rng_2, taylor_approx, num_draws,
+      taylor_approx.alpha, "iter ", logger, true, 1e-8);
+  EXPECT_EQ(static_cast<size_t>(num_draws), noisy_est.fn_calls);
+  EXPECT_EQ(num_draws, noisy_est.lp_ratio.rows());
+}
@@ -1,5 +1,7 @@
 #include <stan/services/sample/hmc_nuts_diag_e_adapt.hpp>
 #include <gtest/gtest.h>
+#include <stan/callbacks/histogram_telemetry.hpp>
+#include <stan/callbacks/structured_writer.hpp>
 #include <stan/io/empty_var_context.hpp>
 #include <test/test-models/good/optimization/rosenbrock.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
@@ -173,3 +175,174 @@ TEST_F(ServicesSampleHmcNutsDiagEAdaptPar, output_regression) {
   EXPECT_EQ(num_chains, logger.find_info("seconds (Total)"));
   EXPECT_EQ(0, logger.call_count_error());
 }
+
+TEST_F(ServicesSampleHmcNutsDiagEAdaptPar, pooled_adaptation) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  bool pool_adaptation = true;
+  stan::test::unit::instrumented_interrupt interrupt;
+  EXPECT_EQ(interrupt.call_count(), 0);
+
+  int return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+      model, num_chains, context, random_seed, chain, init_radius, num_warmup,
+      num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
+      max_depth, delta, gamma, kappa, t0, init_buffer, term_buffer, window,
+      interrupt, logger, init, parameter, diagnostic, pool_adaptation);
+
+  EXPECT_EQ(0, return_code);
+
+  int num_output_lines = (num_warmup + num_samples) / num_thin;
+  EXPECT_EQ((num_warmup + num_samples) * num_chains, interrupt.call_count());
+  for (int i = 0; i < num_chains; ++i) {
+    EXPECT_EQ(1, parameter[i].call_count("vector_string"));
+    EXPECT_EQ(num_output_lines, parameter[i].call_count("vector_double"));
+    EXPECT_EQ(1, diagnostic[i].call_count("vector_string"));
+    EXPECT_EQ(num_output_lines, diagnostic[i].call_count("vector_double"));
+  }
+  EXPECT_EQ(num_chains, logger.find_info("Elapsed Time:"));
+  EXPECT_EQ(0, logger.call_count_error());
+}
+
+TEST_F(ServicesSampleHmcNutsDiagEAdaptPar, convergence_monitoring) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  stan::services::util::convergence_criteria convergence;
+  convergence.check_interval = 100;
+  convergence.target_ess = 1e6;
+  stan::test::unit::instrumented_interrupt interrupt;
+  EXPECT_EQ(interrupt.call_count(), 0);
+
+  int return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+      model, num_chains, context, random_seed, chain, init_radius, num_warmup,
+      num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
+      max_depth, delta, gamma, kappa, t0, init_buffer, term_buffer, window,
+      interrupt, logger, init, parameter, diagnostic, false, convergence);
+
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(0, logger.find_info("Stopping sampling"));
+  EXPECT_EQ(num_chains, logger.find_info(" Iterations: "));
+  for (int i = 0; i < num_chains; ++i) {
+    EXPECT_EQ(num_samples / num_thin + num_warmup / num_thin,
+              parameter[i].call_count("vector_double"));
+    EXPECT_EQ(1, parameter[i].call_count("vector_string"));
+  }
+}
+
+TEST_F(ServicesSampleHmcNutsDiagEAdaptPar, single_chain_convergence) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  stan::services::util::convergence_criteria convergence;
+  convergence.check_interval = 100;
+  convergence.target_ess = 1e6;
+  stan::test::unit::instrumented_interrupt interrupt;
+  init.resize(1);
+  parameter.resize(1);
+  diagnostic.resize(1);
+  context.resize(1);
+
+  int return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+      model, 1, context, random_seed, chain, init_radius, num_warmup,
+      num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
+      max_depth, delta, gamma, kappa, t0, init_buffer, term_buffer, window,
+      interrupt, logger, init, parameter, diagnostic, false, convergence);
+
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(0, logger.find_info("Stopping sampling"));
+  EXPECT_EQ(1, logger.find_info(" Iterations: "));
+  EXPECT_EQ(num_samples / num_thin + num_warmup / num_thin,
+            parameter[0].call_count("vector_double"));
+}
+
+TEST_F(ServicesSampleHmcNutsDiagEAdaptPar, telemetry) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  stan::test::unit::instrumented_interrupt interrupt;
+  std::vector<std::shared_ptr<stan::io::array_var_context>> inv_metric;
+  for (size_t i = 0; i < num_chains; ++i)
+    inv_metric.push_back(std::make_shared<stan::io::array_var_context>(
+        stan::services::util::create_unit_e_diag_inv_metric(
+            model.num_params_r())));
+  std::vector<stan::callbacks::structured_writer> metric(num_chains);
+
+  // Per chain and pooled adaptation run the chains differently
+  for (bool pool_adaptation : {false, true}) {
+    std::vector<stan::callbacks::histogram_telemetry> telemetry(num_chains);
+    int return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+        model, num_chains, context, inv_metric, random_seed, chain,
+        init_radius, num_warmup, num_samples, num_thin, save_warmup, refresh,
+        stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
+        init_buffer, term_buffer, window, interrupt, logger, init, parameter,
+        diagnostic, metric, telemetry, pool_adaptation);
+
+    EXPECT_EQ(0, return_code);
+    for (int i = 0; i < num_chains; ++i) {
+      EXPECT_EQ(num_warmup, telemetry[i].warmup().transitions);
+      EXPECT_EQ(num_samples, telemetry[i].main().transitions);
+      EXPECT_EQ(num_samples, telemetry[i].main().tree_depth.count());
+    }
+  }
+}
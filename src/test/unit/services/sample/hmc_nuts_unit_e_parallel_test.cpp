@@ -3,6 +3,7 @@
 #include <test/test-models/good/optimization/rosenbrock.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
 #include <gtest/gtest.h>
+#include <stan/callbacks/histogram_telemetry.hpp>
 #include <iostream>
 
 auto&& blah = stan::math::init_threadpool_tbb();
@@ -171,3 +172,32 @@ TEST_F(ServicesSampleHmcNutsUnitEPar, output_regression) {
   EXPECT_EQ(num_chains, logger.find_info("seconds (Total)"));
   EXPECT_EQ(0, logger.call_count_error());
 }
+
+TEST_F(ServicesSampleHmcNutsUnitEPar, telemetry) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  stan::test::unit::instrumented_interrupt interrupt;
+  std::vector<stan::callbacks::histogram_telemetry> telemetry(num_chains);
+
+  int return_code = stan::services::sample::hmc_nuts_unit_e(
+      model, num_chains, context, random_seed, chain, init_radius, num_warmup,
+      num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
+      max_depth, interrupt, logger, init, parameter, diagnostic, telemetry);
+
+  EXPECT_EQ(0, return_code);
+  for (int i = 0; i < num_chains; ++i) {
+    EXPECT_EQ(num_warmup, telemetry[i].warmup().transitions);
+    EXPECT_EQ(num_samples, telemetry[i].main().transitions);
+    EXPECT_LE(telemetry[i].main().gradient_seconds.sum(),
+              telemetry[i].main().transition_seconds.sum());
+  }
+}
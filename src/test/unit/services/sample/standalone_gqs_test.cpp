@@ -10,6 +10,7 @@
 #include <test/test-models/good/services/bernoulli.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
 #include <test/unit/util.hpp>
+#include <tbb/global_control.h>
 #include <vector>
 
 class ServicesStandaloneGQ : public ::testing::Test {
@@ -79,3 +80,35 @@ TEST_F(ServicesStandaloneGQ, genDraws_bad) {
   EXPECT_EQ(count_matches("Wrong number of parameter values", logger_ss.str()),
             1);
 }
+
+TEST_F(ServicesStandaloneGQ, genDraws_thread_invariant) {
+  stan::io::stan_csv bern_csv;
+  std::stringstream out;
+  std::ifstream csv_stream;
+  csv_stream.open("src/test/test-models/good/services/bernoulli_fit.csv");
+  bern_csv = stan::io::stan_csv_reader::parse(csv_stream, &out);
+  csv_stream.close();
+  ASSERT_EQ(1000, bern_csv.samples.rows());
+
+  std::stringstream serial_ss;
+  {
+    tbb::global_control limit(tbb::global_control::max_allowed_parallelism, 1);
+    stan::callbacks::stream_writer sample_writer(serial_ss, "");
+    int return_code = stan::services::standalone_generate(
+        *model, bern_csv.samples.middleCols<1>(7), 12345, interrupt, logger,
+        sample_writer);
+    EXPECT_EQ(return_code, stan::services::error_codes::OK);
+  }
+  std::stringstream parallel_ss;
+  {
+    tbb::global_control limit(tbb::global_control::max_allowed_parallelism, 4);
+    stan::callbacks::stream_writer sample_writer(parallel_ss, "");
+    int return_code = stan::services::standalone_generate(
+        *model, bern_csv.samples.middleCols<1>(7), 12345, interrupt, logger,
+        sample_writer);
+    EXPECT_EQ(return_code, stan::services::error_codes::OK);
+  }
+  EXPECT_EQ(count_matches("\n", serial_ss.str()), 1001);
+  EXPECT_EQ(serial_ss.str(), parallel_ss.str());
+  EXPECT_EQ(8U, interrupt.call_count());
+}
@@ -28,3 +28,17 @@ TEST(rng, initialize_with_zero) {
   rng2();
   EXPECT_NE(rng1, rng2);
 }
+
+TEST(rng, initialize_with_substream) {
+  stan::rng_t rng1 = stan::services::util::create_rng(0, 1);
+  stan::rng_t rng2 = stan::services::util::create_rng(0, 1, 0);
+  EXPECT_EQ(rng1, rng2);
+
+  for (unsigned int n = 1; n < 20; n++) {
+    stan::rng_t rng3 = stan::services::util::create_rng(0, 1, n);
+    stan::rng_t rng4 = stan::services::util::create_rng(0, 1, n);
+    EXPECT_EQ(rng3, rng4);
+    EXPECT_NE(rng1, rng3);
+    EXPECT_NE(stan::services::util::create_rng(0, 2, n), rng3);
+  }
+}
@@ -10,6 +10,10 @@
 #include <stan/io/array_var_context.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#include <atomic>
+#include <limits>
 
 class ServicesUtilInitialize : public testing::Test {
  public:
@@ -578,3 +582,162 @@ TEST_F(ServicesUtilInitialize, model_throws_in_write_array__full_init) {
   EXPECT_EQ(2, logger.call_count_error());
   EXPECT_EQ(100, logger.find_warn("throwing within write_array"));
 }
+
+namespace test {
+// mock_rejecting_model has log density -0.5 * sum(x^2) and rejects
+// initial values with a negative first element
+class mock_rejecting_model : public stan::model::prob_grad {
+ public:
+  mock_rejecting_model() : stan::model::prob_grad(2) {}
+
+  template <bool propto__, bool jacobian__, typename T__>
+  T__ log_prob(std::vector<T__>& params_r__, std::vector<int>& params_i__,
+               std::ostream* pstream__ = 0) const {
+    if (params_r__[0] < 0)
+      throw std::domain_error("negative first element");
+    T__ lp = 0;
+    for (size_t n = 0; n < params_r__.size(); ++n)
+      lp = lp - 0.5 * params_r__[n] * params_r__[n];
+    return lp;
+  }
+
+  void transform_inits(const stan::io::var_context& context__,
+                       std::vector<int>& params_i__,
+                       std::vector<double>& params_r__,
+                       std::ostream* pstream__) const {
+    params_r__ = context__.vals_r("theta");
+  }
+
+  void get_dims(std::vector<std::vector<size_t> >& dimss__,
+                bool include_tparams = true, bool include_gqs = true) const {
+    dimss__.clear();
+    dimss__.push_back(std::vector<size_t>{2});
+  }
+
+  void constrained_param_names(std::vector<std::string>& param_names__,
+                               bool include_tparams__ = true,
+                               bool include_gqs__ = true) const {
+    param_names__.push_back("theta.1");
+    param_names__.push_back("theta.2");
+  }
+
+  void get_param_names(std::vector<std::string>& names,
+                       bool include_tparams = true,
+                       bool include_gqs = true) const {
+    names.clear();
+    names.push_back("theta");
+  }
+
+  void unconstrained_param_names(std::vector<std::string>& param_names__,
+                                 bool include_tparams__ = true,
+                                 bool include_gqs__ = true) const {
+    constrained_param_names(param_names__);
+  }
+
+  template <typename RNG>
+  void write_array(RNG& base_rng__, std::vector<double>& params_r__,
+                   std::vector<int>& params_i__, std::vector<double>& vars__,
+                   bool include_tparams__ = true, bool include_gqs__ = true,
+                   std::ostream* pstream__ = 0) const {
+    vars__ = params_r__;
+  }
+};
+}  // namespace test
+
+TEST_F(ServicesUtilInitialize, rejecting_model__first_valid) {
+  test::mock_rejecting_model rejecting_model;
+  stan::rng_t expected_rng = rng;
+  std::vector<double> expected;
+  int num_rejected = 0;
+  while (true) {
+    expected = stan::io::random_var_context::draw_unconstrained(
+        rejecting_model, expected_rng, 2, false);
+    if (expected[0] >= 0)
+      break;
+    ++num_rejected;
+  }
+
+  std::vector<double> params = stan::services::util::initialize(
+      rejecting_model, empty_context, rng, 2, false, logger, init);
+  EXPECT_EQ(expected, params);
+  EXPECT_EQ(3 * num_rejected, logger.call_count_warn());
+  EXPECT_EQ(num_rejected, logger.find_warn("negative first element"));
+  // The generator continues from the draws of the accepted value
+  EXPECT_EQ(expected_rng(), rng());
+}
+
+TEST_F(ServicesUtilInitialize, rejecting_model__best_of_candidates) {
+  test::mock_rejecting_model rejecting_model;
+  stan::rng_t expected_rng = rng;
+  std::vector<double> expected;
+  double best_lp = -std::numeric_limits<double>::infinity();
+  for (int k = 0; k < 10; ++k) {
+    std::vector<double> draw = stan::io::random_var_context::draw_unconstrained(
+        rejecting_model, expected_rng, 2, false);
+    double lp = -0.5 * (draw[0] * draw[0] + draw[1] * draw[1]);
+    if (draw[0] >= 0 && lp > best_lp) {
+      best_lp = lp;
+      expected = draw;
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  std::vector<double> params = stan::services::util::initialize(
+      rejecting_model, empty_context, rng, 2, false, logger, init, 10);
+  EXPECT_EQ(expected, params);
+  ASSERT_EQ(1, init.vector_double_values().size());
+  EXPECT_EQ(expected, init.vector_double_values()[0]);
+  EXPECT_EQ(expected_rng(), rng());
+}
+
+TEST_F(ServicesUtilInitialize, rejecting_model__thread_invariant) {
+  test::mock_rejecting_model rejecting_model;
+  std::vector<std::vector<double>> params;
+  std::vector<unsigned int> num_warnings;
+  std::vector<stan::rng_t::result_type> next_draws;
+  for (int num_threads : {1, 4}) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism,
+                                num_threads);
+    stan::rng_t thread_rng = stan::services::util::create_rng(3, 1);
+    stan::test::unit::instrumented_logger thread_logger;
+    params.push_back(stan::services::util::initialize(
+        rejecting_model, empty_context, thread_rng, 2, false, thread_logger,
+        init));
+    num_warnings.push_back(thread_logger.call_count_warn());
+    next_draws.push_back(thread_rng());
+  }
+  EXPECT_EQ(params[0], params[1]);
+  EXPECT_EQ(num_warnings[0], num_warnings[1]);
+  EXPECT_EQ(next_draws[0], next_draws[1]);
+}
+
+namespace test {
+// Mock model that accepts every initial value and counts the
+// candidates evaluated
+class mock_counting_model : public mock_rejecting_model {
+ public:
+  mutable std::atomic<int> num_evaluations{0};
+
+  template <bool propto__, bool jacobian__, typename T__>
+  T__ log_prob(std::vector<T__>& params_r__, std::vector<int>& params_i__,
+               std::ostream* pstream__ = 0) const {
+    // The gradient is evaluated with propto__ = true
+    if (!propto__)
+      ++num_evaluations;
+    T__ lp = 0;
+    for (size_t n = 0; n < params_r__.size(); ++n)
+      lp = lp - 0.5 * params_r__[n] * params_r__[n];
+    return lp;
+  }
+};
+}  // namespace test
+
+TEST_F(ServicesUtilInitialize, valid_first_value__evaluated_alone) {
+  test::mock_counting_model counting_model;
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    stan::services::util::initialize(counting_model, empty_context, rng, 2,
+                                     false, logger, init);
+  });
+  EXPECT_EQ(1, counting_model.num_evaluations);
+}
@@ -2,6 +2,7 @@
 #include <stan/services/util/create_rng.hpp>
 #include <gtest/gtest.h>
 #include <test/test-models/good/services/test_lp.hpp>
+#include <stan/callbacks/histogram_telemetry.hpp>
 #include <stan/callbacks/structured_writer.hpp>
 #include <stan/io/empty_var_context.hpp>
 #include <stan/services/util/create_rng.hpp>
@@ -208,3 +209,32 @@ TEST_F(ServicesUtil, num_warmup_num_samples_refresh) {
   EXPECT_EQ(num_samples, diagnostic_writer.call_count("vector_double"))
       << "draws";
 }
+
+TEST_F(ServicesUtil, telemetry) {
+  num_warmup = 20;
+  save_warmup = false;
+  num_samples = 30;
+  num_thin = 3;
+  stan::callbacks::histogram_telemetry telemetry;
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, num_samples, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer,
+      dummy_metric_writer, telemetry);
+  EXPECT_EQ(num_warmup + num_samples, interrupt.call_count());
+
+  const auto& warmup = telemetry.warmup();
+  EXPECT_EQ(num_warmup, warmup.transitions);
+  EXPECT_EQ(num_warmup, warmup.tree_depth.count());
+  EXPECT_GE(sampler.get_max_depth(), warmup.tree_depth.max());
+  EXPECT_LE(1, warmup.gradient_evals.min());
+  EXPECT_FLOAT_EQ(0, warmup.write_array_seconds.sum()) << "draws not saved";
+
+  const auto& main = telemetry.main();
+  EXPECT_EQ(num_samples, main.transitions);
+  EXPECT_EQ(num_samples, main.tree_depth.count());
+  EXPECT_LE(main.gradient_seconds.sum(), main.transition_seconds.sum());
+  EXPECT_LE(0, main.integrator_seconds.min());
+  EXPECT_LE(0, main.writer_seconds.min());
+  EXPECT_EQ(num_samples / num_thin,
+            sample_writer.call_count("vector_double"));
+}
@@ -0,0 +1,179 @@
+#include <stan/services/util/run_lockstep_adaptive_sampler.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <gtest/gtest.h>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <stan/callbacks/histogram_telemetry.hpp>
+#include <stan/callbacks/structured_writer.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_dense_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+
+static constexpr size_t num_chains = 3;
+
+static Eigen::VectorXd metric_diagonal(const Eigen::VectorXd& inv_metric) {
+  return inv_metric;
+}
+
+static Eigen::VectorXd metric_diagonal(const Eigen::MatrixXd& inv_metric) {
+  return inv_metric.diagonal();
+}
+
+template <typename Sampler>
+class ServicesUtilLockstep : public testing::Test {
+ public:
+  ServicesUtilLockstep()
+      : model(context, 0, &model_log),
+        num_warmup(200),
+        num_samples(100),
+        num_thin(1),
+        refresh(0),
+        save_warmup(false),
+        sample_writer(num_chains),
+        diagnostic_writer(num_chains),
+        metric_writer(num_chains),
+        telemetry(num_chains) {
+    rngs.reserve(num_chains);
+    samplers.reserve(num_chains);
+    for (size_t i = 0; i < num_chains; ++i) {
+      rngs.emplace_back(stan::services::util::create_rng(0, i + 1));
+      cont_vectors.push_back({0.1 * i, -0.1 * i});
+      samplers.emplace_back(model, rngs[i]);
+      samplers[i].set_nominal_stepsize(0.1);
+      samplers[i].set_max_depth(5);
+      samplers[i].get_stepsize_adaptation().set_mu(log(10 * 0.1));
+      samplers[i].get_stepsize_adaptation().set_delta(0.8);
+      samplers[i].get_stepsize_adaptation().set_gamma(0.05);
+      samplers[i].get_stepsize_adaptation().set_kappa(0.75);
+      samplers[i].get_stepsize_adaptation().set_t0(10);
+      samplers[i].set_window_params(num_warmup, 15, 50, 25, logger);
+    }
+  }
+
+  std::stringstream model_log;
+  stan::io::empty_var_context context;
+  stan_model model;
+  int num_warmup, num_samples, num_thin, refresh;
+  bool save_warmup;
+  std::vector<stan::rng_t> rngs;
+  std::vector<std::vector<double>> cont_vectors;
+  std::vector<Sampler> samplers;
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::test::unit::instrumented_logger logger;
+  std::vector<stan::test::unit::instrumented_writer> sample_writer;
+  std::vector<stan::test::unit::instrumented_writer> diagnostic_writer;
+  std::vector<stan::callbacks::structured_writer> metric_writer;
+  std::vector<stan::callbacks::histogram_telemetry> telemetry;
+  stan::services::util::convergence_criteria criteria;
+
+  void run(bool pool_adaptation) {
+    stan::services::util::run_lockstep_adaptive_sampler(
+        samplers, model, cont_vectors, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rngs, interrupt, logger, sample_writer,
+        diagnostic_writer, metric_writer, telemetry, pool_adaptation,
+        criteria);
+  }
+};
+
+using lockstep_samplers
+    = ::testing::Types<stan::mcmc::adapt_diag_e_nuts<stan_model, stan::rng_t>,
+                       stan::mcmc::adapt_dense_e_nuts<stan_model, stan::rng_t>>;
+TYPED_TEST_SUITE(ServicesUtilLockstep, lockstep_samplers);
+
+TYPED_TEST(ServicesUtilLockstep, pooled_call_count) {
+  this->run(true);
+
+  EXPECT_EQ(num_chains * (this->num_warmup + this->num_samples),
+            this->interrupt.call_count());
+  EXPECT_EQ(0, this->logger.call_count_error());
+  for (size_t i = 0; i < num_chains; ++i) {
+    EXPECT_EQ(1, this->sample_writer[i].call_count("vector_string"));
+    EXPECT_EQ(this->num_samples,
+              this->sample_writer[i].call_count("vector_double"));
+    EXPECT_EQ(1, this->diagnostic_writer[i].call_count("vector_string"));
+    EXPECT_EQ(this->num_samples,
+              this->diagnostic_writer[i].call_count("vector_double"));
+  }
+}
+
+TYPED_TEST(ServicesUtilLockstep, telemetry) {
+  this->run(true);
+
+  for (size_t i = 0; i < num_chains; ++i) {
+    EXPECT_EQ(this->num_warmup, this->telemetry[i].warmup().transitions);
+    EXPECT_EQ(this->num_samples, this->telemetry[i].main().transitions);
+    EXPECT_EQ(this->num_samples,
+              this->telemetry[i].main().tree_depth.count());
+  }
+}
+
+TYPED_TEST(ServicesUtilLockstep, pooled_shared_metric) {
+  auto initial_inv_metric = this->samplers[0].z().inv_e_metric();
+  this->run(true);
+
+  const auto& inv_metric = this->samplers[0].z().inv_e_metric();
+  EXPECT_FALSE(inv_metric == initial_inv_metric);
+  for (size_t i = 0; i < num_chains; ++i) {
+    EXPECT_TRUE(inv_metric == this->samplers[i].z().inv_e_metric());
+    EXPECT_FALSE(this->samplers[i].adapting());
+    EXPECT_FALSE(stan::services::util::internal::metric_adaptation(
+                     this->samplers[i])
+                     .pooled());
+  }
+}
+
+TYPED_TEST(ServicesUtilLockstep, unconverged_runs_to_the_end) {
+  this->criteria.check_interval = 50;
+  this->criteria.target_ess = 1e6;
+  this->run(false);
+
+  EXPECT_EQ(num_chains * (this->num_warmup + this->num_samples),
+            this->interrupt.call_count());
+  EXPECT_EQ(0, this->logger.find_info("Stopping sampling"));
+  EXPECT_EQ(num_chains, this->logger.find_info(" Iterations: "));
+  for (size_t i = 0; i < num_chains; ++i)
+    EXPECT_EQ(this->num_samples,
+              this->sample_writer[i].call_count("vector_double"));
+}
+
+TYPED_TEST(ServicesUtilLockstep, converged_stops_early) {
+  this->num_warmup = 1000;
+  this->num_samples = 2000;
+  for (size_t i = 0; i < num_chains; ++i)
+    this->samplers[i].set_window_params(this->num_warmup, 75, 50, 25,
+                                        this->logger);
+  this->criteria.check_interval = 100;
+  this->criteria.max_rhat = 1.1;
+  this->criteria.target_ess = 100;
+  this->refresh = 100;
+  this->run(true);
+
+  EXPECT_EQ(1, this->logger.find_info("Ending warmup early"));
+  int warmup_end = stan::services::util::internal::metric_adaptation(
+                       this->samplers[0])
+                       .num_warmup();
+  EXPECT_LT(warmup_end, this->num_warmup);
+  EXPECT_LT(0, this->logger.find_info(
+                   " / " + std::to_string(warmup_end + this->num_samples)));
+  EXPECT_EQ(1, this->logger.find_info("Stopping sampling"));
+  EXPECT_GT(num_chains * (this->num_warmup + this->num_samples),
+            this->interrupt.call_count());
+  EXPECT_EQ(0, this->interrupt.call_count() % num_chains);
+
+  int num_draws = this->sample_writer[0].call_count("vector_double");
+  EXPECT_LT(num_draws, this->num_samples);
+  EXPECT_EQ(0, num_draws % this->criteria.check_interval);
+  for (size_t i = 0; i < num_chains; ++i) {
+    EXPECT_EQ(num_draws, this->sample_writer[i].call_count("vector_double"));
+    EXPECT_FALSE(this->samplers[i].adapting());
+  }
+  EXPECT_EQ(0, this->logger.call_count_error());
+
+  // The last window runs to its scheduled end, so the metric is close
+  // to the variance of the unconstrained parameters, which is about
+  // 1 / 25 for a standard normal bounded to (-10, 10)
+  Eigen::VectorXd inv_metric
+      = metric_diagonal(this->samplers[0].z().inv_e_metric());
+  for (int i = 0; i < inv_metric.size(); ++i)
+    EXPECT_NEAR(0.04, inv_metric(i), 0.015);
+}
@@ -0,0 +1,99 @@
+#include <stan/variational/parallel_monte_carlo.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <tbb/global_control.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct monte_carlo_result {
+  double sum = 0;
+  std::vector<double> accepted;
+  std::string info;
+};
+
+// Sums the squared norm of standard normal draws, dropping draws whose
+// first element is below the threshold.
+monte_carlo_result run_monte_carlo(int n_draws, double threshold) {
+  monte_carlo_result result;
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+  boost::ecuyer1988 rng(1234);
+  boost::random::normal_distribution<double> std_normal;
+  stan::variational::internal::parallel_monte_carlo<std::domain_error>(
+      3, n_draws, n_draws,
+      [&](Eigen::VectorXd& x) {
+        for (int d = 0; d < x.size(); ++d)
+          x(d) = std_normal(rng);
+      },
+      [&](const Eigen::VectorXd& x, std::ostream& msgs) {
+        msgs << "x0 = " << x(0);
+        if (x(0) < threshold)
+          throw std::domain_error("dropped");
+        return x.squaredNorm();
+      },
+      [&](const Eigen::VectorXd& x, double value) {
+        result.sum += value;
+        result.accepted.push_back(x(0));
+      },
+      [&]() { throw std::domain_error("too many dropped"); }, logger);
+  result.info = info.str();
+  return result;
+}
+
+}  // namespace
+
+TEST(parallel_monte_carlo, matches_serial_loop) {
+  const int n_draws = 50;
+  monte_carlo_result result = run_monte_carlo(n_draws, -1e10);
+
+  boost::ecuyer1988 rng(1234);
+  boost::random::normal_distribution<double> std_normal;
+  double sum = 0;
+  std::stringstream info;
+  for (int i = 0; i < n_draws; ++i) {
+    Eigen::VectorXd x(3);
+    for (int d = 0; d < x.size(); ++d)
+      x(d) = std_normal(rng);
+    sum += x.squaredNorm();
+    std::stringstream msg;
+    msg << "x0 = " << x(0);
+    info << msg.str() << std::endl;
+    EXPECT_EQ(x(0), result.accepted[i]);
+  }
+  EXPECT_EQ(sum, result.sum);
+  EXPECT_EQ(info.str(), result.info);
+}
+
+TEST(parallel_monte_carlo, replaces_dropped_draws) {
+  const int n_draws = 50;
+  monte_carlo_result result = run_monte_carlo(n_draws, -0.5);
+  ASSERT_EQ(static_cast<std::size_t>(n_draws), result.accepted.size());
+  for (double x0 : result.accepted)
+    EXPECT_GE(x0, -0.5);
+}
+
+TEST(parallel_monte_carlo, independent_of_threads) {
+  const int n_draws = 200;
+  monte_carlo_result serial;
+  {
+    tbb::global_control limit(tbb::global_control::max_allowed_parallelism, 1);
+    serial = run_monte_carlo(n_draws, -0.5);
+  }
+  {
+    tbb::global_control limit(tbb::global_control::max_allowed_parallelism, 4);
+    monte_carlo_result parallel = run_monte_carlo(n_draws, -0.5);
+    EXPECT_EQ(serial.sum, parallel.sum);
+    EXPECT_EQ(serial.accepted, parallel.accepted);
+    EXPECT_EQ(serial.info, parallel.info);
+  }
+}
+
+TEST(parallel_monte_carlo, max_dropped) {
+  EXPECT_THROW(run_monte_carlo(10, 1e10), std::domain_error);
+}